@@ -82,6 +82,12 @@ typedef struct pomelo_rtt_s pomelo_rtt_t;
 /// @brief Session iterator. Do not modify iterator internal values manually.
 typedef struct pomelo_session_iterator_s pomelo_session_iterator_t;
 
+/// @brief Group of server sockets which are the shards of one server
+typedef struct pomelo_socket_group_s pomelo_socket_group_t;
+
+/// @brief The options for creating socket group
+typedef struct pomelo_socket_group_options_s pomelo_socket_group_options_t;
+
 
 struct pomelo_context_root_options_s {
     /// @brief The allocator
@@ -92,6 +98,48 @@ struct pomelo_context_root_options_s {
 
     /// @brief Whether to synchronize the context
     bool synchronized;
+
+    /// @brief The decryption policy of incoming packets
+    pomelo_decrypt_policy decrypt_policy;
+
+    /// @brief The maximum body size of packets decrypted in the loop thread by
+    /// the adaptive policy. Zero for default.
+    size_t decrypt_inline_threshold;
+
+    /// @brief The number of packet sequences of the replay protection window
+    /// per peer. It must be a power of two from 64 to 1024. Peers sending at
+    /// high rates need bigger windows to tolerate reordering. Zero for default
+    /// (256).
+    size_t replay_window;
+
+    /// @brief The maximum number of reliable messages in flight per channel.
+    /// Both sides should use the same value. Zero for default.
+    size_t reliable_window;
+
+    /// @brief The delay of aggregated ACKs in milliseconds, at most 8ms. The
+    /// received fragments of reliable messages are acked together after this
+    /// delay. Both sides must enable it. Zero to ack every fragment immediately.
+    uint64_t ack_delay_ms;
+
+    /// @brief Whether to coalesce small fragments sent to a peer into shared
+    /// packets. The peer must support coalesced packets.
+    bool coalesce;
+
+    /// @brief The maximum delay of coalesced fragments in milliseconds, at
+    /// most 8ms. Zero to flush them on the next loop iteration.
+    uint64_t coalesce_delay_ms;
+
+    /// @brief The number of FEC repair fragments sent after every unreliable
+    /// or sequenced message of multiple fragments, at most 16. Up to this
+    /// number of lost fragments can be rebuilt by the peer, which must
+    /// support repair fragments. Zero to disable.
+    size_t fec_repairs;
+
+    /// @brief Whether to reassemble the received messages of up to 64
+    /// fragments into one contiguous buffer, so pomelo_message_body() can
+    /// return their whole body. The fragments are copied as they arrive and
+    /// the received packets are released right away.
+    bool contiguous_reassembly;
 };
 
 
@@ -119,6 +167,51 @@ struct pomelo_socket_options_s {
     /// If this options is set NULL, all the channels will be set to unreliable
     /// mode.
     pomelo_channel_mode * channel_modes;
+
+    /// @brief The group which this socket joins as a shard. Optional.
+    /// The socket must be created in the loop thread of its platform and use
+    /// the same root context as the group.
+    pomelo_socket_group_t * group;
+
+    /// @brief The congestion control of the sessions of this socket. Disabled
+    /// by default, which suits LAN.
+    pomelo_congestion_control congestion_control;
+
+    /// @brief The checksum of multi-fragment messages. BLAKE2b by default.
+    /// The remote sockets must use the same algorithm.
+    pomelo_checksum checksum;
+
+    /// @brief The array of channel priorities. When the congestion control
+    /// holds back the packets of a session, the packets of channels with higher
+    /// priorities are sent first. If this option is set NULL, all the channels
+    /// have priority 0.
+    uint8_t * channel_priorities;
+
+    /// @brief The array of channel weights. The channels of the same priority
+    /// share the sending rate in proportion to their weights. If this option
+    /// is set NULL, or for zero elements, the weight is 1.
+    uint32_t * channel_weights;
+
+    /// @brief The number of connection requests per second which a server
+    /// socket accepts from a source IP (or IPv6 /64 prefix). The requests over
+    /// this rate are dropped before any peer is allocated. Zero for default
+    /// (64).
+    uint32_t request_rate;
+
+    /// @brief The number of connection requests which a server socket accepts
+    /// at once from a source, for the clients sharing a NAT address. Zero for
+    /// default (256).
+    uint32_t request_burst;
+};
+
+
+struct pomelo_socket_group_options_s {
+    /// @brief The allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The API context. Its root context must be synchronized, because
+    /// the shards run in different threads.
+    pomelo_context_t * context;
 };
 
 
@@ -288,6 +381,65 @@ pomelo_channel_mode pomelo_socket_get_channel_mode(
 pomelo_adapter_t * pomelo_socket_get_adapter(pomelo_socket_t * socket);
 
 
+/* -------------------------------------------------------------------------- */
+/*                             Socket group APIs                              */
+/* -------------------------------------------------------------------------- */
+
+/// A socket group shards one server over several platforms, one per loop
+/// thread. Each shard is a socket created with the `group` option, and each
+/// one listens on the same address in its own loop thread. The platforms must
+/// be created with their `reuse_port` option, so the kernel distributes
+/// the datagrams between the shards by source address and a peer always talks
+/// to the same shard.
+
+
+/// @brief Create a socket group
+/// @return New group or NULL on failure
+pomelo_socket_group_t * pomelo_socket_group_create(
+    pomelo_socket_group_options_t * options
+);
+
+
+/// @brief Destroy the socket group. All of its sockets must have been
+/// destroyed before.
+void pomelo_socket_group_destroy(pomelo_socket_group_t * group);
+
+
+/// @brief Get the number of sockets in group (Threadsafe)
+size_t pomelo_socket_group_get_nsockets(pomelo_socket_group_t * group);
+
+
+/// @brief Get the number of connected sessions of all sockets in group
+/// (Threadsafe)
+size_t pomelo_socket_group_get_nsessions(pomelo_socket_group_t * group);
+
+
+/// @brief Get the statistics of all sockets in group. The shards share the
+/// root context, so this is the statistics of that context.
+void pomelo_socket_group_statistic(
+    pomelo_socket_group_t * group,
+    pomelo_statistic_t * statistic
+);
+
+
+/// @brief Send a message to all sessions of all sockets in group (Threadsafe).
+/// The message is copied for each shard and the copies are sent in the loop
+/// threads of the shards, so the caller still owns the message. The send result
+/// is dispatched once per shard with the copied message.
+/// @param group The socket group
+/// @param channel_index The index of channel
+/// @param message The message
+/// @param data The data for callback
+/// @return The number of shards which the message has been dispatched to, or
+/// -1 on failure
+int pomelo_socket_group_broadcast(
+    pomelo_socket_group_t * group,
+    size_t channel_index,
+    pomelo_message_t * message,
+    void * data
+);
+
+
 /* -------------------------------------------------------------------------- */
 /*                              Socket events                                 */
 /* -------------------------------------------------------------------------- */
@@ -521,6 +673,18 @@ int pomelo_message_reset(pomelo_message_t * message);
 size_t pomelo_message_size(pomelo_message_t * message);
 
 
+/// @brief Get the read-only body of message without copying. The body is valid
+/// until the message is released or modified, and it is not affected by the
+/// read functions.
+/// @param length Output length of the whole body
+/// @return The body, or NULL if the message is empty or its body is not
+/// contiguous (see the contiguous_reassembly option of context)
+const uint8_t * pomelo_message_body(
+    pomelo_message_t * message,
+    size_t * length
+);
+
+
 /// @brief Write buffer to the message
 /// @return 0 on success, or -1 on failure
 int pomelo_message_write_buffer(
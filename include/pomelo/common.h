@@ -90,6 +90,10 @@ typedef struct pomelo_channel_s pomelo_channel_t;
 /// - Reliable: Guarantees both delivery and ordering. Required for critical
 ///   data that must arrive intact and in sequence.
 ///
+/// - Reliable unordered: Guarantees delivery but not ordering. Every message
+///   is delivered as soon as it is complete, so a lost message does not stall
+///   the following ones. Good for one-off events.
+///
 /// The delivery mode is set per-channel when configuring a socket and cannot
 /// be changed after the socket is created. All messages sent through a channel
 /// will follow that channel's delivery guarantees.
@@ -106,11 +110,96 @@ typedef enum pomelo_channel_mode_e {
     /// The packet will be received by the target.
     POMELO_CHANNEL_MODE_RELIABLE,
 
+    /// @brief The reliable unordered mode.
+    /// The packet will be received by the target, but it might be out of
+    /// order.
+    POMELO_CHANNEL_MODE_RELIABLE_UNORDERED,
+
     /// @brief Channel mode count
     POMELO_CHANNEL_MODE_COUNT
 } pomelo_channel_mode;
 
 
+/// @brief Incoming packet decryption policy
+///
+/// Specifies where incoming packets are decrypted and decoded:
+///
+/// - Adaptive: Packets which are not bigger than the inline threshold are
+///   decrypted directly in the loop thread. Bigger packets and the connection
+///   handshake packets (which carry tokens) are offloaded to worker threads.
+///
+/// - Worker: All encrypted packets are offloaded to worker threads.
+///
+/// - Inline: All packets are decrypted in the loop thread.
+typedef enum pomelo_decrypt_policy_e {
+    /// @brief The adaptive policy. This is the default policy.
+    POMELO_DECRYPT_POLICY_ADAPTIVE,
+
+    /// @brief The worker policy.
+    POMELO_DECRYPT_POLICY_WORKER,
+
+    /// @brief The inline policy.
+    POMELO_DECRYPT_POLICY_INLINE,
+
+    /// @brief Decrypt policy count
+    POMELO_DECRYPT_POLICY_COUNT
+} pomelo_decrypt_policy;
+
+
+/// @brief Congestion control of sessions
+///
+/// Specifies how the sending rate of a session is limited:
+///
+/// - Disabled: Fragments are sent as soon as possible. This is the default
+///   mode, suitable for LAN.
+///
+/// - CUBIC: A loss-based congestion window (CUBIC) limits the sending rate,
+///   and a pacer spreads the packets over the round trip time.
+typedef enum pomelo_congestion_control_e {
+    /// @brief No congestion control. This is the default mode.
+    POMELO_CONGESTION_CONTROL_DISABLED,
+
+    /// @brief The CUBIC congestion control with pacing.
+    POMELO_CONGESTION_CONTROL_CUBIC,
+
+    /// @brief Congestion control count
+    POMELO_CONGESTION_CONTROL_COUNT
+} pomelo_congestion_control;
+
+
+/// @brief Checksum of multi-fragment messages
+///
+/// Every fragment is already authenticated by the protocol layer, the checksum
+/// only guards the reassembly of fragments. Both sides of a connection must use
+/// the same algorithm:
+///
+/// - BLAKE2b: 32-byte cryptographic hash, computed in worker threads. This is
+///   the default algorithm.
+///
+/// - None: No checksum is attached.
+///
+/// - CRC32C: 4-byte CRC, hardware accelerated with SSE4.2 or ARMv8 CRC when
+///   available. Computed in the loop thread.
+///
+/// - XXH64: 8-byte xxHash64, computed in the loop thread.
+typedef enum pomelo_checksum_e {
+    /// @brief The BLAKE2b checksum. This is the default algorithm.
+    POMELO_CHECKSUM_BLAKE2B,
+
+    /// @brief No checksum.
+    POMELO_CHECKSUM_NONE,
+
+    /// @brief The CRC32C checksum.
+    POMELO_CHECKSUM_CRC32C,
+
+    /// @brief The xxHash64 checksum.
+    POMELO_CHECKSUM_XXH64,
+
+    /// @brief Checksum count
+    POMELO_CHECKSUM_COUNT
+} pomelo_checksum;
+
+
 /// @brief The API context interface
 ///
 /// The context manages the core networking functionality and plugin system.
@@ -0,0 +1,106 @@
+#ifndef POMELO_PLATFORM_URING_H
+#define POMELO_PLATFORM_URING_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "pomelo/allocator.h"
+#include "pomelo/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/// @brief The options for platform
+typedef struct pomelo_platform_uring_options_s
+    pomelo_platform_uring_options_t;
+
+
+/// @brief The statistic of platform
+typedef struct pomelo_statistic_platform_uring_s
+    pomelo_statistic_platform_uring_t;
+
+
+struct pomelo_platform_uring_options_s {
+    /// @brief The allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The number of submission queue entries. Zero for default.
+    uint32_t queue_depth;
+
+    /// @brief The number of provided receiving buffers shared by all sockets.
+    /// It will be rounded up to a power of two. Zero for default.
+    uint32_t recv_buffers;
+
+    /// @brief The maximum payload size of a received datagram. Zero for
+    /// default.
+    size_t recv_buffer_size;
+
+    /// @brief The number of worker threads. Zero for default.
+    size_t worker_threads;
+
+    /// @brief Bind server sockets with SO_REUSEPORT, so that several platforms
+    /// can listen on the same address.
+    bool reuse_port;
+};
+
+
+struct pomelo_statistic_platform_uring_s {
+    /// @brief The number of scheduled timers
+    size_t timers;
+
+    /// @brief The number of scheduled works
+    size_t worker_tasks;
+
+    /// @brief The number of main tasks
+    size_t threadsafe_tasks;
+
+    /// @brief The number of in-use sending commands
+    size_t send_commands;
+
+    /// @brief The number of bytes which are sent by platform
+    uint64_t sent_bytes;
+
+    /// @brief The number of bytes which are recv by platform
+    uint64_t recv_bytes;
+
+    /// @brief The number of submit calls
+    uint64_t submissions;
+
+    /// @brief The number of reaped completions
+    uint64_t completions;
+
+    /// @brief The number of times the provided buffers ran out
+    uint64_t recv_buffers_exhausted;
+};
+
+
+/// @brief Create the io_uring platform
+pomelo_platform_t * pomelo_platform_uring_create(
+    pomelo_platform_uring_options_t * options
+);
+
+
+/// @brief Destroy the io_uring platform. After calling this function, if there
+/// are some pending works to do, no more callbacks will be called.
+void pomelo_platform_uring_destroy(pomelo_platform_t * platform);
+
+
+/// @brief Run the event loop of platform in the calling thread. This function
+/// returns after the platform has been completely shut down.
+/// @return 0 on success or -1 on failure
+int pomelo_platform_uring_run(pomelo_platform_t * platform);
+
+
+/// @brief Get the statistic of platform
+void pomelo_platform_uring_statistic(
+    pomelo_platform_t * platform,
+    pomelo_statistic_platform_uring_t * statistic
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PLATFORM_URING_H
@@ -1,5 +1,6 @@
 #ifndef POMELO_PLATFORM_UV_H
 #define POMELO_PLATFORM_UV_H
+#include <stdbool.h>
 #include "uv.h"
 #include "pomelo/allocator.h"
 #include "pomelo/platform.h"
@@ -24,6 +25,33 @@ struct pomelo_platform_uv_options_s {
 
     /// @brief The UV loop
     uv_loop_t * uv_loop;
+
+    /// @brief The maximum number of datagrams read by a single receive call
+    /// (recvmmsg). Zero or one disables batched receiving.
+    size_t recv_batch_size;
+
+    /// @brief The maximum number of datagrams sent by a single send call
+    /// (sendmmsg). Outgoing datagrams are queued per socket and flushed once
+    /// per loop iteration. Zero or one disables batched sending.
+    size_t send_batch_size;
+
+    /// @brief Pack consecutive equal-size datagrams to the same target into
+    /// a single UDP GSO send (UDP_SEGMENT). This requires batched sending and
+    /// falls back to plain sending if the kernel or device does not support it.
+    bool udp_gso;
+
+    /// @brief Bind server sockets with SO_REUSEPORT, so that several platforms
+    /// (one per loop thread) can listen on the same address. The kernel
+    /// distributes incoming datagrams by hashing the source address, so a peer
+    /// always lands on the same platform.
+    bool reuse_port;
+
+    /// @brief Schedule timers on a hierarchical timing wheel driven by a single
+    /// uv timer instead of one uv timer per platform timer. Starting and
+    /// stopping a timer become O(1) without touching the heap of libuv, which
+    /// suits high-churn timers like the resend timers of reliable channels.
+    /// The resolution of wheel is one millisecond.
+    bool timer_wheel;
 };
 
 
@@ -51,6 +79,19 @@ struct pomelo_statistic_platform_uv_s {
 
     /// @brief The number of bytes which are recv by platform
     uint64_t recv_bytes;
+
+    /// @brief The effective send batch size. Zero if batched sending is
+    /// disabled or not supported.
+    size_t send_batch_size;
+
+    /// @brief The number of batched send calls (sendmmsg)
+    uint64_t send_flushes;
+
+    /// @brief The number of datagrams sent by batched send calls
+    uint64_t send_flushed_datagrams;
+
+    /// @brief The number of datagrams sent as GSO segments
+    uint64_t send_gso_segments;
 };
 
 
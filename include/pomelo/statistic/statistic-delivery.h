@@ -2,6 +2,7 @@
 #define POMELO_STATISTIC_DELIVERY_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,24 @@ struct pomelo_statistic_delivery_s {
 
     /// @brief The number of active heartbeat objects
     size_t heartbeats;
+
+    /// @brief The number of fragments retransmitted by timeouts
+    uint64_t retransmitted_fragments;
+
+    /// @brief The number of fragments retransmitted after later fragments had
+    /// been acked (fast retransmit)
+    uint64_t fast_retransmitted_fragments;
+
+    /// @brief The number of lost fragments rebuilt from FEC repair fragments
+    uint64_t recovered_fragments;
+
+    /// @brief The number of bytes of the per-bus lists, maps and windows.
+    /// They are created on the first use of each delivery mode.
+    size_t bus_state_bytes;
+
+    /// @brief The average number of bytes of an active endpoint (the delivery
+    /// state of a session), including its buses and their structures
+    size_t endpoint_bytes;
 };
 
 #ifdef __cplusplus
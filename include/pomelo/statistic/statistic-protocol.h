@@ -2,6 +2,7 @@
 #define POMELO_STATISTIC_PROTOCOL_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +35,17 @@ struct pomelo_statistic_protocol_s {
     
     /// @brief The number of accepted connections
     size_t acceptances;
+
+    /// @brief The number of received packets processed in the loop thread
+    uint64_t inline_received_packets;
+
+    /// @brief The number of received packets processed in worker threads
+    uint64_t worker_received_packets;
+
+    /// @brief The number of connection requests dropped by servers before
+    /// allocating peers, because their sources exceeded the request rate or
+    /// too many requests were pending
+    uint64_t dropped_requests;
 };
 
 #ifdef __cplusplus
@@ -107,7 +107,8 @@ void pomelo_channel_builtin_send(
     pomelo_delivery_sender_options_t options = {
         .context = socket->context->delivery_context,
         .parcel = message->parcel,
-        .platform = socket->platform
+        .platform = socket->platform,
+        .checksum = socket->checksum
     };
     pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
     if (!sender) {
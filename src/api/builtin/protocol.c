@@ -85,3 +85,14 @@ void pomelo_protocol_socket_on_connect_result(
         (pomelo_socket_connect_result) result
     );
 }
+
+
+void pomelo_protocol_socket_on_heartbeat(pomelo_protocol_socket_t * socket) {
+    assert(socket != NULL);
+
+    pomelo_socket_t * api_socket = pomelo_protocol_socket_get_extra(socket);
+    if (!api_socket) return; // No associated socket
+
+    // The pings of delivery suppress the keep alive packets of the same peers
+    pomelo_delivery_heartbeat_run(api_socket->heartbeat);
+}
@@ -138,7 +138,11 @@ int pomelo_session_builtin_init(
         .sequencer = &socket->sequencer,
         .heartbeat = socket->heartbeat,
         .nbuses = socket->channel_modes->size,
-        .time_sync = (socket->state == POMELO_SOCKET_STATE_RUNNING_CLIENT)
+        .time_sync = (socket->state == POMELO_SOCKET_STATE_RUNNING_CLIENT),
+        .congestion_control = socket->congestion_control,
+        .checksum = socket->checksum,
+        .bus_priorities = socket->channel_priorities->elements,
+        .bus_weights = socket->channel_weights->elements
     };
     pomelo_delivery_endpoint_t * endpoint =
         pomelo_delivery_endpoint_create(&options);
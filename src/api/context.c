@@ -52,6 +52,7 @@ pomelo_context_t * pomelo_context_root_create(
     pomelo_context_t * base = &context->base;
 
     context->allocator = allocator;
+    context->synchronized = options->synchronized;
 
     // Create buffer context
     pomelo_buffer_context_root_options_t buffer_context_options = {
@@ -75,6 +76,12 @@ pomelo_context_t * pomelo_context_root_create(
             message_capacity,
             POMELO_FRAGMENT_BODY_CAPACITY
         ),
+        .reliable_window = options->reliable_window,
+        .ack_delay_ms = options->ack_delay_ms,
+        .coalesce = options->coalesce,
+        .coalesce_delay_ms = options->coalesce_delay_ms,
+        .fec_repairs = options->fec_repairs,
+        .contiguous_reassembly = options->contiguous_reassembly,
         .synchronized = options->synchronized
     };
     context->delivery_context =
@@ -88,7 +95,11 @@ pomelo_context_t * pomelo_context_root_create(
     pomelo_protocol_context_options_t protocol_context_options = {
         .allocator = allocator,
         .buffer_context = context->buffer_context,
-        .payload_capacity = POMELO_PACKET_BODY_CAPACITY
+        .payload_capacity = POMELO_PACKET_BODY_CAPACITY,
+        .synchronized = options->synchronized,
+        .decrypt_policy = options->decrypt_policy,
+        .decrypt_inline_threshold = options->decrypt_inline_threshold,
+        .replay_window = options->replay_window
     };
     base->protocol_context =
         pomelo_protocol_context_create(&protocol_context_options);
@@ -134,6 +145,7 @@ pomelo_context_t * pomelo_context_root_create(
     pool_options.on_init = (pomelo_pool_init_cb) pomelo_socket_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb) pomelo_socket_cleanup;
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
     base->socket_pool = pomelo_pool_root_create(&pool_options);
     if (!base->socket_pool) {
         pomelo_context_root_destroy(context);
@@ -152,6 +164,7 @@ pomelo_context_t * pomelo_context_root_create(
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_session_builtin_cleanup;
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
 
     base->builtin_session_pool = pomelo_pool_root_create(&pool_options);
     if (!base->builtin_session_pool) {
@@ -168,6 +181,7 @@ pomelo_context_t * pomelo_context_root_create(
     pool_options.on_init = (pomelo_pool_init_cb) pomelo_channel_builtin_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_channel_builtin_cleanup;
+    pool_options.synchronized = options->synchronized;
     base->builtin_channel_pool = pomelo_pool_root_create(&pool_options);
     if (!base->builtin_channel_pool) {
         pomelo_context_root_destroy(context);
@@ -186,6 +200,7 @@ pomelo_context_t * pomelo_context_root_create(
     pool_options.on_init = (pomelo_pool_init_cb) pomelo_session_plugin_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_session_plugin_cleanup;
+    pool_options.synchronized = options->synchronized;
     base->plugin_session_pool = pomelo_pool_root_create(&pool_options);
     if (!base->plugin_session_pool) {
         pomelo_context_root_destroy(context);
@@ -201,6 +216,7 @@ pomelo_context_t * pomelo_context_root_create(
     pool_options.on_init = (pomelo_pool_init_cb) pomelo_channel_plugin_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_channel_plugin_cleanup;
+    pool_options.synchronized = options->synchronized;
     base->plugin_channel_pool = pomelo_pool_root_create(&pool_options);
     if (!base->plugin_channel_pool) {
         pomelo_context_root_destroy(context);
@@ -408,8 +424,7 @@ pomelo_context_t * pomelo_context_shared_create(
         pomelo_context_shared_statistic;
     base->buffer_context = (pomelo_buffer_context_t *)
         context->buffer_context;
-    base->protocol_context = (pomelo_protocol_context_t *)
-        context->base.protocol_context;
+    base->protocol_context = root->base.protocol_context;
     base->delivery_context = (pomelo_delivery_context_t *)
         context->delivery_context;
     base->plugin_manager = root->plugin_manager;
@@ -117,6 +117,9 @@ struct pomelo_context_root_s {
 
     /// @brief The plugin manager
     pomelo_plugin_manager_t * plugin_manager;
+
+    /// @brief Whether this context can be shared between threads
+    bool synchronized;
 };
 
 
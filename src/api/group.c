@@ -0,0 +1,291 @@
+#include <assert.h>
+#include <string.h>
+#include "group.h"
+#include "context.h"
+#include "socket.h"
+#include "message.h"
+
+
+/// @brief Free the group when its last reference is gone
+static void socket_group_on_finalize(pomelo_reference_t * ref) {
+    assert(ref != NULL);
+    pomelo_socket_group_t * group = ref->data;
+
+    if (group->task_pool) {
+        pomelo_pool_destroy(group->task_pool);
+        group->task_pool = NULL;
+    }
+
+    if (group->sockets) {
+        pomelo_list_destroy(group->sockets);
+        group->sockets = NULL;
+    }
+
+    if (group->mutex) {
+        pomelo_mutex_destroy(group->mutex);
+        group->mutex = NULL;
+    }
+
+    pomelo_allocator_free(group->allocator, group);
+}
+
+
+/// @brief Send the message to all sessions of socket
+static void socket_group_send(
+    pomelo_socket_t * socket,
+    size_t channel_index,
+    pomelo_message_t * message,
+    void * data
+) {
+    // Collect the sessions of this shard
+    pomelo_array_t * sessions = socket->broadcast_sessions;
+    if (pomelo_array_resize(sessions, socket->sessions->size) < 0) {
+        return; // Failed to resize the sessions array
+    }
+
+    size_t nsessions = 0;
+    pomelo_session_t * session = NULL;
+    pomelo_list_iterator_t it;
+    pomelo_list_iterator_init(&it, socket->sessions);
+    while (pomelo_list_iterator_next(&it, &session) == 0) {
+        pomelo_array_set(sessions, nsessions++, session);
+    }
+
+    pomelo_socket_send(
+        socket,
+        channel_index,
+        message,
+        (pomelo_session_t **) sessions->elements,
+        nsessions,
+        data
+    );
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Public APIs                                  */
+/* -------------------------------------------------------------------------- */
+
+
+pomelo_socket_group_t * pomelo_socket_group_create(
+    pomelo_socket_group_options_t * options
+) {
+    assert(options != NULL);
+    pomelo_context_t * context = options->context;
+    if (!context) return NULL;
+    if (!context->root->synchronized) {
+        return NULL; // Shards run in different threads
+    }
+
+    pomelo_allocator_t * allocator = options->allocator;
+    if (!allocator) {
+        allocator = pomelo_allocator_default();
+    }
+
+    pomelo_socket_group_t * group =
+        pomelo_allocator_malloc_t(allocator, pomelo_socket_group_t);
+    if (!group) return NULL;
+    memset(group, 0, sizeof(pomelo_socket_group_t));
+    group->allocator = allocator;
+    group->context = &context->root->base;
+    group->ref.data = group;
+    pomelo_reference_init(&group->ref, socket_group_on_finalize);
+    pomelo_atomic_uint64_store(&group->nsessions, 0);
+
+    group->mutex = pomelo_mutex_create(allocator);
+    if (!group->mutex) {
+        pomelo_socket_group_destroy(group);
+        return NULL;
+    }
+
+    pomelo_list_options_t list_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_socket_t *)
+    };
+    group->sockets = pomelo_list_create(&list_options);
+    if (!group->sockets) {
+        pomelo_socket_group_destroy(group);
+        return NULL;
+    }
+
+    pomelo_pool_root_options_t pool_options;
+    memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
+    pool_options.allocator = allocator;
+    pool_options.element_size = sizeof(pomelo_socket_group_task_t);
+    pool_options.zero_init = true;
+    pool_options.synchronized = true;
+    group->task_pool = pomelo_pool_root_create(&pool_options);
+    if (!group->task_pool) {
+        pomelo_socket_group_destroy(group);
+        return NULL;
+    }
+
+    return group;
+}
+
+
+void pomelo_socket_group_destroy(pomelo_socket_group_t * group) {
+    assert(group != NULL);
+    assert(group->sockets == NULL || group->sockets->size == 0);
+    pomelo_reference_unref(&group->ref);
+    // => socket_group_on_finalize()
+}
+
+
+size_t pomelo_socket_group_get_nsockets(pomelo_socket_group_t * group) {
+    assert(group != NULL);
+
+    POMELO_BEGIN_CRITICAL_SECTION(group->mutex);
+    size_t nsockets = group->sockets->size;
+    POMELO_END_CRITICAL_SECTION(group->mutex);
+
+    return nsockets;
+}
+
+
+size_t pomelo_socket_group_get_nsessions(pomelo_socket_group_t * group) {
+    assert(group != NULL);
+    return (size_t) pomelo_atomic_uint64_load(&group->nsessions);
+}
+
+
+void pomelo_socket_group_statistic(
+    pomelo_socket_group_t * group,
+    pomelo_statistic_t * statistic
+) {
+    assert(group != NULL);
+    assert(statistic != NULL);
+    pomelo_context_statistic(group->context, statistic);
+}
+
+
+int pomelo_socket_group_broadcast(
+    pomelo_socket_group_t * group,
+    size_t channel_index,
+    pomelo_message_t * message,
+    void * data
+) {
+    assert(group != NULL);
+    assert(message != NULL);
+
+    int ndispatched = 0;
+    int ret = 0;
+    pomelo_socket_t * socket = NULL;
+    pomelo_list_iterator_t it;
+
+    POMELO_BEGIN_CRITICAL_SECTION(group->mutex);
+    pomelo_list_iterator_init(&it, group->sockets);
+    while (pomelo_list_iterator_next(&it, &socket) == 0) {
+        pomelo_message_t * copied =
+            pomelo_context_acquire_message(group->context);
+        if (!copied) {
+            ret = -1; // Failed to acquire message
+            break;
+        }
+
+        if (pomelo_message_copy(copied, message) < 0) {
+            pomelo_message_unref(copied);
+            ret = -1; // Failed to copy message
+            break;
+        }
+
+        pomelo_socket_group_task_t * task =
+            pomelo_pool_acquire(group->task_pool, NULL);
+        if (!task) {
+            pomelo_message_unref(copied);
+            ret = -1; // Failed to acquire task
+            break;
+        }
+
+        // The task keeps the group and the socket until it has run
+        pomelo_reference_ref(&group->ref);
+        pomelo_reference_ref(&socket->ref);
+        task->group = group;
+        task->socket = socket;
+        task->message = copied;
+        task->channel_index = channel_index;
+        task->data = data;
+
+        pomelo_platform_task_t * platform_task =
+            pomelo_threadsafe_executor_submit(
+                socket->platform,
+                socket->executor,
+                (pomelo_platform_task_entry)
+                    pomelo_socket_group_broadcast_deferred,
+                task
+            );
+        if (!platform_task) {
+            // The platform of this shard is shutting down, skip it. The socket
+            // is still in the group, so these are not the last references.
+            pomelo_pool_release(group->task_pool, task);
+            pomelo_message_unref(copied);
+            pomelo_reference_unref(&socket->ref);
+            pomelo_reference_unref(&group->ref);
+            continue;
+        }
+
+        ndispatched++;
+        // => pomelo_socket_group_broadcast_deferred()
+    }
+    POMELO_END_CRITICAL_SECTION(group->mutex);
+
+    return (ret < 0 && ndispatched == 0) ? -1 : ndispatched;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+
+int pomelo_socket_group_add_socket(
+    pomelo_socket_group_t * group,
+    pomelo_socket_t * socket
+) {
+    assert(group != NULL);
+    assert(socket != NULL);
+
+    POMELO_BEGIN_CRITICAL_SECTION(group->mutex);
+    socket->group_entry = pomelo_list_push_back(group->sockets, socket);
+    POMELO_END_CRITICAL_SECTION(group->mutex);
+
+    return socket->group_entry ? 0 : -1;
+}
+
+
+void pomelo_socket_group_remove_socket(
+    pomelo_socket_group_t * group,
+    pomelo_socket_t * socket
+) {
+    assert(group != NULL);
+    assert(socket != NULL);
+    if (!socket->group_entry) return; // Not in group
+
+    POMELO_BEGIN_CRITICAL_SECTION(group->mutex);
+    pomelo_list_remove(group->sockets, socket->group_entry);
+    POMELO_END_CRITICAL_SECTION(group->mutex);
+
+    socket->group_entry = NULL;
+}
+
+
+void pomelo_socket_group_broadcast_deferred(pomelo_socket_group_task_t * task) {
+    assert(task != NULL);
+    pomelo_socket_group_t * group = task->group;
+    pomelo_socket_t * socket = task->socket;
+    pomelo_message_t * message = task->message;
+    size_t channel_index = task->channel_index;
+    void * data = task->data;
+    pomelo_pool_release(group->task_pool, task);
+
+    // The socket may have left the group or stopped after submitting
+    if (socket->group == group &&
+        socket->state == POMELO_SOCKET_STATE_RUNNING_SERVER
+    ) {
+        socket_group_send(socket, channel_index, message, data);
+    }
+
+    pomelo_message_unref(message);
+    pomelo_reference_unref(&socket->ref);
+    pomelo_reference_unref(&group->ref);
+}
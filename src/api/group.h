@@ -0,0 +1,92 @@
+#ifndef POMELO_API_GROUP_SRC_H
+#define POMELO_API_GROUP_SRC_H
+#include "pomelo/api.h"
+#include "base/ref.h"
+#include "utils/atomic.h"
+#include "utils/list.h"
+#include "utils/mutex.h"
+#include "utils/pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// @brief The broadcasting task of a shard
+typedef struct pomelo_socket_group_task_s pomelo_socket_group_task_t;
+
+
+struct pomelo_socket_group_s {
+    /// @brief The allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The root context shared by all sockets of group
+    pomelo_context_t * context;
+
+    /// @brief The mutex of sockets list
+    pomelo_mutex_t * mutex;
+
+    /// @brief [Synchronized] The list of sockets
+    pomelo_list_t * sockets;
+
+    /// @brief The number of connected sessions of all sockets
+    pomelo_atomic_uint64_t nsessions;
+
+    /// @brief [Synchronized] The pool of broadcasting tasks
+    pomelo_pool_t * task_pool;
+
+    /// @brief The reference of group. The pending broadcasting tasks hold it,
+    /// so that the group is freed after they have run.
+    pomelo_reference_t ref;
+};
+
+
+struct pomelo_socket_group_task_s {
+    /// @brief The group
+    pomelo_socket_group_t * group;
+
+    /// @brief The target socket
+    pomelo_socket_t * socket;
+
+    /// @brief The copied message which is owned by this task
+    pomelo_message_t * message;
+
+    /// @brief The index of channel
+    size_t channel_index;
+
+    /// @brief The data for send callback
+    void * data;
+};
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+
+/// @brief Add socket to group. This is called in the loop thread of socket.
+/// @return 0 on success or -1 on failure
+int pomelo_socket_group_add_socket(
+    pomelo_socket_group_t * group,
+    pomelo_socket_t * socket
+);
+
+
+/// @brief Remove socket from group. This is called in the loop thread of
+/// socket.
+void pomelo_socket_group_remove_socket(
+    pomelo_socket_group_t * group,
+    pomelo_socket_t * socket
+);
+
+
+/// @brief Send the copied message to all sessions of the target socket. This
+/// runs in the loop thread of socket and releases the references of the group
+/// and the socket taken by the broadcasting.
+void pomelo_socket_group_broadcast_deferred(pomelo_socket_group_task_t * task);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_API_GROUP_SRC_H
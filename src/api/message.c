@@ -93,6 +93,18 @@ size_t pomelo_message_size(pomelo_message_t * message) {
 }
 
 
+const uint8_t * pomelo_message_body(
+    pomelo_message_t * message,
+    size_t * length
+) {
+    assert(message != NULL);
+    assert(length != NULL);
+    pomelo_message_check_alive(message);
+
+    return pomelo_delivery_parcel_body(message->parcel, length);
+}
+
+
 int pomelo_message_init(
     pomelo_message_t * message,
     pomelo_message_info_t * info
@@ -193,6 +205,28 @@ void pomelo_message_finish_send(pomelo_message_t * message) {
 }
 
 
+int pomelo_message_copy(pomelo_message_t * message, pomelo_message_t * source) {
+    assert(message != NULL);
+    assert(source != NULL);
+    pomelo_message_check_alive(source);
+
+    pomelo_array_t * chunks = source->parcel->chunks;
+    for (size_t i = 0; i < chunks->size; i++) {
+        pomelo_buffer_view_t * chunk = pomelo_array_get_ptr(chunks, i);
+        if (!chunk->buffer || chunk->length == 0) continue; // Empty chunk
+
+        int ret = pomelo_message_write_buffer(
+            message,
+            chunk->buffer->data + chunk->offset,
+            chunk->length
+        );
+        if (ret < 0) return ret; // Failed to write
+    }
+
+    return 0;
+}
+
+
 /* -------------------------------------------------------------------------- */
 /*                               Public APIs                                  */
 /* -------------------------------------------------------------------------- */
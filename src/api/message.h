@@ -107,6 +107,12 @@ void pomelo_message_prepare_send(pomelo_message_t * message, void * data);
 void pomelo_message_finish_send(pomelo_message_t * message);
 
 
+/// @brief Append the whole content of source message to the writing message.
+/// The source message is left untouched.
+/// @return 0 on success or an error code on failure
+int pomelo_message_copy(pomelo_message_t * message, pomelo_message_t * source);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,6 +3,7 @@
 #include "pomelo/errno.h"
 #include "socket.h"
 #include "context.h"
+#include "group.h"
 #include "session.h"
 #include "message.h"
 #include "channel.h"
@@ -17,6 +18,14 @@
 #include "plugin/session.h"
 
 
+/// @brief Release the socket when its last reference is gone
+static void socket_on_finalize(pomelo_reference_t * ref) {
+    assert(ref != NULL);
+    pomelo_socket_t * socket = ref->data;
+    pomelo_pool_release(socket->context->socket_pool, socket);
+}
+
+
 int pomelo_socket_on_alloc(
     pomelo_socket_t * socket,
     pomelo_context_t * context
@@ -26,6 +35,11 @@ int pomelo_socket_on_alloc(
 
     pomelo_extra_set(socket->extra, NULL);
     socket->context = context;
+    socket->group = NULL;
+    socket->group_entry = NULL;
+    socket->executor = NULL;
+    socket->broadcast_sessions = NULL;
+    socket->ref.data = socket;
 
     // Create sessions list
     pomelo_list_options_t list_options = {
@@ -43,6 +57,16 @@ int pomelo_socket_on_alloc(
     socket->channel_modes = pomelo_array_create(&array_options);
     if (!socket->channel_modes) return -1;
 
+    // Create channel priorities array
+    array_options.element_size = sizeof(uint8_t);
+    socket->channel_priorities = pomelo_array_create(&array_options);
+    if (!socket->channel_priorities) return -1;
+
+    // Create channel weights array
+    array_options.element_size = sizeof(uint32_t);
+    socket->channel_weights = pomelo_array_create(&array_options);
+    if (!socket->channel_weights) return -1;
+
     return 0;
 }
 
@@ -59,6 +83,16 @@ void pomelo_socket_on_free(pomelo_socket_t * socket) {
         pomelo_array_destroy(socket->channel_modes);
         socket->channel_modes = NULL;
     }
+
+    if (socket->channel_priorities) {
+        pomelo_array_destroy(socket->channel_priorities);
+        socket->channel_priorities = NULL;
+    }
+
+    if (socket->channel_weights) {
+        pomelo_array_destroy(socket->channel_weights);
+        socket->channel_weights = NULL;
+    }
 }
 
 
@@ -71,6 +105,10 @@ int pomelo_socket_init(
     if (options->nchannels == 0) return -1;
 
     socket->platform = options->platform;
+    socket->congestion_control = options->congestion_control;
+    socket->checksum = options->checksum;
+    socket->request_rate = options->request_rate;
+    socket->request_burst = options->request_burst;
 
     pomelo_context_t * context = options->context;
     pomelo_allocator_t * allocator = context->allocator;
@@ -90,6 +128,25 @@ int pomelo_socket_init(
         }
     }
 
+    // Initialize channel scheduling arrays
+    pomelo_array_t * channel_priorities = socket->channel_priorities;
+    pomelo_array_t * channel_weights = socket->channel_weights;
+    pomelo_array_resize(channel_priorities, options->nchannels);
+    pomelo_array_resize(channel_weights, options->nchannels);
+    for (size_t i = 0; i < options->nchannels; i++) {
+        uint8_t priority = options->channel_priorities
+            ? options->channel_priorities[i]
+            : 0;
+        uint32_t weight = options->channel_weights
+            ? options->channel_weights[i]
+            : 0;
+        if (weight == 0) {
+            weight = 1;
+        }
+        pomelo_array_set(channel_priorities, i, priority);
+        pomelo_array_set(channel_weights, i, weight);
+    }
+
     // The protocol socket will be created later
     socket->protocol_socket = NULL;
 
@@ -104,10 +161,11 @@ int pomelo_socket_init(
     socket->adapter = pomelo_adapter_create(&adapter_options);
     if (!socket->adapter) return -1;
 
-    // Create heartbeat
+    // Create heartbeat, it is run with the keep alive of protocol socket
     pomelo_delivery_heartbeat_options_t heartbeat_options = {
         .context = context->delivery_context,
-        .platform = options->platform
+        .platform = options->platform,
+        .manual = true
     };
     socket->heartbeat = pomelo_delivery_heartbeat_create(&heartbeat_options);
     if (!socket->heartbeat) return -1;
@@ -126,6 +184,32 @@ int pomelo_socket_init(
         socket
     );
 
+    // Initialize the reference
+    pomelo_reference_init(&socket->ref, socket_on_finalize);
+
+    // Join the group
+    pomelo_socket_group_t * group = options->group;
+    if (group) {
+        if (group->context->root != context->root) {
+            return -1; // Shards must share the same root context
+        }
+
+        socket->executor =
+            pomelo_platform_acquire_threadsafe_executor(options->platform);
+        if (!socket->executor) return -1;
+
+        pomelo_array_options_t array_options = {
+            .allocator = allocator,
+            .element_size = sizeof(pomelo_session_t *)
+        };
+        socket->broadcast_sessions = pomelo_array_create(&array_options);
+        if (!socket->broadcast_sessions) return -1;
+
+        socket->group = group;
+        int ret = pomelo_socket_group_add_socket(group, socket);
+        if (ret < 0) return -1;
+    }
+
     // Dispatch to plugins
     pomelo_plugin_dispatch_socket_on_created(socket);
     return 0;
@@ -146,6 +230,14 @@ void pomelo_socket_cleanup(pomelo_socket_t * socket) {
         pomelo_array_resize(socket->channel_modes, 0);
     }
 
+    if (socket->channel_priorities) {
+        pomelo_array_resize(socket->channel_priorities, 0);
+    }
+
+    if (socket->channel_weights) {
+        pomelo_array_resize(socket->channel_weights, 0);
+    }
+
     if (socket->adapter) {
         pomelo_adapter_destroy(socket->adapter);
         socket->adapter = NULL;
@@ -155,6 +247,24 @@ void pomelo_socket_cleanup(pomelo_socket_t * socket) {
         pomelo_delivery_heartbeat_destroy(socket->heartbeat);
         socket->heartbeat = NULL;
     }
+
+    if (socket->group) {
+        pomelo_socket_group_remove_socket(socket->group, socket);
+        socket->group = NULL;
+    }
+
+    if (socket->executor) {
+        pomelo_platform_release_threadsafe_executor(
+            socket->platform,
+            socket->executor
+        );
+        socket->executor = NULL;
+    }
+
+    if (socket->broadcast_sessions) {
+        pomelo_array_destroy(socket->broadcast_sessions);
+        socket->broadcast_sessions = NULL;
+    }
 }
 
 
@@ -170,6 +280,12 @@ pomelo_socket_t * pomelo_socket_create(pomelo_socket_options_t * options) {
     if (options->nchannels == 0 || options->nchannels > POMELO_MAX_CHANNELS) {
         return NULL; // Invalid number of channels
     }
+    if (options->congestion_control >= POMELO_CONGESTION_CONTROL_COUNT) {
+        return NULL; // Invalid congestion control
+    }
+    if (options->checksum >= POMELO_CHECKSUM_COUNT) {
+        return NULL; // Invalid checksum
+    }
 
     return pomelo_pool_acquire(options->context->socket_pool, options);
 }
@@ -267,7 +383,9 @@ int pomelo_socket_listen(
         .private_key = private_key,
         .protocol_id = protocol_id,
         .address = *address,
-        .adapter = socket->adapter
+        .adapter = socket->adapter,
+        .request_rate = socket->request_rate,
+        .request_burst = socket->request_burst
     };
     socket->protocol_socket = pomelo_protocol_server_create(&server_options);
     if (!socket->protocol_socket) {
@@ -563,6 +681,9 @@ void pomelo_socket_add_session(
     assert(socket != NULL);
     assert(session != NULL);
     session->entry = pomelo_list_push_back(socket->sessions, session);
+    if (session->entry && socket->group) {
+        pomelo_atomic_uint64_fetch_add(&socket->group->nsessions, 1);
+    }
 }
 
 
@@ -576,6 +697,9 @@ void pomelo_socket_remove_session(
     if (session->entry) {
         pomelo_list_remove(socket->sessions, session->entry);
         session->entry = NULL;
+        if (socket->group) {
+            pomelo_atomic_uint64_fetch_sub(&socket->group->nsessions, 1);
+        }
     }
 }
 
@@ -636,7 +760,8 @@ int pomelo_socket_send_builtin(
     pomelo_delivery_sender_options_t options = {
         .context = socket->context->delivery_context,
         .parcel = message->parcel,
-        .platform = socket->platform
+        .platform = socket->platform,
+        .checksum = socket->checksum
     };
     pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
     if (!sender) return -1; // Failed to create sender
@@ -770,7 +895,16 @@ void pomelo_socket_destroy_deferred(pomelo_socket_t * socket) {
 
     // Dispatch to plugins
     pomelo_plugin_dispatch_socket_on_destroyed(socket);
-    pomelo_pool_release(socket->context->socket_pool, socket);
+
+    // Leave the group, so that no more broadcasting tasks are submitted. The
+    // submitted ones hold the references of socket.
+    if (socket->group) {
+        pomelo_socket_group_remove_socket(socket->group, socket);
+        socket->group = NULL;
+    }
+
+    pomelo_reference_unref(&socket->ref);
+    // => socket_on_finalize()
 }
 
 
@@ -791,6 +925,12 @@ void pomelo_socket_stop_deferred(pomelo_socket_t * socket) {
 
     pomelo_pool_t * builtin_pool = context->builtin_session_pool;
     pomelo_pool_t * plugin_pool = context->plugin_session_pool;
+    if (socket->group) {
+        pomelo_atomic_uint64_fetch_sub(
+            &socket->group->nsessions,
+            sessions->size
+        );
+    }
     while (pomelo_list_pop_front(sessions, &session) == 0) {
         switch (session->type) {
             case POMELO_SESSION_TYPE_BUILTIN:
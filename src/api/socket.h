@@ -3,6 +3,7 @@
 #include "pomelo/api.h"
 #include "pomelo/constants.h"
 #include "base/extra.h"
+#include "base/ref.h"
 #include "base/sequencer.h"
 #include "protocol/protocol.h"
 #include "delivery/delivery.h"
@@ -49,6 +50,24 @@ struct pomelo_socket_s {
     /// @brief The array of channel modes
     pomelo_array_t * channel_modes;
 
+    /// @brief The array of channel scheduling priorities
+    pomelo_array_t * channel_priorities;
+
+    /// @brief The array of channel scheduling weights
+    pomelo_array_t * channel_weights;
+
+    /// @brief The congestion control of sessions
+    pomelo_congestion_control congestion_control;
+
+    /// @brief The checksum of multi-fragment messages
+    pomelo_checksum checksum;
+
+    /// @brief The number of connection requests per second from a source
+    uint32_t request_rate;
+
+    /// @brief The number of connection requests at once from a source
+    uint32_t request_burst;
+
     /// @brief The counter for session signature
     uint64_t session_signature_generator;
 
@@ -69,6 +88,22 @@ struct pomelo_socket_s {
 
     /// @brief The destroy task of socket
     pomelo_sequencer_task_t destroy_task;
+
+    /// @brief The group which this socket belongs to
+    pomelo_socket_group_t * group;
+
+    /// @brief The entry of this socket in the sockets list of group
+    pomelo_list_entry_t * group_entry;
+
+    /// @brief The executor for receiving broadcasts from other threads
+    pomelo_threadsafe_executor_t * executor;
+
+    /// @brief The temporary sessions array for group broadcasting
+    pomelo_array_t * broadcast_sessions;
+
+    /// @brief The reference of socket. The pending broadcasting tasks of group
+    /// hold it, so that the socket is released after they have run.
+    pomelo_reference_t ref;
 };
 
 
@@ -90,6 +90,10 @@ void pomelo_pipeline_execute(pomelo_pipeline_t * pipeline) {
     pomelo_sequencer_t * sequencer = pipeline->sequencer;
 
     while (true) {
+        // The last task might release the owner of pipeline to a pool shared
+        // with other threads, so that the pipeline is not touched after it.
+        bool last = (pipeline->task_index == (pipeline->task_count - 1));
+
         // Run the task
         if (sequencer) {
             // Submit the task to the sequencer
@@ -98,6 +102,7 @@ void pomelo_pipeline_execute(pomelo_pipeline_t * pipeline) {
             // Execute the task directly
             pomelo_pipeline_execute_current_task(pipeline);
         }
+        if (last) return; // Finished
 
         // Check the finish flag
         if (pipeline->flags & POMELO_PIPELINE_FLAG_FINISH) {
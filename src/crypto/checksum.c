@@ -1,23 +1,379 @@
 #include <assert.h>
+#include <string.h>
 #include "checksum.h"
 #include "sodium/crypto_generichash_blake2b.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define POMELO_CRYPTO_CRC32C_SSE42
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define POMELO_CRYPTO_CRC32C_ARMV8
+#endif
 
-int pomelo_crypto_checksum_init(pomelo_crypto_checksum_state_t * state) {
+#define POMELO_CRYPTO_CRC32C_BYTES 4
+#define POMELO_CRYPTO_XXH64_BYTES 8
+
+#define XXH64_PRIME_1 0x9E3779B185EBCA87ULL
+#define XXH64_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define XXH64_PRIME_3 0x165667B19E3779F9ULL
+#define XXH64_PRIME_4 0x85EBCA77C2B2AE63ULL
+#define XXH64_PRIME_5 0x27D4EB2F165667C5ULL
+
+#define xxh64_rotl(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+
+/* -------------------------------------------------------------------------- */
+/*                                  CRC32C                                    */
+/* -------------------------------------------------------------------------- */
+
+#ifndef POMELO_CRYPTO_CRC32C_ARMV8
+
+/// @brief The CRC32C (Castagnoli, reflected 0x82F63B78) table
+static const uint32_t crc32c_table[256] = {
+    0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C,
+    0x26A1E7E8, 0xD4CA64EB, 0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B,
+    0x4D43CFD0, 0xBF284CD3, 0xAC78BF27, 0x5E133C24, 0x105EC76F, 0xE235446C,
+    0xF165B798, 0x030E349B, 0xD7C45070, 0x25AFD373, 0x36FF2087, 0xC494A384,
+    0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54, 0x5D1D08BF, 0xAF768BBC,
+    0xBC267848, 0x4E4DFB4B, 0x20BD8EDE, 0xD2D60DDD, 0xC186FE29, 0x33ED7D2A,
+    0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35, 0xAA64D611, 0x580F5512,
+    0x4B5FA6E6, 0xB93425E5, 0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA,
+    0x30E349B1, 0xC288CAB2, 0xD1D83946, 0x23B3BA45, 0xF779DEAE, 0x05125DAD,
+    0x1642AE59, 0xE4292D5A, 0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A,
+    0x7DA08661, 0x8FCB0562, 0x9C9BF696, 0x6EF07595, 0x417B1DBC, 0xB3109EBF,
+    0xA0406D4B, 0x522BEE48, 0x86E18AA3, 0x748A09A0, 0x67DAFA54, 0x95B17957,
+    0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687, 0x0C38D26C, 0xFE53516F,
+    0xED03A29B, 0x1F682198, 0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927,
+    0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38, 0xDBFC821C, 0x2997011F,
+    0x3AC7F2EB, 0xC8AC71E8, 0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7,
+    0x61C69362, 0x93AD1061, 0x80FDE395, 0x72966096, 0xA65C047D, 0x5437877E,
+    0x4767748A, 0xB50CF789, 0xEB1FCBAD, 0x197448AE, 0x0A24BB5A, 0xF84F3859,
+    0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46, 0x7198540D, 0x83F3D70E,
+    0x90A324FA, 0x62C8A7F9, 0xB602C312, 0x44694011, 0x5739B3E5, 0xA55230E6,
+    0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36, 0x3CDB9BDD, 0xCEB018DE,
+    0xDDE0EB2A, 0x2F8B6829, 0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C,
+    0x456CAC67, 0xB7072F64, 0xA457DC90, 0x563C5F93, 0x082F63B7, 0xFA44E0B4,
+    0xE9141340, 0x1B7F9043, 0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C,
+    0x92A8FC17, 0x60C37F14, 0x73938CE0, 0x81F80FE3, 0x55326B08, 0xA759E80B,
+    0xB4091BFF, 0x466298FC, 0x1871A4D8, 0xEA1A27DB, 0xF94AD42F, 0x0B21572C,
+    0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033, 0xA24BB5A6, 0x502036A5,
+    0x4370C551, 0xB11B4652, 0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+    0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D, 0xEF087A76, 0x1D63F975,
+    0x0E330A81, 0xFC588982, 0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D,
+    0x758FE5D6, 0x87E466D5, 0x94B49521, 0x66DF1622, 0x38CC2A06, 0xCAA7A905,
+    0xD9F75AF1, 0x2B9CD9F2, 0xFF56BD19, 0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED,
+    0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530, 0x0417B1DB, 0xF67C32D8,
+    0xE52CC12C, 0x1747422F, 0x49547E0B, 0xBB3FFD08, 0xA86F0EFC, 0x5A048DFF,
+    0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0, 0xD3D3E1AB, 0x21B862A8,
+    0x32E8915C, 0xC083125F, 0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540,
+    0x590AB964, 0xAB613A67, 0xB831C993, 0x4A5A4A90, 0x9E902E7B, 0x6CFBAD78,
+    0x7FAB5E8C, 0x8DC0DD8F, 0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE,
+    0x24AA3F05, 0xD6C1BC06, 0xC5914FF2, 0x37FACCF1, 0x69E9F0D5, 0x9B8273D6,
+    0x88D28022, 0x7AB90321, 0xAE7367CA, 0x5C18E4C9, 0x4F48173D, 0xBD23943E,
+    0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A, 0xC69F7B69,
+    0xD5CF889D, 0x27A40B9E, 0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E,
+    0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351
+};
+
+
+/// @brief Update the CRC32C with the lookup table
+static uint32_t crc32c_update_software(
+    uint32_t crc,
+    const uint8_t * buffer,
+    size_t length
+) {
+    for (size_t i = 0; i < length; i++) {
+        crc = crc32c_table[(crc ^ buffer[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#endif // !POMELO_CRYPTO_CRC32C_ARMV8
+
+
+#ifdef POMELO_CRYPTO_CRC32C_SSE42
+
+/// @brief Update the CRC32C with SSE4.2 instructions
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_update_sse42(
+    uint32_t crc,
+    const uint8_t * buffer,
+    size_t length
+) {
+    uint64_t crc64 = crc;
+    for (; length >= 8; buffer += 8, length -= 8) {
+        uint64_t value;
+        memcpy(&value, buffer, sizeof(value));
+        crc64 = _mm_crc32_u64(crc64, value);
+    }
+
+    crc = (uint32_t) crc64;
+    for (; length > 0; buffer++, length--) {
+        crc = _mm_crc32_u8(crc, *buffer);
+    }
+    return crc;
+}
+
+#endif // POMELO_CRYPTO_CRC32C_SSE42
+
+
+#ifdef POMELO_CRYPTO_CRC32C_ARMV8
+
+/// @brief Update the CRC32C with ARMv8 CRC instructions
+static uint32_t crc32c_update_armv8(
+    uint32_t crc,
+    const uint8_t * buffer,
+    size_t length
+) {
+    for (; length >= 8; buffer += 8, length -= 8) {
+        uint64_t value;
+        memcpy(&value, buffer, sizeof(value));
+        crc = __crc32cd(crc, value);
+    }
+
+    for (; length > 0; buffer++, length--) {
+        crc = __crc32cb(crc, *buffer);
+    }
+    return crc;
+}
+
+#endif // POMELO_CRYPTO_CRC32C_ARMV8
+
+
+bool pomelo_crypto_crc32c_hardware(void) {
+#if defined(POMELO_CRYPTO_CRC32C_SSE42)
+    return __builtin_cpu_supports("sse4.2");
+#elif defined(POMELO_CRYPTO_CRC32C_ARMV8)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/// @brief Update the CRC32C with the fastest available implementation
+static uint32_t crc32c_update(
+    uint32_t crc,
+    const uint8_t * buffer,
+    size_t length
+) {
+#if defined(POMELO_CRYPTO_CRC32C_SSE42)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return crc32c_update_sse42(crc, buffer, length);
+    }
+    return crc32c_update_software(crc, buffer, length);
+#elif defined(POMELO_CRYPTO_CRC32C_ARMV8)
+    return crc32c_update_armv8(crc, buffer, length);
+#else
+    return crc32c_update_software(crc, buffer, length);
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                                 xxHash64                                   */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Read a little-endian 64-bit value
+static inline uint64_t xxh64_read64(const uint8_t * p) {
+    return (uint64_t) p[0] | ((uint64_t) p[1] << 8) |
+        ((uint64_t) p[2] << 16) | ((uint64_t) p[3] << 24) |
+        ((uint64_t) p[4] << 32) | ((uint64_t) p[5] << 40) |
+        ((uint64_t) p[6] << 48) | ((uint64_t) p[7] << 56);
+}
+
+
+/// @brief Read a little-endian 32-bit value
+static inline uint64_t xxh64_read32(const uint8_t * p) {
+    return (uint64_t) p[0] | ((uint64_t) p[1] << 8) |
+        ((uint64_t) p[2] << 16) | ((uint64_t) p[3] << 24);
+}
+
+
+/// @brief Mix a lane into an accumulator
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * XXH64_PRIME_2;
+    acc = xxh64_rotl(acc, 31);
+    return acc * XXH64_PRIME_1;
+}
+
+
+/// @brief Merge an accumulator into the hash
+static inline uint64_t xxh64_merge_round(uint64_t hash, uint64_t acc) {
+    hash ^= xxh64_round(0, acc);
+    return hash * XXH64_PRIME_1 + XXH64_PRIME_4;
+}
+
+
+/// @brief Consume a full stripe
+static inline void xxh64_stripe(uint64_t * acc, const uint8_t * p) {
+    acc[0] = xxh64_round(acc[0], xxh64_read64(p));
+    acc[1] = xxh64_round(acc[1], xxh64_read64(p + 8));
+    acc[2] = xxh64_round(acc[2], xxh64_read64(p + 16));
+    acc[3] = xxh64_round(acc[3], xxh64_read64(p + 24));
+}
+
+
+static void xxh64_init(pomelo_crypto_xxh64_state_t * state) {
+    state->acc[0] = XXH64_PRIME_1 + XXH64_PRIME_2;
+    state->acc[1] = XXH64_PRIME_2;
+    state->acc[2] = 0;
+    state->acc[3] = 0 - XXH64_PRIME_1;
+    state->total = 0;
+    state->memory_size = 0;
+}
+
+
+static void xxh64_update(
+    pomelo_crypto_xxh64_state_t * state,
+    const uint8_t * buffer,
+    size_t length
+) {
+    state->total += length;
+
+    if (state->memory_size + length < POMELO_CRYPTO_XXH64_STRIPE_BYTES) {
+        // Not enough data for a stripe
+        memcpy(state->memory + state->memory_size, buffer, length);
+        state->memory_size += length;
+        return;
+    }
+
+    if (state->memory_size > 0) {
+        // Complete the buffered stripe
+        size_t fill = POMELO_CRYPTO_XXH64_STRIPE_BYTES - state->memory_size;
+        memcpy(state->memory + state->memory_size, buffer, fill);
+        xxh64_stripe(state->acc, state->memory);
+        buffer += fill;
+        length -= fill;
+        state->memory_size = 0;
+    }
+
+    for (
+        ;
+        length >= POMELO_CRYPTO_XXH64_STRIPE_BYTES;
+        buffer += POMELO_CRYPTO_XXH64_STRIPE_BYTES,
+        length -= POMELO_CRYPTO_XXH64_STRIPE_BYTES
+    ) {
+        xxh64_stripe(state->acc, buffer);
+    }
+
+    if (length > 0) {
+        memcpy(state->memory, buffer, length);
+        state->memory_size = length;
+    }
+}
+
+
+static uint64_t xxh64_final(pomelo_crypto_xxh64_state_t * state) {
+    uint64_t * acc = state->acc;
+    uint64_t hash;
+    if (state->total >= POMELO_CRYPTO_XXH64_STRIPE_BYTES) {
+        hash = xxh64_rotl(acc[0], 1) + xxh64_rotl(acc[1], 7) +
+            xxh64_rotl(acc[2], 12) + xxh64_rotl(acc[3], 18);
+        hash = xxh64_merge_round(hash, acc[0]);
+        hash = xxh64_merge_round(hash, acc[1]);
+        hash = xxh64_merge_round(hash, acc[2]);
+        hash = xxh64_merge_round(hash, acc[3]);
+    } else {
+        hash = XXH64_PRIME_5;
+    }
+    hash += state->total;
+
+    // Process the remaining bytes
+    const uint8_t * p = state->memory;
+    size_t remain = state->memory_size;
+    for (; remain >= 8; p += 8, remain -= 8) {
+        hash ^= xxh64_round(0, xxh64_read64(p));
+        hash = xxh64_rotl(hash, 27) * XXH64_PRIME_1 + XXH64_PRIME_4;
+    }
+
+    if (remain >= 4) {
+        hash ^= xxh64_read32(p) * XXH64_PRIME_1;
+        hash = xxh64_rotl(hash, 23) * XXH64_PRIME_2 + XXH64_PRIME_3;
+        p += 4;
+        remain -= 4;
+    }
+
+    for (; remain > 0; p++, remain--) {
+        hash ^= (*p) * XXH64_PRIME_5;
+        hash = xxh64_rotl(hash, 11) * XXH64_PRIME_1;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= XXH64_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= XXH64_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                                 Checksum                                   */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Write the checksum value in little-endian order
+static void checksum_write(uint8_t * checksum, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        checksum[i] = (uint8_t) (value >> (i * 8));
+    }
+}
+
+
+size_t pomelo_crypto_checksum_bytes(pomelo_checksum algorithm) {
+    switch (algorithm) {
+        case POMELO_CHECKSUM_BLAKE2B:
+            return POMELO_CRYPTO_CHECKSUM_BYTES;
+
+        case POMELO_CHECKSUM_CRC32C:
+            return POMELO_CRYPTO_CRC32C_BYTES;
+
+        case POMELO_CHECKSUM_XXH64:
+            return POMELO_CRYPTO_XXH64_BYTES;
+
+        default:
+            return 0;
+    }
+}
+
+
+int pomelo_crypto_checksum_init(
+    pomelo_crypto_checksum_state_t * state,
+    pomelo_checksum algorithm
+) {
     assert(state != NULL);
 
     // Check opaque size
     assert(
-        sizeof(pomelo_crypto_checksum_state_t) >=
-        sizeof(crypto_generichash_blake2b_state)
+        sizeof(state->opaque) >= sizeof(crypto_generichash_blake2b_state)
     );
 
-    return crypto_generichash_blake2b_init(
-        (crypto_generichash_blake2b_state *) state,
-        /* key = */ NULL,
-        /* key_length = */ 0,
-        POMELO_CRYPTO_CHECKSUM_BYTES
-    );
+    state->algorithm = algorithm;
+    switch (algorithm) {
+        case POMELO_CHECKSUM_BLAKE2B:
+            return crypto_generichash_blake2b_init(
+                (crypto_generichash_blake2b_state *) state->opaque,
+                /* key = */ NULL,
+                /* key_length = */ 0,
+                POMELO_CRYPTO_CHECKSUM_BYTES
+            );
+
+        case POMELO_CHECKSUM_NONE:
+            return 0;
+
+        case POMELO_CHECKSUM_CRC32C:
+            state->crc32c = 0xFFFFFFFF;
+            return 0;
+
+        case POMELO_CHECKSUM_XXH64:
+            xxh64_init(&state->xxh64);
+            return 0;
+
+        default:
+            return -1; // Invalid algorithm
+    }
 }
 
 
@@ -29,11 +385,25 @@ int pomelo_crypto_checksum_update(
     assert(state != NULL);
     assert(buffer != NULL);
 
-    return crypto_generichash_blake2b_update(
-        (crypto_generichash_blake2b_state *) state,
-        buffer,
-        length
-    );
+    switch (state->algorithm) {
+        case POMELO_CHECKSUM_BLAKE2B:
+            return crypto_generichash_blake2b_update(
+                (crypto_generichash_blake2b_state *) state->opaque,
+                buffer,
+                length
+            );
+
+        case POMELO_CHECKSUM_CRC32C:
+            state->crc32c = crc32c_update(state->crc32c, buffer, length);
+            return 0;
+
+        case POMELO_CHECKSUM_XXH64:
+            xxh64_update(&state->xxh64, buffer, length);
+            return 0;
+
+        default:
+            return 0;
+    }
 }
 
 
@@ -44,9 +414,31 @@ int pomelo_crypto_checksum_final(
     assert(state != NULL);
     assert(checksum != NULL);
 
-    return crypto_generichash_blake2b_final(
-        (crypto_generichash_blake2b_state *) state,
-        checksum,
-        POMELO_CRYPTO_CHECKSUM_BYTES
-    );
+    switch (state->algorithm) {
+        case POMELO_CHECKSUM_BLAKE2B:
+            return crypto_generichash_blake2b_final(
+                (crypto_generichash_blake2b_state *) state->opaque,
+                checksum,
+                POMELO_CRYPTO_CHECKSUM_BYTES
+            );
+
+        case POMELO_CHECKSUM_CRC32C:
+            checksum_write(
+                checksum,
+                state->crc32c ^ 0xFFFFFFFF,
+                POMELO_CRYPTO_CRC32C_BYTES
+            );
+            return 0;
+
+        case POMELO_CHECKSUM_XXH64:
+            checksum_write(
+                checksum,
+                xxh64_final(&state->xxh64),
+                POMELO_CRYPTO_XXH64_BYTES
+            );
+            return 0;
+
+        default:
+            return 0;
+    }
 }
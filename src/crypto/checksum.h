@@ -2,22 +2,67 @@
 #define POMELO_CRYPTO_CHECKSUM_SRC_H
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include "pomelo/common.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/// @brief The maximum number of checksum bytes of all algorithms
 #define POMELO_CRYPTO_CHECKSUM_BYTES 32
 #define POMELO_CRYPTO_CHECKSUM_STATE_OPAQUE 384
 
+/// @brief The number of bytes of a xxHash64 stripe
+#define POMELO_CRYPTO_XXH64_STRIPE_BYTES 32
+
+
+/// @brief Check if the checksum algorithm is cheap enough to be computed in
+/// the loop thread
+#define pomelo_crypto_checksum_inline(algorithm)                               \
+    ((algorithm) != POMELO_CHECKSUM_BLAKE2B)
+
+
+/// The xxHash64 state
+typedef struct pomelo_crypto_xxh64_state_s {
+    /// @brief The accumulators
+    uint64_t acc[4];
+
+    /// @brief The total number of bytes
+    uint64_t total;
+
+    /// @brief The buffered bytes of the incomplete stripe
+    uint8_t memory[POMELO_CRYPTO_XXH64_STRIPE_BYTES];
+
+    /// @brief The number of buffered bytes
+    size_t memory_size;
+} pomelo_crypto_xxh64_state_t;
+
 
 /// The codec checksum state
 typedef struct pomelo_crypto_checksum_state_s {
+    /// @brief The BLAKE2b state
     uint8_t opaque[POMELO_CRYPTO_CHECKSUM_STATE_OPAQUE];
+
+    /// @brief The algorithm
+    pomelo_checksum algorithm;
+
+    /// @brief The CRC32C state
+    uint32_t crc32c;
+
+    /// @brief The xxHash64 state
+    pomelo_crypto_xxh64_state_t xxh64;
 } pomelo_crypto_checksum_state_t;
 
 
+/// @brief Get the number of checksum bytes of the algorithm
+size_t pomelo_crypto_checksum_bytes(pomelo_checksum algorithm);
+
+
 /// @brief Initailize the checksum
-int pomelo_crypto_checksum_init(pomelo_crypto_checksum_state_t * state);
+int pomelo_crypto_checksum_init(
+    pomelo_crypto_checksum_state_t * state,
+    pomelo_checksum algorithm
+);
 
 
 /// @brief Update the checksum.
@@ -29,13 +74,18 @@ int pomelo_crypto_checksum_update(
 );
 
 
-/// @brief Finalize the checksum
+/// @brief Finalize the checksum.
+/// The output must have at least pomelo_crypto_checksum_bytes(algorithm) bytes
 int pomelo_crypto_checksum_final(
     pomelo_crypto_checksum_state_t * state,
     uint8_t * output
 );
 
 
+/// @brief Check if CRC32C is computed by hardware instructions
+bool pomelo_crypto_crc32c_hardware(void);
+
+
 #ifdef __cplusplus
 }
 #endif
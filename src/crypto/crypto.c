@@ -1,11 +1,13 @@
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 #include "crypto.h"
 #include "base/payload.h"
 #include "sodium/core.h"
 #include "sodium/utils.h"
 #include "sodium/randombytes.h"
 #include "sodium/crypto_aead_chacha20poly1305.h"
+#include "sodium/crypto_shorthash_siphash24.h"
 
 
 /// @brief Initialized flag
@@ -119,3 +121,20 @@ int pomelo_crypto_decrypt_aead(
 
     return 0;
 }
+
+
+uint64_t pomelo_crypto_shorthash(
+    const uint8_t * input,
+    size_t input_length,
+    const uint8_t * key
+) {
+    assert(input != NULL);
+    assert(key != NULL);
+
+    uint8_t output[crypto_shorthash_siphash24_BYTES];
+    crypto_shorthash_siphash24(output, input, input_length, key);
+
+    uint64_t hash;
+    memcpy(&hash, output, sizeof(hash));
+    return hash;
+}
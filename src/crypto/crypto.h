@@ -13,6 +13,9 @@ extern "C" {
 /// @brief The length of HMAC
 #define POMELO_CRYPTO_AEAD_HMAC_BYTES   16
 
+/// @brief The length of the short hash key
+#define POMELO_CRYPTO_SHORTHASH_KEY_BYTES 16
+
 
 /// @brief Initialize crypto system
 int pomelo_crypto_init(void);
@@ -52,6 +55,15 @@ int pomelo_crypto_decrypt_aead(
 );
 
 
+/// @brief Hash a short input with a secret key (SipHash-2-4). The hash of
+/// attacker-controlled inputs cannot be predicted without the key.
+uint64_t pomelo_crypto_shorthash(
+    const uint8_t * input,
+    size_t input_length,
+    const uint8_t * key
+);
+
+
 #ifdef __cplusplus
 }
 #endif
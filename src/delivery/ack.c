@@ -0,0 +1,179 @@
+#include <assert.h>
+#include <string.h>
+#include "ack.h"
+#include "fragment.h"
+
+
+size_t pomelo_delivery_ack_block_build(
+    pomelo_delivery_ack_block_t * block,
+    pomelo_array_t * fragments,
+    size_t start
+) {
+    assert(block != NULL);
+    assert(fragments != NULL);
+
+    size_t nfragments = fragments->size;
+    pomelo_delivery_fragment_t * fragment = NULL;
+
+    // Find the first received fragment
+    size_t first = start;
+    for (; first < nfragments; first++) {
+        fragment = pomelo_array_get_ptr(fragments, first);
+        if (fragment->content.buffer) break;
+    }
+    if (first >= nfragments) return start; // No more received fragments
+
+    // Count the continuously received fragments
+    size_t end = first + 1;
+    for (; end < nfragments; end++) {
+        fragment = pomelo_array_get_ptr(fragments, end);
+        if (!fragment->content.buffer) break;
+    }
+
+    block->first = first;
+    block->run = end - first;
+    block->mask = 0;
+
+    // Fragment at end is missing, build the mask of the next fragments
+    size_t next = end + 1;
+    for (size_t i = 0; i < POMELO_DELIVERY_ACK_MASK_BITS; i++) {
+        size_t index = end + 1 + i;
+        if (index >= nfragments) break;
+
+        fragment = pomelo_array_get_ptr(fragments, index);
+        if (fragment->content.buffer) {
+            block->mask |= (1U << i);
+            next = index + 1;
+        }
+    }
+
+    return (next < nfragments) ? next : nfragments;
+}
+
+
+/// @brief Get the number of bytes of the mask
+static size_t ack_mask_bytes(uint32_t mask) {
+    if (mask == 0) return 0;
+    if (mask <= 0xFF) return 1;
+    if (mask <= 0xFFFF) return 2;
+    if (mask <= 0xFFFFFF) return 3;
+    return 4;
+}
+
+
+size_t pomelo_delivery_ack_block_encode(
+    pomelo_delivery_ack_block_t * block,
+    uint8_t * buffer
+) {
+    assert(block != NULL);
+    assert(buffer != NULL);
+
+    size_t bus_id_bytes = pomelo_payload_calc_packed_uint64_bytes(
+        block->bus_id
+    );
+    size_t sequence_bytes = pomelo_payload_calc_packed_uint64_bytes(
+        block->sequence
+    );
+    size_t index_bytes = pomelo_payload_calc_packed_uint64_bytes(
+        block->first | block->run
+    );
+    size_t mask_bytes = ack_mask_bytes(block->mask);
+    assert(bus_id_bytes <= 2);
+    assert(index_bytes <= 2);
+
+    pomelo_payload_t payload = {
+        .data = buffer,
+        .capacity = POMELO_DELIVERY_ACK_BLOCK_MAX_BYTES,
+        .position = 0
+    };
+
+    uint8_t block_byte = (uint8_t) (
+        ((bus_id_bytes - 1) << 7) |
+        ((sequence_bytes - 1) << 4) |
+        ((index_bytes - 1) << 3) |
+        mask_bytes
+    );
+    pomelo_payload_write_uint8_unsafe(&payload, block_byte);
+    pomelo_payload_write_packed_uint64_unsafe(
+        &payload,
+        bus_id_bytes,
+        block->bus_id
+    );
+    pomelo_payload_write_packed_uint64_unsafe(
+        &payload,
+        sequence_bytes,
+        block->sequence
+    );
+    pomelo_payload_write_packed_uint64_unsafe(
+        &payload,
+        index_bytes,
+        block->first
+    );
+    pomelo_payload_write_packed_uint64_unsafe(
+        &payload,
+        index_bytes,
+        block->run
+    );
+    if (mask_bytes > 0) {
+        pomelo_payload_write_packed_uint64_unsafe(
+            &payload,
+            mask_bytes,
+            block->mask
+        );
+    }
+
+    return payload.position;
+}
+
+
+int pomelo_delivery_ack_block_decode(
+    pomelo_delivery_ack_block_t * block,
+    pomelo_delivery_reader_t * reader
+) {
+    assert(block != NULL);
+    assert(reader != NULL);
+
+    uint8_t block_byte = 0;
+    int ret = pomelo_delivery_reader_read(reader, &block_byte, 1);
+    if (ret < 0) return -1; // Failed to read the block byte
+
+    size_t bus_id_bytes = ((block_byte >> 7) & 0x01) + 1;
+    size_t sequence_bytes = ((block_byte >> 4) & 0x07) + 1;
+    size_t index_bytes = ((block_byte >> 3) & 0x01) + 1;
+    size_t mask_bytes = block_byte & 0x07;
+    if (mask_bytes > 4) return -1; // Invalid mask
+
+    size_t length =
+        bus_id_bytes + sequence_bytes + index_bytes * 2 + mask_bytes;
+
+    uint8_t buffer[POMELO_DELIVERY_ACK_BLOCK_MAX_BYTES];
+    ret = pomelo_delivery_reader_read(reader, buffer, length);
+    if (ret < 0) return -1; // Not enough data
+
+    pomelo_payload_t payload = {
+        .data = buffer,
+        .capacity = length,
+        .position = 0
+    };
+
+    uint64_t value = 0;
+    pomelo_payload_read_packed_uint64_unsafe(&payload, bus_id_bytes, &value);
+    block->bus_id = (size_t) value;
+
+    pomelo_payload_read_packed_uint64_unsafe(&payload, sequence_bytes, &value);
+    block->sequence = value;
+
+    pomelo_payload_read_packed_uint64_unsafe(&payload, index_bytes, &value);
+    block->first = (size_t) value;
+
+    pomelo_payload_read_packed_uint64_unsafe(&payload, index_bytes, &value);
+    block->run = (size_t) value;
+
+    block->mask = 0;
+    if (mask_bytes > 0) {
+        pomelo_payload_read_packed_uint64_unsafe(&payload, mask_bytes, &value);
+        block->mask = (uint32_t) value;
+    }
+
+    return 0;
+}
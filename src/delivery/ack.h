@@ -0,0 +1,127 @@
+#ifndef POMELO_DELIVERY_ACK_SRC_H
+#define POMELO_DELIVERY_ACK_SRC_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "utils/array.h"
+#include "delivery.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+    Aggregated ACK
+    --------------
+    When the ACK delay of context is not zero, the fragments of reliable parcels
+    are not acked one by one. The endpoint collects the received parcels for a
+    few milliseconds, then acks all of them in one system parcel:
+
+    meta_byte: opcode (3 bits) | <padding> (5 bits)
+    blocks   : one or more ACK blocks
+
+    ACK block layout:
+    ----------------------------------------------------------------------------
+    Offset | Field Name          | Size          | Value Range
+    -------|---------------------|---------------|------------------------------
+    0      | block_byte          | 1 byte        | [0-255]
+    1      | bus_id              | 1-2 bytes     | [0-65535]
+    +1     | sequence            | 1-8 bytes     | [0-2^64-1]
+    +1     | first               | 1-2 bytes     | [0-65535]
+    +1     | run                 | 1-2 bytes     | [1-65535]
+    +1     | mask                | 0-4 bytes     | [0-2^32-1]
+
+    Block Byte Bit Layout (8 bits)
+    ----------------------------------------------------------------------------
+    Bits  | Field Name           | Description
+    ------|----------------------|----------------------------------------------
+    7     | bus_id_bytes         | Size of bus_id (0=1 byte, 1=2 bytes)
+    6-4   | sequence_bytes       | Size of sequence (value+1 = actual bytes)
+    3     | index_bytes          | Size of first & run (0=1 byte, 1=2 bytes)
+    2-0   | mask_bytes           | Size of mask (0-4 bytes)
+
+    The fragments [first, first + run) are acked cumulatively. Fragment
+    (first + run) is missing, and bit i of the mask acks the fragment
+    (first + run + 1 + i) selectively. A parcel which has been completely
+    received is acked by a single block with first = 0 & run = total fragments.
+*/
+
+
+/// @brief The maximum number of bytes of an ACK block
+#define POMELO_DELIVERY_ACK_BLOCK_MAX_BYTES 19
+
+/// @brief The number of fragments which are selectively acked by a block
+#define POMELO_DELIVERY_ACK_MASK_BITS 32
+
+
+/// @brief The pending ACK of a reliable parcel
+typedef struct pomelo_delivery_ack_s pomelo_delivery_ack_t;
+
+/// @brief The ACK block
+typedef struct pomelo_delivery_ack_block_s pomelo_delivery_ack_block_t;
+
+
+struct pomelo_delivery_ack_s {
+    /// @brief The bus ID of parcel
+    size_t bus_id;
+
+    /// @brief The sequence of parcel
+    uint64_t sequence;
+
+    /// @brief The last fragment index of parcel
+    size_t last_index;
+};
+
+
+struct pomelo_delivery_ack_block_s {
+    /// @brief The bus ID of parcel
+    size_t bus_id;
+
+    /// @brief The sequence of parcel
+    uint64_t sequence;
+
+    /// @brief The first acked fragment index
+    size_t first;
+
+    /// @brief The number of continuously acked fragments from the first one
+    size_t run;
+
+    /// @brief The selectively acked fragments after the missing one
+    uint32_t mask;
+};
+
+
+/// @brief Build the next ACK block from the received fragments of a parcel
+/// @param block The block with bus ID & sequence set
+/// @param fragments The fragments of receiving parcel
+/// @param start The index to start scanning
+/// @return The index to continue scanning, or start if there is no received
+/// fragment from start. The block is only valid if the returned value is
+/// greater than start.
+size_t pomelo_delivery_ack_block_build(
+    pomelo_delivery_ack_block_t * block,
+    pomelo_array_t * fragments,
+    size_t start
+);
+
+
+/// @brief Encode the ACK block
+/// @return The number of written bytes, at most
+/// POMELO_DELIVERY_ACK_BLOCK_MAX_BYTES
+size_t pomelo_delivery_ack_block_encode(
+    pomelo_delivery_ack_block_t * block,
+    uint8_t * buffer
+);
+
+
+/// @brief Decode the ACK block
+/// @return 0 on success, or -1 on failure
+int pomelo_delivery_ack_block_decode(
+    pomelo_delivery_ack_block_t * block,
+    pomelo_delivery_reader_t * reader
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_DELIVERY_ACK_SRC_H
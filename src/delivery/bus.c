@@ -56,6 +56,62 @@ static int receiver_expiration_compare(void * a, void * b) {
 }
 
 
+/// @brief The bytes allocated up front by a list which owns its context
+#define BUS_LIST_BYTES                                                         \
+    (sizeof(pomelo_list_t) + sizeof(pomelo_list_context_t) +                  \
+        sizeof(pomelo_pool_root_t))
+
+/// @brief The bytes allocated up front by a map
+#define BUS_MAP_BYTES                                                          \
+    (sizeof(pomelo_map_t) + sizeof(pomelo_array_t) +                          \
+        POMELO_MAP_DEFAULT_INITIAL_BUCKETS * sizeof(pomelo_map_bucket_t *) +  \
+        2 * sizeof(pomelo_pool_root_t))
+
+/// @brief The bytes allocated up front by a heap
+#define BUS_HEAP_BYTES                                                         \
+    (sizeof(pomelo_heap_t) + 2 * sizeof(pomelo_pool_root_t))
+
+/// @brief The bytes allocated up front by an array
+#define BUS_ARRAY_BYTES(capacity, element_size)                                \
+    (sizeof(pomelo_array_t) + (capacity) * (element_size))
+
+
+/// @brief Account the bytes of a newly created structure of bus
+static void bus_add_state_bytes(pomelo_delivery_bus_t * bus, size_t bytes) {
+    bus->state_bytes += bytes;
+    pomelo_atomic_uint64_fetch_add(
+        &bus->context->root->bus_state_bytes,
+        bytes
+    );
+}
+
+
+/// @brief Create a window array of the bus
+static pomelo_array_t * bus_create_window(
+    pomelo_delivery_bus_t * bus,
+    size_t element_size
+) {
+    pomelo_array_options_t options = {
+        .allocator = bus->context->allocator,
+        .element_size = element_size,
+        .initial_capacity = bus->reliable_window
+    };
+    pomelo_array_t * array = pomelo_array_create(&options);
+    if (!array) return NULL; // Failed to create array
+
+    if (pomelo_array_resize(array, bus->reliable_window) < 0) {
+        pomelo_array_destroy(array);
+        return NULL; // Failed to resize array
+    }
+
+    bus_add_state_bytes(
+        bus,
+        BUS_ARRAY_BYTES(bus->reliable_window, element_size)
+    );
+    return array;
+}
+
+
 int pomelo_delivery_bus_on_alloc(
     pomelo_delivery_bus_t * bus,
     pomelo_delivery_context_t * context
@@ -63,35 +119,10 @@ int pomelo_delivery_bus_on_alloc(
     assert(bus != NULL);
     assert(context != NULL);
 
-    pomelo_allocator_t * allocator = context->allocator;
+    // The lists, maps and windows of bus are created on demand. Most of the
+    // buses never receive or send any parcels of some delivery modes.
     bus->context = context;
-
-    // Create pending send parcels list
-    pomelo_list_options_t list_options = {
-        .allocator = allocator,
-        .element_size = sizeof(pomelo_delivery_dispatcher_t *)
-    };
-    bus->pending_dispatchers = pomelo_list_create(&list_options);
-    if (!bus->pending_dispatchers) return -1;
-
-    // Create incomplete receiving parcels map
-    pomelo_map_options_t map_options = {
-        .allocator = allocator,
-        .key_size = sizeof(uint64_t),
-        .value_size = sizeof(pomelo_delivery_receiver_t *)
-    };
-    bus->receivers_map = pomelo_map_create(&map_options);
-    if (!bus->receivers_map) return -1;
-
-    // Create the heap for receiving commands
-    pomelo_heap_options_t heap_options = {
-        .allocator = allocator,
-        .compare = receiver_expiration_compare,
-        .element_size = sizeof(pomelo_delivery_receiver_t *)
-    };
-    bus->receivers_heap = pomelo_heap_create(&heap_options);
-    if (!bus->receivers_heap) return -1;
-
+    bus->reliable_window = context->reliable_window;
     return 0;
 }
 
@@ -114,6 +145,121 @@ void pomelo_delivery_bus_on_free(pomelo_delivery_bus_t * bus) {
         pomelo_heap_destroy(bus->receivers_heap);
         bus->receivers_heap = NULL;
     }
+
+    if (bus->reliable_dispatchers) {
+        pomelo_array_destroy(bus->reliable_dispatchers);
+        bus->reliable_dispatchers = NULL;
+    }
+
+    if (bus->reliable_slots) {
+        pomelo_array_destroy(bus->reliable_slots);
+        bus->reliable_slots = NULL;
+    }
+
+    if (bus->pacer_queue) {
+        pomelo_list_destroy(bus->pacer_queue);
+        bus->pacer_queue = NULL;
+    }
+
+    if (bus->state_bytes > 0) {
+        pomelo_atomic_uint64_fetch_sub(
+            &bus->context->root->bus_state_bytes,
+            bus->state_bytes
+        );
+        bus->state_bytes = 0;
+    }
+}
+
+
+int pomelo_delivery_bus_ensure_pending_dispatchers(
+    pomelo_delivery_bus_t * bus
+) {
+    assert(bus != NULL);
+    if (bus->pending_dispatchers) return 0; // Already created
+
+    pomelo_list_options_t options = {
+        .allocator = bus->context->allocator,
+        .element_size = sizeof(pomelo_delivery_dispatcher_t *)
+    };
+    bus->pending_dispatchers = pomelo_list_create(&options);
+    if (!bus->pending_dispatchers) return -1; // Failed to create list
+
+    bus_add_state_bytes(bus, BUS_LIST_BYTES);
+    return 0;
+}
+
+
+int pomelo_delivery_bus_ensure_receivers(pomelo_delivery_bus_t * bus) {
+    assert(bus != NULL);
+    pomelo_allocator_t * allocator = bus->context->allocator;
+
+    // Create incomplete receiving parcels map
+    if (!bus->receivers_map) {
+        pomelo_map_options_t map_options = {
+            .allocator = allocator,
+            .key_size = sizeof(uint64_t),
+            .value_size = sizeof(pomelo_delivery_receiver_t *)
+        };
+        bus->receivers_map = pomelo_map_create(&map_options);
+        if (!bus->receivers_map) return -1; // Failed to create map
+        bus_add_state_bytes(bus, BUS_MAP_BYTES);
+    }
+
+    // Create the heap for receiving commands
+    if (!bus->receivers_heap) {
+        pomelo_heap_options_t heap_options = {
+            .allocator = allocator,
+            .compare = receiver_expiration_compare,
+            .element_size = sizeof(pomelo_delivery_receiver_t *)
+        };
+        bus->receivers_heap = pomelo_heap_create(&heap_options);
+        if (!bus->receivers_heap) return -1; // Failed to create heap
+        bus_add_state_bytes(bus, BUS_HEAP_BYTES);
+    }
+
+    return 0;
+}
+
+
+int pomelo_delivery_bus_ensure_reliable_dispatchers(
+    pomelo_delivery_bus_t * bus
+) {
+    assert(bus != NULL);
+    if (bus->reliable_dispatchers) return 0; // Already created
+
+    bus->reliable_dispatchers =
+        bus_create_window(bus, sizeof(pomelo_delivery_dispatcher_t *));
+    if (!bus->reliable_dispatchers) return -1; // Failed to create window
+
+    return 0;
+}
+
+
+int pomelo_delivery_bus_ensure_reliable_slots(pomelo_delivery_bus_t * bus) {
+    assert(bus != NULL);
+    if (bus->reliable_slots) return 0; // Already created
+
+    bus->reliable_slots =
+        bus_create_window(bus, sizeof(pomelo_delivery_reliable_slot_t));
+    if (!bus->reliable_slots) return -1; // Failed to create window
+
+    return 0;
+}
+
+
+int pomelo_delivery_bus_ensure_pacer_queue(pomelo_delivery_bus_t * bus) {
+    assert(bus != NULL);
+    if (bus->pacer_queue) return 0; // Already created
+
+    pomelo_list_options_t options = {
+        .allocator = bus->context->allocator,
+        .element_size = sizeof(pomelo_buffer_view_t)
+    };
+    bus->pacer_queue = pomelo_list_create(&options);
+    if (!bus->pacer_queue) return -1; // Failed to create list
+
+    bus_add_state_bytes(bus, BUS_LIST_BYTES);
+    return 0;
 }
 
 
@@ -127,6 +273,14 @@ int pomelo_delivery_bus_init(
     bus->endpoint = info->endpoint;
     bus->id = info->id;
     bus->platform = info->endpoint->platform;
+    bus->pacer_entry = NULL;
+    bus->priority = info->priority;
+    bus->weight = (info->weight > 0) ? info->weight : 1;
+    bus->deficit = 0;
+    bus->reliable_send_base = 1;
+    bus->reliable_send_next = 1;
+    bus->reliable_acked_sent_time = 0;
+    bus->reliable_recv_base = 1;
 
     // Initialize the send task
     pomelo_sequencer_task_init(
@@ -162,36 +316,67 @@ void pomelo_delivery_bus_stop(pomelo_delivery_bus_t * bus) {
     // Cleanup dispatchers
     pomelo_delivery_dispatcher_t * dispatcher = NULL;
     pomelo_list_t * dispatchers = bus->pending_dispatchers;
-    while (pomelo_list_pop_front(dispatchers, &dispatcher) == 0) {
+    while (
+        dispatchers && pomelo_list_pop_front(dispatchers, &dispatcher) == 0
+    ) {
         pomelo_delivery_dispatcher_cancel(dispatcher);
     }
 
     // Cleanup receivers
-    pomelo_map_iterator_t it;
-    pomelo_map_entry_t * entry;
-    pomelo_map_iterator_init(&it, bus->receivers_map);
     pomelo_delivery_receiver_t * receiver = NULL;
-    while (pomelo_map_iterator_next(&it, &entry) == 0) { // OK
-        receiver = pomelo_map_entry_value_ptr(entry);
-        receiver->sequence_entry = NULL;
-        pomelo_delivery_receiver_cancel(receiver);
+    if (bus->receivers_map) {
+        pomelo_map_iterator_t it;
+        pomelo_map_entry_t * entry;
+        pomelo_map_iterator_init(&it, bus->receivers_map);
+        while (pomelo_map_iterator_next(&it, &entry) == 0) { // OK
+            receiver = pomelo_map_entry_value_ptr(entry);
+            receiver->sequence_entry = NULL;
+            pomelo_delivery_receiver_cancel(receiver);
+        }
+        pomelo_map_clear(bus->receivers_map);
+    }
+
+    // Cleanup the reliable sending window
+    size_t window = bus->reliable_dispatchers ? bus->reliable_window : 0;
+    for (size_t i = 0; i < window; i++) {
+        pomelo_delivery_dispatcher_t ** p_dispatcher =
+            pomelo_array_get_ptr(bus->reliable_dispatchers, i);
+        assert(p_dispatcher != NULL);
+
+        dispatcher = *p_dispatcher;
+        if (!dispatcher) continue;
+        *p_dispatcher = NULL;
+        pomelo_delivery_dispatcher_cancel(dispatcher);
     }
-    pomelo_map_clear(bus->receivers_map);
 
-    // Cleanup current reliable receiver
-    bus->incomplete_reliable_receiver = NULL;
+    // Cleanup the reliable receiving window
+    window = bus->reliable_slots ? bus->reliable_window : 0;
+    for (size_t i = 0; i < window; i++) {
+        pomelo_delivery_reliable_slot_t * slot =
+            pomelo_array_get_ptr(bus->reliable_slots, i);
+        assert(slot != NULL);
 
-    // Cleanup current reliable dispatcher
-    if (bus->incomplete_reliable_dispatcher) {
-        pomelo_delivery_dispatcher_cancel(bus->incomplete_reliable_dispatcher);
-        bus->incomplete_reliable_dispatcher = NULL;
+        receiver = slot->receiver;
+        if (slot->parcel) {
+            pomelo_delivery_parcel_unref(slot->parcel);
+        }
+        memset(slot, 0, sizeof(pomelo_delivery_reliable_slot_t));
+        if (receiver) {
+            pomelo_delivery_receiver_cancel(receiver);
+        }
     }
 
     // Cleanup receivers heap
-    pomelo_heap_clear(bus->receivers_heap);
+    if (bus->receivers_heap) {
+        pomelo_heap_clear(bus->receivers_heap);
+    }
 
     // Cleanup other values
-    bus->last_recv_reliable_sequence = 0;
+    bus->reliable_send_base = 1;
+    bus->reliable_send_next = 1;
+    bus->reliable_acked_sent_time = 0;
+    bus->reliable_recv_base = 1;
+    bus->reliable_sequence_generator = 0;
     bus->sequence_generator = 0;
     bus->last_recv_sequenced_sequence = 0;
     bus->flags = 0;
@@ -230,19 +415,31 @@ int pomelo_delivery_bus_recv_fragment_data(
     assert(meta != NULL);
 
     // Validate meta
-    if (meta->type == POMELO_FRAGMENT_TYPE_DATA_RELIABLE) {
-        if (bus->incomplete_reliable_receiver) {
-            // There's a incomplete reliable receiver
-            if (meta->sequence != bus->last_recv_reliable_sequence) {
-                return -1; // Mismatch reliable parcel sequence
-            }
-        } else {
-            // There's no incomplete reliable receiver
-            if (meta->sequence == bus->last_recv_reliable_sequence) {
-                // This fragment is a part of the most recent reliable parcel
-                pomelo_delivery_bus_reply_ack(bus, meta);
-                return 0;
-            }
+    bool repair = meta->fragment_index > meta->last_index;
+    if (pomelo_delivery_fragment_type_is_reliable(meta->type)) {
+        if (repair) return -1; // Reliable parcels are never repaired
+
+        uint64_t base = bus->reliable_recv_base;
+        if (meta->sequence < base) {
+            // This fragment is a part of a delivered parcel, its ack was lost
+            pomelo_delivery_bus_reply_ack(bus, meta);
+            return 0;
+        }
+
+        if (meta->sequence - base >= bus->reliable_window) {
+            return -1; // Out of the receiving window, the sender will resend
+        }
+
+        if (pomelo_delivery_bus_ensure_reliable_slots(bus) < 0) {
+            return -1; // Failed to create the receiving window
+        }
+
+        pomelo_delivery_reliable_slot_t * slot =
+            pomelo_delivery_bus_reliable_slot(bus, meta->sequence);
+        if (slot->completed) {
+            // The parcel is waiting for the previous parcels
+            pomelo_delivery_bus_reply_ack(bus, meta);
+            return 0;
         }
     } else if (meta->type == POMELO_FRAGMENT_TYPE_DATA_SEQUENCED) {
         // For sequenced parcel
@@ -252,11 +449,22 @@ int pomelo_delivery_bus_recv_fragment_data(
     }
     
     // Get the receiver
-    pomelo_delivery_receiver_t * receiver =
-        pomelo_delivery_bus_ensure_recv_command(bus, meta);
-    if (!receiver) return -1; // Failed to prepare receiving command
+    pomelo_delivery_receiver_t * receiver = NULL;
+    if (repair) {
+        // Repair fragments never open a receiver. Either the parcel has been
+        // delivered or none of its fragments has arrived yet.
+        if (!bus->receivers_map) return 0; // Nothing to repair
+        pomelo_map_get(bus->receivers_map, meta->sequence, &receiver);
+        if (!receiver) return 0; // Nothing to repair
+
+        int ret = pomelo_delivery_receiver_check_meta(receiver, meta);
+        if (ret < 0) return -1; // Invalid meta, discard
+    } else {
+        receiver = pomelo_delivery_bus_ensure_recv_command(bus, meta);
+        if (!receiver) return -1; // Failed to prepare receiving command
+    }
 
-    if (receiver->mode == POMELO_DELIVERY_MODE_RELIABLE) {
+    if (pomelo_delivery_mode_is_reliable(receiver->mode)) {
         // Reply the ack to the sender
         pomelo_delivery_bus_reply_ack(bus, meta);
     }
@@ -274,12 +482,18 @@ void pomelo_delivery_bus_handle_receiver_complete(
     assert(bus != NULL);
     assert(receiver != NULL);
 
-    if (receiver->mode == POMELO_DELIVERY_MODE_RELIABLE) {
-        assert(bus->incomplete_reliable_receiver == receiver);
-        bus->incomplete_reliable_receiver = NULL;
+    pomelo_delivery_reliable_slot_t * slot = NULL;
+    if (pomelo_delivery_mode_is_reliable(receiver->mode)) {
+        // The parcel is considered lost if the receiver failed, all of its
+        // fragments have been acked so the sender will not resend it.
+        slot = pomelo_delivery_bus_reliable_slot(bus, receiver->sequence);
+        slot->completed = true;
     }
 
     if (receiver->flags & POMELO_DELIVERY_RECEIVER_FLAG_FAILED) {
+        if (slot) {
+            pomelo_delivery_bus_deliver_reliable(bus);
+        }
         return; // Failed, ignore
     }
 
@@ -292,9 +506,29 @@ void pomelo_delivery_bus_handle_receiver_complete(
     int ret = pomelo_delivery_parcel_set_fragments(parcel, receiver->fragments);
     if (ret < 0) {
         pomelo_delivery_parcel_unref(parcel);
-        return; // Failed to set fragments
+        parcel = NULL; // Failed to set fragments
+    }
+
+    if (slot && receiver->mode == POMELO_DELIVERY_MODE_RELIABLE) {
+        // Keep the parcel in the window until the previous ones are delivered
+        slot->parcel = parcel;
+        pomelo_delivery_bus_deliver_reliable(bus);
+        return;
     }
 
+    if (slot) {
+        // Unordered parcel, deliver it right now. Its slot is skipped when the
+        // window slides over it.
+        if (parcel) {
+            pomelo_delivery_bus_dispatch_received(bus, parcel, receiver->mode);
+            pomelo_delivery_parcel_unref(parcel);
+        }
+        pomelo_delivery_bus_deliver_reliable(bus);
+        return;
+    }
+
+    if (!parcel) return; // Failed to build the parcel
+
     if (receiver->mode != POMELO_DELIVERY_MODE_SEQUENCED) {
         // Just call the callback
         pomelo_delivery_bus_dispatch_received(bus, parcel, receiver->mode);
@@ -314,6 +548,33 @@ void pomelo_delivery_bus_handle_receiver_complete(
 }
 
 
+/// @brief Find the reliable dispatcher in the sending window
+static pomelo_delivery_dispatcher_t * find_reliable_dispatcher(
+    pomelo_delivery_bus_t * bus,
+    uint64_t sequence
+) {
+    if (sequence < bus->reliable_send_base) {
+        return NULL; // The parcel has been acked
+    }
+
+    if (sequence >= bus->reliable_send_next) {
+        return NULL; // The parcel has not been dispatched
+    }
+
+    pomelo_delivery_dispatcher_t * dispatcher = NULL;
+    pomelo_array_get(
+        bus->reliable_dispatchers,
+        sequence % bus->reliable_window,
+        &dispatcher
+    );
+    if (!dispatcher || dispatcher->sequence != sequence) {
+        return NULL; // Not found
+    }
+
+    return dispatcher;
+}
+
+
 int pomelo_delivery_bus_recv_fragment_ack(
     pomelo_delivery_bus_t * bus,
     pomelo_delivery_fragment_meta_t * meta
@@ -321,15 +582,124 @@ int pomelo_delivery_bus_recv_fragment_ack(
     assert(bus != NULL);
     assert(meta != NULL);
 
-    // Check the current reliable sending command
     pomelo_delivery_dispatcher_t * dispatcher =
-        bus->incomplete_reliable_dispatcher;
-    if (!dispatcher || dispatcher->sequence != meta->sequence) {
-        return -1; // Invalid ack
-    }
+        find_reliable_dispatcher(bus, meta->sequence);
+    if (!dispatcher) return -1; // Invalid ack
 
     // Process ack
-    pomelo_delivery_dispatcher_recv_ack(dispatcher, meta);
+    pomelo_delivery_dispatcher_recv_ack(dispatcher, meta->fragment_index);
+    return 0;
+}
+
+
+int pomelo_delivery_bus_recv_ack_block(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_ack_block_t * block
+) {
+    assert(bus != NULL);
+    assert(block != NULL);
+
+    pomelo_delivery_dispatcher_t * dispatcher =
+        find_reliable_dispatcher(bus, block->sequence);
+    if (!dispatcher) return -1; // Invalid ack
+
+    // The dispatcher completes in a deferred task, so that it is still alive
+    // after all of its fragments have been acked.
+    size_t nfragments = dispatcher->fragments->size;
+    size_t end = block->first + block->run;
+    if (end > nfragments) {
+        end = nfragments;
+    }
+
+    for (size_t i = block->first; i < end; i++) {
+        pomelo_delivery_dispatcher_recv_ack(dispatcher, i);
+    }
+
+    uint32_t mask = block->mask;
+    for (size_t i = 0; mask != 0; i++, mask >>= 1) {
+        if (mask & 1) {
+            pomelo_delivery_dispatcher_recv_ack(dispatcher, end + 1 + i);
+        }
+    }
+
+    return 0;
+}
+
+
+void pomelo_delivery_bus_stamp_fragment(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_fragment_meta_t * meta,
+    uint64_t time
+) {
+    assert(bus != NULL);
+    assert(meta != NULL);
+
+    pomelo_delivery_dispatcher_t * dispatcher =
+        find_reliable_dispatcher(bus, meta->sequence);
+    if (!dispatcher) return; // The parcel has been acked or canceled
+
+    pomelo_delivery_fragment_t * fragment =
+        pomelo_array_get_ptr(dispatcher->fragments, meta->fragment_index);
+    if (!fragment) return; // Repair fragment
+    if (fragment->sent_time == POMELO_DELIVERY_FRAGMENT_SENT_TIME_QUEUED) {
+        fragment->sent_time = time;
+    }
+}
+
+
+void pomelo_delivery_bus_recv_later_ack(
+    pomelo_delivery_bus_t * bus,
+    uint64_t sequence,
+    uint64_t sent_time
+) {
+    assert(bus != NULL);
+
+    pomelo_array_t * dispatchers = bus->reliable_dispatchers;
+    size_t window = bus->reliable_window;
+
+    uint64_t end = sequence;
+    if (end > bus->reliable_send_next) {
+        end = bus->reliable_send_next;
+    }
+
+    for (uint64_t i = bus->reliable_send_base; i < end; i++) {
+        pomelo_delivery_dispatcher_t * dispatcher = NULL;
+        pomelo_array_get(dispatchers, i % window, &dispatcher);
+        if (!dispatcher || dispatcher->sequence != i) continue;
+
+        if (dispatcher->unacked_index == dispatcher->fragments->size) {
+            continue; // Waiting for completion
+        }
+
+        pomelo_delivery_dispatcher_recv_later_ack(
+            dispatcher,
+            dispatcher->fragments->size,
+            sent_time
+        );
+    }
+}
+
+
+int pomelo_delivery_bus_reliable_state(
+    pomelo_delivery_bus_t * bus,
+    uint64_t sequence,
+    pomelo_delivery_receiver_t ** receiver
+) {
+    assert(bus != NULL);
+    assert(receiver != NULL);
+    *receiver = NULL;
+
+    uint64_t base = bus->reliable_recv_base;
+    if (sequence < base) return 1; // Delivered
+    if (sequence - base >= bus->reliable_window) return -1; // Out of window
+    if (!bus->reliable_slots) return -1; // Nothing has been received
+
+    pomelo_delivery_reliable_slot_t * slot =
+        pomelo_delivery_bus_reliable_slot(bus, sequence);
+    if (slot->completed) return 1; // Waiting for the previous parcels
+    if (!slot->receiver) return -1;
+
+    *receiver = slot->receiver;
     return 0;
 }
 
@@ -344,6 +714,13 @@ int pomelo_delivery_bus_reply_ack(
     pomelo_delivery_endpoint_t * endpoint = bus->endpoint;
     pomelo_delivery_context_t * context = endpoint->context;
 
+    if (context->ack_delay_ms > 0) {
+        // Aggregate the ACK with other ones
+        int ret = pomelo_delivery_endpoint_queue_ack(endpoint, meta);
+        if (ret == 0) return 0;
+        // Otherwise, fall back to the single ACK
+    }
+
     // Acquire new buffer for writing
     pomelo_buffer_t * buffer =
         pomelo_buffer_context_acquire(context->buffer_context);
@@ -367,7 +744,13 @@ int pomelo_delivery_bus_reply_ack(
     }
 
     // Send the payload
-    ret = pomelo_delivery_endpoint_send(endpoint, &view, 1);
+    // ACKs are scheduled with the system parcels
+    ret = pomelo_delivery_endpoint_transmit(
+        endpoint,
+        endpoint->system_bus,
+        &view,
+        1
+    );
 
     // Finally, unref the payload
     pomelo_buffer_unref(buffer);
@@ -385,11 +768,18 @@ pomelo_delivery_receiver_t * pomelo_delivery_bus_ensure_recv_command(
     // Cleanup expired receivers first
     pomelo_delivery_bus_cleanup_expired_receivers(bus);
 
-    // Get the receiver from map
+    // Get the receiver from the receiving window or map
     uint64_t sequence = meta->sequence;
 
     pomelo_delivery_receiver_t * receiver = NULL;
-    pomelo_map_get(bus->receivers_map, sequence, &receiver);
+    if (pomelo_delivery_fragment_type_is_reliable(meta->type)) {
+        receiver = pomelo_delivery_bus_reliable_slot(bus, sequence)->receiver;
+    } else {
+        if (pomelo_delivery_bus_ensure_receivers(bus) < 0) {
+            return NULL; // Failed to create the receivers map
+        }
+        pomelo_map_get(bus->receivers_map, sequence, &receiver);
+    }
     if (receiver) {
         int ret = pomelo_delivery_receiver_check_meta(receiver, meta);
         if (ret < 0) return NULL; // Invalid meta, discard
@@ -404,25 +794,108 @@ pomelo_delivery_receiver_t * pomelo_delivery_bus_ensure_recv_command(
     receiver = pomelo_pool_acquire(bus->context->receiver_pool, &info);
     if (!receiver) return NULL; // Failed to acquire new receiver
 
-    if (receiver->mode == POMELO_DELIVERY_MODE_RELIABLE) {
-        assert(bus->incomplete_reliable_receiver == NULL);
-        bus->incomplete_reliable_receiver = receiver;
-        bus->last_recv_reliable_sequence = receiver->sequence;
-    }
-
     // Submit the receiving command
     pomelo_delivery_receiver_submit(receiver);
     return receiver;
 }
 
 
+int pomelo_delivery_bus_add_receiver(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_receiver_t * receiver
+) {
+    assert(bus != NULL);
+    assert(receiver != NULL);
+
+    if (pomelo_delivery_mode_is_reliable(receiver->mode)) {
+        pomelo_delivery_reliable_slot_t * slot =
+            pomelo_delivery_bus_reliable_slot(bus, receiver->sequence);
+        assert(slot->receiver == NULL);
+        slot->receiver = receiver;
+        return 0;
+    }
+
+    receiver->sequence_entry = pomelo_map_set(
+        bus->receivers_map,
+        receiver->sequence,
+        receiver
+    );
+    if (!receiver->sequence_entry) return -1; // Cannot set receiver to map
+
+    return 0;
+}
+
+
+void pomelo_delivery_bus_remove_receiver(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_receiver_t * receiver
+) {
+    assert(bus != NULL);
+    assert(receiver != NULL);
+
+    if (pomelo_delivery_mode_is_reliable(receiver->mode)) {
+        pomelo_delivery_reliable_slot_t * slot =
+            pomelo_delivery_bus_reliable_slot(bus, receiver->sequence);
+        if (slot->receiver == receiver) {
+            slot->receiver = NULL;
+        }
+        return;
+    }
+
+    if (receiver->sequence_entry) {
+        pomelo_map_remove(bus->receivers_map, receiver->sequence_entry);
+        receiver->sequence_entry = NULL;
+    }
+}
+
+
+pomelo_delivery_reliable_slot_t * pomelo_delivery_bus_reliable_slot(
+    pomelo_delivery_bus_t * bus,
+    uint64_t sequence
+) {
+    assert(bus != NULL);
+    pomelo_delivery_reliable_slot_t * slot = pomelo_array_get_ptr(
+        bus->reliable_slots,
+        sequence % bus->reliable_window
+    );
+    assert(slot != NULL);
+    return slot;
+}
+
+
+void pomelo_delivery_bus_deliver_reliable(pomelo_delivery_bus_t * bus) {
+    assert(bus != NULL);
+
+    while (true) {
+        pomelo_delivery_reliable_slot_t * slot =
+            pomelo_delivery_bus_reliable_slot(bus, bus->reliable_recv_base);
+        if (!slot->completed) break; // Waiting for the next parcel
+
+        // Release the slot before dispatching, the callback may stop the bus
+        pomelo_delivery_parcel_t * parcel = slot->parcel;
+        memset(slot, 0, sizeof(pomelo_delivery_reliable_slot_t));
+        bus->reliable_recv_base++;
+
+        if (!parcel) continue; // Lost parcel, skip it
+        pomelo_delivery_bus_dispatch_received(
+            bus,
+            parcel,
+            POMELO_DELIVERY_MODE_RELIABLE
+        );
+        pomelo_delivery_parcel_unref(parcel);
+    }
+}
+
+
 void pomelo_delivery_bus_cleanup_expired_receivers(
     pomelo_delivery_bus_t * bus
 ) {
     assert(bus != NULL);
 
-    uint64_t now = pomelo_platform_hrtime(bus->platform);
     pomelo_heap_t * receivers = bus->receivers_heap;
+    if (!receivers) return; // No unreliable or sequenced receivers
+
+    uint64_t now = pomelo_platform_hrtime(bus->platform);
     pomelo_delivery_receiver_t * command = NULL;
 
     while (pomelo_heap_top(receivers, &command) == 0) {
@@ -521,18 +994,31 @@ void pomelo_delivery_bus_process_sending_deferred(pomelo_delivery_bus_t * bus) {
     assert(bus != NULL);
     pomelo_list_t * dispatchers = bus->pending_dispatchers;
 
-    // Reliable sending command will block the bus
+    // A full reliable sending window will block the bus
     while (
-        !(bus->flags & POMELO_DELIVERY_BUS_FLAG_STOP)
-        && !bus->incomplete_reliable_dispatcher
+        !(bus->flags & POMELO_DELIVERY_BUS_FLAG_STOP) &&
+        dispatchers && dispatchers->front
     ) {
-        pomelo_delivery_dispatcher_t * command = NULL;
-        if (pomelo_list_pop_front(dispatchers, &command) != 0) break;
+        pomelo_delivery_dispatcher_t * command = pomelo_list_element(
+            dispatchers->front,
+            pomelo_delivery_dispatcher_t *
+        );
+
+        if (pomelo_delivery_mode_is_reliable(command->mode)) {
+            uint64_t sequence = command->sequence;
+            if (sequence - bus->reliable_send_base >= bus->reliable_window) {
+                break; // The sending window is full
+            }
 
-        if (command->mode == POMELO_DELIVERY_MODE_RELIABLE) {
-            bus->incomplete_reliable_dispatcher = command;
+            pomelo_array_set(
+                bus->reliable_dispatchers,
+                sequence % bus->reliable_window,
+                command
+            );
+            bus->reliable_send_next = sequence + 1;
         }
 
+        pomelo_list_pop_front(dispatchers, &command);
         pomelo_delivery_dispatcher_submit(command);
     }
 
@@ -545,6 +1031,19 @@ void pomelo_delivery_bus_process_sending_deferred(pomelo_delivery_bus_t * bus) {
 }
 
 
+uint64_t pomelo_delivery_bus_next_sequence(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_mode mode
+) {
+    assert(bus != NULL);
+    if (pomelo_delivery_mode_is_reliable(mode)) {
+        return ++bus->reliable_sequence_generator;
+    }
+
+    return ++bus->sequence_generator;
+}
+
+
 void pomelo_delivery_bus_on_dispatcher_completed(
     pomelo_delivery_bus_t * bus,
     pomelo_delivery_dispatcher_t * dispatcher
@@ -552,11 +1051,39 @@ void pomelo_delivery_bus_on_dispatcher_completed(
     assert(bus != NULL);
     assert(dispatcher != NULL);
 
-    if (dispatcher == bus->incomplete_reliable_dispatcher) {
-        // The current reliable sending command is completed
-        bus->incomplete_reliable_dispatcher = NULL;
+    if (pomelo_delivery_mode_is_reliable(dispatcher->mode)) {
+        // Slide the sending window
+        pomelo_delivery_bus_remove_dispatcher(bus, dispatcher);
     }
 
     // Continue processing.
     pomelo_delivery_bus_process_sending(bus);
 }
+
+
+void pomelo_delivery_bus_remove_dispatcher(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_dispatcher_t * dispatcher
+) {
+    assert(bus != NULL);
+    assert(dispatcher != NULL);
+
+    pomelo_array_t * dispatchers = bus->reliable_dispatchers;
+    size_t window = bus->reliable_window;
+
+    pomelo_delivery_dispatcher_t ** p_dispatcher =
+        pomelo_array_get_ptr(dispatchers, dispatcher->sequence % window);
+    assert(p_dispatcher != NULL);
+    if (*p_dispatcher != dispatcher) return; // Not in the window
+    *p_dispatcher = NULL;
+
+    // Advance the base over the acked parcels
+    while (bus->reliable_send_base < bus->reliable_send_next) {
+        p_dispatcher = pomelo_array_get_ptr(
+            dispatchers,
+            bus->reliable_send_base % window
+        );
+        if (*p_dispatcher) break; // Waiting for acks
+        bus->reliable_send_base++;
+    }
+}
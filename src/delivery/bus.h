@@ -2,10 +2,12 @@
 #define POMELO_DELIVERY_BUS_SRC_H
 #include "utils/map.h"
 #include "utils/list.h"
+#include "utils/array.h"
 #include "utils/heap.h"
 #include "base/extra.h"
 #include "internal.h"
 #include "fragment.h"
+#include "ack.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -23,6 +25,9 @@ typedef struct pomelo_delivery_reception_s pomelo_delivery_reception_t;
 /// @brief The information of bus
 typedef struct pomelo_delivery_bus_info_s pomelo_delivery_bus_info_t;
 
+/// @brief The slot of a reliable parcel in the receiving window
+typedef struct pomelo_delivery_reliable_slot_s pomelo_delivery_reliable_slot_t;
+
 
 struct pomelo_delivery_reception_s {
     /// @brief The bus which this information belongs to
@@ -39,12 +44,32 @@ struct pomelo_delivery_reception_s {
 };
 
 
+struct pomelo_delivery_reliable_slot_s {
+    /// @brief The receiver which is receiving the parcel
+    pomelo_delivery_receiver_t * receiver;
+
+    /// @brief The received parcel which is waiting for the previous parcels
+    pomelo_delivery_parcel_t * parcel;
+
+    /// @brief Whether the parcel has been completely received. A completed
+    /// slot without parcel is a parcel which has failed (e.g. mismatched
+    /// checksum), it is skipped because the sender has all its acks.
+    bool completed;
+};
+
+
 struct pomelo_delivery_bus_info_s {
     /// @brief The endpoint which this bus belongs to
     pomelo_delivery_endpoint_t * endpoint;
 
     /// @brief The id of this bus
     size_t id;
+
+    /// @brief The scheduling priority of this bus
+    unsigned int priority;
+
+    /// @brief The scheduling weight of this bus
+    uint32_t weight;
 };
 
 
@@ -64,34 +89,79 @@ struct pomelo_delivery_bus_s {
     /// @brief The platform of this bus
     pomelo_platform_t * platform;
 
-    /// @brief The dispatchers which are pending because bus is blocked
+    /// @brief The dispatchers which are pending because bus is blocked.
+    /// It is created on the first sent parcel.
     pomelo_list_t * pending_dispatchers;
 
-    /// @brief The map of receivers by sequence
+    /// @brief The map of unreliable & sequenced receivers by sequence.
+    /// It is created on the first received unreliable or sequenced parcel.
     pomelo_map_t * receivers_map;
 
-    /// @brief The heap of receivers by expired time
+    /// @brief The heap of receivers by expired time. It is created with the
+    /// receivers map.
     pomelo_heap_t * receivers_heap;
 
-    /// @brief The reliable parcel which is receiving from other peer.
-    /// No more reliable parcels will be accepted if there's a pending reliable
-    /// receiving command.
-    pomelo_delivery_receiver_t * incomplete_reliable_receiver;
+    /// @brief The size of reliable sending & receiving windows
+    size_t reliable_window;
+
+    /// @brief The sending window. The reliable dispatchers which are waiting
+    /// to be acked, indexed by their sequences modulo the window size. When
+    /// the window is full, the next parcels are queued in pending dispatchers
+    /// list. It is created on the first sent reliable parcel.
+    pomelo_array_t * reliable_dispatchers;
+
+    /// @brief The lowest reliable sequence which has not been acked
+    uint64_t reliable_send_base;
 
-    /// @brief The reliable parcel which is waiting to be acked. If this field
-    /// is not null, the next incoming parcels will be queued in pending
-    /// dispatchers list
-    pomelo_delivery_dispatcher_t * incomplete_reliable_dispatcher;
+    /// @brief The next reliable sequence to dispatch
+    uint64_t reliable_send_next;
 
-    /// @brief The last received reliable parcel sequence number
-    uint64_t last_recv_reliable_sequence;
+    /// @brief The latest sent time of the acked reliable fragments. The ACKs
+    /// of earlier sent fragments bring no new evidence of losses.
+    uint64_t reliable_acked_sent_time;
+
+    /// @brief The receiving window (reorder buffer). The slots of reliable
+    /// parcels which are receiving or waiting for the previous parcels, indexed
+    /// by their sequences modulo the window size. It is created on the first
+    /// received reliable fragment.
+    pomelo_array_t * reliable_slots;
+
+    /// @brief The payloads which are waiting for the pacer of endpoint. It is
+    /// created on the first payload which is not allowed to be sent right away.
+    pomelo_list_t * pacer_queue;
+
+    /// @brief The entry of this bus in the pacing buses list of endpoint
+    pomelo_list_entry_t * pacer_entry;
+
+    /// @brief The scheduling priority of this bus. The paced payloads of the
+    /// buses with higher priorities are sent first.
+    unsigned int priority;
+
+    /// @brief The scheduling weight of this bus. The buses of the same priority
+    /// share the pacer in proportion to their weights.
+    uint32_t weight;
+
+    /// @brief The deficit counter of round robin scheduling in bytes
+    size_t deficit;
+
+    /// @brief The number of bytes allocated up front by the structures above
+    size_t state_bytes;
+
+    /// @brief The next reliable sequence to deliver
+    uint64_t reliable_recv_base;
 
     /// @brief The last received sequenced parcel sequence number
     uint64_t last_recv_sequenced_sequence;
 
-    /// @brief The parcel sequence generator. It starts from 1.
+    /// @brief The parcel sequence generator of unreliable & sequenced parcels.
+    /// It starts from 1.
     uint64_t sequence_generator;
 
+    /// @brief The reliable parcel sequence generator. Reliable parcels have
+    /// their own continuous sequences, so that the receiver can deliver them in
+    /// order. It starts from 1.
+    uint64_t reliable_sequence_generator;
+
     /// @brief The flags of bus
     uint32_t flags;
 
@@ -130,6 +200,30 @@ int pomelo_delivery_bus_start(pomelo_delivery_bus_t * bus);
 void pomelo_delivery_bus_stop(pomelo_delivery_bus_t * bus);
 
 
+/// @brief Create the pending dispatchers list if it has not been created
+int pomelo_delivery_bus_ensure_pending_dispatchers(
+    pomelo_delivery_bus_t * bus
+);
+
+
+/// @brief Create the receivers map & heap if they have not been created
+int pomelo_delivery_bus_ensure_receivers(pomelo_delivery_bus_t * bus);
+
+
+/// @brief Create the reliable sending window if it has not been created
+int pomelo_delivery_bus_ensure_reliable_dispatchers(
+    pomelo_delivery_bus_t * bus
+);
+
+
+/// @brief Create the reliable receiving window if it has not been created
+int pomelo_delivery_bus_ensure_reliable_slots(pomelo_delivery_bus_t * bus);
+
+
+/// @brief Create the pacer queue if it has not been created
+int pomelo_delivery_bus_ensure_pacer_queue(pomelo_delivery_bus_t * bus);
+
+
 /* -------------------------------------------------------------------------- */
 /*                             Receiving Process                              */
 /* -------------------------------------------------------------------------- */
@@ -165,6 +259,42 @@ int pomelo_delivery_bus_recv_fragment_ack(
 );
 
 
+/// @brief Process receiving ACK block
+int pomelo_delivery_bus_recv_ack_block(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_ack_block_t * block
+);
+
+
+/// @brief Stamp the sent time of a queued reliable fragment when the endpoint
+/// emits it
+void pomelo_delivery_bus_stamp_fragment(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_fragment_meta_t * meta,
+    uint64_t time
+);
+
+
+/// @brief Notify the reliable parcels dispatched before the sequence about a
+/// newly acked fragment, so that the lost ones are retransmitted early
+void pomelo_delivery_bus_recv_later_ack(
+    pomelo_delivery_bus_t * bus,
+    uint64_t sequence,
+    uint64_t sent_time
+);
+
+
+/// @brief Get the receiving state of a reliable parcel
+/// @param receiver Output receiver if the parcel is being received
+/// @return 1 if the parcel has been completely received, 0 if the parcel is
+/// being received or -1 if the parcel is unknown
+int pomelo_delivery_bus_reliable_state(
+    pomelo_delivery_bus_t * bus,
+    uint64_t sequence,
+    pomelo_delivery_receiver_t ** receiver
+);
+
+
 /// @brief Reply ack
 int pomelo_delivery_bus_reply_ack(
     pomelo_delivery_bus_t * bus,
@@ -179,6 +309,31 @@ pomelo_delivery_receiver_t * pomelo_delivery_bus_ensure_recv_command(
 );
 
 
+/// @brief Add a receiver to the map or the receiving window of bus
+int pomelo_delivery_bus_add_receiver(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_receiver_t * receiver
+);
+
+
+/// @brief Remove a receiver from the map or the receiving window of bus
+void pomelo_delivery_bus_remove_receiver(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_receiver_t * receiver
+);
+
+
+/// @brief Get the slot of a reliable sequence in the receiving window
+pomelo_delivery_reliable_slot_t * pomelo_delivery_bus_reliable_slot(
+    pomelo_delivery_bus_t * bus,
+    uint64_t sequence
+);
+
+
+/// @brief Deliver the completed reliable parcels in order of their sequences
+void pomelo_delivery_bus_deliver_reliable(pomelo_delivery_bus_t * bus);
+
+
 /// @brief Cleanup expired receiving commands
 void pomelo_delivery_bus_cleanup_expired_receivers(
     pomelo_delivery_bus_t * bus
@@ -231,6 +386,20 @@ void pomelo_delivery_bus_process_sending(pomelo_delivery_bus_t * bus);
 void pomelo_delivery_bus_process_sending_deferred(pomelo_delivery_bus_t * bus);
 
 
+/// @brief Generate the sequence of a new parcel
+uint64_t pomelo_delivery_bus_next_sequence(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_mode mode
+);
+
+
+/// @brief Remove a reliable dispatcher from the sending window of bus
+void pomelo_delivery_bus_remove_dispatcher(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_dispatcher_t * dispatcher
+);
+
+
 /// @brief The callback when a sending dispatcher has completed running
 void pomelo_delivery_bus_on_dispatcher_completed(
     pomelo_delivery_bus_t * bus,
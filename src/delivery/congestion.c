@@ -0,0 +1,278 @@
+#include <assert.h>
+#include "utils/macro.h"
+#include "congestion.h"
+
+
+/// The multiplicative decrease factor (beta) in percents
+#define POMELO_DELIVERY_CUBIC_BETA 70
+
+/// 1 / C in 1/10 seconds^3 per MSS: C = 0.4 MSS/s^3
+#define POMELO_DELIVERY_CUBIC_C_INV_X10 25
+
+/// The maximum time in milliseconds from the origin which is applied to the
+/// cubic function, this keeps the integer math from overflowing
+#define POMELO_DELIVERY_CUBIC_MAX_DT_MS 30000
+
+/// Nanoseconds per millisecond
+#define POMELO_DELIVERY_NS_PER_MS 1000000ULL
+
+
+/// @brief Get the integer cube root of the value
+static uint64_t congestion_icbrt(uint64_t value) {
+    uint64_t root = 0;
+    for (int shift = 63; shift >= 0; shift -= 3) {
+        root <<= 1;
+        // (root + 1)^3 - root^3 = 3 * root * (root + 1) + 1
+        uint64_t step = 3 * root * (root + 1) + 1;
+        if ((value >> shift) >= step) {
+            value -= step << shift;
+            root++;
+        }
+    }
+    return root;
+}
+
+
+/// @brief Get the minimum window of the controller
+static size_t congestion_min_window(pomelo_delivery_congestion_t * congestion) {
+    return POMELO_DELIVERY_CONGESTION_MIN_WINDOW * congestion->mss;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                                   CUBIC                                    */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Reset the CUBIC controller
+static void cubic_reset(pomelo_delivery_congestion_t * congestion) {
+    congestion->cwnd =
+        POMELO_DELIVERY_CONGESTION_INITIAL_WINDOW * congestion->mss;
+    congestion->ssthresh = SIZE_MAX;
+    congestion->w_max = 0;
+    congestion->w_origin = 0;
+    congestion->k_ms = 0;
+    congestion->epoch = 0;
+}
+
+
+/// @brief Get the target window of CUBIC at the time
+static size_t cubic_target(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t time
+) {
+    // The target is the window after one more RTT
+    uint64_t elapsed_ms = (time - congestion->epoch +
+        pomelo_delivery_congestion_srtt(congestion)) /
+        POMELO_DELIVERY_NS_PER_MS;
+
+    bool growing = (elapsed_ms >= congestion->k_ms);
+    uint64_t dt = growing
+        ? (elapsed_ms - congestion->k_ms)
+        : (congestion->k_ms - elapsed_ms);
+    if (dt > POMELO_DELIVERY_CUBIC_MAX_DT_MS) {
+        dt = POMELO_DELIVERY_CUBIC_MAX_DT_MS;
+    }
+
+    // C * dt^3 * MSS = 0.4 * (dt / 1000)^3 * MSS = 4 * MSS * dt^3 / 10^10
+    uint64_t delta = 4 * congestion->mss * dt * dt / 10000 * dt / 1000000;
+    if (growing) {
+        return congestion->w_origin + (size_t) delta;
+    }
+
+    if (delta + congestion_min_window(congestion) >= congestion->w_origin) {
+        return congestion_min_window(congestion);
+    }
+    return congestion->w_origin - (size_t) delta;
+}
+
+
+/// @brief Process the newly acked bytes of CUBIC
+static void cubic_on_acked(
+    pomelo_delivery_congestion_t * congestion,
+    size_t bytes,
+    uint64_t time
+) {
+    if (congestion->cwnd < congestion->ssthresh) {
+        // Slow start
+        congestion->cwnd += bytes;
+        return;
+    }
+
+    // Congestion avoidance
+    if (congestion->epoch == 0) {
+        congestion->epoch = time;
+        if (congestion->cwnd < congestion->w_max) {
+            // K = cbrt((W_max - cwnd) / C), in milliseconds
+            uint64_t diff = congestion->w_max - congestion->cwnd;
+            congestion->k_ms = congestion_icbrt(
+                diff * POMELO_DELIVERY_CUBIC_C_INV_X10 * 100000000ULL /
+                congestion->mss
+            );
+            congestion->w_origin = congestion->w_max;
+        } else {
+            congestion->k_ms = 0;
+            congestion->w_origin = congestion->cwnd;
+        }
+    }
+
+    size_t target = cubic_target(congestion, time);
+    size_t cwnd = congestion->cwnd;
+    if (target > cwnd) {
+        // Reach the target in one RTT
+        uint64_t increase = (uint64_t) (target - cwnd) * bytes / cwnd;
+        congestion->cwnd += (size_t) increase;
+    } else {
+        // Probe slowly: 1% of MSS per RTT
+        congestion->cwnd += congestion->mss * bytes / (100 * cwnd);
+    }
+}
+
+
+/// @brief Reduce the window of CUBIC
+static void cubic_reduce(pomelo_delivery_congestion_t * congestion) {
+    size_t cwnd = congestion->cwnd;
+
+    // Fast convergence: release the bandwidth for new flows
+    if (cwnd < congestion->w_max) {
+        congestion->w_max =
+            cwnd * (100 + POMELO_DELIVERY_CUBIC_BETA) / 200;
+    } else {
+        congestion->w_max = cwnd;
+    }
+
+    cwnd = cwnd * POMELO_DELIVERY_CUBIC_BETA / 100;
+    congestion->ssthresh = POMELO_MAX(cwnd, congestion_min_window(congestion));
+    congestion->epoch = 0;
+}
+
+
+/// @brief Process a loss event of CUBIC
+static void cubic_on_lost(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t time
+) {
+    (void) time;
+    cubic_reduce(congestion);
+    congestion->cwnd = congestion->ssthresh;
+}
+
+
+/// @brief Process a retransmission timeout of CUBIC
+static void cubic_on_timeout(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t time
+) {
+    (void) time;
+    cubic_reduce(congestion);
+    congestion->cwnd = congestion->mss; // Restart from slow start
+}
+
+
+pomelo_delivery_congestion_methods_t * pomelo_delivery_congestion_cubic(void) {
+    static bool initialized = false;
+    static pomelo_delivery_congestion_methods_t methods;
+    if (initialized) {
+        return &methods;
+    }
+
+    methods.reset = cubic_reset;
+    methods.on_acked = cubic_on_acked;
+    methods.on_lost = cubic_on_lost;
+    methods.on_timeout = cubic_on_timeout;
+
+    initialized = true;
+    return &methods;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+int pomelo_delivery_congestion_init(
+    pomelo_delivery_congestion_t * congestion,
+    pomelo_congestion_control mode,
+    pomelo_delivery_rto_t * rto,
+    size_t mss
+) {
+    assert(congestion != NULL);
+    assert(rto != NULL);
+    assert(mss > 0);
+
+    congestion->rto = rto;
+    congestion->mss = mss;
+    congestion->recovery_time = 0;
+
+    switch (mode) {
+        case POMELO_CONGESTION_CONTROL_DISABLED:
+            congestion->methods = NULL;
+            congestion->cwnd = SIZE_MAX;
+            congestion->ssthresh = SIZE_MAX;
+            return 0;
+
+        case POMELO_CONGESTION_CONTROL_CUBIC:
+            congestion->methods = pomelo_delivery_congestion_cubic();
+            break;
+
+        default:
+            return -1; // Invalid mode
+    }
+
+    congestion->methods->reset(congestion);
+    return 0;
+}
+
+
+void pomelo_delivery_congestion_on_acked(
+    pomelo_delivery_congestion_t * congestion,
+    size_t bytes,
+    uint64_t time
+) {
+    assert(congestion != NULL);
+    if (!congestion->methods) return; // Disabled
+    congestion->methods->on_acked(congestion, bytes, time);
+
+    if (congestion->cwnd > POMELO_DELIVERY_CONGESTION_MAX_WINDOW_BYTES) {
+        congestion->cwnd = POMELO_DELIVERY_CONGESTION_MAX_WINDOW_BYTES;
+    }
+}
+
+
+void pomelo_delivery_congestion_on_lost(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t sent_time,
+    uint64_t time
+) {
+    assert(congestion != NULL);
+    if (!congestion->methods) return; // Disabled
+
+    // Only one reduction per window
+    if (sent_time <= congestion->recovery_time) return;
+    congestion->recovery_time = time;
+    congestion->methods->on_lost(congestion, time);
+}
+
+
+void pomelo_delivery_congestion_on_timeout(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t sent_time,
+    uint64_t time
+) {
+    assert(congestion != NULL);
+    if (!congestion->methods) return; // Disabled
+
+    // Only one reduction per window
+    if (sent_time <= congestion->recovery_time) return;
+    congestion->recovery_time = time;
+    congestion->methods->on_timeout(congestion, time);
+}
+
+
+uint64_t pomelo_delivery_congestion_srtt(
+    pomelo_delivery_congestion_t * congestion
+) {
+    assert(congestion != NULL);
+    pomelo_delivery_rto_t * rto = congestion->rto;
+    if (!rto->measured) return POMELO_DELIVERY_RTO_INITIAL_NS;
+    return POMELO_MAX(rto->srtt, POMELO_DELIVERY_NS_PER_MS);
+}
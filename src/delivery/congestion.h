@@ -0,0 +1,169 @@
+#ifndef POMELO_DELIVERY_CONGESTION_SRC_H
+#define POMELO_DELIVERY_CONGESTION_SRC_H
+#include <stddef.h>
+#include <stdint.h>
+#include "pomelo/common.h"
+#include "rto.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+    Congestion control
+    ------------------
+    The congestion controller of an endpoint keeps a congestion window (cwnd)
+    in bytes. It is not enforced by counting the bytes in flight, but by the
+    pacer of endpoint which releases at most 5/4 * cwnd bytes per SRTT.
+
+    The controllers are pluggable through their methods. Losses are reported
+    at most once per window: the losses of fragments which were sent before
+    the last reduction are ignored.
+
+    CUBIC (RFC 8312, without the TCP-friendly region):
+        W(t) = C * (t - K)^3 + W_max, C = 0.4 MSS/s^3, beta = 0.7
+        K    = cbrt(W_max * (1 - beta) / C)
+    Slow start doubles the window per RTT until the first loss.
+*/
+
+
+/// @brief The initial congestion window in fragments
+#define POMELO_DELIVERY_CONGESTION_INITIAL_WINDOW 10
+
+/// @brief The minimum congestion window in fragments
+#define POMELO_DELIVERY_CONGESTION_MIN_WINDOW 2
+
+/// @brief The maximum congestion window in bytes. The window keeps growing
+/// while the endpoint is application limited, so it has to be bounded.
+#define POMELO_DELIVERY_CONGESTION_MAX_WINDOW_BYTES (64 * 1024 * 1024)
+
+
+/// @brief The congestion controller
+typedef struct pomelo_delivery_congestion_s pomelo_delivery_congestion_t;
+
+/// @brief The methods of congestion controller
+typedef struct pomelo_delivery_congestion_methods_s
+    pomelo_delivery_congestion_methods_t;
+
+
+/// @brief Reset the state of controller
+typedef void (*pomelo_delivery_congestion_reset_fn)(
+    pomelo_delivery_congestion_t * congestion
+);
+
+/// @brief Process the newly acked bytes
+typedef void (*pomelo_delivery_congestion_acked_fn)(
+    pomelo_delivery_congestion_t * congestion,
+    size_t bytes,
+    uint64_t time
+);
+
+/// @brief Process a loss event
+typedef void (*pomelo_delivery_congestion_lost_fn)(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t time
+);
+
+
+struct pomelo_delivery_congestion_methods_s {
+    /// @brief Reset method
+    pomelo_delivery_congestion_reset_fn reset;
+
+    /// @brief Newly acked bytes method
+    pomelo_delivery_congestion_acked_fn on_acked;
+
+    /// @brief Loss detected by later ACKs method
+    pomelo_delivery_congestion_lost_fn on_lost;
+
+    /// @brief Retransmission timeout method
+    pomelo_delivery_congestion_lost_fn on_timeout;
+};
+
+
+struct pomelo_delivery_congestion_s {
+    /// @brief The methods of controller. NULL if congestion control is
+    /// disabled.
+    pomelo_delivery_congestion_methods_t * methods;
+
+    /// @brief The RTT estimator of endpoint
+    pomelo_delivery_rto_t * rto;
+
+    /// @brief The maximum size of a fragment
+    size_t mss;
+
+    /// @brief The congestion window in bytes
+    size_t cwnd;
+
+    /// @brief The slow start threshold in bytes
+    size_t ssthresh;
+
+    /// @brief The time of the last window reduction
+    uint64_t recovery_time;
+
+    /// @brief [CUBIC] The window before the last reduction
+    size_t w_max;
+
+    /// @brief [CUBIC] The origin point of the cubic function
+    size_t w_origin;
+
+    /// @brief [CUBIC] The time to reach the origin in milliseconds
+    uint64_t k_ms;
+
+    /// @brief [CUBIC] The start time of the current epoch, zero if none
+    uint64_t epoch;
+};
+
+
+/// @brief Initialize the controller
+/// @param mode The congestion control mode
+/// @param rto The RTT estimator of endpoint
+/// @param mss The maximum size of a fragment
+/// @return 0 on success, or -1 if the mode is invalid
+int pomelo_delivery_congestion_init(
+    pomelo_delivery_congestion_t * congestion,
+    pomelo_congestion_control mode,
+    pomelo_delivery_rto_t * rto,
+    size_t mss
+);
+
+
+/// @brief Process the newly acked bytes
+void pomelo_delivery_congestion_on_acked(
+    pomelo_delivery_congestion_t * congestion,
+    size_t bytes,
+    uint64_t time
+);
+
+
+/// @brief Process a fragment which is lost (detected by later ACKs)
+/// @param sent_time The time of the lost transmission
+void pomelo_delivery_congestion_on_lost(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t sent_time,
+    uint64_t time
+);
+
+
+/// @brief Process a retransmission timeout
+/// @param sent_time The time of the timed out transmission
+void pomelo_delivery_congestion_on_timeout(
+    pomelo_delivery_congestion_t * congestion,
+    uint64_t sent_time,
+    uint64_t time
+);
+
+
+/// @brief Get the smoothed RTT for pacing, at least 1ms
+uint64_t pomelo_delivery_congestion_srtt(
+    pomelo_delivery_congestion_t * congestion
+);
+
+
+/// @brief Get the methods of CUBIC controller
+pomelo_delivery_congestion_methods_t * pomelo_delivery_congestion_cubic(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_DELIVERY_CONGESTION_SRC_H
@@ -9,6 +9,7 @@
 #include "bus.h"
 #include "dispatcher.h"
 #include "heartbeat.h"
+#include "fec.h"
 
 
 /// @brief Initialize the parcel
@@ -74,6 +75,25 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
         return NULL;
     }
 
+    size_t reliable_window = options->reliable_window;
+    if (reliable_window == 0) {
+        reliable_window = POMELO_DELIVERY_RELIABLE_WINDOW_DEFAULT;
+    } else if (reliable_window > POMELO_DELIVERY_RELIABLE_WINDOW_MAX) {
+        return NULL;
+    }
+
+    if (options->ack_delay_ms > POMELO_DELIVERY_ACK_DELAY_MAX_MS) {
+        return NULL; // ACKs would be delayed over the resend time
+    }
+
+    if (options->coalesce_delay_ms > POMELO_DELIVERY_COALESCE_DELAY_MAX_MS) {
+        return NULL; // Fragments would be delayed over the resend time
+    }
+
+    if (options->fec_repairs > POMELO_DELIVERY_FEC_MAX_REPAIRS) {
+        return NULL; // Too many repair fragments
+    }
+
     pomelo_allocator_t * allocator = options->allocator;
     if (!allocator) {
         allocator = pomelo_allocator_default();
@@ -88,6 +108,10 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
 
     context->buffer_context = (pomelo_buffer_context_t *)
         options->buffer_context->root;
+    pomelo_atomic_uint64_store(&context->retransmitted_fragments, 0);
+    pomelo_atomic_uint64_store(&context->fast_retransmitted_fragments, 0);
+    pomelo_atomic_uint64_store(&context->recovered_fragments, 0);
+    pomelo_atomic_uint64_store(&context->bus_state_bytes, 0);
     pomelo_pool_root_options_t pool_options;
 
 
@@ -128,6 +152,30 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
         options->fragment_capacity - POMELO_MAX_FRAGMENT_META_DATA_BYTES;
 
     base->max_fragments = max_fragments;
+    base->reliable_window = reliable_window;
+    base->ack_delay_ms = options->ack_delay_ms;
+    base->coalesce = options->coalesce;
+    base->coalesce_delay_ms = options->coalesce_delay_ms;
+    base->fec_repairs = options->fec_repairs;
+    base->contiguous_reassembly = options->contiguous_reassembly;
+
+    // Create the size-classed body buffer contexts
+    if (options->contiguous_reassembly) {
+        for (size_t i = 0; i < POMELO_DELIVERY_BODY_CLASSES; i++) {
+            pomelo_buffer_context_root_options_t buffer_options = {
+                .allocator = allocator,
+                .buffer_capacity =
+                    base->fragment_content_capacity * ((size_t) 2 << i),
+                .synchronized = options->synchronized
+            };
+            context->body_contexts[i] =
+                pomelo_buffer_context_root_create(&buffer_options);
+            if (!context->body_contexts[i]) {
+                pomelo_delivery_context_root_destroy(context);
+                return NULL;
+            }
+        }
+    }
 
     // Create pool of dispatchers
     memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
@@ -142,6 +190,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_delivery_dispatcher_cleanup;
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
     base->dispatcher_pool = pomelo_pool_root_create(&pool_options);
     if (!base->dispatcher_pool) {
         pomelo_delivery_context_root_destroy(context);
@@ -161,6 +210,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_delivery_sender_cleanup;
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
 
     base->sender_pool = pomelo_pool_root_create(&pool_options);
     if (!base->sender_pool) {
@@ -181,6 +231,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_delivery_receiver_cleanup;
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
     base->receiver_pool = pomelo_pool_root_create(&pool_options);
     if (!base->receiver_pool) {
         pomelo_delivery_context_root_destroy(context);
@@ -200,6 +251,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
         pomelo_delivery_endpoint_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_delivery_endpoint_cleanup;
+    pool_options.synchronized = options->synchronized;
     base->endpoint_pool = pomelo_pool_root_create(&pool_options);
     if (!base->endpoint_pool) {
         pomelo_delivery_context_root_destroy(context);
@@ -219,6 +271,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
         pomelo_delivery_bus_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_delivery_bus_cleanup;
+    pool_options.synchronized = options->synchronized;
     base->bus_pool = pomelo_pool_root_create(&pool_options);
     if (!base->bus_pool) {
         pomelo_delivery_context_root_destroy(context);
@@ -230,6 +283,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
     pool_options.allocator = allocator;
     pool_options.element_size = sizeof(pomelo_delivery_reception_t);
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
     base->reception_pool = pomelo_pool_root_create(&pool_options);
     if (!base->reception_pool) {
         pomelo_delivery_context_root_destroy(context);
@@ -241,6 +295,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
     pool_options.allocator = allocator;
     pool_options.element_size = sizeof(pomelo_delivery_transmission_t);
     pool_options.zero_init = true;
+    pool_options.synchronized = options->synchronized;
     base->transmission_pool = pomelo_pool_root_create(&pool_options);
     if (!base->transmission_pool) {
         pomelo_delivery_context_root_destroy(context);
@@ -260,6 +315,7 @@ pomelo_delivery_context_t * pomelo_delivery_context_root_create(
         pomelo_delivery_heartbeat_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_delivery_heartbeat_cleanup;
+    pool_options.synchronized = options->synchronized;
     base->heartbeat_pool = pomelo_pool_root_create(&pool_options);
     if (!base->heartbeat_pool) {
         pomelo_delivery_context_root_destroy(context);
@@ -322,6 +378,13 @@ void pomelo_delivery_context_root_destroy(
         base->heartbeat_pool = NULL;
     }
 
+    for (size_t i = 0; i < POMELO_DELIVERY_BODY_CLASSES; i++) {
+        if (context->body_contexts[i]) {
+            pomelo_buffer_context_destroy(context->body_contexts[i]);
+            context->body_contexts[i] = NULL;
+        }
+    }
+
     pomelo_allocator_free(base->allocator, context);
 }
 
@@ -349,6 +412,38 @@ void pomelo_delivery_context_root_release_parcel(
 }
 
 
+pomelo_buffer_t * pomelo_delivery_context_root_acquire_body(
+    pomelo_delivery_context_root_t * context,
+    size_t nfragments
+) {
+    assert(context != NULL);
+    if (!context->base.contiguous_reassembly) return NULL;
+    if (nfragments > POMELO_DELIVERY_BODY_MAX_FRAGMENTS) return NULL;
+
+    // Find the smallest class which fits the fragments
+    size_t index = 0;
+    while (((size_t) 2 << index) < nfragments) {
+        index++;
+    }
+    return pomelo_buffer_context_acquire(context->body_contexts[index]);
+}
+
+
+bool pomelo_delivery_context_root_is_body(
+    pomelo_delivery_context_root_t * context,
+    pomelo_buffer_t * buffer
+) {
+    assert(context != NULL);
+    assert(buffer != NULL);
+    if (!context->base.contiguous_reassembly) return false;
+
+    for (size_t i = 0; i < POMELO_DELIVERY_BODY_CLASSES; i++) {
+        if (buffer->context == context->body_contexts[i]) return true;
+    }
+    return false;
+}
+
+
 void pomelo_delivery_context_root_statistic(
     pomelo_delivery_context_root_t * context,
     pomelo_statistic_delivery_t * statistic
@@ -366,6 +461,24 @@ void pomelo_delivery_context_root_statistic(
     statistic->transmissions = pomelo_pool_in_use(base->transmission_pool);
     statistic->parcels = pomelo_pool_in_use(context->parcel_pool);
     statistic->heartbeats = pomelo_pool_in_use(base->heartbeat_pool);
+    statistic->retransmitted_fragments =
+        pomelo_atomic_uint64_load(&context->retransmitted_fragments);
+    statistic->fast_retransmitted_fragments =
+        pomelo_atomic_uint64_load(&context->fast_retransmitted_fragments);
+    statistic->recovered_fragments =
+        pomelo_atomic_uint64_load(&context->recovered_fragments);
+    statistic->bus_state_bytes =
+        (size_t) pomelo_atomic_uint64_load(&context->bus_state_bytes);
+
+    // The average memory of an active endpoint with its buses
+    statistic->endpoint_bytes = 0;
+    if (statistic->endpoints > 0) {
+        size_t bytes =
+            statistic->endpoints * sizeof(pomelo_delivery_endpoint_t) +
+            statistic->buses * sizeof(pomelo_delivery_bus_t) +
+            statistic->bus_state_bytes;
+        statistic->endpoint_bytes = bytes / statistic->endpoints;
+    }
 }
 
 
@@ -434,6 +547,12 @@ pomelo_delivery_context_t * pomelo_delivery_context_shared_create(
     base->root = root;
     base->fragment_content_capacity = root->base.fragment_content_capacity;
     base->max_fragments = root->base.max_fragments;
+    base->reliable_window = root->base.reliable_window;
+    base->ack_delay_ms = root->base.ack_delay_ms;
+    base->coalesce = root->base.coalesce;
+    base->coalesce_delay_ms = root->base.coalesce_delay_ms;
+    base->fec_repairs = root->base.fec_repairs;
+    base->contiguous_reassembly = root->base.contiguous_reassembly;
     base->dispatcher_pool = root->base.dispatcher_pool;
     base->sender_pool = root->base.sender_pool;
     base->receiver_pool = root->base.receiver_pool;
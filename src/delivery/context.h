@@ -3,6 +3,7 @@
 #include "utils/pool.h"
 #include "platform/platform.h"
 #include "base/buffer.h"
+#include "utils/atomic.h"
 #include "delivery.h"
 
 
@@ -70,6 +71,24 @@ struct pomelo_delivery_context_s {
     /// @brief The maximum number of fragments in a parcel
     size_t max_fragments;
 
+    /// @brief The maximum number of reliable parcels in flight per bus
+    size_t reliable_window;
+
+    /// @brief The delay of aggregated ACKs in milliseconds
+    uint64_t ack_delay_ms;
+
+    /// @brief Whether to coalesce small fragments
+    bool coalesce;
+
+    /// @brief The maximum delay of coalesced fragments in milliseconds
+    uint64_t coalesce_delay_ms;
+
+    /// @brief The number of FEC repair fragments per parcel
+    size_t fec_repairs;
+
+    /// @brief Whether to reassemble parcels into contiguous bodies
+    bool contiguous_reassembly;
+
     /// @brief The pool of dispatchers
     pomelo_pool_t * dispatcher_pool;
 
@@ -105,6 +124,22 @@ struct pomelo_delivery_context_root_s {
 
     /// @brief [Synchronized] The pool of parcels.
     pomelo_pool_t * parcel_pool;
+
+    /// @brief [Synchronized] The size-classed buffer contexts of contiguous
+    /// parcel bodies. Their buffers are always released to these contexts.
+    pomelo_buffer_context_t * body_contexts[POMELO_DELIVERY_BODY_CLASSES];
+
+    /// @brief The number of fragments retransmitted by timeouts
+    pomelo_atomic_uint64_t retransmitted_fragments;
+
+    /// @brief The number of fragments retransmitted by later ACKs
+    pomelo_atomic_uint64_t fast_retransmitted_fragments;
+
+    /// @brief The number of fragments rebuilt from FEC repair fragments
+    pomelo_atomic_uint64_t recovered_fragments;
+
+    /// @brief The number of bytes of the lazily created structures of buses
+    pomelo_atomic_uint64_t bus_state_bytes;
 };
 
 
@@ -143,6 +178,22 @@ void pomelo_delivery_context_root_release_parcel(
 );
 
 
+/// @brief Acquire a contiguous body buffer for the parcel of fragments
+/// @return New buffer, or NULL if the parcel has too many fragments or
+/// contiguous reassembly is disabled
+pomelo_buffer_t * pomelo_delivery_context_root_acquire_body(
+    pomelo_delivery_context_root_t * context,
+    size_t nfragments
+);
+
+
+/// @brief Check if the buffer is a contiguous body buffer
+bool pomelo_delivery_context_root_is_body(
+    pomelo_delivery_context_root_t * context,
+    pomelo_buffer_t * buffer
+);
+
+
 /// @brief Get the statistic of delivery context
 void pomelo_delivery_context_root_statistic(
     pomelo_delivery_context_root_t * context,
@@ -1,6 +1,7 @@
 #ifndef POMELO_DELIVERY_SRC_H
 #define POMELO_DELIVERY_SRC_H
 #include "pomelo/allocator.h"
+#include "pomelo/common.h"
 #include "pomelo/statistic/statistic-delivery.h"
 #include "base/buffer.h"
 #include "base/payload.h"
@@ -25,6 +26,33 @@ extern "C" {
 /// The maximum number of buses
 #define POMELO_DELIVERY_MAX_BUSES 65535
 
+/// The default number of reliable parcels in flight per bus
+#define POMELO_DELIVERY_RELIABLE_WINDOW_DEFAULT 32
+
+/// The maximum number of reliable parcels in flight per bus
+#define POMELO_DELIVERY_RELIABLE_WINDOW_MAX 1024
+
+/// The maximum delay of aggregated ACKs. It must stay below the minimum resend
+/// time of reliable parcels.
+#define POMELO_DELIVERY_ACK_DELAY_MAX_MS 8
+
+/// The maximum delay of coalesced fragments. It must stay below the minimum
+/// resend time of reliable parcels.
+#define POMELO_DELIVERY_COALESCE_DELAY_MAX_MS 8
+
+/// The number of size classes of contiguous parcel bodies. Class k holds the
+/// bodies of up to (2 << k) fragments.
+#define POMELO_DELIVERY_BODY_CLASSES 6
+
+/// The maximum number of fragments of a parcel reassembled contiguously. The
+/// larger parcels keep their fragments in separate buffers.
+#define POMELO_DELIVERY_BODY_MAX_FRAGMENTS                                     \
+    (2 << (POMELO_DELIVERY_BODY_CLASSES - 1))
+
+/// The scheduling priority of the system bus. It is above the priorities of
+/// all user buses, so that pings and ACKs are never delayed by other parcels.
+#define POMELO_DELIVERY_BUS_PRIORITY_SYSTEM 256
+
 
 /// @brief Delivery mode
 typedef enum pomelo_delivery_mode {
@@ -35,11 +63,22 @@ typedef enum pomelo_delivery_mode {
     POMELO_DELIVERY_MODE_SEQUENCED,
 
     /// @brief The reliable mode
-    POMELO_DELIVERY_MODE_RELIABLE
+    POMELO_DELIVERY_MODE_RELIABLE,
+
+    /// @brief The reliable mode without ordering. The parcels share the
+    /// reliable sequences & windows of bus, but they are delivered as soon as
+    /// they are complete.
+    POMELO_DELIVERY_MODE_RELIABLE_UNORDERED
 
 } pomelo_delivery_mode;
 
 
+/// @brief Check if the delivery mode requires acks & retransmissions
+#define pomelo_delivery_mode_is_reliable(mode)                                 \
+    ((mode) == POMELO_DELIVERY_MODE_RELIABLE ||                                \
+        (mode) == POMELO_DELIVERY_MODE_RELIABLE_UNORDERED)
+
+
 /// @brief The delivery context interface.
 typedef struct pomelo_delivery_context_s pomelo_delivery_context_t;
 
@@ -105,6 +144,35 @@ struct pomelo_delivery_context_root_options_s {
     /// @brief The maximum number of fragments in a parcel
     size_t max_fragments;
 
+    /// @brief The maximum number of reliable parcels in flight per bus. The
+    /// receiving side buffers up to this number of out-of-order parcels.
+    /// Zero for default.
+    size_t reliable_window;
+
+    /// @brief The delay of aggregated ACKs in milliseconds. The fragments of
+    /// reliable parcels received in this duration are acked together by one
+    /// system parcel. Zero to ack every fragment immediately.
+    uint64_t ack_delay_ms;
+
+    /// @brief Whether to coalesce small fragments of an endpoint into shared
+    /// payloads. Coalesced payloads are always unpacked on receiving.
+    bool coalesce;
+
+    /// @brief The maximum delay of coalesced fragments in milliseconds. Zero
+    /// to flush them on the next loop iteration.
+    uint64_t coalesce_delay_ms;
+
+    /// @brief The number of FEC repair fragments sent after every unreliable
+    /// or sequenced parcel of multiple fragments, at most
+    /// POMELO_DELIVERY_FEC_MAX_REPAIRS. Repair fragments are always used on
+    /// receiving. Zero to disable.
+    size_t fec_repairs;
+
+    /// @brief Whether to reassemble the received parcels of multiple
+    /// fragments into one contiguous buffer. The fragments are copied into
+    /// the body as they arrive, so their packets are released right away.
+    bool contiguous_reassembly;
+
     /// @brief Whether to synchronize the context
     bool synchronized;
 };
@@ -138,6 +206,23 @@ struct pomelo_delivery_endpoint_options_s {
 
     /// @brief Whether to sync time. This is for client side.
     bool time_sync;
+
+    /// @brief The congestion control of this endpoint
+    pomelo_congestion_control congestion_control;
+
+    /// @brief The checksum algorithm of multi-fragment parcels. It must match
+    /// the one of the remote endpoint.
+    pomelo_checksum checksum;
+
+    /// @brief The scheduling priorities of buses, nbuses elements. When the
+    /// pacer is constrained, the payloads of buses with higher priorities are
+    /// sent first. NULL for all zeros.
+    uint8_t * bus_priorities;
+
+    /// @brief The scheduling weights of buses, nbuses elements. The buses of
+    /// the same priority share the pacer in proportion to their weights. NULL
+    /// or zero elements for 1.
+    uint32_t * bus_weights;
 };
 
 
@@ -150,6 +235,9 @@ struct pomelo_delivery_sender_options_s {
 
     /// @brief The parcel of this command
     pomelo_delivery_parcel_t * parcel;
+
+    /// @brief The checksum algorithm of multi-fragment parcels
+    pomelo_checksum checksum;
 };
 
 
@@ -159,6 +247,11 @@ struct pomelo_delivery_heartbeat_options_s {
 
     /// @brief Platform
     pomelo_platform_t * platform;
+
+    /// @brief Whether the heartbeat is run by its owner instead of its own
+    /// timer. The owner calls pomelo_delivery_heartbeat_run() at the heartbeat
+    /// frequency, so that the heartbeat shares the schedule of the owner.
+    bool manual;
 };
 
 
@@ -233,6 +326,10 @@ pomelo_delivery_heartbeat_t * pomelo_delivery_heartbeat_create(
 void pomelo_delivery_heartbeat_destroy(pomelo_delivery_heartbeat_t * heartbeat);
 
 
+/// @brief Run the heartbeat of all scheduled endpoints
+void pomelo_delivery_heartbeat_run(pomelo_delivery_heartbeat_t * heartbeat);
+
+
 /* -------------------------------------------------------------------------- */
 /*                                Sender APIs                                 */
 /* -------------------------------------------------------------------------- */
@@ -414,6 +511,16 @@ void pomelo_delivery_parcel_unref(pomelo_delivery_parcel_t * parcel);
 void pomelo_delivery_parcel_reset(pomelo_delivery_parcel_t * parcel);
 
 
+/// @brief Get the read-only body of the parcel without copying
+/// @param length Output length of the body, set in all cases
+/// @return The body, or NULL if the parcel is empty or its content is not
+/// stored contiguously
+const uint8_t * pomelo_delivery_parcel_body(
+    pomelo_delivery_parcel_t * parcel,
+    size_t * length
+);
+
+
 /// @brief Initialize the reader of parcel
 void pomelo_delivery_reader_init(
     pomelo_delivery_reader_t * reader,
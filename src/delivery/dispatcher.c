@@ -8,19 +8,12 @@
 #include "parcel.h"
 #include "context.h"
 #include "sender.h"
+#include "fec.h"
 
 
-/// The minimum parcel resending schedule. The parcel will be resent after
-/// a certain time but not less than this value.
-#define POMELO_REL_MSG_MIN_RESEND_TIME_NS 10000000ULL // 10ms
-
-/// The maximum parcel resending schedule. The parcel will be resent after
-/// a certain time but not greater than this value.
-#define POMELO_REL_MSG_MAX_RESEND_TIME_NS 100000000ULL // 100ms
-
-/// The factor of resending time for reliable parcel:
-/// resend = factor * rtt
-#define POMELO_REL_MSG_RESENT_FACTOR_RTT 1
+/// The number of later acked fragments which marks an unacked fragment as lost
+/// and retransmits it before its timeout (fast retransmit)
+#define POMELO_DELIVERY_FAST_RETRANSMIT_THRESHOLD 3
 
 /// The initial capacity of the fragments array
 #define POMELO_DELIVERY_DISPATCHER_FRAGMENTS_INIT_CAPACITY 16
@@ -95,14 +88,19 @@ int pomelo_delivery_dispatcher_init(
     dispatcher->bus = bus;
     dispatcher->endpoint = bus->endpoint;
     dispatcher->acked_counter = 0;
+    dispatcher->unacked_index = 0;
     dispatcher->mode = info->mode;
     dispatcher->sequence = info->sequence;
     dispatcher->sequencer = endpoint->sequencer;
     dispatcher->flags = 0;
 
     dispatcher->checksum = info->sender->checksum;
+    dispatcher->checksum_bytes = 0;
     if (dispatcher->checksum) {
         pomelo_buffer_ref(dispatcher->checksum);
+        dispatcher->checksum_bytes = pomelo_crypto_checksum_bytes(
+            info->sender->checksum_algorithm
+        );
     }
 
     dispatcher->sender = info->sender;
@@ -117,7 +115,7 @@ int pomelo_delivery_dispatcher_init(
 
     // Check the checksum mode
     pomelo_array_t * chunks = parcel->chunks;
-    if (chunks->size >= 2) {
+    if (dispatcher->checksum) {
         pomelo_buffer_view_t * last_chunk =
             pomelo_array_get_ptr(chunks, chunks->size - 1);
         assert(last_chunk != NULL);
@@ -130,7 +128,7 @@ int pomelo_delivery_dispatcher_init(
             buffer_capacity
         );
         size_t remain = capacity - last_chunk->length;
-        dispatcher->checksum_mode = (remain >= POMELO_CRYPTO_CHECKSUM_BYTES)
+        dispatcher->checksum_mode = (remain >= dispatcher->checksum_bytes)
             ? POMELO_DELIVERY_CHECKSUM_EMBEDDED
             : POMELO_DELIVERY_CHECKSUM_EXTRA;
     } else {
@@ -176,7 +174,7 @@ int pomelo_delivery_dispatcher_init(
 
         // Acquire the checksum buffer
         pomelo_delivery_fragment_attach_buffer(fragment, dispatcher->checksum);
-        fragment->content.length = POMELO_CRYPTO_CHECKSUM_BYTES;
+        fragment->content.length = dispatcher->checksum_bytes;
         fragment->acked = false;
     }
 
@@ -190,6 +188,17 @@ int pomelo_delivery_dispatcher_init(
 
 
     // Add sender to the bus
+    if (pomelo_delivery_bus_ensure_pending_dispatchers(bus) < 0) {
+        return -1; // Failed to create the pending list of bus
+    }
+
+    if (
+        pomelo_delivery_mode_is_reliable(dispatcher->mode) &&
+        pomelo_delivery_bus_ensure_reliable_dispatchers(bus) < 0
+    ) {
+        return -1; // Failed to create the sending window of bus
+    }
+
     if (!pomelo_list_push_back(bus->pending_dispatchers, dispatcher)) {
         return -1; // Failed to add the dispatcher to the bus
     }
@@ -244,6 +253,11 @@ void pomelo_delivery_dispatcher_cancel(
     if (dispatcher->flags & POMELO_DELIVERY_DISPATCHER_FLAG_CANCELED) return;
     dispatcher->flags |= POMELO_DELIVERY_DISPATCHER_FLAG_CANCELED;
 
+    if (pomelo_delivery_mode_is_reliable(dispatcher->mode)) {
+        // Release the slot of sending window
+        pomelo_delivery_bus_remove_dispatcher(dispatcher->bus, dispatcher);
+    }
+
     // Cancel resend timer
     pomelo_platform_timer_stop(
         dispatcher->platform,
@@ -272,51 +286,261 @@ static void on_resend_timer_triggered(
 }
 
 
-void pomelo_delivery_dispatcher_dispatch(
+/// @brief Start the retransmission timer with the current timeout
+static int dispatcher_start_resend_timer(
     pomelo_delivery_dispatcher_t * dispatcher
 ) {
-    assert(dispatcher != NULL);
+    return pomelo_platform_timer_start(
+        dispatcher->platform,
+        (pomelo_platform_timer_entry) on_resend_timer_triggered,
+        POMELO_TIME_NS_TO_MS(dispatcher->rto),
+        0, // No repeat, the timeout is backed off on every trigger
+        dispatcher,
+        &dispatcher->resend_timer
+    );
+}
 
-    pomelo_delivery_bus_t * bus = dispatcher->bus;
-    pomelo_delivery_endpoint_t * endpoint = bus->endpoint;
 
-    // Send the parcel first time
-    int ret = pomelo_delivery_dispatcher_send(dispatcher);
-    if (ret < 0) {
-        // Failed to dispatch the parcel
-        dispatcher->flags |= POMELO_DELIVERY_DISPATCHER_FLAG_FAILED;
-        pomelo_pipeline_finish(&dispatcher->pipeline);
-        return;
+/// @brief Get the views of the content of a fragment, without its meta
+/// @param views The output views, at least 2 views
+/// @return The number of views
+static size_t dispatcher_fragment_views(
+    pomelo_delivery_dispatcher_t * dispatcher,
+    size_t index,
+    pomelo_buffer_view_t * views
+) {
+    pomelo_array_t * fragments = dispatcher->fragments;
+    pomelo_delivery_fragment_t * fragment =
+        pomelo_array_get_ptr(fragments, index);
+    assert(fragment != NULL);
+
+    views[0] = fragment->content;
+    if (
+        index == fragments->size - 1 &&
+        dispatcher->checksum_mode == POMELO_DELIVERY_CHECKSUM_EMBEDDED
+    ) {
+        // Send checksum along with the last fragment
+        pomelo_buffer_view_t * view_checksum = &views[1];
+        view_checksum->buffer = dispatcher->checksum;
+        view_checksum->offset = 0;
+        view_checksum->length = dispatcher->checksum_bytes;
+        return 2;
     }
 
-    if (dispatcher->mode != POMELO_DELIVERY_MODE_RELIABLE) {
-        // Other modes than reliable do not need to resend, next stage
-        pomelo_pipeline_next(&dispatcher->pipeline);
-        return;
+    return 1;
+}
+
+
+/// @brief Send a single fragment of the parcel
+static int dispatcher_send_fragment(
+    pomelo_delivery_dispatcher_t * dispatcher,
+    size_t index,
+    uint64_t time
+) {
+    pomelo_buffer_view_t views[3];
+    pomelo_buffer_context_t * buffer_context =
+        dispatcher->context->buffer_context;
+
+    pomelo_array_t * fragments = dispatcher->fragments;
+    pomelo_delivery_fragment_t * fragment =
+        pomelo_array_get_ptr(fragments, index);
+    assert(fragment != NULL);
+
+    // Build the meta of the fragment
+    pomelo_delivery_fragment_meta_t meta;
+    meta.bus_id = dispatcher->bus->id;
+    meta.sequence = dispatcher->sequence;
+    meta.type = pomelo_delivery_fragment_type_from_mode(dispatcher->mode);
+    meta.last_index = fragments->size - 1;
+    meta.fragment_index = index;
+
+    // Acquire new buffer for the meta
+    pomelo_buffer_t * buffer_meta =
+        pomelo_buffer_context_acquire(buffer_context);
+    if (!buffer_meta) return -1; // Failed to acquire buffer
+    views[0].buffer = buffer_meta;
+    views[0].offset = 0;
+    views[0].length = 0;
+
+    int ret = pomelo_delivery_fragment_meta_encode(&meta, &views[0]);
+    if (ret < 0) {
+        pomelo_buffer_unref(buffer_meta);
+        return ret; // Failed to build the meta
     }
 
-    // Setup resent timer
-    uint64_t rtt_mean = 0;
-    pomelo_delivery_endpoint_rtt(endpoint, &rtt_mean, NULL);
+    size_t view_count =
+        1 + dispatcher_fragment_views(dispatcher, index, views + 1);
+
+    ret = pomelo_delivery_endpoint_transmit(
+        dispatcher->endpoint,
+        dispatcher->bus,
+        views,
+        view_count
+    );
+
+    // Finally, unref the meta buffer
+    pomelo_buffer_unref(buffer_meta);
+    if (ret < 0) return ret; // Failed to send the fragment
+
+    fragment->transmissions++;
+    fragment->later_acks = 0;
+    fragment->sent_time = (ret > 0)
+        ? POMELO_DELIVERY_FRAGMENT_SENT_TIME_QUEUED // Stamped when emitted
+        : time;
+    return 0;
+}
+
+
+/// @brief Build and send a FEC repair fragment of the parcel
+static int dispatcher_send_repair(
+    pomelo_delivery_dispatcher_t * dispatcher,
+    size_t repair_index,
+    size_t symbol_length
+) {
+    pomelo_delivery_context_t * context = dispatcher->context;
+    pomelo_array_t * fragments = dispatcher->fragments;
+    size_t nsources = fragments->size;
+
+    pomelo_delivery_fragment_meta_t meta;
+    meta.bus_id = dispatcher->bus->id;
+    meta.sequence = dispatcher->sequence;
+    meta.type = pomelo_delivery_fragment_type_from_mode(dispatcher->mode);
+    meta.last_index = nsources - 1;
+    meta.fragment_index = nsources + repair_index;
+
+    pomelo_buffer_t * buffer =
+        pomelo_buffer_context_acquire(context->buffer_context);
+    if (!buffer) return -1; // Failed to acquire buffer
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = 0;
+
+    int ret = pomelo_delivery_fragment_meta_encode(&meta, &view);
+    if (ret < 0) {
+        pomelo_buffer_unref(buffer);
+        return -1; // Failed to encode the meta
+    }
 
-    // Set a resending schedule
-    uint64_t time_ns = rtt_mean * POMELO_REL_MSG_RESENT_FACTOR_RTT;
-    if (time_ns < POMELO_REL_MSG_MIN_RESEND_TIME_NS) {
-        time_ns = POMELO_REL_MSG_MIN_RESEND_TIME_NS;
-    } else if (time_ns > POMELO_REL_MSG_MAX_RESEND_TIME_NS) {
-        time_ns = POMELO_REL_MSG_MAX_RESEND_TIME_NS;
+    // The repair fragment must fit in a single payload
+    size_t length = view.length + symbol_length;
+    size_t capacity = context->fragment_content_capacity +
+        POMELO_MAX_FRAGMENT_META_DATA_BYTES;
+    if (length > capacity || length > buffer->capacity) {
+        pomelo_buffer_unref(buffer);
+        return -1; // The symbols are too long
     }
 
-    uint64_t time_ms = POMELO_TIME_NS_TO_MS(time_ns);
+    uint8_t * symbol = buffer->data + view.length;
+    memset(symbol, 0, symbol_length);
 
-    ret = pomelo_platform_timer_start(
-        dispatcher->platform,
-        (pomelo_platform_timer_entry) on_resend_timer_triggered,
-        time_ms,
-        time_ms, // With repeat
-        dispatcher,
-        &dispatcher->resend_timer
+    pomelo_buffer_view_t views[2];
+    uint8_t header[POMELO_DELIVERY_FEC_HEADER_BYTES];
+    for (size_t i = 0; i < nsources; i++) {
+        uint8_t coef =
+            pomelo_delivery_fec_coefficient(nsources, repair_index, i);
+        size_t nviews = dispatcher_fragment_views(dispatcher, i, views);
+
+        size_t fragment_length = 0;
+        for (size_t k = 0; k < nviews; k++) {
+            fragment_length += views[k].length;
+        }
+
+        pomelo_payload_t payload;
+        payload.data = header;
+        payload.capacity = sizeof(header);
+        payload.position = 0;
+        pomelo_payload_write_uint16_unsafe(
+            &payload,
+            (uint16_t) fragment_length
+        );
+        pomelo_delivery_fec_mul_add(symbol, header, sizeof(header), coef);
+
+        size_t offset = sizeof(header);
+        for (size_t k = 0; k < nviews; k++) {
+            pomelo_delivery_fec_mul_add(
+                symbol + offset,
+                views[k].buffer->data + views[k].offset,
+                views[k].length,
+                coef
+            );
+            offset += views[k].length;
+        }
+    }
+
+    view.length = length;
+    ret = pomelo_delivery_endpoint_transmit(
+        dispatcher->endpoint,
+        dispatcher->bus,
+        &view,
+        1
     );
+    pomelo_buffer_unref(buffer);
+    return ret;
+}
+
+
+/// @brief Send the FEC repair fragments of the parcel
+static void dispatcher_send_repairs(pomelo_delivery_dispatcher_t * dispatcher) {
+    size_t nrepairs = dispatcher->context->fec_repairs;
+    pomelo_array_t * fragments = dispatcher->fragments;
+    size_t nsources = fragments->size;
+
+    if (nrepairs == 0 || nsources < 2) return; // Nothing to repair
+    if (nsources + nrepairs > POMELO_DELIVERY_FEC_MAX_SYMBOLS) {
+        return; // Too many fragments for the code
+    }
+
+    // The symbols are padded to the longest fragment
+    pomelo_buffer_view_t views[2];
+    size_t max_length = 0;
+    for (size_t i = 0; i < nsources; i++) {
+        size_t nviews = dispatcher_fragment_views(dispatcher, i, views);
+        size_t length = 0;
+        for (size_t k = 0; k < nviews; k++) {
+            length += views[k].length;
+        }
+        max_length = POMELO_MAX(max_length, length);
+    }
+    size_t symbol_length = POMELO_DELIVERY_FEC_HEADER_BYTES + max_length;
+
+    for (size_t j = 0; j < nrepairs; j++) {
+        // Repair fragments are best effort, like the parcel itself
+        int ret = dispatcher_send_repair(dispatcher, j, symbol_length);
+        if (ret < 0) return;
+    }
+}
+
+
+void pomelo_delivery_dispatcher_dispatch(
+    pomelo_delivery_dispatcher_t * dispatcher
+) {
+    assert(dispatcher != NULL);
+
+    // Send the parcel first time
+    int ret = pomelo_delivery_dispatcher_send(dispatcher);
+    if (!pomelo_delivery_mode_is_reliable(dispatcher->mode)) {
+        if (ret < 0) {
+            // Failed to dispatch the parcel
+            dispatcher->flags |= POMELO_DELIVERY_DISPATCHER_FLAG_FAILED;
+            pomelo_pipeline_finish(&dispatcher->pipeline);
+            return;
+        }
+
+        // Other modes than reliable do not need to resend, but can be
+        // repaired by the receiver
+        dispatcher_send_repairs(dispatcher);
+        pomelo_pipeline_next(&dispatcher->pipeline);
+        return;
+    }
+
+    // A failed reliable sending is retried by the resend timer. Dropping it
+    // would leave a hole in the reliable sequences of the receiving window.
+
+    // Setup the retransmission timer with the latest estimated timeout
+    dispatcher->rto = dispatcher->endpoint->rto.rto;
+    ret = dispatcher_start_resend_timer(dispatcher);
     if (ret < 0) {
         // Failed to start timer
         dispatcher->flags |= POMELO_DELIVERY_DISPATCHER_FLAG_FAILED;
@@ -328,23 +552,10 @@ void pomelo_delivery_dispatcher_dispatch(
 
 int pomelo_delivery_dispatcher_send(pomelo_delivery_dispatcher_t * dispatcher) {
     assert(dispatcher != NULL);
-    pomelo_buffer_view_t views[3];
-
-    pomelo_delivery_endpoint_t * endpoint = dispatcher->endpoint;
-    pomelo_buffer_context_t * buffer_context =
-        dispatcher->context->buffer_context;
 
-    // Get the last fragment
+    uint64_t time = pomelo_platform_hrtime(dispatcher->platform);
     pomelo_array_t * fragments = dispatcher->fragments;
     size_t nfragments = fragments->size;
-    size_t last_fragment_index = nfragments - 1;
-
-    // Build the meta of the fragments
-    pomelo_delivery_fragment_meta_t meta;
-    meta.bus_id = dispatcher->bus->id;
-    meta.sequence = dispatcher->sequence;
-    meta.type = pomelo_delivery_fragment_type_from_mode(dispatcher->mode);
-    meta.last_index = nfragments - 1;
 
     for (size_t i = 0; i < nfragments; i++) {
         pomelo_delivery_fragment_t * fragment =
@@ -352,45 +563,8 @@ int pomelo_delivery_dispatcher_send(pomelo_delivery_dispatcher_t * dispatcher) {
         assert(fragment != NULL);
         if (fragment->acked) continue; // Ignore acked fragments
 
-        // Acquire new buffer for the meta
-        pomelo_buffer_t * buffer_meta =
-            pomelo_buffer_context_acquire(buffer_context);
-        if (!buffer_meta) return -1; // Failed to acquire buffer
-        views[0].buffer = buffer_meta;
-        views[0].offset = 0;
-        views[0].length = 0;
-
-        // Build the meta
-        meta.fragment_index = i;
-        int ret = pomelo_delivery_fragment_meta_encode(&meta, &views[0]);
-        if (ret < 0) {
-            pomelo_buffer_unref(buffer_meta);
-            return ret; // Failed to build the meta
-        }
-
-        views[1] = fragment->content;
-        size_t view_count = 2;
-
-        if (
-            i == last_fragment_index &&
-            dispatcher->checksum_mode == POMELO_DELIVERY_CHECKSUM_EMBEDDED
-        ) {
-            // Send checksum along with the last fragment
-            pomelo_buffer_view_t * view_checksum = &views[2];
-            view_checksum->buffer = dispatcher->checksum;
-            view_checksum->offset = 0;
-            view_checksum->length = POMELO_CRYPTO_CHECKSUM_BYTES;
-            view_count = 3;
-        }
-
-        ret = pomelo_delivery_endpoint_send(endpoint, views, view_count);
-        if (ret < 0) {
-            pomelo_buffer_unref(buffer_meta); // Unref the meta buffer
-            return ret; // Failed to send the fragment
-        }
-
-        // Finally, unref the meta buffer
-        pomelo_buffer_unref(buffer_meta);
+        int ret = dispatcher_send_fragment(dispatcher, i, time);
+        if (ret < 0) return ret; // Failed to send the fragment
     }
 
     return 0;
@@ -402,8 +576,50 @@ void pomelo_delivery_dispatcher_resend(
 ) {
     assert(dispatcher != NULL);
 
-    int ret = pomelo_delivery_dispatcher_send(dispatcher);
+    uint64_t time = pomelo_platform_hrtime(dispatcher->platform);
+    pomelo_array_t * fragments = dispatcher->fragments;
+    size_t nfragments = fragments->size;
+    pomelo_delivery_context_root_t * root = dispatcher->context->root;
+    pomelo_delivery_congestion_t * congestion =
+        &dispatcher->endpoint->congestion;
+    bool timed_out = false;
+
+    for (size_t i = 0; i < nfragments; i++) {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(fragments, i);
+        assert(fragment != NULL);
+        if (fragment->acked) continue; // Ignore acked fragments
+        if (fragment->sent_time == POMELO_DELIVERY_FRAGMENT_SENT_TIME_QUEUED) {
+            continue; // Still waiting in the endpoint
+        }
+
+        // Fragments which have been fast retransmitted recently have not
+        // timed out yet
+        uint64_t deadline = fragment->sent_time + dispatcher->rto;
+        if (deadline > time + POMELO_DELIVERY_RTO_GRANULARITY_NS) continue;
+
+        if (!timed_out) {
+            timed_out = true;
+            pomelo_delivery_congestion_on_timeout(
+                congestion,
+                fragment->sent_time,
+                time
+            );
+        }
+
+        // Failures are ignored, the fragment will be resent on next trigger
+        if (dispatcher_send_fragment(dispatcher, i, time) == 0) {
+            pomelo_atomic_uint64_fetch_add(&root->retransmitted_fragments, 1);
+        }
+    }
+
+    // Exponential backoff, only when something has timed out
+    if (timed_out) {
+        dispatcher->rto = pomelo_delivery_rto_backoff(dispatcher->rto);
+    }
+    int ret = dispatcher_start_resend_timer(dispatcher);
     if (ret < 0) {
+        // Failed to start timer
         dispatcher->flags |= POMELO_DELIVERY_DISPATCHER_FLAG_FAILED;
         pomelo_pipeline_finish(&dispatcher->pipeline);
     }
@@ -412,25 +628,80 @@ void pomelo_delivery_dispatcher_resend(
 
 void pomelo_delivery_dispatcher_recv_ack(
     pomelo_delivery_dispatcher_t * dispatcher,
-    pomelo_delivery_fragment_meta_t * meta
+    size_t fragment_index
 ) {
     assert(dispatcher != NULL);
-    assert(meta != NULL);
 
     // The command must be reliable
-    if (dispatcher->mode != POMELO_DELIVERY_MODE_RELIABLE) return;
+    if (!pomelo_delivery_mode_is_reliable(dispatcher->mode)) return;
 
     pomelo_array_t * fragments = dispatcher->fragments;
     pomelo_delivery_fragment_t * fragment =
-        pomelo_array_get_ptr(fragments, meta->fragment_index);
+        pomelo_array_get_ptr(fragments, fragment_index);
     if (!fragment) return; // The fragment does not exist
     if (fragment->acked) return; // The fragment has already been acked
+    if (fragment->transmissions == 0) return; // The fragment has not been sent
 
     // Mark the fragment as acked
     fragment->acked = true;
     dispatcher->acked_counter++;
 
+    // Skip the acked fragments at front
+    while (dispatcher->unacked_index < fragments->size) {
+        pomelo_delivery_fragment_t * front =
+            pomelo_array_get_ptr(fragments, dispatcher->unacked_index);
+        if (!front->acked) break;
+        dispatcher->unacked_index++;
+    }
+
+    // Only the fragments which have been sent once give unambiguous RTT
+    // samples (Karn's algorithm)
+    pomelo_delivery_endpoint_t * endpoint = dispatcher->endpoint;
+    uint64_t time = pomelo_platform_hrtime(dispatcher->platform);
+    if (fragment->transmissions == 1) {
+        pomelo_delivery_rto_submit(&endpoint->rto, time - fragment->sent_time);
+
+        // The ACKs of busy endpoints sample the RTT, so they skip pings
+        endpoint->rtt_sample_time = time;
+    }
+
+    // Grow the congestion window
+    pomelo_delivery_congestion_on_acked(
+        &endpoint->congestion,
+        fragment->content.length,
+        time
+    );
+
+    // The earlier fragments of this parcel & the earlier reliable parcels of
+    // the bus which are still unacked might be lost. Like RACK, only the ACKs
+    // of the latest sent fragments count, the ACKs of reordered earlier ones
+    // would visit the same fragments again.
+    pomelo_delivery_bus_t * bus = dispatcher->bus;
+    uint64_t sent_time = fragment->sent_time;
+    if (sent_time != POMELO_DELIVERY_FRAGMENT_SENT_TIME_QUEUED &&
+        sent_time >= bus->reliable_acked_sent_time
+    ) {
+        bus->reliable_acked_sent_time = sent_time;
+        pomelo_delivery_dispatcher_recv_later_ack(
+            dispatcher,
+            fragment_index,
+            sent_time
+        );
+        pomelo_delivery_bus_recv_later_ack(
+            bus,
+            dispatcher->sequence,
+            sent_time
+        );
+    }
+
     if (dispatcher->acked_counter < fragments->size) {
+        // New progress, restart the timer without backoff
+        dispatcher->rto = endpoint->rto.rto;
+        pomelo_platform_timer_stop(
+            dispatcher->platform,
+            &dispatcher->resend_timer
+        );
+        dispatcher_start_resend_timer(dispatcher);
         return; // Not enough acked fragments
     }
 
@@ -439,6 +710,54 @@ void pomelo_delivery_dispatcher_recv_ack(
 }
 
 
+void pomelo_delivery_dispatcher_recv_later_ack(
+    pomelo_delivery_dispatcher_t * dispatcher,
+    size_t end,
+    uint64_t sent_time
+) {
+    assert(dispatcher != NULL);
+
+    pomelo_array_t * fragments = dispatcher->fragments;
+    if (end > fragments->size) {
+        end = fragments->size;
+    }
+
+    uint64_t time = 0;
+    pomelo_delivery_context_root_t * root = dispatcher->context->root;
+
+    for (size_t i = dispatcher->unacked_index; i < end; i++) {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(fragments, i);
+        assert(fragment != NULL);
+        if (fragment->acked || fragment->transmissions == 0) continue;
+
+        // Only the fragments sent before the acked one might be lost
+        if (fragment->sent_time > sent_time) continue;
+
+        fragment->later_acks++;
+        if (fragment->later_acks != POMELO_DELIVERY_FAST_RETRANSMIT_THRESHOLD) {
+            continue;
+        }
+
+        // The fragment is considered lost, retransmit it now
+        if (time == 0) {
+            time = pomelo_platform_hrtime(dispatcher->platform);
+        }
+        pomelo_delivery_congestion_on_lost(
+            &dispatcher->endpoint->congestion,
+            fragment->sent_time,
+            time
+        );
+        if (dispatcher_send_fragment(dispatcher, i, time) == 0) {
+            pomelo_atomic_uint64_fetch_add(
+                &root->fast_retransmitted_fragments,
+                1
+            );
+        }
+    }
+}
+
+
 void pomelo_delivery_dispatcher_complete(
     pomelo_delivery_dispatcher_t * dispatcher
 ) {
@@ -62,6 +62,10 @@ struct pomelo_delivery_dispatcher_s {
     /// @brief The number of acknowledged fragments
     size_t acked_counter;
 
+    /// @brief The index of the first fragment which has not been acked. The
+    /// later ACKs only visit the fragments from here.
+    size_t unacked_index;
+
     /// @brief The delivery mode of this parcel
     pomelo_delivery_mode mode;
 
@@ -77,6 +81,10 @@ struct pomelo_delivery_dispatcher_s {
     /// @brief The resend task
     pomelo_sequencer_task_t resend_task;
 
+    /// @brief The current retransmission timeout with backoff in nanoseconds
+    /// (reliable only)
+    uint64_t rto;
+
     /// @brief The flags of this command
     uint32_t flags;
 
@@ -86,6 +94,9 @@ struct pomelo_delivery_dispatcher_s {
     /// @brief The buffer for checksum
     pomelo_buffer_t * checksum;
 
+    /// @brief The number of checksum bytes
+    size_t checksum_bytes;
+
     /// @brief The sender of this command
     pomelo_delivery_sender_t * sender;
 
@@ -170,10 +181,20 @@ void pomelo_delivery_dispatcher_resend(
 );
 
 
-/// @brief Submit ack response to sending command
+/// @brief Submit ack response of a fragment to sending command
 void pomelo_delivery_dispatcher_recv_ack(
     pomelo_delivery_dispatcher_t * dispatcher,
-    pomelo_delivery_fragment_meta_t * meta
+    size_t fragment_index
+);
+
+
+/// @brief Process a newly acked fragment which was sent after the unacked
+/// fragments [unacked_index, end) of this dispatcher. Fragments which have been passed by
+/// enough later ACKs are retransmitted before their timeout.
+void pomelo_delivery_dispatcher_recv_later_ack(
+    pomelo_delivery_dispatcher_t * dispatcher,
+    size_t end,
+    uint64_t sent_time
 );
 
 
@@ -6,7 +6,10 @@
 #include "parcel.h"
 #include "context.h"
 #include "sender.h"
+#include "receiver.h"
+#include "fec.h"
 #define POMELO_DELIVERY_ENDPOINT_DEFAULT_BUSES_CAPACITY 16
+#define POMELO_DELIVERY_ENDPOINT_DEFAULT_ACKS_CAPACITY 16
 
 
 pomelo_delivery_endpoint_t * pomelo_delivery_endpoint_create(
@@ -59,37 +62,85 @@ pomelo_delivery_bus_t * pomelo_delivery_endpoint_get_bus(
 }
 
 
-int pomelo_delivery_endpoint_recv(
+/// @brief Check if the fragment meta is the header of a coalesced payload
+static bool is_coalesced_header(pomelo_delivery_fragment_meta_t * meta) {
+    return meta->bus_id == 0 &&
+        meta->type == POMELO_FRAGMENT_TYPE_DATA_UNRELIABLE &&
+        meta->sequence == 0;
+}
+
+
+/// @brief Drop all paced payloads
+static void endpoint_drop_paced(pomelo_delivery_endpoint_t * endpoint) {
+    pomelo_platform_timer_stop(endpoint->platform, &endpoint->pacer_timer);
+    endpoint->flags &= ~POMELO_DELIVERY_ENDPOINT_FLAG_PACER_SCHEDULED;
+
+    pomelo_delivery_bus_t * bus = NULL;
+    pomelo_buffer_view_t view;
+    while (pomelo_list_pop_front(endpoint->pacer_buses, &bus) == 0) {
+        while (pomelo_list_pop_front(bus->pacer_queue, &view) == 0) {
+            pomelo_buffer_unref(view.buffer);
+        }
+        bus->pacer_entry = NULL;
+        bus->deficit = 0;
+    }
+    endpoint->pacer_count = 0;
+}
+
+
+/// @brief Dispatch the decoded fragment to its bus
+static int endpoint_recv_fragment(
     pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_fragment_meta_t * meta,
     pomelo_buffer_view_t * view
 ) {
-    assert(endpoint != NULL);
-    assert(view != NULL);
-
-    // Decode the meta
-    pomelo_delivery_fragment_meta_t meta;
-    int ret = pomelo_delivery_fragment_meta_decode(&meta, view);
-    if (ret < 0) return ret; // Failed to decode the meta
-    // View is now at the beginning of the content
-
-    if (meta.last_index >= endpoint->context->max_fragments)  {
+    if (meta->last_index >= endpoint->context->max_fragments)  {
         return -1; // Exceed the maximum number of fragments
     }
 
+    if (meta->fragment_index > meta->last_index) {
+        // FEC repair fragment
+        size_t repair_index = meta->fragment_index - meta->last_index - 1;
+        if (repair_index >= POMELO_DELIVERY_FEC_MAX_REPAIRS) {
+            return -1; // Invalid repair fragment index
+        }
+    }
+
     // Get the bus
     pomelo_delivery_bus_t * bus = NULL;
-    if (meta.bus_id == 0) {
+    if (meta->bus_id == 0) {
         bus = endpoint->system_bus;
     } else {
         if (!(endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_READY)) {
             return -1; // Endpoint is not ready
         }
 
-        ret = pomelo_array_get(endpoint->buses, meta.bus_id - 1, &bus);
+        int ret = pomelo_array_get(endpoint->buses, meta->bus_id - 1, &bus);
         if (ret < 0 || !bus) return -1; // Failed to get bus
     }
 
-    return pomelo_delivery_bus_recv(bus, &meta, view);
+    return pomelo_delivery_bus_recv(bus, meta, view);
+}
+
+
+int pomelo_delivery_endpoint_recv(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * view
+) {
+    assert(endpoint != NULL);
+    assert(view != NULL);
+
+    // Decode the meta
+    pomelo_delivery_fragment_meta_t meta;
+    int ret = pomelo_delivery_fragment_meta_decode(&meta, view);
+    if (ret < 0) return ret; // Failed to decode the meta
+    // View is now at the beginning of the content
+
+    if (is_coalesced_header(&meta)) {
+        return pomelo_delivery_endpoint_recv_coalesced(endpoint, view);
+    }
+
+    return endpoint_recv_fragment(endpoint, &meta, view);
 }
 
 
@@ -129,6 +180,21 @@ int pomelo_delivery_endpoint_on_alloc(
     endpoint->buses = pomelo_array_create(&array_options);
     if (!endpoint->buses) return -1;
 
+    // Create array of pending ACKs
+    array_options.element_size = sizeof(pomelo_delivery_ack_t);
+    array_options.initial_capacity =
+        POMELO_DELIVERY_ENDPOINT_DEFAULT_ACKS_CAPACITY;
+    endpoint->acks = pomelo_array_create(&array_options);
+    if (!endpoint->acks) return -1;
+
+    // Create the list of pacing buses
+    pomelo_list_options_t list_options = {
+        .allocator = context->allocator,
+        .element_size = sizeof(pomelo_delivery_bus_t *)
+    };
+    endpoint->pacer_buses = pomelo_list_create(&list_options);
+    if (!endpoint->pacer_buses) return -1;
+
     return 0;
 }
 
@@ -141,6 +207,16 @@ void pomelo_delivery_endpoint_on_free(pomelo_delivery_endpoint_t * endpoint) {
         pomelo_array_destroy(endpoint->buses);
         endpoint->buses = NULL;
     }
+
+    if (endpoint->acks) {
+        pomelo_array_destroy(endpoint->acks);
+        endpoint->acks = NULL;
+    }
+
+    if (endpoint->pacer_buses) {
+        pomelo_list_destroy(endpoint->pacer_buses);
+        endpoint->pacer_buses = NULL;
+    }
 }
 
 
@@ -160,6 +236,8 @@ int pomelo_delivery_endpoint_init(
     endpoint->sequencer = info->sequencer;
     endpoint->heartbeat = info->heartbeat;
     endpoint->flags = 0;
+    endpoint->last_send_time = 0;
+    endpoint->rtt_sample_time = 0;
 
     // Initialize the stop task
     pomelo_sequencer_task_init(
@@ -189,13 +267,56 @@ int pomelo_delivery_endpoint_init(
         endpoint
     );
 
+    // Initialize the ACK task
+    pomelo_sequencer_task_init(
+        &endpoint->ack_task,
+        (pomelo_sequencer_callback) pomelo_delivery_endpoint_flush_acks,
+        endpoint
+    );
+    pomelo_array_clear(endpoint->acks);
+
+    // Initialize the coalesce task
+    pomelo_sequencer_task_init(
+        &endpoint->coalesce_task,
+        (pomelo_sequencer_callback) pomelo_delivery_endpoint_flush_coalesced,
+        endpoint
+    );
+    endpoint->coalesce_buffer = NULL;
+    endpoint->coalesce_length = 0;
+    endpoint->coalesce_count = 0;
+    endpoint->coalesce_bus = NULL;
+
+    // Initialize the pacer task
+    pomelo_sequencer_task_init(
+        &endpoint->pacer_task,
+        (pomelo_sequencer_callback) pomelo_delivery_endpoint_flush_paced,
+        endpoint
+    );
+    endpoint->pacer_count = 0;
+    endpoint->pacer_tokens = 0;
+    endpoint->pacer_time = 0;
+
+    // Initialize the congestion controller
+    int ret = pomelo_delivery_congestion_init(
+        &endpoint->congestion,
+        info->congestion_control,
+        &endpoint->rto,
+        context->fragment_content_capacity + POMELO_MAX_FRAGMENT_META_DATA_BYTES
+    );
+    if (ret < 0) return -1; // Invalid congestion control
+
+    if (info->checksum >= POMELO_CHECKSUM_COUNT) {
+        return -1; // Invalid checksum algorithm
+    }
+    endpoint->checksum = info->checksum;
+
     // Set time sync flag
     if (info->time_sync) {
         endpoint->flags |= POMELO_DELIVERY_ENDPOINT_FLAG_TIME_SYNC;
     }
 
     // Resize bus array
-    int ret = pomelo_array_resize(endpoint->buses, info->nbuses);
+    ret = pomelo_array_resize(endpoint->buses, info->nbuses);
     if (ret < 0) return ret; // Failed to resize the bus array
     pomelo_array_fill_zero(endpoint->buses); // Fill the bus array with zeros
 
@@ -205,7 +326,9 @@ int pomelo_delivery_endpoint_init(
     for (size_t i = 0; i < nbuses; i++) {
         pomelo_delivery_bus_info_t bus_info = {
             .endpoint = endpoint,
-            .id = i + 1 // ID 0 is reserved for the system bus
+            .id = i + 1, // ID 0 is reserved for the system bus
+            .priority = info->bus_priorities ? info->bus_priorities[i] : 0,
+            .weight = info->bus_weights ? info->bus_weights[i] : 1
         };
         pomelo_delivery_bus_t * bus = pomelo_pool_acquire(bus_pool, &bus_info);
         if (!bus) return -1; // Failed to acquire the bus
@@ -216,7 +339,9 @@ int pomelo_delivery_endpoint_init(
     // Acquire and initialize the system bus
     pomelo_delivery_bus_info_t bus_info = {
         .endpoint = endpoint,
-        .id = 0 // ID 0 is reserved for the system bus
+        .id = 0, // ID 0 is reserved for the system bus
+        .priority = POMELO_DELIVERY_BUS_PRIORITY_SYSTEM,
+        .weight = 1
     };
     endpoint->system_bus = pomelo_pool_acquire(bus_pool, &bus_info);
     if (!endpoint->system_bus) return -1; // Failed to acquire the system bus
@@ -224,6 +349,9 @@ int pomelo_delivery_endpoint_init(
     // Initialize the rtt
     pomelo_rtt_calculator_init(&endpoint->rtt);
 
+    // Initialize the retransmission timeout
+    pomelo_delivery_rto_init(&endpoint->rto);
+
     // Initialize the clock
     pomelo_delivery_clock_init(&endpoint->clock, endpoint->platform);
 
@@ -234,6 +362,9 @@ int pomelo_delivery_endpoint_init(
 void pomelo_delivery_endpoint_cleanup(pomelo_delivery_endpoint_t * endpoint) {
     assert(endpoint != NULL);
 
+    // Drop the paced payloads, they are queued in the buses
+    endpoint_drop_paced(endpoint);
+
     // Release all buses of the endpoint
     pomelo_pool_t * bus_pool = endpoint->context->bus_pool;
     size_t nbuses = endpoint->buses->size;
@@ -253,6 +384,18 @@ void pomelo_delivery_endpoint_cleanup(pomelo_delivery_endpoint_t * endpoint) {
 
     // Stop the heartbeat
     pomelo_delivery_heartbeat_unschedule(endpoint->heartbeat, endpoint);
+
+    // Stop the ACK timer
+    pomelo_platform_timer_stop(endpoint->platform, &endpoint->ack_timer);
+    pomelo_array_clear(endpoint->acks);
+
+    // Drop the coalesced payload
+    pomelo_platform_timer_stop(endpoint->platform, &endpoint->coalesce_timer);
+    if (endpoint->coalesce_buffer) {
+        pomelo_buffer_unref(endpoint->coalesce_buffer);
+        endpoint->coalesce_buffer = NULL;
+    }
+    endpoint->coalesce_bus = NULL;
 }
 
 
@@ -355,7 +498,8 @@ void pomelo_delivery_endpoint_send_ping_ex(
     pomelo_delivery_sender_options_t options = {
         .context = endpoint->context,
         .platform = endpoint->platform,
-        .parcel = parcel
+        .parcel = parcel,
+        .checksum = endpoint->checksum
     };
     pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
     if (!sender) return; // Failed to create the sender
@@ -473,7 +617,8 @@ void pomelo_delivery_endpoint_send_pong_ex(
     pomelo_delivery_sender_options_t options = {
         .context = endpoint->context,
         .platform = endpoint->platform,
-        .parcel = parcel
+        .parcel = parcel,
+        .checksum = endpoint->checksum
     };
     pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
     if (!sender) return; // Failed to create the sender
@@ -522,6 +667,10 @@ void pomelo_delivery_endpoint_recv_system_parcel(
             pomelo_delivery_endpoint_recv_pong(endpoint, meta_byte, &reader);
             break;
 
+        case POMELO_DELIVERY_OPCODE_ACK:
+            pomelo_delivery_endpoint_recv_ack(endpoint, meta_byte, &reader);
+            break;
+
         default:
             break;
     }
@@ -633,6 +782,8 @@ void pomelo_delivery_endpoint_recv_pong(
         recv_time,
         0 // Currently, req_recv_time and res_send_time are the same
     );
+    pomelo_delivery_rto_submit(&endpoint->rto, recv_time - entry->time);
+    endpoint->rtt_sample_time = recv_time;
 
     // Update the clock
     if (endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_TIME_SYNC) {
@@ -651,8 +802,814 @@ void pomelo_delivery_endpoint_recv_pong(
 }
 
 
+/// @brief Handle the ACK timer triggered event
+static void on_ack_timer_triggered(pomelo_delivery_endpoint_t * endpoint) {
+    assert(endpoint != NULL);
+    pomelo_sequencer_submit(endpoint->sequencer, &endpoint->ack_task);
+    // => pomelo_delivery_endpoint_flush_acks()
+}
+
+
+int pomelo_delivery_endpoint_queue_ack(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_fragment_meta_t * meta
+) {
+    assert(endpoint != NULL);
+    assert(meta != NULL);
+
+    // Fragments of the same parcel usually come together, check the most
+    // recent ACK first
+    pomelo_array_t * acks = endpoint->acks;
+    for (size_t i = acks->size; i > 0; i--) {
+        pomelo_delivery_ack_t * ack = pomelo_array_get_ptr(acks, i - 1);
+        assert(ack != NULL);
+        if (ack->bus_id == meta->bus_id && ack->sequence == meta->sequence) {
+            return 0; // Already queued
+        }
+    }
+
+    pomelo_delivery_ack_t * ack = pomelo_array_append_ptr(acks, NULL);
+    if (!ack) return -1; // Failed to append new ACK
+    ack->bus_id = meta->bus_id;
+    ack->sequence = meta->sequence;
+    ack->last_index = meta->last_index;
+
+    if (endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_ACK_SCHEDULED) {
+        return 0; // The ACKs will be flushed by the scheduled timer
+    }
+
+    int ret = pomelo_platform_timer_start(
+        endpoint->platform,
+        (pomelo_platform_timer_entry) on_ack_timer_triggered,
+        endpoint->context->ack_delay_ms,
+        0, // No repeat
+        endpoint,
+        &endpoint->ack_timer
+    );
+    if (ret < 0) {
+        // Failed to start timer, take the ACK back
+        pomelo_array_resize(acks, acks->size - 1);
+        return -1;
+    }
+
+    endpoint->flags |= POMELO_DELIVERY_ENDPOINT_FLAG_ACK_SCHEDULED;
+    return 0;
+}
+
+
+/// @brief Submit the system parcel to the system bus
+static void submit_system_parcel(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_parcel_t * parcel
+) {
+    pomelo_delivery_sender_options_t options = {
+        .context = endpoint->context,
+        .platform = endpoint->platform,
+        .parcel = parcel,
+        .checksum = endpoint->checksum
+    };
+    pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
+    if (!sender) return; // Failed to create the sender
+
+    // Set this sender as system sender
+    sender->flags |= POMELO_DELIVERY_SENDER_FLAG_SYSTEM;
+
+    // Add the recipient
+    int ret = pomelo_delivery_sender_add_transmission(
+        sender,
+        endpoint->system_bus,
+        POMELO_DELIVERY_MODE_UNRELIABLE
+    );
+    if (ret < 0) {
+        pomelo_delivery_sender_cancel(sender);
+        return; // Failed to add the recipient
+    }
+
+    // Submit the sender
+    pomelo_delivery_sender_submit(sender);
+}
+
+
+/// @brief Get the bus by its ID
+static pomelo_delivery_bus_t * endpoint_bus_by_id(
+    pomelo_delivery_endpoint_t * endpoint,
+    size_t bus_id
+) {
+    if (bus_id == 0) return endpoint->system_bus;
+
+    pomelo_delivery_bus_t * bus = NULL;
+    pomelo_array_get(endpoint->buses, bus_id - 1, &bus);
+    return bus;
+}
+
+
+void pomelo_delivery_endpoint_flush_acks(pomelo_delivery_endpoint_t * endpoint) {
+    assert(endpoint != NULL);
+    endpoint->flags &= ~POMELO_DELIVERY_ENDPOINT_FLAG_ACK_SCHEDULED;
+
+    pomelo_array_t * acks = endpoint->acks;
+    if (acks->size == 0) return; // Nothing to flush
+
+    // Keep every ACK parcel in a single fragment
+    size_t capacity = endpoint->context->fragment_content_capacity;
+    uint8_t meta_byte = POMELO_DELIVERY_OPCODE_ACK << 5;
+    uint8_t buffer[POMELO_DELIVERY_ACK_BLOCK_MAX_BYTES];
+
+    pomelo_delivery_parcel_t * parcel = NULL;
+    pomelo_delivery_writer_t writer;
+    size_t written = 0;
+
+    for (size_t i = 0; i < acks->size; i++) {
+        pomelo_delivery_ack_t * ack = pomelo_array_get_ptr(acks, i);
+        assert(ack != NULL);
+
+        pomelo_delivery_bus_t * bus = endpoint_bus_by_id(endpoint, ack->bus_id);
+        if (!bus) continue; // The bus does not exist
+
+        pomelo_delivery_receiver_t * receiver = NULL;
+        int state = pomelo_delivery_bus_reliable_state(
+            bus,
+            ack->sequence,
+            &receiver
+        );
+        if (state < 0) continue; // Unknown parcel
+
+        pomelo_delivery_ack_block_t block;
+        block.bus_id = ack->bus_id;
+        block.sequence = ack->sequence;
+
+        size_t start = 0;
+        size_t end = ack->last_index + 1;
+        while (start < end) {
+            if (receiver) {
+                // Cumulative & selective ACK of the received fragments
+                size_t next = pomelo_delivery_ack_block_build(
+                    &block,
+                    receiver->fragments,
+                    start
+                );
+                if (next <= start) break; // No more received fragments
+                start = next;
+            } else {
+                // The parcel has been completely received
+                block.first = 0;
+                block.run = end;
+                block.mask = 0;
+                start = end;
+            }
+
+            size_t remain = capacity - written;
+            if (parcel && remain < POMELO_DELIVERY_ACK_BLOCK_MAX_BYTES) {
+                // The parcel is full
+                submit_system_parcel(endpoint, parcel);
+                pomelo_delivery_parcel_unref(parcel);
+                parcel = NULL;
+            }
+
+            if (!parcel) {
+                parcel = pomelo_delivery_context_acquire_parcel(
+                    endpoint->context
+                );
+                if (!parcel) break; // Failed to acquire the parcel
+
+                pomelo_delivery_writer_init(&writer, parcel);
+                if (pomelo_delivery_writer_write(&writer, &meta_byte, 1) < 0) {
+                    pomelo_delivery_parcel_unref(parcel);
+                    parcel = NULL;
+                    break; // Failed to write the meta byte
+                }
+                written = 1;
+            }
+
+            size_t length = pomelo_delivery_ack_block_encode(&block, buffer);
+            if (pomelo_delivery_writer_write(&writer, buffer, length) < 0) {
+                break; // Failed to write the block
+            }
+            written += length;
+        }
+    }
+    pomelo_array_clear(acks);
+
+    if (parcel) {
+        if (written > 1) {
+            submit_system_parcel(endpoint, parcel);
+        }
+        pomelo_delivery_parcel_unref(parcel);
+    }
+}
+
+
+void pomelo_delivery_endpoint_recv_ack(
+    pomelo_delivery_endpoint_t * endpoint,
+    uint8_t meta_byte,
+    pomelo_delivery_reader_t * reader
+) {
+    assert(endpoint != NULL);
+    assert(reader != NULL);
+    (void) meta_byte;
+
+    pomelo_delivery_ack_block_t block;
+    while (pomelo_delivery_reader_remain_bytes(reader) > 0) {
+        int ret = pomelo_delivery_ack_block_decode(&block, reader);
+        if (ret < 0) return; // Failed to decode the block
+
+        if (block.bus_id > 0 &&
+            !(endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_READY)
+        ) {
+            continue; // Endpoint is not ready
+        }
+
+        pomelo_delivery_bus_t * bus = endpoint_bus_by_id(endpoint, block.bus_id);
+        if (!bus) continue; // The bus does not exist
+
+        pomelo_delivery_bus_recv_ack_block(bus, &block);
+    }
+}
+
+
+/// @brief Get the pacing rate in bytes per SRTT
+static uint64_t endpoint_pacer_rate(pomelo_delivery_endpoint_t * endpoint) {
+    // Pace at 5/4 of the window, so that the pacer does not limit the flow
+    // more than the window does
+    return (uint64_t) endpoint->congestion.cwnd * 5 / 4;
+}
+
+
+/// @brief Refill the tokens of pacer
+static void endpoint_refill_pacer(
+    pomelo_delivery_endpoint_t * endpoint,
+    uint64_t time
+) {
+    uint64_t srtt = pomelo_delivery_congestion_srtt(&endpoint->congestion);
+    uint64_t rate = endpoint_pacer_rate(endpoint);
+
+    // The burst covers the granularity of timers
+    uint64_t burst = POMELO_MAX(
+        rate * POMELO_DELIVERY_RTO_GRANULARITY_NS / srtt,
+        2 * (uint64_t) endpoint->congestion.mss
+    );
+
+    uint64_t elapsed = POMELO_MIN(time - endpoint->pacer_time, srtt);
+    uint64_t tokens = elapsed * rate / srtt;
+    if (tokens == 0) return; // Keep the remainder for the next refill
+
+    tokens += endpoint->pacer_tokens;
+    endpoint->pacer_tokens = (size_t) POMELO_MIN(tokens, burst);
+    endpoint->pacer_time = time;
+}
+
+
+/// @brief Handle the pacer timer triggered event
+static void on_pacer_timer_triggered(pomelo_delivery_endpoint_t * endpoint) {
+    assert(endpoint != NULL);
+    endpoint->flags &= ~POMELO_DELIVERY_ENDPOINT_FLAG_PACER_SCHEDULED;
+    pomelo_sequencer_submit(endpoint->sequencer, &endpoint->pacer_task);
+    // => pomelo_delivery_endpoint_flush_paced()
+}
+
+
+/// @brief Schedule the pacer until there are enough tokens for the payload
+static void endpoint_schedule_pacer(
+    pomelo_delivery_endpoint_t * endpoint,
+    size_t length
+) {
+    if (endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_PACER_SCHEDULED) {
+        return; // Already scheduled
+    }
+
+    uint64_t srtt = pomelo_delivery_congestion_srtt(&endpoint->congestion);
+    uint64_t rate = endpoint_pacer_rate(endpoint);
+    uint64_t missing = (length > endpoint->pacer_tokens)
+        ? (length - endpoint->pacer_tokens)
+        : 0;
+    uint64_t delay = POMELO_TIME_NS_TO_MS(
+        missing * srtt / rate + POMELO_DELIVERY_RTO_GRANULARITY_NS - 1
+    );
+
+    int ret = pomelo_platform_timer_start(
+        endpoint->platform,
+        (pomelo_platform_timer_entry) on_pacer_timer_triggered,
+        delay,
+        0, // No repeat
+        endpoint,
+        &endpoint->pacer_timer
+    );
+    if (ret < 0) {
+        // Failed to start the timer, flush on the next loop iteration
+        pomelo_sequencer_submit(endpoint->sequencer, &endpoint->pacer_task);
+        return;
+    }
+
+    endpoint->flags |= POMELO_DELIVERY_ENDPOINT_FLAG_PACER_SCHEDULED;
+}
+
+
+/// @brief Get the length of the next paced payload of bus
+static size_t bus_pacer_front_length(pomelo_delivery_bus_t * bus) {
+    return pomelo_list_element(
+        bus->pacer_queue->front,
+        pomelo_buffer_view_t
+    ).length;
+}
+
+
+/// @brief Pick the bus whose paced payload is sent next. The buses of the
+/// highest priority are served first, and they share the pacer by deficit
+/// round robin with quanta of their weights times the MSS.
+static pomelo_delivery_bus_t * endpoint_pacer_next(
+    pomelo_delivery_endpoint_t * endpoint
+) {
+    pomelo_list_t * buses = endpoint->pacer_buses;
+    if (pomelo_list_is_empty(buses)) return NULL; // Nothing to send
+
+    // Strict priority between the levels
+    unsigned int priority = 0;
+    pomelo_list_entry_t * entry = buses->front;
+    for (; entry; entry = entry->next) {
+        pomelo_delivery_bus_t * bus =
+            pomelo_list_element(entry, pomelo_delivery_bus_t *);
+        priority = POMELO_MAX(priority, bus->priority);
+    }
+
+    // A quantum is never smaller than a payload, so every bus of the level
+    // can send after at most one turn.
+    while (true) {
+        pomelo_delivery_bus_t * bus = NULL;
+        for (entry = buses->front; entry; entry = entry->next) {
+            bus = pomelo_list_element(entry, pomelo_delivery_bus_t *);
+            if (bus->priority == priority) break;
+        }
+        assert(entry != NULL);
+
+        if (bus->deficit >= bus_pacer_front_length(bus)) {
+            return bus;
+        }
+
+        // End of its turn, move it behind the other buses
+        bus->deficit += (size_t) bus->weight * endpoint->congestion.mss;
+        pomelo_list_move_back(buses, entry);
+    }
+}
+
+
+/// @brief Queue the payload of bus for the pacer
+static int endpoint_queue_paced(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_bus_t * bus,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+) {
+    if (endpoint->pacer_count >= POMELO_DELIVERY_PACER_QUEUE_MAX) {
+        return -1; // The pacer queue is full
+    }
+
+    if (pomelo_delivery_bus_ensure_pacer_queue(bus) < 0) {
+        return -1; // Failed to create the pacer queue of bus
+    }
+
+    // Copy the payload, the views are only valid in this call
+    pomelo_buffer_t * buffer =
+        pomelo_buffer_context_acquire(endpoint->context->buffer_context);
+    if (!buffer) return -1; // Failed to acquire buffer
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = 0;
+    for (size_t i = 0; i < nviews; i++) {
+        memcpy(
+            buffer->data + view.length,
+            views[i].buffer->data + views[i].offset,
+            views[i].length
+        );
+        view.length += views[i].length;
+    }
+
+    if (!bus->pacer_entry) {
+        // The bus starts pacing
+        bus->pacer_entry = pomelo_list_push_back(endpoint->pacer_buses, bus);
+        if (!bus->pacer_entry) {
+            pomelo_buffer_unref(buffer);
+            return -1; // Failed to add the bus to the pacing list
+        }
+    }
+
+    if (!pomelo_list_push_back(bus->pacer_queue, view)) {
+        if (pomelo_list_is_empty(bus->pacer_queue)) {
+            pomelo_list_remove(endpoint->pacer_buses, bus->pacer_entry);
+            bus->pacer_entry = NULL;
+        }
+        pomelo_buffer_unref(buffer);
+        return -1; // Failed to queue the payload
+    }
+
+    endpoint->pacer_count++;
+    endpoint_schedule_pacer(endpoint, view.length);
+    return 0;
+}
+
+
+/// @brief Stamp the sent time of a reliable fragment which has been queued
+static void endpoint_stamp_fragment(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_fragment_meta_t * meta,
+    uint64_t time
+) {
+    if (meta->type != POMELO_FRAGMENT_TYPE_DATA_RELIABLE &&
+        meta->type != POMELO_FRAGMENT_TYPE_DATA_RELIABLE_UNORDERED
+    ) {
+        return; // Only reliable fragments are acked
+    }
+
+    pomelo_delivery_bus_t * bus = endpoint_bus_by_id(endpoint, meta->bus_id);
+    if (!bus) return; // The bus does not exist
+    pomelo_delivery_bus_stamp_fragment(bus, meta, time);
+}
+
+
+/// @brief Stamp the sent time of the reliable fragments of a queued payload
+/// when it leaves the endpoint, so that the queueing delay is not counted in
+/// their RTT samples and timeouts.
+static void endpoint_stamp_emitted(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * view,
+    uint64_t time
+) {
+    pomelo_buffer_view_t content = *view;
+    pomelo_delivery_fragment_meta_t meta;
+    int ret = pomelo_delivery_fragment_meta_decode(&meta, &content);
+    if (ret < 0) return; // Failed to decode the meta
+
+    if (!is_coalesced_header(&meta)) {
+        endpoint_stamp_fragment(endpoint, &meta, time);
+        return;
+    }
+
+    pomelo_payload_t payload;
+    payload.data = content.buffer->data + content.offset;
+    payload.capacity = content.length;
+    payload.position = 0;
+
+    while (payload.position < payload.capacity) {
+        uint16_t length = 0;
+        ret = pomelo_payload_read_uint16(&payload, &length);
+        if (ret < 0) return; // Failed to read the length
+        if (length > payload.capacity - payload.position) return;
+
+        pomelo_buffer_view_t entry;
+        entry.buffer = content.buffer;
+        entry.offset = content.offset + payload.position;
+        entry.length = length;
+        payload.position += length;
+
+        ret = pomelo_delivery_fragment_meta_decode(&meta, &entry);
+        if (ret < 0) return; // Failed to decode the meta
+        endpoint_stamp_fragment(endpoint, &meta, time);
+    }
+}
+
+
+/// @brief Send the payload of bus through the pacer of endpoint
+/// @return 0 if the payload is sent, 1 if it is queued for the pacer, or -1 on
+/// failure
+static int endpoint_output(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_bus_t * bus,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+) {
+    if (!endpoint->congestion.methods) {
+        // Congestion control is disabled
+        return pomelo_delivery_endpoint_send(endpoint, views, nviews);
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < nviews; i++) {
+        length += views[i].length;
+    }
+
+    if (endpoint->pacer_count == 0) {
+        endpoint_refill_pacer(
+            endpoint,
+            pomelo_platform_hrtime(endpoint->platform)
+        );
+        if (endpoint->pacer_tokens >= length) {
+            endpoint->pacer_tokens -= length;
+            return pomelo_delivery_endpoint_send(endpoint, views, nviews);
+        }
+    }
+
+    int ret = endpoint_queue_paced(endpoint, bus, views, nviews);
+    if (ret < 0) return ret; // Failed to queue the payload
+    return 1;
+}
+
+
+/// @brief Handle the coalesce timer triggered event
+static void on_coalesce_timer_triggered(pomelo_delivery_endpoint_t * endpoint) {
+    assert(endpoint != NULL);
+    pomelo_sequencer_submit(endpoint->sequencer, &endpoint->coalesce_task);
+    // => pomelo_delivery_endpoint_flush_coalesced()
+}
+
+
+/// @brief Start a new coalesced payload
+static int endpoint_begin_coalesced(pomelo_delivery_endpoint_t * endpoint) {
+    pomelo_delivery_context_t * context = endpoint->context;
+    pomelo_buffer_t * buffer =
+        pomelo_buffer_context_acquire(context->buffer_context);
+    if (!buffer) return -1; // Failed to acquire buffer
+
+    // The header is the meta of a system fragment which is never sent
+    pomelo_delivery_fragment_meta_t meta;
+    meta.type = POMELO_FRAGMENT_TYPE_DATA_UNRELIABLE;
+    meta.bus_id = 0;
+    meta.fragment_index = 0;
+    meta.last_index = 0;
+    meta.sequence = 0;
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = 0;
+
+    int ret = pomelo_delivery_fragment_meta_encode(&meta, &view);
+    if (ret < 0) {
+        pomelo_buffer_unref(buffer);
+        return -1; // Failed to encode the header
+    }
+
+    ret = pomelo_platform_timer_start(
+        endpoint->platform,
+        (pomelo_platform_timer_entry) on_coalesce_timer_triggered,
+        context->coalesce_delay_ms,
+        0, // No repeat
+        endpoint,
+        &endpoint->coalesce_timer
+    );
+    if (ret < 0) {
+        pomelo_buffer_unref(buffer);
+        return -1; // Failed to start the timer
+    }
+
+    endpoint->flags |= POMELO_DELIVERY_ENDPOINT_FLAG_COALESCE_SCHEDULED;
+    endpoint->coalesce_buffer = buffer;
+    endpoint->coalesce_length = view.length;
+    endpoint->coalesce_count = 0;
+    return 0;
+}
+
+
+int pomelo_delivery_endpoint_transmit(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_bus_t * bus,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+) {
+    assert(endpoint != NULL);
+    assert(bus != NULL);
+    assert(views != NULL);
+
+    if (bus != endpoint->system_bus) {
+        // User traffic makes pings redundant, see endpoint_ping_redundant()
+        endpoint->last_send_time = pomelo_platform_hrtime(endpoint->platform);
+    }
+
+    pomelo_delivery_context_t * context = endpoint->context;
+    if (!context->coalesce) {
+        return endpoint_output(endpoint, bus, views, nviews);
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < nviews; i++) {
+        length += views[i].length;
+    }
+
+    // A coalesced payload is never larger than a single fragment
+    size_t capacity = context->fragment_content_capacity +
+        POMELO_MAX_FRAGMENT_META_DATA_BYTES;
+    size_t entry_length = POMELO_DELIVERY_COALESCE_LENGTH_BYTES + length;
+
+    if (endpoint->coalesce_buffer &&
+        endpoint->coalesce_length + entry_length > capacity
+    ) {
+        // Not enough space, send the pending fragments first
+        pomelo_delivery_endpoint_flush_coalesced(endpoint);
+    }
+
+    if (!endpoint->coalesce_buffer) {
+        if (POMELO_DELIVERY_FRAGMENT_META_MIN_SIZE + entry_length > capacity) {
+            // Large fragment, there is no room for other ones
+            return endpoint_output(endpoint, bus, views, nviews);
+        }
+
+        int ret = endpoint_begin_coalesced(endpoint);
+        if (ret < 0) {
+            // Failed to begin, send the fragment directly
+            return endpoint_output(endpoint, bus, views, nviews);
+        }
+    }
+
+    // The coalesced payload is scheduled with its most urgent fragment
+    if (!endpoint->coalesce_bus ||
+        bus->priority > endpoint->coalesce_bus->priority
+    ) {
+        endpoint->coalesce_bus = bus;
+    }
+
+    // Append the entry
+    pomelo_payload_t payload;
+    payload.data = endpoint->coalesce_buffer->data;
+    payload.capacity = capacity;
+    payload.position = endpoint->coalesce_length;
+
+    pomelo_payload_write_uint16_unsafe(&payload, (uint16_t) length);
+    for (size_t i = 0; i < nviews; i++) {
+        pomelo_buffer_view_t * view = &views[i];
+        memcpy(
+            payload.data + payload.position,
+            view->buffer->data + view->offset,
+            view->length
+        );
+        payload.position += view->length;
+    }
+
+    endpoint->coalesce_length = payload.position;
+    endpoint->coalesce_count++;
+    return 1;
+}
+
+
+void pomelo_delivery_endpoint_flush_coalesced(
+    pomelo_delivery_endpoint_t * endpoint
+) {
+    assert(endpoint != NULL);
+    if (endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_COALESCE_SCHEDULED) {
+        pomelo_platform_timer_stop(
+            endpoint->platform,
+            &endpoint->coalesce_timer
+        );
+        endpoint->flags &= ~POMELO_DELIVERY_ENDPOINT_FLAG_COALESCE_SCHEDULED;
+    }
+
+    pomelo_buffer_t * buffer = endpoint->coalesce_buffer;
+    if (!buffer) return; // Nothing to flush
+    endpoint->coalesce_buffer = NULL;
+
+    pomelo_delivery_bus_t * bus = endpoint->coalesce_bus;
+    endpoint->coalesce_bus = NULL;
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = endpoint->coalesce_length;
+
+    if (endpoint->coalesce_count == 1) {
+        // A single fragment is sent as it is, without the header
+        size_t skip = POMELO_DELIVERY_FRAGMENT_META_MIN_SIZE +
+            POMELO_DELIVERY_COALESCE_LENGTH_BYTES;
+        view.offset = skip;
+        view.length -= skip;
+    }
+
+    if (endpoint->coalesce_count > 0) {
+        // Failures are ignored, reliable fragments will be resent
+        int ret = endpoint_output(endpoint, bus, &view, 1);
+        if (ret != 1) {
+            // Not queued for the pacer, the fragments have left
+            endpoint_stamp_emitted(
+                endpoint,
+                &view,
+                pomelo_platform_hrtime(endpoint->platform)
+            );
+        }
+    }
+
+    pomelo_buffer_unref(buffer);
+    endpoint->coalesce_length = 0;
+    endpoint->coalesce_count = 0;
+}
+
+
+void pomelo_delivery_endpoint_flush_paced(
+    pomelo_delivery_endpoint_t * endpoint
+) {
+    assert(endpoint != NULL);
+
+    if (endpoint->pacer_count == 0) return; // Nothing to flush
+    endpoint_refill_pacer(endpoint, pomelo_platform_hrtime(endpoint->platform));
+
+    pomelo_delivery_bus_t * bus = NULL;
+    pomelo_buffer_view_t view;
+    while ((bus = endpoint_pacer_next(endpoint))) {
+        size_t length = bus_pacer_front_length(bus);
+        if (length > endpoint->pacer_tokens) {
+            // Wait for more tokens
+            endpoint_schedule_pacer(endpoint, length);
+            return;
+        }
+
+        pomelo_list_pop_front(bus->pacer_queue, &view);
+        endpoint->pacer_count--;
+        endpoint->pacer_tokens -= length;
+        bus->deficit -= length;
+
+        if (pomelo_list_is_empty(bus->pacer_queue)) {
+            // The bus stops pacing, its deficit is not kept
+            pomelo_list_remove(endpoint->pacer_buses, bus->pacer_entry);
+            bus->pacer_entry = NULL;
+            bus->deficit = 0;
+        }
+
+        // Failures are ignored, reliable fragments will be resent
+        pomelo_delivery_endpoint_send(endpoint, &view, 1);
+        endpoint_stamp_emitted(
+            endpoint,
+            &view,
+            pomelo_platform_hrtime(endpoint->platform)
+        );
+        pomelo_buffer_unref(view.buffer);
+    }
+}
+
+
+int pomelo_delivery_endpoint_recv_coalesced(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * view
+) {
+    assert(endpoint != NULL);
+    assert(view != NULL);
+
+    pomelo_payload_t payload;
+    payload.data = view->buffer->data + view->offset;
+    payload.capacity = view->length;
+    payload.position = 0;
+
+    if (payload.capacity == 0) return -1; // Empty coalesced payload
+
+    while (payload.position < payload.capacity) {
+        uint16_t length = 0;
+        int ret = pomelo_payload_read_uint16(&payload, &length);
+        if (ret < 0) return -1; // Failed to read the length
+
+        if (length > payload.capacity - payload.position) {
+            return -1; // Truncated entry
+        }
+
+        pomelo_buffer_view_t entry;
+        entry.buffer = view->buffer;
+        entry.offset = view->offset + payload.position;
+        entry.length = length;
+        payload.position += length;
+
+        pomelo_delivery_fragment_meta_t meta;
+        ret = pomelo_delivery_fragment_meta_decode(&meta, &entry);
+        if (ret < 0) return -1; // Failed to decode the meta
+
+        if (is_coalesced_header(&meta)) {
+            return -1; // Nested coalesced payloads are not allowed
+        }
+
+        // Failure of an entry does not affect the other ones
+        endpoint_recv_fragment(endpoint, &meta, &entry);
+    }
+
+    return 0;
+}
+
+
+/// @brief Check if the ping of this heartbeat can be skipped. Pings of idle
+/// endpoints keep the connections alive, while busy endpoints only need them
+/// to refresh the RTT.
+static bool endpoint_ping_redundant(
+    pomelo_delivery_endpoint_t * endpoint,
+    uint64_t time
+) {
+    if (!(endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_READY)) {
+        return false; // Pings make the endpoint ready
+    }
+
+    if (endpoint->flags & POMELO_DELIVERY_ENDPOINT_FLAG_TIME_SYNC) {
+        return false; // The clock is only synced by pongs
+    }
+
+    uint64_t interval = POMELO_FREQ_TO_NS(POMELO_DELIVERY_HEARTBEAT_FREQUENCY);
+    if (time - endpoint->last_send_time >= interval) {
+        return false; // Idle endpoint
+    }
+
+    return time - endpoint->rtt_sample_time <
+        POMELO_DELIVERY_ENDPOINT_RTT_SAMPLE_AGE_NS;
+}
+
+
 void pomelo_delivery_endpoint_heartbeat(pomelo_delivery_endpoint_t * endpoint) {
     assert(endpoint != NULL);
+    uint64_t time = pomelo_platform_hrtime(endpoint->platform);
+    if (endpoint_ping_redundant(endpoint, time)) {
+        return; // The RTT is fresh and the traffic keeps the connection alive
+    }
+
     pomelo_sequencer_submit(endpoint->sequencer, &endpoint->heartbeat_task);
     // => pomelo_delivery_endpoint_send_ping()
 }
@@ -686,6 +1643,23 @@ void pomelo_delivery_endpoint_stop_deferred(pomelo_delivery_endpoint_t * endpoin
 
     // Stop the heartbeat
     pomelo_delivery_heartbeat_unschedule(endpoint->heartbeat, endpoint);
+
+    // Drop the pending ACKs
+    pomelo_platform_timer_stop(endpoint->platform, &endpoint->ack_timer);
+    endpoint->flags &= ~POMELO_DELIVERY_ENDPOINT_FLAG_ACK_SCHEDULED;
+    pomelo_array_clear(endpoint->acks);
+
+    // Drop the coalesced payload
+    pomelo_platform_timer_stop(endpoint->platform, &endpoint->coalesce_timer);
+    endpoint->flags &= ~POMELO_DELIVERY_ENDPOINT_FLAG_COALESCE_SCHEDULED;
+    if (endpoint->coalesce_buffer) {
+        pomelo_buffer_unref(endpoint->coalesce_buffer);
+        endpoint->coalesce_buffer = NULL;
+    }
+    endpoint->coalesce_bus = NULL;
+
+    // Drop the paced payloads
+    endpoint_drop_paced(endpoint);
 }
 
 
@@ -7,6 +7,9 @@
 #include "fragment.h"
 #include "clock.h"
 #include "heartbeat.h"
+#include "ack.h"
+#include "rto.h"
+#include "congestion.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -33,6 +36,25 @@ extern "C" {
  * Pong content layout (Only available when time_sync is true):
  *    sequence: 1 - 8 bytes
  *    time    : 1 - 8 bytes
+ * 
+ * Ack opcode-meta layout:
+ *    <padding>: 5 bits
+ * 
+ * Ack content layout:
+ *    blocks: one or more ACK blocks (See ack.h)
+ */
+
+
+/**
+ * Coalesced payload layout:
+ *    header : fragment meta of an unreliable fragment of the system bus with
+ *             sequence 0. Real parcels always have sequences from 1.
+ *    entries: one or more entries
+ *
+ * Entry layout:
+ *    length  : 2 bytes
+ *    fragment: `length` bytes, a whole fragment (meta & content) which would
+ *              be sent as a single payload otherwise
  */
 
 
@@ -42,9 +64,29 @@ extern "C" {
 /// @brief The ready flag of the endpoint
 #define POMELO_DELIVERY_ENDPOINT_FLAG_READY      (1 << 1)
 
+/// @brief The flag of scheduled ACK timer
+#define POMELO_DELIVERY_ENDPOINT_FLAG_ACK_SCHEDULED (1 << 2)
+
+/// @brief The flag of scheduled coalesce timer
+#define POMELO_DELIVERY_ENDPOINT_FLAG_COALESCE_SCHEDULED (1 << 3)
+
+/// @brief The flag of scheduled pacer timer
+#define POMELO_DELIVERY_ENDPOINT_FLAG_PACER_SCHEDULED (1 << 4)
+
+/// @brief The maximum number of payloads which are waiting for the pacer
+#define POMELO_DELIVERY_PACER_QUEUE_MAX 1024
+
+/// @brief The size of the length field of coalesced entries
+#define POMELO_DELIVERY_COALESCE_LENGTH_BYTES 2
+
 /// @brief The ping frequency of the endpoint
 #define POMELO_DELIVERY_ENDPOINT_PING_FREQUENCY 10 // Hz
 
+/// @brief While the endpoint is sending, pings are skipped if the RTT has been
+/// sampled within this duration
+#define POMELO_DELIVERY_ENDPOINT_RTT_SAMPLE_AGE_NS                             \
+    (2 * POMELO_FREQ_TO_NS(POMELO_DELIVERY_HEARTBEAT_FREQUENCY))
+
 /// @brief Send result
 typedef struct pomelo_delivery_send_result_s pomelo_delivery_send_result_t;
 
@@ -52,7 +94,8 @@ typedef struct pomelo_delivery_send_result_s pomelo_delivery_send_result_t;
 /// @brief The opcode of the parcel
 typedef enum pomelo_delivery_opcode {
     POMELO_DELIVERY_OPCODE_PING = 0,
-    POMELO_DELIVERY_OPCODE_PONG = 1
+    POMELO_DELIVERY_OPCODE_PONG = 1,
+    POMELO_DELIVERY_OPCODE_ACK = 2
 } pomelo_delivery_opcode;
 
 
@@ -102,9 +145,18 @@ struct pomelo_delivery_endpoint_s {
     /// @brief The clock of this endpoint
     pomelo_delivery_clock_t clock;
 
+    /// @brief The retransmission timeout estimator of this endpoint
+    pomelo_delivery_rto_t rto;
+
     /// @brief The heartbeat ping handle
     pomelo_delivery_heartbeat_handle_t heartbeat_handle;
 
+    /// @brief The last time a fragment of user buses was transmitted
+    uint64_t last_send_time;
+
+    /// @brief The last time the RTT was sampled by a pong or an ACK
+    uint64_t rtt_sample_time;
+
     /// @brief The stop task
     pomelo_sequencer_task_t stop_task;
 
@@ -116,6 +168,57 @@ struct pomelo_delivery_endpoint_s {
 
     /// @brief The ready task
     pomelo_sequencer_task_t ready_task;
+
+    /// @brief The reliable parcels which are waiting to be acked
+    pomelo_array_t * acks;
+
+    /// @brief The timer of aggregated ACKs
+    pomelo_platform_timer_handle_t ack_timer;
+
+    /// @brief The task of flushing aggregated ACKs
+    pomelo_sequencer_task_t ack_task;
+
+    /// @brief The pending coalesced payload
+    pomelo_buffer_t * coalesce_buffer;
+
+    /// @brief The number of written bytes of the coalesced payload
+    size_t coalesce_length;
+
+    /// @brief The number of fragments in the coalesced payload
+    size_t coalesce_count;
+
+    /// @brief The timer of coalesced payload
+    pomelo_platform_timer_handle_t coalesce_timer;
+
+    /// @brief The task of flushing coalesced payload
+    pomelo_sequencer_task_t coalesce_task;
+
+    /// @brief The bus of the highest priority in the coalesced payload
+    pomelo_delivery_bus_t * coalesce_bus;
+
+    /// @brief The congestion controller of this endpoint
+    pomelo_delivery_congestion_t congestion;
+
+    /// @brief The checksum algorithm of multi-fragment parcels
+    pomelo_checksum checksum;
+
+    /// @brief The buses which have payloads waiting for the pacer
+    pomelo_list_t * pacer_buses;
+
+    /// @brief The number of payloads which are waiting for the pacer
+    size_t pacer_count;
+
+    /// @brief The number of bytes which can be sent right now
+    size_t pacer_tokens;
+
+    /// @brief The last time the tokens were refilled
+    uint64_t pacer_time;
+
+    /// @brief The timer of pacer
+    pomelo_platform_timer_handle_t pacer_timer;
+
+    /// @brief The task of flushing the paced payloads
+    pomelo_sequencer_task_t pacer_task;
 };
 
 
@@ -192,6 +295,57 @@ void pomelo_delivery_endpoint_recv_pong(
 );
 
 
+/// @brief Queue the ACK of a reliable fragment. The ACK will be sent with
+/// other ones after the ACK delay.
+int pomelo_delivery_endpoint_queue_ack(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_fragment_meta_t * meta
+);
+
+
+/// @brief Send all queued ACKs
+void pomelo_delivery_endpoint_flush_acks(pomelo_delivery_endpoint_t * endpoint);
+
+
+/// @brief Receive the aggregated ACKs
+void pomelo_delivery_endpoint_recv_ack(
+    pomelo_delivery_endpoint_t * endpoint,
+    uint8_t meta_byte,
+    pomelo_delivery_reader_t * reader
+);
+
+
+/// @brief Send the fragment of the bus. Small fragments are coalesced with the
+/// other ones if the coalescing of context is enabled. When the pacer is
+/// constrained, the bus decides the order of the queued fragments.
+/// @return 0 if the fragment has been sent, 1 if it is queued for coalescing
+/// or pacing, or -1 on failure
+int pomelo_delivery_endpoint_transmit(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_delivery_bus_t * bus,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+);
+
+
+/// @brief Send the pending coalesced payload
+void pomelo_delivery_endpoint_flush_coalesced(
+    pomelo_delivery_endpoint_t * endpoint
+);
+
+
+/// @brief Send the paced payloads which are allowed by the congestion window
+void pomelo_delivery_endpoint_flush_paced(pomelo_delivery_endpoint_t * endpoint);
+
+
+/// @brief Receive the entries of a coalesced payload
+/// @param view The view of entries, right after the header
+int pomelo_delivery_endpoint_recv_coalesced(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * view
+);
+
+
 /// @brief Process heartbeat
 void pomelo_delivery_endpoint_heartbeat(pomelo_delivery_endpoint_t * endpoint);
 
@@ -0,0 +1,84 @@
+#ifndef POMELO_DELIVERY_FEC_SRC_H
+#define POMELO_DELIVERY_FEC_SRC_H
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+    Forward error correction
+    ------------------------
+    Multi-fragment unreliable & sequenced parcels can be followed by K repair
+    fragments, so that the receiver can rebuild the parcel when up to K of its
+    N fragments are lost. The code is a systematic Reed-Solomon code over
+    GF(2^8) (polynomial 0x11D) with a Cauchy generator matrix:
+
+        repair[j] = sum(C[j][i] * source[i]), i = 0..N-1
+        C[j][i]   = 1 / ((N + j) ^ i)
+
+    Every square sub-matrix of a Cauchy matrix is invertible, so any N of the
+    N + K fragments are enough. This requires N + K <= 256.
+
+    Source symbol i is the 2-byte length of fragment i followed by its content
+    (including the embedded checksum), padded with zeros to the length of the
+    longest one. Repair fragment j has the fragment index N + j, and its content
+    is the repair symbol:
+
+    ----------------------------------------------------------------------------
+    Offset | Field Name          | Size          | Value Range
+    -------|---------------------|---------------|------------------------------
+    0      | length              | 2 bytes       | [0-65535]
+    2      | content             | L bytes       | The padded content
+*/
+
+
+/// @brief The maximum number of repair fragments per parcel
+#define POMELO_DELIVERY_FEC_MAX_REPAIRS 16
+
+/// @brief The maximum number of source & repair fragments per parcel
+#define POMELO_DELIVERY_FEC_MAX_SYMBOLS 256
+
+/// @brief The size of the length header of symbols
+#define POMELO_DELIVERY_FEC_HEADER_BYTES 2
+
+
+/// @brief Get the coefficient of a source symbol for a repair symbol
+/// @param nsources The number of source symbols
+/// @param repair_index The index of repair symbol
+/// @param source_index The index of source symbol
+uint8_t pomelo_delivery_fec_coefficient(
+    size_t nsources,
+    size_t repair_index,
+    size_t source_index
+);
+
+
+/// @brief Multiply the source by the coefficient and add it to the
+/// destination: dst += coef * src
+void pomelo_delivery_fec_mul_add(
+    uint8_t * dst,
+    const uint8_t * src,
+    size_t length,
+    uint8_t coef
+);
+
+
+/// @brief Solve the linear system A * X = B in place.
+/// @param matrix The n x n matrix A (row major), it is destroyed
+/// @param rows The n rows of B, each has the given length. They are replaced
+/// by the rows of X.
+/// @return 0 on success, or -1 if the matrix is singular
+int pomelo_delivery_fec_solve(
+    uint8_t * matrix,
+    uint8_t ** rows,
+    size_t n,
+    size_t length
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_DELIVERY_FEC_SRC_H
@@ -60,6 +60,15 @@ int pomelo_delivery_fragment_meta_decode(
     // Read bus id
     pomelo_payload_read_packed_uint64_unsafe(&payload, bus_id_bytes, &value);
     meta->bus_id = (size_t) value;
+    meta->type = (pomelo_delivery_fragment_type) fragment_type;
+    if (value & POMELO_DELIVERY_FRAGMENT_UNORDERED_FLAG) {
+        if (fragment_type != POMELO_FRAGMENT_TYPE_DATA_RELIABLE) {
+            return -1; // Only reliable data fragments can be unordered
+        }
+        value &= ~((uint64_t) POMELO_DELIVERY_FRAGMENT_UNORDERED_FLAG);
+        meta->bus_id = (size_t) value;
+        meta->type = POMELO_FRAGMENT_TYPE_DATA_RELIABLE_UNORDERED;
+    }
 
     // Read fragment index
     pomelo_payload_read_packed_uint64_unsafe(
@@ -82,9 +91,6 @@ int pomelo_delivery_fragment_meta_decode(
     pomelo_payload_read_packed_uint64_unsafe(&payload, sequence_bytes, &value);
     meta->sequence = value;
 
-    // The type
-    meta->type = (pomelo_delivery_fragment_type) fragment_type;
-
     // Update the view length and offset
     view->length -= meta_length;
     view->offset += meta_length;
@@ -100,8 +106,17 @@ int pomelo_delivery_fragment_meta_encode(
     assert(view != NULL);
     assert(meta->last_index >= 0);
 
+    // Reliable unordered fragments are reliable ones with the flag in bus ID
+    size_t fragment_type = meta->type;
+    uint64_t bus_id = meta->bus_id;
+    if (fragment_type == POMELO_FRAGMENT_TYPE_DATA_RELIABLE_UNORDERED) {
+        assert(bus_id < POMELO_DELIVERY_FRAGMENT_UNORDERED_FLAG);
+        fragment_type = POMELO_FRAGMENT_TYPE_DATA_RELIABLE;
+        bus_id |= POMELO_DELIVERY_FRAGMENT_UNORDERED_FLAG;
+    }
+
     size_t bus_id_bytes = 
-        pomelo_payload_calc_packed_uint64_bytes(meta->bus_id);
+        pomelo_payload_calc_packed_uint64_bytes(bus_id);
     size_t fragment_index_bytes =
         pomelo_payload_calc_packed_uint64_bytes(meta->fragment_index);
     size_t last_index_bytes =
@@ -131,7 +146,7 @@ int pomelo_delivery_fragment_meta_encode(
     payload.capacity = view->buffer->capacity - view->offset;
 
     size_t meta_byte =
-        (meta->type << 6)                  |
+        (fragment_type << 6)               |
         ((bus_id_bytes - 1) << 5)          |
         ((fragment_index_bytes - 1) << 4)  |
         ((last_index_bytes - 1) << 3)      |
@@ -144,7 +159,7 @@ int pomelo_delivery_fragment_meta_encode(
     pomelo_payload_write_packed_uint64_unsafe(
         &payload,
         bus_id_bytes,
-        meta->bus_id
+        bus_id
     );
 
     // Write fragment index
@@ -47,6 +47,10 @@ extern "C" {
     the bus array of the endpoint. Bus ID is the ID of the bus in the system.
     The ID 0 is reserved for the system bus. And the first user bus (index 0)
     has the ID 1.
+
+    The 2-bit fragment type has no room for the fragments of reliable unordered
+    parcels. They are encoded as reliable data fragments whose bus ID has the
+    unordered flag (bit 15) set, so their bus_id field always takes 2 bytes.
 */
 
 
@@ -56,6 +60,13 @@ extern "C" {
 /// @brief The maximum size of fragment meta
 #define POMELO_DELIVERY_FRAGMENT_META_MAX_SIZE 15
 
+/// @brief The flag of bus ID for the fragments of reliable unordered parcels
+#define POMELO_DELIVERY_FRAGMENT_UNORDERED_FLAG 0x8000
+
+/// @brief The sent time of fragments which are waiting to be coalesced or
+/// paced. They are stamped when the endpoint emits them.
+#define POMELO_DELIVERY_FRAGMENT_SENT_TIME_QUEUED UINT64_MAX
+
 
 /// @brief The fragment type
 typedef enum pomelo_delivery_fragment_type {
@@ -69,7 +80,11 @@ typedef enum pomelo_delivery_fragment_type {
     POMELO_FRAGMENT_TYPE_DATA_RELIABLE,
 
     /// @brief The ack fragment
-    POMELO_FRAGMENT_TYPE_ACK
+    POMELO_FRAGMENT_TYPE_ACK,
+
+    /// @brief The data fragment of reliable unordered parcel. It is encoded as
+    /// a reliable data fragment with the unordered flag in its bus ID.
+    POMELO_FRAGMENT_TYPE_DATA_RELIABLE_UNORDERED
 
 } pomelo_delivery_fragment_type;
 
@@ -84,6 +99,18 @@ struct pomelo_delivery_fragment_s {
 
     /// @brief The acked flag of fragment
     bool acked;
+
+    /// @brief The number of transmissions of fragment (sending only)
+    uint32_t transmissions;
+
+    /// @brief The number of later fragments acked since the last transmission
+    /// (sending only)
+    uint32_t later_acks;
+
+    /// @brief The time of the last transmission (sending only). It is
+    /// POMELO_DELIVERY_FRAGMENT_SENT_TIME_QUEUED until the transmission leaves
+    /// the endpoint.
+    uint64_t sent_time;
 };
 
 
@@ -106,13 +133,23 @@ struct pomelo_delivery_fragment_meta_s {
 
 
 /// @brief Convert the delivery mode to fragment type
-#define pomelo_delivery_fragment_type_from_mode(delivery_mode) \
-    (pomelo_delivery_fragment_type) (delivery_mode)
+#define pomelo_delivery_fragment_type_from_mode(delivery_mode)                 \
+    (((delivery_mode) == POMELO_DELIVERY_MODE_RELIABLE_UNORDERED)              \
+        ? POMELO_FRAGMENT_TYPE_DATA_RELIABLE_UNORDERED                         \
+        : (pomelo_delivery_fragment_type) (delivery_mode))
 
 
 /// @brief Convert the fragment type to delivery mode
-#define pomelo_delivery_mode_from_fragment_type(fragment_type) \
-    (pomelo_delivery_mode) (fragment_type)
+#define pomelo_delivery_mode_from_fragment_type(fragment_type)                 \
+    (((fragment_type) == POMELO_FRAGMENT_TYPE_DATA_RELIABLE_UNORDERED)         \
+        ? POMELO_DELIVERY_MODE_RELIABLE_UNORDERED                              \
+        : (pomelo_delivery_mode) (fragment_type))
+
+
+/// @brief Check if the fragment is a data fragment of reliable parcel
+#define pomelo_delivery_fragment_type_is_reliable(fragment_type)               \
+    ((fragment_type) == POMELO_FRAGMENT_TYPE_DATA_RELIABLE ||                  \
+        (fragment_type) == POMELO_FRAGMENT_TYPE_DATA_RELIABLE_UNORDERED)
 
 
 /// @brief Initialize the fragment
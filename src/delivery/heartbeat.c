@@ -61,6 +61,7 @@ int pomelo_delivery_heartbeat_init(
     assert(heartbeat != NULL);
     assert(options != NULL);
     heartbeat->platform = options->platform;
+    heartbeat->manual = options->manual;
     return 0;
 }
 
@@ -93,7 +94,7 @@ int pomelo_delivery_heartbeat_schedule(
     if (handle->entry) return -1; // Already scheduled
 
     pomelo_list_t * endpoints = heartbeat->endpoints;
-    if (endpoints->size == 0) {
+    if (endpoints->size == 0 && !heartbeat->manual) {
         // Schedule the timer
         int ret = pomelo_platform_timer_start(
             heartbeat->platform,
@@ -110,7 +111,7 @@ int pomelo_delivery_heartbeat_schedule(
     handle->entry = pomelo_list_push_back(heartbeat->endpoints, endpoint);
     if (!handle->entry) {
         // Failed to append
-        if (endpoints->size == 0) {
+        if (endpoints->size == 0 && !heartbeat->manual) {
             // Stop the timer
             pomelo_platform_timer_stop(
                 heartbeat->platform,
@@ -141,7 +142,7 @@ void pomelo_delivery_heartbeat_unschedule(
     handle->entry = NULL;
 
     // Stop the timer if there's no more endpoints
-    if (endpoints->size == 0) {
+    if (endpoints->size == 0 && !heartbeat->manual) {
         pomelo_platform_timer_stop(
             heartbeat->platform,
             &heartbeat->timer_handle
@@ -35,6 +35,9 @@ struct pomelo_delivery_heartbeat_s {
 
     /// @brief Timer handle
     pomelo_platform_timer_handle_t timer_handle;
+
+    /// @brief Whether the heartbeat is run by its owner
+    bool manual;
 };
 
 
@@ -74,10 +77,6 @@ void pomelo_delivery_heartbeat_unschedule(
 );
 
 
-/// @brief Heartbeat run
-void pomelo_delivery_heartbeat_run(pomelo_delivery_heartbeat_t * heartbeat);
-
-
 #ifdef __cplusplus
 }
 #endif
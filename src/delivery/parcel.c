@@ -76,6 +76,7 @@ void pomelo_delivery_parcel_set_context(
     // Change the context of parcel
     parcel->context = context;
     pomelo_buffer_context_t * buffer_context = context->buffer_context;
+    pomelo_delivery_context_root_t * root = context->root;
 
     // Change the context of chunks
     pomelo_array_t * chunks = parcel->chunks;
@@ -84,6 +85,9 @@ void pomelo_delivery_parcel_set_context(
         pomelo_buffer_view_t * chunk = pomelo_array_get_ptr(chunks, i);
         assert(chunk != NULL);
         if (!chunk->buffer) continue; // The chunk has not been arrived
+        if (pomelo_delivery_context_root_is_body(root, chunk->buffer)) {
+            continue; // Body buffers always return to their own pools
+        }
         pomelo_buffer_set_context(chunk->buffer, buffer_context);
     }
 }
@@ -116,6 +120,16 @@ pomelo_buffer_view_t * pomelo_delivery_parcel_append_chunk(
 }
 
 
+/// @brief Check if the view continues right after the previous one
+static bool parcel_views_adjacent(
+    pomelo_buffer_view_t * prev,
+    pomelo_buffer_view_t * view
+) {
+    return view->buffer == prev->buffer &&
+        view->offset == prev->offset + prev->length;
+}
+
+
 int pomelo_delivery_parcel_set_fragments(
     pomelo_delivery_parcel_t * parcel,
     pomelo_array_t * fragments
@@ -132,17 +146,38 @@ int pomelo_delivery_parcel_set_fragments(
         nfragments--;
     }
 
-    int ret = pomelo_array_resize(parcel->chunks, nfragments);
+    // Count the chunks, the adjacent contents of the same buffer are merged
+    size_t nchunks = 0;
+    pomelo_buffer_view_t * prev = NULL;
+    for (size_t i = 0; i < nfragments; i++) {
+        fragment = pomelo_array_get_ptr(fragments, i);
+        assert(fragment != NULL);
+
+        pomelo_buffer_view_t * content = &fragment->content;
+        if (!prev || !parcel_views_adjacent(prev, content)) nchunks++;
+        prev = content;
+    }
+
+    int ret = pomelo_array_resize(parcel->chunks, nchunks);
     if (ret < 0) return ret;
 
+    pomelo_buffer_view_t * chunk = NULL;
+    size_t index = 0;
+    prev = NULL;
     for (size_t i = 0; i < nfragments; i++) {
         fragment = pomelo_array_get_ptr(fragments, i);
         assert(fragment != NULL);
 
-        pomelo_buffer_view_t * chunk = pomelo_array_get_ptr(parcel->chunks, i);
-        assert(chunk != NULL);
-        *chunk = fragment->content;
-        pomelo_buffer_ref(chunk->buffer);
+        pomelo_buffer_view_t * content = &fragment->content;
+        if (prev && parcel_views_adjacent(prev, content)) {
+            chunk->length += content->length;
+        } else {
+            chunk = pomelo_array_get_ptr(parcel->chunks, index++);
+            assert(chunk != NULL);
+            *chunk = *content;
+            pomelo_buffer_ref(chunk->buffer);
+        }
+        prev = content;
     }
 
     return 0;
@@ -207,6 +242,32 @@ void pomelo_delivery_parcel_reset(pomelo_delivery_parcel_t * parcel) {
 }
 
 
+const uint8_t * pomelo_delivery_parcel_body(
+    pomelo_delivery_parcel_t * parcel,
+    size_t * length
+) {
+    assert(parcel != NULL);
+    assert(length != NULL);
+
+    pomelo_array_t * chunks = parcel->chunks;
+    if (chunks->size != 1) {
+        // Empty or scattered parcel
+        *length = 0;
+        for (size_t i = 0; i < chunks->size; i++) {
+            pomelo_buffer_view_t * chunk = pomelo_array_get_ptr(chunks, i);
+            assert(chunk != NULL);
+            if (chunk->buffer) *length += chunk->length;
+        }
+        return NULL;
+    }
+
+    pomelo_buffer_view_t * chunk = pomelo_array_get_ptr(chunks, 0);
+    assert(chunk != NULL);
+    *length = chunk->length;
+    return chunk->buffer->data + chunk->offset;
+}
+
+
 void pomelo_delivery_reader_init(
     pomelo_delivery_reader_t * reader,
     pomelo_delivery_parcel_t * parcel
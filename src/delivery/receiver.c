@@ -5,6 +5,7 @@
 #include "parcel.h"
 #include "receiver.h"
 #include "context.h"
+#include "fec.h"
 
 /// The maximum alive time of unreliable parcel. The parcel will be
 /// auto-released after a certain time but not great than this value.
@@ -51,6 +52,9 @@ int pomelo_delivery_receiver_on_alloc(
     receiver->fragments = pomelo_array_create(&array_options);
     if (!receiver->fragments) return -1; // Failed to create new array
 
+    receiver->repairs = pomelo_array_create(&array_options);
+    if (!receiver->repairs) return -1; // Failed to create new array
+
     return 0;
 }
 
@@ -63,7 +67,12 @@ void pomelo_delivery_receiver_on_free(pomelo_delivery_receiver_t * receiver) {
         pomelo_array_destroy(receiver->fragments);
         receiver->fragments = NULL;
     }
-    
+
+    if (receiver->repairs) {
+        pomelo_array_destroy(receiver->repairs);
+        receiver->repairs = NULL;
+    }
+
     return;
 }
 
@@ -96,20 +105,19 @@ int pomelo_delivery_receiver_init(
     receiver->mode = pomelo_delivery_mode_from_fragment_type(meta->type);
     receiver->sequence = meta->sequence;
     receiver->recv_fragments = 0;
+    receiver->recv_repairs = 0;
+    receiver->body = NULL;
     receiver->expired_time = 0;
     receiver->expired_entry = NULL;
     receiver->sequence_entry = NULL;
     receiver->flags = 0;
     receiver->checksum_verify_task = NULL;
     receiver->checksum_compute_result = 0;
+    receiver->checksum_algorithm = endpoint->checksum;
 
-    // Add command to map
-    receiver->sequence_entry = pomelo_map_set(
-        bus->receivers_map,
-        receiver->sequence,
-        receiver
-    );
-    if (!receiver->sequence_entry) return -1; // Cannot set command to map
+    // Add command to the map or the receiving window
+    ret = pomelo_delivery_bus_add_receiver(bus, receiver);
+    if (ret < 0) return ret; // Cannot add command to bus
 
     // Reserve room for fragments
     size_t nfragments = meta->last_index + 1;
@@ -142,6 +150,23 @@ void pomelo_delivery_receiver_cleanup(pomelo_delivery_receiver_t * receiver) {
     }
     pomelo_array_clear(fragments);
 
+    // Cleanup the repair fragments
+    pomelo_array_t * repairs = receiver->repairs;
+    size_t nrepairs = repairs->size;
+    for (size_t i = 0; i < nrepairs; i++) {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(repairs, i);
+        assert(fragment != NULL);
+        pomelo_delivery_fragment_cleanup(fragment);
+    }
+    pomelo_array_clear(repairs);
+
+    // Release the body, the fragments have released their references
+    if (receiver->body) {
+        pomelo_buffer_unref(receiver->body);
+        receiver->body = NULL;
+    }
+
     // Cleanup the expired entry
     if (receiver->expired_entry) {
         assert(receiver->bus != NULL);
@@ -153,13 +178,8 @@ void pomelo_delivery_receiver_cleanup(pomelo_delivery_receiver_t * receiver) {
     }
     
     // Cleanup the sequence entry
-    if (receiver->sequence_entry) {
-        assert(receiver->bus != NULL);
-        pomelo_map_remove(
-            receiver->bus->receivers_map,
-            receiver->sequence_entry
-        );
-        receiver->sequence_entry = NULL;
+    if (receiver->bus) {
+        pomelo_delivery_bus_remove_receiver(receiver->bus, receiver);
     }
 }
 
@@ -205,9 +225,7 @@ void pomelo_delivery_receiver_cancel(pomelo_delivery_receiver_t * receiver) {
             pomelo_heap_remove(bus->receivers_heap, receiver->expired_entry);
         }
 
-        if (receiver->sequence_entry) {
-            pomelo_map_remove(bus->receivers_map, receiver->sequence_entry);
-        }
+        pomelo_delivery_bus_remove_receiver(bus, receiver);
     }
 
     receiver->bus = NULL;
@@ -234,7 +252,7 @@ void pomelo_delivery_receiver_wait_fragments(
     assert(receiver != NULL);
     pomelo_delivery_bus_t * bus = receiver->bus;
 
-    if (receiver->mode == POMELO_DELIVERY_MODE_RELIABLE) {
+    if (pomelo_delivery_mode_is_reliable(receiver->mode)) {
         // With reliable mode, wait forever
         receiver->expired_time = 0;
         return;
@@ -263,6 +281,278 @@ void pomelo_delivery_receiver_wait_fragments(
 }
 
 
+/// @brief Attach the content to a fragment of the parcel. With contiguous
+/// reassembly, the content is copied into the body of the parcel and the
+/// fragment views it, so the incoming buffer is not kept.
+static void receiver_attach_content(
+    pomelo_delivery_receiver_t * receiver,
+    size_t index,
+    pomelo_buffer_view_t * content
+) {
+    pomelo_delivery_fragment_t * fragment =
+        pomelo_array_get_ptr(receiver->fragments, index);
+    assert(fragment != NULL);
+
+    pomelo_delivery_context_t * context = receiver->context;
+    size_t capacity = context->fragment_content_capacity;
+    size_t nfragments = receiver->fragments->size;
+    if (
+        !context->contiguous_reassembly ||
+        nfragments < 2 ||
+        content->length > capacity
+    ) {
+        pomelo_delivery_fragment_attach_content(fragment, content);
+        return;
+    }
+
+    if (!receiver->body) {
+        receiver->body = pomelo_delivery_context_root_acquire_body(
+            context->root,
+            nfragments
+        );
+        if (!receiver->body) {
+            // Too many fragments or no more buffers, keep the incoming one
+            pomelo_delivery_fragment_attach_content(fragment, content);
+            return;
+        }
+    }
+
+    pomelo_buffer_view_t view;
+    view.buffer = receiver->body;
+    view.offset = index * capacity;
+    view.length = content->length;
+    memcpy(
+        view.buffer->data + view.offset,
+        content->buffer->data + content->offset,
+        content->length
+    );
+    pomelo_delivery_fragment_attach_content(fragment, &view);
+}
+
+
+/// @brief Add a FEC repair fragment to the receiving command
+static void receiver_add_repair(
+    pomelo_delivery_receiver_t * receiver,
+    size_t repair_index,
+    pomelo_buffer_view_t * content
+) {
+    if (pomelo_delivery_mode_is_reliable(receiver->mode)) {
+        return; // Reliable parcels are never repaired
+    }
+    if (repair_index >= POMELO_DELIVERY_FEC_MAX_REPAIRS) return;
+
+    pomelo_array_t * repairs = receiver->repairs;
+    size_t nrepairs = repairs->size;
+    if (repair_index >= nrepairs) {
+        int ret = pomelo_array_resize(repairs, repair_index + 1);
+        if (ret < 0) return; // Failed to resize the array
+
+        for (size_t i = nrepairs; i <= repair_index; i++) {
+            pomelo_delivery_fragment_t * fragment =
+                pomelo_array_get_ptr(repairs, i);
+            assert(fragment != NULL);
+            pomelo_delivery_fragment_init(fragment);
+        }
+    }
+
+    pomelo_delivery_fragment_t * fragment =
+        pomelo_array_get_ptr(repairs, repair_index);
+    assert(fragment != NULL);
+    if (fragment->content.buffer) return; // Received
+
+    pomelo_delivery_fragment_attach_content(fragment, content);
+    receiver->recv_repairs++;
+}
+
+
+/// @brief Solve the missing symbols from the copied repair symbols
+/// @param rows The copied repair symbols, turned into the missing symbols
+/// @param lengths The output content lengths of the missing fragments
+/// @return 0 on success, or -1 on failure
+static int receiver_solve(
+    pomelo_delivery_receiver_t * receiver,
+    size_t * missing,
+    size_t * used,
+    size_t nmissing,
+    uint8_t ** rows,
+    size_t symbol_length,
+    uint16_t * lengths
+) {
+    pomelo_array_t * fragments = receiver->fragments;
+    size_t nfragments = fragments->size;
+    uint8_t header[POMELO_DELIVERY_FEC_HEADER_BYTES];
+    pomelo_payload_t payload;
+
+    // Subtract the received fragments from the repair symbols
+    for (size_t i = 0; i < nfragments; i++) {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(fragments, i);
+        pomelo_buffer_view_t * content = &fragment->content;
+        if (!content->buffer) continue;
+        if (sizeof(header) + content->length > symbol_length) {
+            return -1; // The fragment is longer than the symbol
+        }
+
+        payload.data = header;
+        payload.capacity = sizeof(header);
+        payload.position = 0;
+        pomelo_payload_write_uint16_unsafe(
+            &payload,
+            (uint16_t) content->length
+        );
+
+        for (size_t a = 0; a < nmissing; a++) {
+            uint8_t coef =
+                pomelo_delivery_fec_coefficient(nfragments, used[a], i);
+            pomelo_delivery_fec_mul_add(rows[a], header, sizeof(header), coef);
+            pomelo_delivery_fec_mul_add(
+                rows[a] + sizeof(header),
+                content->buffer->data + content->offset,
+                content->length,
+                coef
+            );
+        }
+    }
+
+    uint8_t matrix[
+        POMELO_DELIVERY_FEC_MAX_REPAIRS * POMELO_DELIVERY_FEC_MAX_REPAIRS
+    ];
+    for (size_t a = 0; a < nmissing; a++) {
+        for (size_t b = 0; b < nmissing; b++) {
+            matrix[a * nmissing + b] = pomelo_delivery_fec_coefficient(
+                nfragments,
+                used[a],
+                missing[b]
+            );
+        }
+    }
+
+    int ret = pomelo_delivery_fec_solve(
+        matrix,
+        rows,
+        nmissing,
+        symbol_length
+    );
+    if (ret < 0) return -1; // Singular matrix
+
+    // Validate the lengths of the rebuilt fragments
+    for (size_t b = 0; b < nmissing; b++) {
+        payload.data = rows[b];
+        payload.capacity = sizeof(header);
+        payload.position = 0;
+        pomelo_payload_read_uint16_unsafe(&payload, &lengths[b]);
+        if (sizeof(header) + lengths[b] > symbol_length) {
+            return -1; // Invalid rebuilt fragment
+        }
+    }
+
+    return 0;
+}
+
+
+/// @brief Rebuild the missing fragments from the repair fragments
+/// @return 0 on success, or -1 on failure
+static int receiver_recover(pomelo_delivery_receiver_t * receiver) {
+    pomelo_array_t * fragments = receiver->fragments;
+    pomelo_array_t * repairs = receiver->repairs;
+    size_t nfragments = fragments->size;
+    size_t nmissing = nfragments - receiver->recv_fragments;
+    if (nmissing > POMELO_DELIVERY_FEC_MAX_REPAIRS) return -1;
+    if (nfragments + repairs->size > POMELO_DELIVERY_FEC_MAX_SYMBOLS) {
+        return -1; // Too many fragments for the code
+    }
+
+    // Collect the missing fragments & the first repair fragments
+    size_t missing[POMELO_DELIVERY_FEC_MAX_REPAIRS];
+    size_t used[POMELO_DELIVERY_FEC_MAX_REPAIRS];
+    size_t count = 0;
+    for (size_t i = 0; i < nfragments && count < nmissing; i++) {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(fragments, i);
+        if (!fragment->content.buffer) {
+            missing[count++] = i;
+        }
+    }
+
+    size_t symbol_length = 0;
+    count = 0;
+    for (size_t j = 0; j < repairs->size && count < nmissing; j++) {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(repairs, j);
+        if (!fragment->content.buffer) continue;
+
+        if (count == 0) {
+            symbol_length = fragment->content.length;
+        } else if (fragment->content.length != symbol_length) {
+            return -1; // Repair fragments of different lengths
+        }
+        used[count++] = j;
+    }
+    if (count < nmissing) return -1; // Not enough repair fragments
+    if (symbol_length < POMELO_DELIVERY_FEC_HEADER_BYTES) return -1;
+
+    // Copy the repair symbols, they are turned into the missing ones
+    pomelo_buffer_context_t * buffer_context =
+        receiver->context->buffer_context;
+    pomelo_buffer_t * buffers[POMELO_DELIVERY_FEC_MAX_REPAIRS];
+    uint8_t * rows[POMELO_DELIVERY_FEC_MAX_REPAIRS];
+    size_t nbuffers = 0;
+    size_t nrows = 0;
+    for (; nrows < nmissing; nrows++) {
+        pomelo_buffer_t * buffer =
+            pomelo_buffer_context_acquire(buffer_context);
+        if (!buffer) break; // Failed to acquire buffer
+        buffers[nbuffers++] = buffer;
+        if (buffer->capacity < symbol_length) break; // The symbol is too long
+
+        pomelo_delivery_fragment_t * repair =
+            pomelo_array_get_ptr(repairs, used[nrows]);
+        rows[nrows] = buffer->data;
+        memcpy(
+            buffer->data,
+            repair->content.buffer->data + repair->content.offset,
+            symbol_length
+        );
+    }
+
+    int ret = -1;
+    uint16_t lengths[POMELO_DELIVERY_FEC_MAX_REPAIRS];
+    if (nrows == nmissing) {
+        ret = receiver_solve(
+            receiver,
+            missing,
+            used,
+            nmissing,
+            rows,
+            symbol_length,
+            lengths
+        );
+    }
+
+    if (ret == 0) {
+        // Attach the rebuilt fragments
+        for (size_t b = 0; b < nmissing; b++) {
+            pomelo_buffer_view_t view;
+            view.buffer = buffers[b];
+            view.offset = POMELO_DELIVERY_FEC_HEADER_BYTES;
+            view.length = lengths[b];
+            receiver_attach_content(receiver, missing[b], &view);
+        }
+
+        receiver->recv_fragments = nfragments;
+        pomelo_atomic_uint64_fetch_add(
+            &receiver->context->root->recovered_fragments,
+            nmissing
+        );
+    }
+
+    for (size_t b = 0; b < nbuffers; b++) {
+        pomelo_buffer_unref(buffers[b]);
+    }
+    return ret;
+}
+
+
 void pomelo_delivery_receiver_add_fragment(
     pomelo_delivery_receiver_t * receiver,
     pomelo_delivery_fragment_meta_t * meta,
@@ -273,20 +563,39 @@ void pomelo_delivery_receiver_add_fragment(
     assert(content != NULL);
 
     pomelo_array_t * fragments = receiver->fragments;
-    pomelo_delivery_fragment_t * fragment =
-        pomelo_array_get_ptr(fragments, meta->fragment_index);
-    assert(fragment != NULL);
-    if (fragment->content.buffer) return; // Received
+    size_t nfragments = fragments->size;
+    if (receiver->recv_fragments == nfragments) return; // Completed
 
-    // Attach the content to the fragment
-    pomelo_delivery_fragment_attach_content(fragment, content);
+    if (meta->fragment_index >= nfragments) {
+        receiver_add_repair(
+            receiver,
+            meta->fragment_index - nfragments,
+            content
+        );
+    } else {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(fragments, meta->fragment_index);
+        assert(fragment != NULL);
+        if (fragment->content.buffer) return; // Received
 
-    // Increment the received fragments counter
-    receiver->recv_fragments++;
-    if (receiver->recv_fragments == receiver->fragments->size) {
-        // Received all fragments, next stage
-        pomelo_pipeline_next(&receiver->pipeline);
+        // Attach the content to the fragment
+        receiver_attach_content(receiver, meta->fragment_index, content);
+
+        // Increment the received fragments counter
+        receiver->recv_fragments++;
+    }
+
+    if (receiver->recv_fragments < nfragments) {
+        if (receiver->recv_fragments + receiver->recv_repairs < nfragments) {
+            return; // Not enough fragments
+        }
+
+        int ret = receiver_recover(receiver);
+        if (ret < 0) return; // Failed to rebuild, wait for the other ones
     }
+
+    // Received all fragments, next stage
+    pomelo_pipeline_next(&receiver->pipeline);
 }
 
 
@@ -295,7 +604,10 @@ static void verify_checksum_entry(pomelo_delivery_receiver_t * receiver) {
     assert(receiver != NULL);
 
     pomelo_crypto_checksum_state_t state;
-    int ret = pomelo_crypto_checksum_init(&state);
+    int ret = pomelo_crypto_checksum_init(
+        &state,
+        receiver->checksum_algorithm
+    );
     if (ret < 0) {
         receiver->checksum_compute_result = ret;
         return;
@@ -358,7 +670,7 @@ static void verify_checksum_complete(
     int ret = memcmp(
         receiver->computed_checksum,
         receiver->embedded_checksum,
-        POMELO_CRYPTO_CHECKSUM_BYTES
+        pomelo_crypto_checksum_bytes(receiver->checksum_algorithm)
     );
     if (ret != 0) {
         // The checksum is not correct
@@ -379,7 +691,9 @@ void pomelo_delivery_receiver_verify_checksum(
 
     // Slice the checksum from the last fragment
     pomelo_array_t * fragments = receiver->fragments;
-    if (fragments->size < 2) {
+    size_t checksum_bytes =
+        pomelo_crypto_checksum_bytes(receiver->checksum_algorithm);
+    if (fragments->size < 2 || checksum_bytes == 0) {
         // Skip checksum verification
         pomelo_pipeline_next(&receiver->pipeline);
         return;
@@ -389,7 +703,7 @@ void pomelo_delivery_receiver_verify_checksum(
         pomelo_array_get_ptr(fragments, fragments->size - 1);
     assert(fragment != NULL);
 
-    if (fragment->content.length < POMELO_CRYPTO_CHECKSUM_BYTES) {
+    if (fragment->content.length < checksum_bytes) {
         // Not enough data
         receiver->flags |= POMELO_DELIVERY_RECEIVER_FLAG_FAILED;
         pomelo_pipeline_finish(&receiver->pipeline);
@@ -399,9 +713,16 @@ void pomelo_delivery_receiver_verify_checksum(
     // Mark the checksum in the last fragment
     pomelo_buffer_view_t * content = &fragment->content;
     size_t checksum_offset =
-        content->offset + content->length - POMELO_CRYPTO_CHECKSUM_BYTES;
+        content->offset + content->length - checksum_bytes;
     receiver->embedded_checksum = content->buffer->data + checksum_offset;
-    content->length -= POMELO_CRYPTO_CHECKSUM_BYTES;
+    content->length -= checksum_bytes;
+
+    if (pomelo_crypto_checksum_inline(receiver->checksum_algorithm)) {
+        // Fast algorithm, verify it in place
+        verify_checksum_entry(receiver);
+        verify_checksum_complete(receiver, false);
+        return;
+    }
 
     // Submit the checksum verification task
     receiver->checksum_verify_task = pomelo_platform_submit_worker_task(
@@ -439,9 +760,7 @@ void pomelo_delivery_receiver_complete(pomelo_delivery_receiver_t * receiver) {
         receiver->expired_entry = NULL;
     }
 
-    assert(receiver->sequence_entry != NULL);
-    pomelo_map_remove(bus->receivers_map, receiver->sequence_entry);
-    receiver->sequence_entry = NULL;
+    pomelo_delivery_bus_remove_receiver(bus, receiver);
 
     pomelo_delivery_bus_handle_receiver_complete(receiver->bus, receiver);
     pomelo_pool_release(context->receiver_pool, receiver);
@@ -47,6 +47,16 @@ struct pomelo_delivery_receiver_s {
     /// @brief The array of received fragments
     pomelo_array_t * fragments;
 
+    /// @brief The number of received FEC repair fragments
+    size_t recv_repairs;
+
+    /// @brief The array of received FEC repair fragments
+    pomelo_array_t * repairs;
+
+    /// @brief The contiguous body of the parcel. The received fragments are
+    /// copied into it at their final positions.
+    pomelo_buffer_t * body;
+
     /// @brief The expired time of this command (unreliable & sequenced only)
     uint64_t expired_time;
 
@@ -65,6 +75,9 @@ struct pomelo_delivery_receiver_s {
     /// @brief The result of checksum computation
     int checksum_compute_result;
 
+    /// @brief The checksum algorithm of the receiving endpoint
+    pomelo_checksum checksum_algorithm;
+
     /// @brief The embedded checksum of the parcel
     uint8_t * embedded_checksum;
 
@@ -129,7 +142,8 @@ void pomelo_delivery_receiver_wait_fragments(
 );
 
 
-/// @brief Add a fragment to the receiving command
+/// @brief Add a fragment to the receiving command. The fragments whose indices
+/// are greater than the last index are FEC repair fragments.
 void pomelo_delivery_receiver_add_fragment(
     pomelo_delivery_receiver_t * receiver,
     pomelo_delivery_fragment_meta_t * meta,
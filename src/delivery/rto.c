@@ -0,0 +1,49 @@
+#include <assert.h>
+#include "rto.h"
+
+
+void pomelo_delivery_rto_init(pomelo_delivery_rto_t * rto) {
+    assert(rto != NULL);
+    rto->srtt = 0;
+    rto->rttvar = 0;
+    rto->rto = POMELO_DELIVERY_RTO_INITIAL_NS;
+    rto->measured = false;
+}
+
+
+void pomelo_delivery_rto_submit(pomelo_delivery_rto_t * rto, uint64_t sample) {
+    assert(rto != NULL);
+
+    if (!rto->measured) {
+        rto->srtt = sample;
+        rto->rttvar = sample / 2;
+        rto->measured = true;
+    } else {
+        uint64_t delta = (rto->srtt > sample)
+            ? (rto->srtt - sample)
+            : (sample - rto->srtt);
+        rto->rttvar = (3 * rto->rttvar + delta) / 4;
+        rto->srtt = (7 * rto->srtt + sample) / 8;
+    }
+
+    uint64_t variance = 4 * rto->rttvar;
+    if (variance < POMELO_DELIVERY_RTO_GRANULARITY_NS) {
+        variance = POMELO_DELIVERY_RTO_GRANULARITY_NS;
+    }
+
+    uint64_t timeout = rto->srtt + variance;
+    if (timeout < POMELO_DELIVERY_RTO_MIN_NS) {
+        timeout = POMELO_DELIVERY_RTO_MIN_NS;
+    } else if (timeout > POMELO_DELIVERY_RTO_MAX_NS) {
+        timeout = POMELO_DELIVERY_RTO_MAX_NS;
+    }
+    rto->rto = timeout;
+}
+
+
+uint64_t pomelo_delivery_rto_backoff(uint64_t timeout) {
+    if (timeout >= POMELO_DELIVERY_RTO_MAX_NS / 2) {
+        return POMELO_DELIVERY_RTO_MAX_NS;
+    }
+    return timeout * 2;
+}
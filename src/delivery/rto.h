@@ -0,0 +1,79 @@
+#ifndef POMELO_DELIVERY_RTO_SRC_H
+#define POMELO_DELIVERY_RTO_SRC_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+    Retransmission timeout (RFC 6298)
+    ---------------------------------
+    For the first RTT sample R:
+        SRTT   = R
+        RTTVAR = R / 2
+
+    For the subsequent samples R':
+        RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R'|
+        SRTT   = 7/8 * SRTT + 1/8 * R'
+
+    Then:
+        RTO = SRTT + max(G, 4 * RTTVAR)
+
+    The RTO is clamped to [10ms, 1s], which suits realtime traffic better than
+    the 1s minimum of the RFC. Every timeout of a reliable parcel doubles its
+    own RTO (exponential backoff) until an ACK brings new progress.
+*/
+
+
+/// @brief The minimum retransmission timeout
+#define POMELO_DELIVERY_RTO_MIN_NS 10000000ULL // 10ms
+
+/// @brief The maximum retransmission timeout, including the backoff
+#define POMELO_DELIVERY_RTO_MAX_NS 1000000000ULL // 1s
+
+/// @brief The retransmission timeout before any RTT sample
+#define POMELO_DELIVERY_RTO_INITIAL_NS 100000000ULL // 100ms
+
+/// @brief The clock granularity (G) of the platform timers
+#define POMELO_DELIVERY_RTO_GRANULARITY_NS 1000000ULL // 1ms
+
+
+/// @brief The retransmission timeout estimator
+typedef struct pomelo_delivery_rto_s pomelo_delivery_rto_t;
+
+
+struct pomelo_delivery_rto_s {
+    /// @brief The smoothed RTT in nanoseconds
+    uint64_t srtt;
+
+    /// @brief The RTT variation in nanoseconds
+    uint64_t rttvar;
+
+    /// @brief The current retransmission timeout in nanoseconds
+    uint64_t rto;
+
+    /// @brief Whether the estimator has received any RTT sample
+    bool measured;
+};
+
+
+/// @brief Initialize the estimator
+void pomelo_delivery_rto_init(pomelo_delivery_rto_t * rto);
+
+
+/// @brief Submit a new RTT sample in nanoseconds
+void pomelo_delivery_rto_submit(pomelo_delivery_rto_t * rto, uint64_t sample);
+
+
+/// @brief Double the timeout for the next retransmission
+/// @return The backed off timeout, at most POMELO_DELIVERY_RTO_MAX_NS
+uint64_t pomelo_delivery_rto_backoff(uint64_t timeout);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_DELIVERY_RTO_SRC_H
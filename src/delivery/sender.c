@@ -92,12 +92,20 @@ int pomelo_delivery_sender_init(
     sender->flags = 0;
     sender->checksum_update_task = NULL;
     sender->checksum_compute_result = 0;
+    sender->checksum_algorithm = info->checksum;
 
     if (parcel->chunks->size == 0) {
         return -1; // No chunks
     }
 
-    if (parcel->chunks->size > 1) {
+    if (info->checksum >= POMELO_CHECKSUM_COUNT) {
+        return -1; // Invalid checksum algorithm
+    }
+
+    if (
+        parcel->chunks->size > 1 &&
+        pomelo_crypto_checksum_bytes(info->checksum) > 0
+    ) {
         sender->checksum =
             pomelo_buffer_context_acquire(context->buffer_context);
         if (!sender->checksum) return -1;
@@ -200,7 +208,7 @@ static void update_checksum_entry(pomelo_delivery_sender_t * sender) {
     assert(sender != NULL);
 
     pomelo_crypto_checksum_state_t state;
-    int ret = pomelo_crypto_checksum_init(&state);
+    int ret = pomelo_crypto_checksum_init(&state, sender->checksum_algorithm);
     if (ret < 0) {
         sender->checksum_compute_result = ret;
         return;
@@ -263,11 +271,18 @@ static void update_checksum_complete(
 
 void pomelo_delivery_sender_update_checksum(pomelo_delivery_sender_t * sender) {
     assert(sender != NULL);
-    if (sender->parcel->chunks->size < 2) {
+    if (!sender->checksum) {
         pomelo_pipeline_next(&sender->pipeline);
         return; // No checksum
     }
 
+    if (pomelo_crypto_checksum_inline(sender->checksum_algorithm)) {
+        // Fast algorithm, compute it in place
+        update_checksum_entry(sender);
+        update_checksum_complete(sender, false);
+        return;
+    }
+
     // Submit the checksum update task
     sender->checksum_update_task = pomelo_platform_submit_worker_task(
         sender->platform,
@@ -297,12 +312,18 @@ static int create_and_submit_dispatcher(
         .sender = sender,
         .bus = bus,
         .parcel = sender->parcel,
-        .sequence = ++bus->sequence_generator,
+        .sequence = pomelo_delivery_bus_next_sequence(bus, recipient->mode),
         .mode = recipient->mode
     };
     pomelo_delivery_dispatcher_t * dispatcher =
         pomelo_pool_acquire(context->dispatcher_pool, &info);
-    if (!dispatcher) return -1;
+    if (!dispatcher) {
+        if (pomelo_delivery_mode_is_reliable(info.mode)) {
+            // Give back the reliable sequence, it must not have any hole
+            bus->reliable_sequence_generator--;
+        }
+        return -1; // Failed to acquire new dispatcher
+    }
 
     // Trigger the sending process
     pomelo_delivery_bus_process_sending(bus);
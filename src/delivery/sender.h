@@ -67,6 +67,9 @@ struct pomelo_delivery_sender_s {
 
     /// @brief The buffer for checksum
     pomelo_buffer_t * checksum;
+
+    /// @brief The checksum algorithm
+    pomelo_checksum checksum_algorithm;
 };
 
 
@@ -0,0 +1,366 @@
+#include <assert.h>
+#include <string.h>
+#include "executor.h"
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+
+pomelo_platform_threadsafe_controller_t *
+pomelo_platform_threadsafe_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator
+) {
+    assert(allocator != NULL);
+
+    pomelo_platform_threadsafe_controller_t * controller =
+        pomelo_allocator_malloc_t(
+            allocator,
+            pomelo_platform_threadsafe_controller_t
+        );
+    if (!controller) {
+        return NULL;
+    }
+    memset(controller, 0, sizeof(pomelo_platform_threadsafe_controller_t));
+    controller->platform = platform;
+    controller->allocator = allocator;
+    pthread_mutex_init(&controller->mutex, NULL);
+
+    pomelo_atomic_int64_store(&controller->running, false);
+    pomelo_atomic_uint64_store(&controller->task_counter, 0);
+
+    // Create tasks pool
+    pomelo_pool_root_options_t pool_options;
+    memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
+    pool_options.allocator = allocator;
+    pool_options.element_size = sizeof(pomelo_platform_task_threadsafe_t);
+    pool_options.zero_init = true;
+    pool_options.synchronized = true;
+    controller->task_pool = pomelo_pool_root_create(&pool_options);
+    if (!controller->task_pool) {
+        pomelo_platform_threadsafe_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Create executor pool
+    memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
+    pool_options.allocator = allocator;
+    pool_options.element_size = sizeof(pomelo_threadsafe_executor_t);
+    pool_options.zero_init = true;
+    pool_options.synchronized = true;
+    controller->executor_pool = pomelo_pool_root_create(&pool_options);
+    if (!controller->executor_pool) {
+        pomelo_platform_threadsafe_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Create executors list
+    pomelo_list_options_t list_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_threadsafe_executor_t *)
+    };
+    controller->executors = pomelo_list_create(&list_options);
+    if (!controller->executors) {
+        pomelo_platform_threadsafe_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Create tasks lists
+    list_options.element_size = sizeof(pomelo_platform_task_threadsafe_t *);
+    controller->tasks_front = pomelo_list_create(&list_options);
+    if (!controller->tasks_front) {
+        pomelo_platform_threadsafe_controller_destroy(controller);
+        return NULL;
+    }
+
+    controller->tasks_back = pomelo_list_create(&list_options);
+    if (!controller->tasks_back) {
+        pomelo_platform_threadsafe_controller_destroy(controller);
+        return NULL;
+    }
+
+    return controller;
+}
+
+
+void pomelo_platform_threadsafe_controller_destroy(
+    pomelo_platform_threadsafe_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_allocator_t * allocator = controller->allocator;
+
+    if (controller->task_pool) {
+        pomelo_pool_destroy(controller->task_pool);
+        controller->task_pool = NULL;
+    }
+
+    if (controller->executor_pool) {
+        pomelo_pool_destroy(controller->executor_pool);
+        controller->executor_pool = NULL;
+    }
+
+    if (controller->executors) {
+        pomelo_list_destroy(controller->executors);
+        controller->executors = NULL;
+    }
+
+    if (controller->tasks_front) {
+        pomelo_list_destroy(controller->tasks_front);
+        controller->tasks_front = NULL;
+    }
+
+    if (controller->tasks_back) {
+        pomelo_list_destroy(controller->tasks_back);
+        controller->tasks_back = NULL;
+    }
+
+    pthread_mutex_destroy(&controller->mutex);
+    pomelo_allocator_free(allocator, controller);
+}
+
+
+void pomelo_platform_threadsafe_controller_startup(
+    pomelo_platform_threadsafe_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_atomic_int64_store(&controller->running, true);
+}
+
+
+void pomelo_platform_threadsafe_controller_shutdown(
+    pomelo_platform_threadsafe_controller_t * controller
+) {
+    assert(controller != NULL);
+    if (!pomelo_atomic_int64_compare_exchange(
+        &controller->running, /* expected */ true, /* desired */ false
+    )) {
+        return; // Controller is already shutting down
+    }
+
+    // Executors have no kernel objects, so they are shut down at once
+    pomelo_threadsafe_executor_t * executor = NULL;
+    while (pomelo_list_pop_front(controller->executors, &executor) == 0) {
+        executor->entry = NULL;
+        pomelo_threadsafe_executor_shutdown(executor);
+    }
+
+    pomelo_platform_threadsafe_controller_on_shutdown(controller);
+}
+
+
+void pomelo_platform_threadsafe_controller_statistic(
+    pomelo_platform_threadsafe_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+) {
+    assert(controller != NULL);
+    assert(statistic != NULL);
+    statistic->threadsafe_tasks =
+        pomelo_atomic_uint64_load(&controller->task_counter);
+}
+
+
+void pomelo_platform_threadsafe_controller_process(
+    pomelo_platform_threadsafe_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_list_t * tasks = controller->tasks_front;
+
+    /* ----------- Begin mutex scope ----------- */
+    pthread_mutex_lock(&controller->mutex);
+
+    // Swap the tasks lists
+    controller->tasks_front = controller->tasks_back;
+    controller->tasks_back = tasks;
+
+    pthread_mutex_unlock(&controller->mutex);
+    /* ------------ End mutex scope ------------ */
+
+    // Update task counter
+    pomelo_atomic_uint64_fetch_sub(&controller->task_counter, tasks->size);
+
+    // Execute tasks. Shutting down an executor drops its tasks from this list.
+    pomelo_platform_task_threadsafe_t * task = NULL;
+    while (pomelo_list_pop_front(tasks, &task) == 0) {
+        pomelo_platform_task_entry entry = task->entry;
+        void * data = task->data;
+        pomelo_platform_task_threadsafe_release(task);
+
+        entry(data);
+    }
+}
+
+
+pomelo_threadsafe_executor_t *
+pomelo_platform_uring_acquire_threadsafe_executor(
+    pomelo_platform_uring_t * platform
+) {
+    assert(platform != NULL);
+    pomelo_platform_threadsafe_controller_t * controller =
+        platform->threadsafe_controller;
+
+    if (!pomelo_atomic_int64_load(&controller->running)) {
+        return NULL; // Controller is not running
+    }
+
+    pomelo_threadsafe_executor_t * executor =
+        pomelo_pool_acquire(controller->executor_pool, NULL);
+    if (!executor) return NULL; // Failed to acquire executor
+
+    executor->controller = controller;
+    executor->entry = pomelo_list_push_back(controller->executors, executor);
+    if (!executor->entry) {
+        pomelo_pool_release(controller->executor_pool, executor);
+        return NULL; // Failed to add executor to list
+    }
+
+    pomelo_atomic_int64_store(&executor->running, true);
+    return executor;
+}
+
+
+/// @brief Release the threadsafe executor
+static void release_threadsafe_executor(
+    pomelo_threadsafe_executor_t * executor
+) {
+    assert(executor != NULL);
+    pomelo_platform_threadsafe_controller_t * controller = executor->controller;
+    if (!pomelo_atomic_int64_load(&controller->running)) {
+        return; // Controller is not running
+    }
+
+    pomelo_list_remove(controller->executors, executor->entry);
+    executor->entry = NULL;
+    pomelo_threadsafe_executor_shutdown(executor);
+}
+
+
+void pomelo_platform_uring_release_threadsafe_executor(
+    pomelo_platform_uring_t * platform,
+    pomelo_threadsafe_executor_t * executor
+) {
+    assert(platform != NULL);
+    assert(executor != NULL);
+    pomelo_platform_threadsafe_controller_t * controller = executor->controller;
+    if (!pomelo_atomic_int64_load(&controller->running)) {
+        return; // Controller is not running
+    }
+    pomelo_threadsafe_executor_uring_submit(
+        platform,
+        executor,
+        (pomelo_platform_task_entry) release_threadsafe_executor,
+        executor
+    );
+}
+
+
+pomelo_platform_task_t * pomelo_threadsafe_executor_uring_submit(
+    pomelo_platform_uring_t * platform,
+    pomelo_threadsafe_executor_t * executor,
+    pomelo_platform_task_entry entry,
+    void * data
+) {
+    assert(platform != NULL);
+    assert(executor != NULL);
+    assert(entry != NULL);
+
+    pomelo_platform_threadsafe_controller_t * controller = executor->controller;
+    if (!pomelo_atomic_int64_load(&controller->running)) {
+        return NULL; // Controller is not running
+    }
+
+    if (!pomelo_atomic_int64_load(&executor->running)) {
+        return NULL; // Executor is not running
+    }
+
+    // Acquire new task
+    pomelo_platform_task_threadsafe_t * task =
+        pomelo_pool_acquire(controller->task_pool, NULL);
+    if (!task) {
+        return NULL; // Failed to acquire new task
+    }
+    task->controller = controller;
+    task->executor = executor;
+    task->entry = entry;
+    task->data = data;
+
+    /* -------------------------  Critical Begin  ----------------------- */
+    pthread_mutex_lock(&controller->mutex);
+
+    pomelo_list_entry_t * list_entry =
+        pomelo_list_push_back(controller->tasks_front, task);
+    if (list_entry) {
+        pomelo_atomic_uint64_fetch_add(&controller->task_counter, 1);
+    }
+
+    pthread_mutex_unlock(&controller->mutex);
+    /* --------------------------  Critical End  ------------------------ */
+
+    if (!list_entry) {
+        pomelo_platform_task_threadsafe_release(task);
+        return NULL; // Failed to append to list
+    }
+
+    // Send signal
+    pomelo_platform_uring_wakeup(platform);
+    return (pomelo_platform_task_t *) task;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+
+void pomelo_platform_task_threadsafe_release(
+    pomelo_platform_task_threadsafe_t * task
+) {
+    assert(task != NULL);
+    pomelo_pool_release(task->controller->task_pool, task);
+}
+
+
+/// @brief Drop all tasks of executor from the list
+static size_t executor_drop_tasks(
+    pomelo_threadsafe_executor_t * executor,
+    pomelo_list_t * tasks
+) {
+    size_t dropped = 0;
+    pomelo_platform_task_threadsafe_t * task = NULL;
+    pomelo_list_iterator_t it;
+    pomelo_list_iterator_init(&it, tasks);
+    while (pomelo_list_iterator_next(&it, &task) == 0) {
+        if (task->executor != executor) continue;
+        pomelo_list_iterator_remove(&it);
+        pomelo_platform_task_threadsafe_release(task);
+        dropped++;
+    }
+    return dropped;
+}
+
+
+void pomelo_threadsafe_executor_shutdown(
+    pomelo_threadsafe_executor_t * executor
+) {
+    assert(executor != NULL);
+    pomelo_platform_threadsafe_controller_t * controller = executor->controller;
+
+    if (!pomelo_atomic_int64_compare_exchange(
+        &executor->running, /* expected */ true, /* desired */ false
+    )) {
+        return; // Executor is not running
+    }
+
+    // The back list is owned by the loop thread
+    executor_drop_tasks(executor, controller->tasks_back);
+
+    /* ----------- Begin mutex scope ----------- */
+    pthread_mutex_lock(&controller->mutex);
+    size_t dropped = executor_drop_tasks(executor, controller->tasks_front);
+    pomelo_atomic_uint64_fetch_sub(&controller->task_counter, dropped);
+    pthread_mutex_unlock(&controller->mutex);
+    /* ------------ End mutex scope ------------ */
+
+    pomelo_pool_release(controller->executor_pool, executor);
+}
@@ -0,0 +1,148 @@
+#ifndef POMELO_PLATFORM_URING_EXECUTOR_SRC_H
+#define POMELO_PLATFORM_URING_EXECUTOR_SRC_H
+#include <pthread.h>
+#include "utils/list.h"
+#include "utils/atomic.h"
+#include "utils/pool.h"
+#include "platform-uring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// @brief Threadsafe task
+typedef struct pomelo_platform_task_threadsafe_s
+    pomelo_platform_task_threadsafe_t;
+
+
+struct pomelo_platform_threadsafe_controller_s {
+    /// @brief Platform
+    pomelo_platform_uring_t * platform;
+
+    /// @brief Allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief Pool of tasks
+    pomelo_pool_t * task_pool;
+
+    /// @brief Pool of executors
+    pomelo_pool_t * executor_pool;
+
+    /// @brief Running flag of controller
+    pomelo_atomic_int64_t running;
+
+    /// @brief Counter of tasks
+    pomelo_atomic_uint64_t task_counter;
+
+    /// @brief List of executors
+    pomelo_list_t * executors;
+
+    /// @brief Front tasks list for queuing
+    pomelo_list_t * tasks_front;
+
+    /// @brief Back tasks list for executing
+    pomelo_list_t * tasks_back;
+
+    /// @brief Mutex of the front tasks list
+    pthread_mutex_t mutex;
+};
+
+
+struct pomelo_threadsafe_executor_s {
+    /// @brief Controller
+    pomelo_platform_threadsafe_controller_t * controller;
+
+    /// @brief Running flag of executor
+    pomelo_atomic_int64_t running;
+
+    /// @brief Entry of this executor
+    pomelo_list_entry_t * entry;
+};
+
+
+struct pomelo_platform_task_threadsafe_s {
+    /// @brief Controller
+    pomelo_platform_threadsafe_controller_t * controller;
+
+    /// @brief The executor of this task
+    pomelo_threadsafe_executor_t * executor;
+
+    /// @brief Entry of this task
+    pomelo_platform_task_entry entry;
+
+    /// @brief Data of this task
+    void * data;
+};
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Create threadsafe controller
+pomelo_platform_threadsafe_controller_t *
+pomelo_platform_threadsafe_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator
+);
+
+
+/// @brief Destroy threadsafe controller
+void pomelo_platform_threadsafe_controller_destroy(
+    pomelo_platform_threadsafe_controller_t * controller
+);
+
+
+/// @brief Startup the threadsafe controller
+void pomelo_platform_threadsafe_controller_startup(
+    pomelo_platform_threadsafe_controller_t * controller
+);
+
+
+/// @brief Shutdown the threadsafe controller
+void pomelo_platform_threadsafe_controller_shutdown(
+    pomelo_platform_threadsafe_controller_t * controller
+);
+
+
+/// @brief Callback when the threadsafe controller is completely shutdown
+void pomelo_platform_threadsafe_controller_on_shutdown(
+    pomelo_platform_threadsafe_controller_t * controller
+);
+
+
+/// @brief Get statistic information
+void pomelo_platform_threadsafe_controller_statistic(
+    pomelo_platform_threadsafe_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+);
+
+
+/// @brief Execute all queued tasks. This is called in the loop thread after
+/// the loop has been woken up.
+void pomelo_platform_threadsafe_controller_process(
+    pomelo_platform_threadsafe_controller_t * controller
+);
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Release threadsafe task
+void pomelo_platform_task_threadsafe_release(
+    pomelo_platform_task_threadsafe_t * task
+);
+
+
+/// @brief Shutdown the threadsafe executor and drop all of its queued tasks
+void pomelo_threadsafe_executor_shutdown(
+    pomelo_threadsafe_executor_t * executor
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PLATFORM_URING_EXECUTOR_SRC_H
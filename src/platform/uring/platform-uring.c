@@ -0,0 +1,505 @@
+#include <assert.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "utils/macro.h"
+#include "platform-uring.h"
+#include "executor.h"
+#include "worker.h"
+#include "timer.h"
+#include "udp.h"
+
+
+/// @brief Round up to the next power of two
+static uint32_t round_up_power_of_two(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+
+/// @brief Initialize the ring. Optional setup flags are dropped if the kernel
+/// does not support them.
+static int platform_ring_init(
+    pomelo_platform_uring_t * platform,
+    uint32_t queue_depth
+) {
+    unsigned flags = IORING_SETUP_SUBMIT_ALL |
+        IORING_SETUP_COOP_TASKRUN |
+        IORING_SETUP_SINGLE_ISSUER;
+
+    int ret = io_uring_queue_init(queue_depth, &platform->ring, flags);
+    if (ret == -EINVAL) {
+        ret = io_uring_queue_init(queue_depth, &platform->ring, 0);
+    }
+    return ret;
+}
+
+
+void pomelo_platform_uring_set_extra(
+    pomelo_platform_uring_t * platform,
+    void * data
+) {
+    assert(platform != NULL);
+    pomelo_extra_set(platform->extra, data);
+}
+
+
+void * pomelo_platform_uring_get_extra(pomelo_platform_uring_t * platform) {
+    assert(platform != NULL);
+    return pomelo_extra_get(platform->extra);
+}
+
+
+pomelo_platform_t * pomelo_platform_uring_create(
+    pomelo_platform_uring_options_t * options
+) {
+    assert(options != NULL);
+
+    pomelo_allocator_t * allocator = options->allocator;
+    if (!allocator) {
+        allocator = pomelo_allocator_default();
+    }
+
+    uint32_t queue_depth = options->queue_depth;
+    if (queue_depth == 0) {
+        queue_depth = POMELO_PLATFORM_URING_DEFAULT_QUEUE_DEPTH;
+    }
+
+    uint32_t recv_buffers = options->recv_buffers;
+    if (recv_buffers == 0) {
+        recv_buffers = POMELO_PLATFORM_URING_DEFAULT_RECV_BUFFERS;
+    }
+    recv_buffers = round_up_power_of_two(
+        POMELO_MIN(recv_buffers, POMELO_PLATFORM_URING_RECV_BUFFERS_MAX)
+    );
+
+    size_t recv_buffer_size = options->recv_buffer_size;
+    if (recv_buffer_size == 0) {
+        recv_buffer_size = POMELO_PLATFORM_URING_DEFAULT_RECV_BUFFER_SIZE;
+    }
+
+    size_t worker_threads = options->worker_threads;
+    if (worker_threads == 0) {
+        worker_threads = POMELO_PLATFORM_URING_DEFAULT_WORKER_THREADS;
+    }
+
+    pomelo_platform_uring_t * platform =
+        pomelo_allocator_malloc_t(allocator, pomelo_platform_uring_t);
+    if (!platform) return NULL; // Failed to allocate new platform
+
+    memset(platform, 0, sizeof(pomelo_platform_uring_t));
+    pomelo_extra_set(platform->extra, NULL);
+    platform->allocator = allocator;
+    platform->wakeup_fd = -1;
+
+    if (platform_ring_init(platform, queue_depth) < 0) {
+        pomelo_platform_uring_destroy((pomelo_platform_t *) platform);
+        return NULL; // io_uring is not available
+    }
+    platform->ring_initialized = true;
+
+    platform->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (platform->wakeup_fd < 0) {
+        pomelo_platform_uring_destroy((pomelo_platform_t *) platform);
+        return NULL;
+    }
+
+    platform->worker_controller = pomelo_platform_worker_controller_create(
+        platform, allocator, worker_threads
+    );
+    if (!platform->worker_controller) {
+        pomelo_platform_uring_destroy((pomelo_platform_t *) platform);
+        return NULL;
+    }
+
+    platform->threadsafe_controller =
+        pomelo_platform_threadsafe_controller_create(platform, allocator);
+    if (!platform->threadsafe_controller) {
+        pomelo_platform_uring_destroy((pomelo_platform_t *) platform);
+        return NULL;
+    }
+
+    platform->udp_controller = pomelo_platform_udp_controller_create(
+        platform, allocator, recv_buffers, recv_buffer_size
+    );
+    if (!platform->udp_controller) {
+        pomelo_platform_uring_destroy((pomelo_platform_t *) platform);
+        return NULL;
+    }
+    platform->udp_controller->reuse_port = options->reuse_port;
+
+    // Create timer manager
+    platform->timer_controller =
+        pomelo_platform_timer_controller_create(platform, allocator);
+    if (!platform->timer_controller) {
+        pomelo_platform_uring_destroy((pomelo_platform_t *) platform);
+        return NULL;
+    }
+
+    return (pomelo_platform_t *) platform;
+}
+
+
+void pomelo_platform_uring_destroy(pomelo_platform_t * platform) {
+    assert(platform != NULL);
+    pomelo_platform_uring_t * uring_platform =
+        (pomelo_platform_uring_t *) platform;
+
+    if (uring_platform->timer_controller) {
+        pomelo_platform_timer_controller_destroy(
+            uring_platform->timer_controller
+        );
+        uring_platform->timer_controller = NULL;
+    }
+
+    if (uring_platform->threadsafe_controller) {
+        pomelo_platform_threadsafe_controller_destroy(
+            uring_platform->threadsafe_controller
+        );
+        uring_platform->threadsafe_controller = NULL;
+    }
+
+    // Worker threads are joined here
+    if (uring_platform->worker_controller) {
+        pomelo_platform_worker_controller_destroy(
+            uring_platform->worker_controller
+        );
+        uring_platform->worker_controller = NULL;
+    }
+
+    if (uring_platform->udp_controller) {
+        pomelo_platform_udp_controller_destroy(
+            uring_platform->udp_controller
+        );
+        uring_platform->udp_controller = NULL;
+    }
+
+    if (uring_platform->ring_initialized) {
+        io_uring_queue_exit(&uring_platform->ring);
+        uring_platform->ring_initialized = false;
+    }
+
+    if (uring_platform->wakeup_fd >= 0) {
+        close(uring_platform->wakeup_fd);
+        uring_platform->wakeup_fd = -1;
+    }
+
+    pomelo_allocator_free(uring_platform->allocator, uring_platform);
+}
+
+
+void pomelo_platform_uring_statistic(
+    pomelo_platform_t * platform,
+    pomelo_statistic_platform_uring_t * statistic
+) {
+    assert(platform != NULL);
+    assert(statistic != NULL);
+
+    pomelo_platform_uring_t * uring_platform =
+        (pomelo_platform_uring_t *) platform;
+
+    pomelo_platform_timer_controller_statistic(
+        uring_platform->timer_controller,
+        statistic
+    );
+
+    pomelo_platform_udp_controller_statistic(
+        uring_platform->udp_controller,
+        statistic
+    );
+
+    pomelo_platform_threadsafe_controller_statistic(
+        uring_platform->threadsafe_controller,
+        statistic
+    );
+
+    pomelo_platform_worker_controller_statistic(
+        uring_platform->worker_controller,
+        statistic
+    );
+
+    statistic->submissions = uring_platform->submissions;
+    statistic->completions = uring_platform->completions;
+}
+
+
+/// @brief Arm the read of wakeup eventfd
+static void wakeup_arm(pomelo_platform_uring_t * platform) {
+    struct io_uring_sqe * sqe = pomelo_platform_uring_get_sqe(platform);
+    if (!sqe) return; // The ring is full, try again in the next iteration
+
+    io_uring_prep_read(
+        sqe,
+        platform->wakeup_fd,
+        &platform->wakeup_value,
+        sizeof(uint64_t),
+        0
+    );
+    io_uring_sqe_set_data(sqe, &platform->wakeup_op);
+    platform->wakeup_armed = true;
+}
+
+
+/// @brief The completion callback of wakeup eventfd
+static void wakeup_complete(
+    pomelo_platform_uring_op_t * op,
+    struct io_uring_cqe * cqe
+) {
+    (void) cqe;
+    pomelo_platform_uring_t * platform =
+        pomelo_platform_uring_container(op, pomelo_platform_uring_t, wakeup_op);
+    platform->wakeup_armed = false;
+
+    pomelo_platform_threadsafe_controller_process(
+        platform->threadsafe_controller
+    );
+    pomelo_platform_worker_controller_process(platform->worker_controller);
+}
+
+
+void pomelo_platform_uring_startup(pomelo_platform_uring_t * platform) {
+    assert(platform != NULL);
+
+    platform->running = true;
+    platform->shutdown_completed = false;
+    platform->wakeup_op.callback = wakeup_complete;
+
+    pomelo_platform_udp_controller_startup(platform->udp_controller);
+    pomelo_platform_timer_controller_startup(platform->timer_controller);
+    pomelo_platform_threadsafe_controller_startup(
+        platform->threadsafe_controller
+    );
+    pomelo_platform_worker_controller_startup(platform->worker_controller);
+}
+
+
+void pomelo_platform_uring_shutdown(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_shutdown_callback callback
+) {
+    assert(platform != NULL);
+    if (!platform->running) return; // Already shutting down
+
+    platform->running = false;
+    platform->shutdown_callback = callback;
+    platform->shutdown_components = 0;
+
+    // Like the idle handle of uv platform, components are shut down in the
+    // next loop iteration.
+    platform->shutdown_pending = true;
+}
+
+
+/// @brief Shutdown all components
+static void platform_shutdown_components(pomelo_platform_uring_t * platform) {
+    platform->shutdown_pending = false;
+
+    pomelo_platform_udp_controller_shutdown(platform->udp_controller);
+    pomelo_platform_timer_controller_shutdown(platform->timer_controller);
+    pomelo_platform_threadsafe_controller_shutdown(
+        platform->threadsafe_controller
+    );
+    pomelo_platform_worker_controller_shutdown(platform->worker_controller);
+}
+
+
+int pomelo_platform_uring_run(pomelo_platform_t * platform) {
+    assert(platform != NULL);
+    pomelo_platform_uring_t * uring_platform =
+        (pomelo_platform_uring_t *) platform;
+    struct io_uring * ring = &uring_platform->ring;
+    struct io_uring_cqe * cqes[POMELO_PLATFORM_URING_CQE_BATCH_SIZE];
+
+    while (!uring_platform->shutdown_completed) {
+        if (uring_platform->shutdown_pending) {
+            platform_shutdown_components(uring_platform);
+            continue;
+        }
+
+        // Run expired timers
+        uint64_t now_ms = pomelo_platform_uring_hrtime(uring_platform)
+            / 1000000ULL;
+        pomelo_platform_timer_controller_run(
+            uring_platform->timer_controller,
+            now_ms
+        );
+        if (uring_platform->shutdown_completed) break;
+
+        if (!uring_platform->wakeup_armed) {
+            wakeup_arm(uring_platform);
+        }
+
+        // Submit all queued entries and wait for at least one completion or
+        // the next timer deadline.
+        struct __kernel_timespec timeout;
+        struct __kernel_timespec * p_timeout = NULL;
+        int64_t timeout_ms = uring_platform->shutdown_pending
+            ? 0
+            : pomelo_platform_timer_controller_next_timeout(
+                uring_platform->timer_controller,
+                now_ms
+            );
+        if (timeout_ms >= 0) {
+            timeout.tv_sec = timeout_ms / 1000;
+            timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+            p_timeout = &timeout;
+        }
+
+        struct io_uring_cqe * cqe = NULL;
+        int ret = io_uring_submit_and_wait_timeout(
+            ring,
+            &cqe,
+            1,
+            p_timeout,
+            NULL
+        );
+        uring_platform->submissions++;
+        if (ret < 0 && ret != -ETIME && ret != -EINTR && ret != -EBUSY) {
+            return -1; // The ring is broken
+        }
+
+        // Reap completions in batches
+        unsigned count;
+        while ((count = io_uring_peek_batch_cqe(
+            ring,
+            cqes,
+            POMELO_PLATFORM_URING_CQE_BATCH_SIZE
+        )) > 0) {
+            for (unsigned i = 0; i < count; i++) {
+                pomelo_platform_uring_op_t * op =
+                    io_uring_cqe_get_data(cqes[i]);
+                if (op) {
+                    // Cancellation requests carry no operation
+                    op->callback(op, cqes[i]);
+                }
+            }
+            io_uring_cq_advance(ring, count);
+            uring_platform->completions += count;
+        }
+    }
+
+    return 0;
+}
+
+
+uint64_t pomelo_platform_uring_hrtime(pomelo_platform_uring_t * platform) {
+    (void) platform;
+    struct timespec t;
+    if (clock_gettime(CLOCK_MONOTONIC, &t)) {
+        return 0;
+    }
+
+    return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+
+uint64_t pomelo_platform_uring_now(pomelo_platform_uring_t * platform) {
+    (void) platform;
+    struct timespec t;
+    if (clock_gettime(CLOCK_REALTIME, &t)) {
+        return 0;
+    }
+
+    return t.tv_sec * 1000ULL + t.tv_nsec / 1000000ULL;
+}
+
+
+struct io_uring_sqe * pomelo_platform_uring_get_sqe(
+    pomelo_platform_uring_t * platform
+) {
+    assert(platform != NULL);
+    struct io_uring_sqe * sqe = io_uring_get_sqe(&platform->ring);
+    if (sqe) return sqe;
+
+    // The submission queue is full, submit the pending entries first
+    if (io_uring_submit(&platform->ring) < 0) {
+        return NULL;
+    }
+    platform->submissions++;
+    return io_uring_get_sqe(&platform->ring);
+}
+
+
+void pomelo_platform_uring_wakeup(pomelo_platform_uring_t * platform) {
+    assert(platform != NULL);
+    uint64_t value = 1;
+    ssize_t ret;
+    do {
+        ret = write(platform->wakeup_fd, &value, sizeof(uint64_t));
+    } while (ret < 0 && errno == EINTR);
+    // EAGAIN means the counter is saturated, the loop is already woken up
+}
+
+
+void pomelo_platform_threadsafe_controller_on_shutdown(
+    pomelo_platform_threadsafe_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_platform_uring_t * platform = controller->platform;
+    assert(platform != NULL);
+    assert(!platform->running);
+
+    platform->shutdown_components |=
+        POMELO_PLATFORM_URING_COMPONENT_THREADSAFE;
+    pomelo_platform_uring_check_shutdown(platform);
+}
+
+
+void pomelo_platform_worker_controller_on_shutdown(
+    pomelo_platform_worker_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_platform_uring_t * platform = controller->platform;
+    assert(platform != NULL);
+    assert(!platform->running);
+
+    platform->shutdown_components |= POMELO_PLATFORM_URING_COMPONENT_WORKER;
+    pomelo_platform_uring_check_shutdown(platform);
+}
+
+
+void pomelo_platform_udp_controller_on_shutdown(
+    pomelo_platform_udp_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_platform_uring_t * platform = controller->platform;
+    assert(platform != NULL);
+    assert(!platform->running);
+
+    platform->shutdown_components |= POMELO_PLATFORM_URING_COMPONENT_UDP;
+    pomelo_platform_uring_check_shutdown(platform);
+}
+
+
+void pomelo_platform_timer_controller_on_shutdown(
+    pomelo_platform_timer_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_platform_uring_t * platform = controller->platform;
+    assert(platform != NULL);
+    assert(!platform->running);
+
+    platform->shutdown_components |= POMELO_PLATFORM_URING_COMPONENT_TIMER;
+    pomelo_platform_uring_check_shutdown(platform);
+}
+
+
+void pomelo_platform_uring_check_shutdown(pomelo_platform_uring_t * platform) {
+    assert(platform != NULL);
+    assert(!platform->running);
+
+    if (platform->shutdown_completed) return; // Already shutdown
+    if (platform->shutdown_components != POMELO_PLATFORM_URING_COMPONENT_ALL) {
+        return; // Some components are still running
+    }
+
+    platform->shutdown_completed = true;
+    if (platform->shutdown_callback) {
+        platform->shutdown_callback((pomelo_platform_t *) platform);
+    }
+}
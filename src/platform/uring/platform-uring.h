@@ -0,0 +1,301 @@
+#ifndef POMELO_PLATFORM_URING_SRC_H
+#define POMELO_PLATFORM_URING_SRC_H
+#include <stddef.h>
+#include "liburing.h"
+#include "pomelo/platforms/platform-uring.h"
+#include "base/extra.h"
+#include "platform/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define POMELO_PLATFORM_URING_COMPONENT_TIMER      (1 << 0)
+#define POMELO_PLATFORM_URING_COMPONENT_UDP        (1 << 1)
+#define POMELO_PLATFORM_URING_COMPONENT_WORKER     (1 << 2)
+#define POMELO_PLATFORM_URING_COMPONENT_THREADSAFE (1 << 3)
+#define POMELO_PLATFORM_URING_COMPONENT_ALL (    \
+    POMELO_PLATFORM_URING_COMPONENT_TIMER      | \
+    POMELO_PLATFORM_URING_COMPONENT_UDP        | \
+    POMELO_PLATFORM_URING_COMPONENT_WORKER     | \
+    POMELO_PLATFORM_URING_COMPONENT_THREADSAFE   \
+)
+
+/// @brief The default number of submission queue entries
+#define POMELO_PLATFORM_URING_DEFAULT_QUEUE_DEPTH 1024
+
+/// @brief The default number of provided receiving buffers
+#define POMELO_PLATFORM_URING_DEFAULT_RECV_BUFFERS 1024
+
+/// @brief The default maximum payload size of received datagrams
+#define POMELO_PLATFORM_URING_DEFAULT_RECV_BUFFER_SIZE 2048
+
+/// @brief The default number of worker threads
+#define POMELO_PLATFORM_URING_DEFAULT_WORKER_THREADS 4
+
+/// @brief The upper bound of provided receiving buffers (buffer IDs are 16-bit)
+#define POMELO_PLATFORM_URING_RECV_BUFFERS_MAX 32768
+
+/// @brief The maximum number of completions reaped at once
+#define POMELO_PLATFORM_URING_CQE_BATCH_SIZE 64
+
+/// @brief Get the object which embeds an operation
+#define pomelo_platform_uring_container(op, type, member)                      \
+    ((type *) (((char *) (op)) - offsetof(type, member)))
+
+
+/// @brief Platform io_uring
+typedef struct pomelo_platform_uring_s pomelo_platform_uring_t;
+
+/// @brief The asynchronous operation which is submitted to the ring
+typedef struct pomelo_platform_uring_op_s pomelo_platform_uring_op_t;
+
+/// @brief The timer controller
+typedef struct pomelo_platform_timer_controller_s
+    pomelo_platform_timer_controller_t;
+
+/// @brief The udp controller
+typedef struct pomelo_platform_udp_controller_s
+    pomelo_platform_udp_controller_t;
+
+/// @brief The worker controller
+typedef struct pomelo_platform_worker_controller_s
+    pomelo_platform_worker_controller_t;
+
+/// @brief The threadsafe controller
+typedef struct pomelo_platform_threadsafe_controller_s
+    pomelo_platform_threadsafe_controller_t;
+
+/// @brief The completion callback of operation
+typedef void (*pomelo_platform_uring_op_cb)(
+    pomelo_platform_uring_op_t * op,
+    struct io_uring_cqe * cqe
+);
+
+
+struct pomelo_platform_uring_op_s {
+    /// @brief The completion callback. The user data of every submitted entry
+    /// points to an operation.
+    pomelo_platform_uring_op_cb callback;
+};
+
+
+struct pomelo_platform_uring_s {
+    /// @brief The extra data
+    pomelo_extra_t extra;
+
+    /// @brief The allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The ring
+    struct io_uring ring;
+
+    /// @brief Whether the ring has been initialized
+    bool ring_initialized;
+
+    /// @brief The flag of running
+    bool running;
+
+    /// @brief The flag of pending shutdown. Shutdown is deferred to the next
+    /// loop iteration.
+    bool shutdown_pending;
+
+    /// @brief The flag of completely shutdown
+    bool shutdown_completed;
+
+    /// @brief The shutdown callback
+    pomelo_platform_shutdown_callback shutdown_callback;
+
+    /// @brief The bitmask of shutdown components
+    uint32_t shutdown_components;
+
+    /// @brief The eventfd for waking up the loop from other threads
+    int wakeup_fd;
+
+    /// @brief The read operation of wakeup eventfd
+    pomelo_platform_uring_op_t wakeup_op;
+
+    /// @brief The value read from wakeup eventfd
+    uint64_t wakeup_value;
+
+    /// @brief Whether the wakeup read is in flight
+    bool wakeup_armed;
+
+    /// @brief The number of submit calls
+    uint64_t submissions;
+
+    /// @brief The number of reaped completions
+    uint64_t completions;
+
+    /// @brief The timer manager
+    pomelo_platform_timer_controller_t * timer_controller;
+
+    /// @brief The socket manager
+    pomelo_platform_udp_controller_t * udp_controller;
+
+    /// @brief Worker controller
+    pomelo_platform_worker_controller_t * worker_controller;
+
+    /// @brief Threadsafe controller
+    pomelo_platform_threadsafe_controller_t * threadsafe_controller;
+};
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Public APIs                                  */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Set the extra data of platform
+void pomelo_platform_uring_set_extra(
+    pomelo_platform_uring_t * platform,
+    void * data
+);
+
+
+/// @brief Get the extra data of platform
+void * pomelo_platform_uring_get_extra(pomelo_platform_uring_t * platform);
+
+
+/// @brief Startup the platform
+void pomelo_platform_uring_startup(pomelo_platform_uring_t * platform);
+
+
+/// @brief Shutdown the platform
+void pomelo_platform_uring_shutdown(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_shutdown_callback callback
+);
+
+
+/// @brief Acquire a threadsafe executor
+pomelo_threadsafe_executor_t *
+pomelo_platform_uring_acquire_threadsafe_executor(
+    pomelo_platform_uring_t * platform
+);
+
+
+/// @brief Release a threadsafe executor
+void pomelo_platform_uring_release_threadsafe_executor(
+    pomelo_platform_uring_t * platform,
+    pomelo_threadsafe_executor_t * executor
+);
+
+
+/// @brief Submit a task to threadsafe executor
+pomelo_platform_task_t * pomelo_threadsafe_executor_uring_submit(
+    pomelo_platform_uring_t * platform,
+    pomelo_threadsafe_executor_t * executor,
+    pomelo_platform_task_entry entry,
+    void * data
+);
+
+
+/// @brief Get high resolution time
+uint64_t pomelo_platform_uring_hrtime(pomelo_platform_uring_t * platform);
+
+
+/// @brief Get current time
+uint64_t pomelo_platform_uring_now(pomelo_platform_uring_t * platform);
+
+
+/// @brief Start a timer
+int pomelo_platform_uring_timer_start(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_timer_entry entry,
+    uint64_t timeout_ms,
+    uint64_t repeat_ms,
+    void * data,
+    pomelo_platform_timer_handle_t * handle
+);
+
+
+/// @brief Stop a timer
+void pomelo_platform_uring_timer_stop(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_timer_handle_t * handle
+);
+
+
+/// @brief Bind a UDP socket
+pomelo_platform_udp_t * pomelo_platform_uring_udp_bind(
+    pomelo_platform_uring_t * platform,
+    pomelo_address_t * address
+);
+
+
+/// @brief Connect a UDP socket
+pomelo_platform_udp_t * pomelo_platform_uring_udp_connect(
+    pomelo_platform_uring_t * platform,
+    pomelo_address_t * address
+);
+
+
+/// @brief Stop a UDP socket
+int pomelo_platform_uring_udp_stop(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_udp_t * socket
+);
+
+
+/// @brief Send data to a UDP socket
+int pomelo_platform_uring_udp_send(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_udp_t * socket,
+    pomelo_address_t * address,
+    int nbuffers,
+    pomelo_platform_iovec_t * buffers,
+    void * callback_data,
+    pomelo_platform_send_cb send_callback
+);
+
+
+/// @brief Start receiving packets from socket
+void pomelo_platform_uring_udp_recv_start(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_udp_t * socket,
+    void * context,
+    pomelo_platform_alloc_cb alloc_callback,
+    pomelo_platform_recv_cb recv_callback
+);
+
+
+/// @brief Submit a worker task
+pomelo_platform_task_t * pomelo_platform_uring_submit_worker_task(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_task_entry entry,
+    pomelo_platform_task_complete complete,
+    void * data
+);
+
+
+/// @brief Cancel a worker task
+void pomelo_platform_uring_cancel_worker_task(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_task_t * task
+);
+
+
+/* -------------------------------------------------------------------------- */
+/*                              Private APIs                                  */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Get a submission queue entry. If the submission queue is full, the
+/// pending entries are submitted first.
+/// @return The entry or NULL if the ring is unable to accept more entries
+struct io_uring_sqe * pomelo_platform_uring_get_sqe(
+    pomelo_platform_uring_t * platform
+);
+
+
+/// @brief Wake up the loop of platform. This is thread-safe.
+void pomelo_platform_uring_wakeup(pomelo_platform_uring_t * platform);
+
+
+/// @brief Check if the platform is shutdown
+void pomelo_platform_uring_check_shutdown(pomelo_platform_uring_t * platform);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PLATFORM_URING_SRC_H
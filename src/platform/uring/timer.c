@@ -0,0 +1,261 @@
+#include <assert.h>
+#include <string.h>
+#include "timer.h"
+
+
+/// @brief Compare the deadlines of two timers
+static int timer_deadline_compare(void * a, void * b) {
+    assert(a != NULL);
+    assert(b != NULL);
+
+    pomelo_platform_timer_t * timer_a = *((pomelo_platform_timer_t **) a);
+    pomelo_platform_timer_t * timer_b = *((pomelo_platform_timer_t **) b);
+
+    if (timer_a->deadline > timer_b->deadline) return 1;
+    if (timer_a->deadline < timer_b->deadline) return -1;
+    return 0;
+}
+
+
+/// @brief Get the monotonic time in milliseconds
+static uint64_t timer_now_ms(pomelo_platform_timer_controller_t * controller) {
+    return pomelo_platform_uring_hrtime(controller->platform) / 1000000ULL;
+}
+
+
+pomelo_platform_timer_controller_t * pomelo_platform_timer_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator
+) {
+    assert(allocator != NULL);
+
+    pomelo_platform_timer_controller_t * controller = pomelo_allocator_malloc(
+        allocator,
+        sizeof(pomelo_platform_timer_controller_t)
+    );
+
+    if (!controller) {
+        return NULL;
+    }
+
+    memset(controller, 0, sizeof(pomelo_platform_timer_controller_t));
+    controller->platform = platform;
+    controller->allocator = allocator;
+
+    // Create active timers heap
+    pomelo_heap_options_t heap_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_platform_timer_t *),
+        .compare = timer_deadline_compare
+    };
+    controller->timers = pomelo_heap_create(&heap_options);
+    if (!controller->timers) {
+        pomelo_platform_timer_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Create timer pool
+    pomelo_pool_root_options_t pool_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_platform_timer_t),
+        .zero_init = true
+    };
+    controller->timer_pool = pomelo_pool_root_create(&pool_options);
+
+    if (!controller->timer_pool) {
+        pomelo_platform_timer_controller_destroy(controller);
+        return NULL;
+    }
+
+    return controller;
+}
+
+
+void pomelo_platform_timer_controller_destroy(
+    pomelo_platform_timer_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_allocator_t * allocator = controller->allocator;
+
+    if (controller->timers) {
+        pomelo_heap_destroy(controller->timers);
+        controller->timers = NULL;
+    }
+
+    if (controller->timer_pool) {
+        pomelo_pool_destroy(controller->timer_pool);
+        controller->timer_pool = NULL;
+    }
+
+    pomelo_allocator_free(allocator, controller);
+}
+
+
+void pomelo_platform_timer_controller_statistic(
+    pomelo_platform_timer_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+) {
+    assert(controller != NULL);
+    assert(statistic != NULL);
+
+    statistic->timers = pomelo_heap_size(controller->timers);
+}
+
+
+void pomelo_platform_timer_controller_startup(
+    pomelo_platform_timer_controller_t * controller
+) {
+    assert(controller != NULL);
+    controller->running = true;
+}
+
+
+void pomelo_platform_timer_controller_shutdown(
+    pomelo_platform_timer_controller_t * controller
+) {
+    assert(controller != NULL);
+    if (!controller->running) {
+        return; // Controller is already shutting down
+    }
+    controller->running = false;
+
+    // Timers are not backed by kernel objects, so they are stopped at once
+    pomelo_platform_timer_t * timer = NULL;
+    while (pomelo_heap_top(controller->timers, &timer) == 0) {
+        pomelo_platform_uring_timer_stop_ex(timer);
+    }
+
+    pomelo_platform_timer_controller_on_shutdown(controller);
+}
+
+
+void pomelo_platform_timer_controller_run(
+    pomelo_platform_timer_controller_t * controller,
+    uint64_t now_ms
+) {
+    assert(controller != NULL);
+
+    pomelo_platform_timer_t * timer = NULL;
+    while (
+        pomelo_heap_top(controller->timers, &timer) == 0 &&
+        timer->deadline <= now_ms
+    ) {
+        pomelo_platform_timer_entry entry = timer->entry;
+        void * data = timer->data;
+
+        if (timer->repeat_ms == 0) {
+            // Timer is not repeating, stop running
+            pomelo_platform_uring_timer_stop_ex(timer);
+        } else {
+            // Reschedule before calling, the entry may stop this timer
+            pomelo_heap_remove(controller->timers, timer->heap_entry);
+            timer->deadline = now_ms + timer->repeat_ms;
+            timer->heap_entry = pomelo_heap_push(controller->timers, timer);
+            if (!timer->heap_entry) {
+                // Cannot reschedule the timer
+                timer->heap_entry = NULL;
+                if (timer->handle) {
+                    timer->handle->timer = NULL;
+                    timer->handle = NULL;
+                }
+                pomelo_pool_release(controller->timer_pool, timer);
+            }
+        }
+
+        entry(data);
+    }
+}
+
+
+int64_t pomelo_platform_timer_controller_next_timeout(
+    pomelo_platform_timer_controller_t * controller,
+    uint64_t now_ms
+) {
+    assert(controller != NULL);
+
+    pomelo_platform_timer_t * timer = NULL;
+    if (pomelo_heap_top(controller->timers, &timer) < 0) {
+        return -1; // No active timer
+    }
+
+    if (timer->deadline <= now_ms) {
+        return 0;
+    }
+    return (int64_t) (timer->deadline - now_ms);
+}
+
+
+int pomelo_platform_uring_timer_start(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_timer_entry entry,
+    uint64_t timeout_ms,
+    uint64_t repeat_ms,
+    void * data,
+    pomelo_platform_timer_handle_t * handle
+) {
+    assert(platform != NULL);
+    assert(entry != NULL);
+
+    pomelo_platform_timer_controller_t * controller =
+        platform->timer_controller;
+
+    pomelo_platform_timer_t * timer =
+        pomelo_pool_acquire(controller->timer_pool, NULL);
+    if (!timer) return -1; // Cannot allocate new timer
+
+    timer->controller = controller;
+    timer->data = data;
+    timer->entry = entry;
+    timer->repeat_ms = repeat_ms;
+    timer->deadline = timer_now_ms(controller) + timeout_ms;
+    timer->handle = NULL;
+
+    timer->heap_entry = pomelo_heap_push(controller->timers, timer);
+    if (!timer->heap_entry) {
+        // Cannot add new timer to active heap
+        pomelo_pool_release(controller->timer_pool, timer);
+        return -1;
+    }
+
+    if (handle) {
+        handle->timer = timer;
+        timer->handle = handle;
+    }
+
+    return 0;
+}
+
+
+void pomelo_platform_uring_timer_stop(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_timer_handle_t * handle
+) {
+    (void) platform;
+    assert(handle != NULL);
+    if (!handle->timer) return; // No timer
+
+    pomelo_platform_uring_timer_stop_ex(handle->timer);
+    handle->timer = NULL;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+void pomelo_platform_uring_timer_stop_ex(pomelo_platform_timer_t * timer) {
+    assert(timer != NULL);
+    pomelo_platform_timer_controller_t * controller = timer->controller;
+
+    if (timer->heap_entry) {
+        pomelo_heap_remove(controller->timers, timer->heap_entry);
+        timer->heap_entry = NULL;
+    }
+
+    if (timer->handle) {
+        timer->handle->timer = NULL;
+        timer->handle = NULL;
+    }
+
+    pomelo_pool_release(controller->timer_pool, timer);
+}
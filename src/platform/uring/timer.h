@@ -0,0 +1,122 @@
+#ifndef POMELO_PLATFORM_URING_TIMER_SRC_H
+#define POMELO_PLATFORM_URING_TIMER_SRC_H
+#include "utils/pool.h"
+#include "utils/heap.h"
+#include "platform-uring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+struct pomelo_platform_timer_s {
+    /// @brief The user data
+    void * data;
+
+    /// @brief The based platform
+    pomelo_platform_timer_controller_t * controller;
+
+    /// @brief The callback
+    pomelo_platform_timer_entry entry;
+
+    /// @brief The deadline of timer in milliseconds (monotonic)
+    uint64_t deadline;
+
+    /// @brief The repeat interval in milliseconds. Zero if not repeating.
+    uint64_t repeat_ms;
+
+    /// @brief The entry of this timer in the deadline heap of controller
+    pomelo_heap_entry_t * heap_entry;
+
+    /// @brief The handle of this timer
+    pomelo_platform_timer_handle_t * handle;
+};
+
+
+struct pomelo_platform_timer_controller_s {
+    /// @brief Platform
+    pomelo_platform_uring_t * platform;
+
+    /// @brief Allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The timer pool
+    pomelo_pool_t * timer_pool;
+
+    /// @brief All active timers, ordered by deadline
+    pomelo_heap_t * timers;
+
+    /// @brief The flag of running
+    bool running;
+};
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Create the timer controller
+pomelo_platform_timer_controller_t * pomelo_platform_timer_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator
+);
+
+
+/// @brief Destroy the timer controller
+void pomelo_platform_timer_controller_destroy(
+    pomelo_platform_timer_controller_t * controller
+);
+
+
+/// @brief Get the statistic of timer controller
+void pomelo_platform_timer_controller_statistic(
+    pomelo_platform_timer_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+);
+
+
+/// @brief Startup the timer controller
+void pomelo_platform_timer_controller_startup(
+    pomelo_platform_timer_controller_t * controller
+);
+
+
+/// @brief Shutdown the timer controller
+void pomelo_platform_timer_controller_shutdown(
+    pomelo_platform_timer_controller_t * controller
+);
+
+
+/// @brief Callback when the timer controller is completely shutdown
+void pomelo_platform_timer_controller_on_shutdown(
+    pomelo_platform_timer_controller_t * controller
+);
+
+
+/// @brief Run all expired timers
+void pomelo_platform_timer_controller_run(
+    pomelo_platform_timer_controller_t * controller,
+    uint64_t now_ms
+);
+
+
+/// @brief Get the time until the next deadline
+/// @return The timeout in milliseconds or -1 if there is no active timer
+int64_t pomelo_platform_timer_controller_next_timeout(
+    pomelo_platform_timer_controller_t * controller,
+    uint64_t now_ms
+);
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Stop timer
+void pomelo_platform_uring_timer_stop_ex(pomelo_platform_timer_t * timer);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PLATFORM_URING_TIMER_SRC_H
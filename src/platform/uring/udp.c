@@ -0,0 +1,656 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include "udp.h"
+
+
+/// @brief Get the length of socket address
+static socklen_t sockaddr_length(struct sockaddr_storage * addr) {
+    return (addr->ss_family == AF_INET6)
+        ? sizeof(struct sockaddr_in6)
+        : sizeof(struct sockaddr_in);
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+pomelo_platform_udp_controller_t * pomelo_platform_udp_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator,
+    uint32_t recv_buffers,
+    size_t recv_buffer_size
+) {
+    assert(platform != NULL);
+    assert(allocator != NULL);
+    assert(recv_buffers > 0);
+
+    pomelo_platform_udp_controller_t * controller = pomelo_allocator_malloc_t(
+        allocator,
+        pomelo_platform_udp_controller_t
+    );
+
+    if (!controller) {
+        return NULL;
+    }
+
+    memset(controller, 0, sizeof(pomelo_platform_udp_controller_t));
+    controller->platform = platform;
+    controller->allocator = allocator;
+
+    // Create send object pool
+    pomelo_pool_root_options_t pool_options;
+    memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
+    pool_options.allocator = allocator;
+    pool_options.element_size = sizeof(pomelo_platform_send_t);
+
+    controller->send_pool = pomelo_pool_root_create(&pool_options);
+    if (!controller->send_pool) {
+        pomelo_platform_udp_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Create pool of sockets
+    memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
+    pool_options.allocator = allocator;
+    pool_options.element_size = sizeof(pomelo_platform_udp_t);
+    pool_options.zero_init = true;
+
+    controller->socket_pool = pomelo_pool_root_create(&pool_options);
+    if (!controller->socket_pool) {
+        pomelo_platform_udp_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Create list of running sockets
+    pomelo_list_options_t list_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_platform_udp_t *)
+    };
+    controller->sockets = pomelo_list_create(&list_options);
+    if (!controller->sockets) {
+        pomelo_platform_udp_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Each provided buffer holds the recvmsg header, the source address and
+    // the payload of one datagram.
+    size_t buffer_size = sizeof(struct io_uring_recvmsg_out) +
+        sizeof(struct sockaddr_storage) + recv_buffer_size;
+    controller->recv_buffers = pomelo_allocator_malloc(
+        allocator,
+        buffer_size * recv_buffers
+    );
+    if (!controller->recv_buffers) {
+        pomelo_platform_udp_controller_destroy(controller);
+        return NULL;
+    }
+
+    int ret = 0;
+    controller->recv_ring = io_uring_setup_buf_ring(
+        &platform->ring,
+        recv_buffers,
+        POMELO_PLATFORM_UDP_RECV_BUFFER_GROUP,
+        0,
+        &ret
+    );
+    if (!controller->recv_ring) {
+        // Provided buffer rings require Linux 5.19
+        pomelo_platform_udp_controller_destroy(controller);
+        return NULL;
+    }
+    controller->recv_buffer_count = recv_buffers;
+    controller->recv_buffer_size = buffer_size;
+
+    // Provide all buffers to the kernel
+    int mask = io_uring_buf_ring_mask(recv_buffers);
+    for (uint32_t i = 0; i < recv_buffers; i++) {
+        io_uring_buf_ring_add(
+            controller->recv_ring,
+            controller->recv_buffers + i * buffer_size,
+            (unsigned int) buffer_size,
+            (unsigned short) i,
+            mask,
+            (int) i
+        );
+    }
+    io_uring_buf_ring_advance(controller->recv_ring, (int) recv_buffers);
+
+    return controller;
+}
+
+
+void pomelo_platform_udp_controller_destroy(
+    pomelo_platform_udp_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_allocator_t * allocator = controller->allocator;
+
+    if (controller->recv_ring) {
+        io_uring_free_buf_ring(
+            &controller->platform->ring,
+            controller->recv_ring,
+            controller->recv_buffer_count,
+            POMELO_PLATFORM_UDP_RECV_BUFFER_GROUP
+        );
+        controller->recv_ring = NULL;
+    }
+
+    if (controller->recv_buffers) {
+        pomelo_allocator_free(allocator, controller->recv_buffers);
+        controller->recv_buffers = NULL;
+    }
+
+    if (controller->send_pool) {
+        pomelo_pool_destroy(controller->send_pool);
+        controller->send_pool = NULL;
+    }
+
+    if (controller->socket_pool) {
+        pomelo_pool_destroy(controller->socket_pool);
+        controller->socket_pool = NULL;
+    }
+
+    if (controller->sockets) {
+        pomelo_list_destroy(controller->sockets);
+        controller->sockets = NULL;
+    }
+
+    pomelo_allocator_free(allocator, controller);
+}
+
+
+void pomelo_platform_udp_controller_statistic(
+    pomelo_platform_udp_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+) {
+    assert(controller != NULL);
+    assert(statistic != NULL);
+
+    statistic->send_commands = pomelo_pool_in_use(controller->send_pool);
+    statistic->sent_bytes = controller->send_bytes;
+    statistic->recv_bytes = controller->recv_bytes;
+    statistic->recv_buffers_exhausted = controller->recv_buffers_exhausted;
+}
+
+
+void pomelo_platform_udp_controller_startup(
+    pomelo_platform_udp_controller_t * controller
+) {
+    assert(controller != NULL);
+    controller->running = true;
+    controller->sending_requests = 0;
+}
+
+
+void pomelo_platform_udp_controller_shutdown(
+    pomelo_platform_udp_controller_t * controller
+) {
+    assert(controller != NULL);
+    if (!controller->running) {
+        return; // Controller is already shutting down
+    }
+    controller->running = false;
+
+    // Closing is completed asynchronously, so the list is not changed here
+    pomelo_platform_udp_t * socket = NULL;
+    pomelo_list_iterator_t it;
+    pomelo_list_iterator_init(&it, controller->sockets);
+    while (pomelo_list_iterator_next(&it, &socket) == 0) {
+        pomelo_platform_udp_close(socket);
+    }
+
+    pomelo_platform_udp_controller_check_shutdown(controller);
+}
+
+
+pomelo_platform_udp_t * pomelo_platform_uring_udp_bind(
+    pomelo_platform_uring_t * platform,
+    pomelo_address_t * address
+) {
+    assert(platform != NULL);
+    assert(address != NULL);
+
+    pomelo_platform_udp_controller_t * controller =
+        platform->udp_controller;
+
+    struct sockaddr_storage addr;
+    if (pomelo_address_to_sockaddr(address, &addr) < 0) {
+        return NULL;
+    }
+
+    pomelo_platform_udp_t * socket = pomelo_platform_udp_open(
+        controller,
+        addr.ss_family,
+        POMELO_SERVER_SOCKET_SNDBUF_SIZE,
+        POMELO_SERVER_SOCKET_RCVBUF_SIZE
+    );
+    if (!socket) return NULL; // Failed to open socket
+
+    int value = 1;
+    setsockopt(socket->fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+    if (controller->reuse_port && setsockopt(
+        socket->fd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value)
+    ) < 0) {
+        pomelo_platform_udp_close(socket);
+        return NULL; // Failed to share the address
+    }
+
+    if (bind(socket->fd, (struct sockaddr *) &addr, sockaddr_length(&addr))) {
+        pomelo_platform_udp_close(socket);
+        return NULL;
+    }
+
+    if (pomelo_platform_udp_recv_arm(socket) < 0) {
+        pomelo_platform_udp_close(socket);
+        return NULL;
+    }
+
+    // Push socket to list
+    socket->entry = pomelo_list_push_back(controller->sockets, socket);
+    if (!socket->entry) {
+        pomelo_platform_udp_close(socket);
+        return NULL;
+    }
+
+    return socket;
+}
+
+
+pomelo_platform_udp_t * pomelo_platform_uring_udp_connect(
+    pomelo_platform_uring_t * platform,
+    pomelo_address_t * address
+) {
+    assert(platform != NULL);
+    assert(address != NULL);
+
+    pomelo_platform_udp_controller_t * controller =
+        platform->udp_controller;
+
+    struct sockaddr_storage addr;
+    if (pomelo_address_to_sockaddr(address, &addr) < 0) {
+        return NULL;
+    }
+
+    pomelo_platform_udp_t * socket = pomelo_platform_udp_open(
+        controller,
+        addr.ss_family,
+        POMELO_CLIENT_SOCKET_SNDBUF_SIZE,
+        POMELO_CLIENT_SOCKET_RCVBUF_SIZE
+    );
+    if (!socket) return NULL; // Failed to open socket
+
+    int ret = connect(
+        socket->fd,
+        (struct sockaddr *) &addr,
+        sockaddr_length(&addr)
+    );
+    if (ret < 0) {
+        pomelo_platform_udp_close(socket);
+        return NULL;
+    }
+
+    if (pomelo_platform_udp_recv_arm(socket) < 0) {
+        pomelo_platform_udp_close(socket);
+        return NULL;
+    }
+
+    socket->entry = pomelo_list_push_back(controller->sockets, socket);
+    if (!socket->entry) {
+        pomelo_platform_udp_close(socket);
+        return NULL;
+    }
+
+    return socket;
+}
+
+
+int pomelo_platform_uring_udp_stop(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_udp_t * socket
+) {
+    (void) platform;
+    assert(socket != NULL);
+
+    // Stop receiving and close the socket
+    pomelo_platform_udp_close(socket);
+    return 0;
+}
+
+
+int pomelo_platform_uring_udp_send(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_udp_t * socket,
+    pomelo_address_t * address,
+    int niovec,
+    pomelo_platform_iovec_t * iovec,
+    void * callback_data,
+    pomelo_platform_send_cb callback
+) {
+    assert(platform != NULL);
+    assert(socket != NULL);
+    assert(iovec != NULL);
+    assert(niovec > 0);
+
+    pomelo_platform_udp_controller_t * controller = platform->udp_controller;
+    if (!controller->running || socket->closing) {
+        return -1; // Controller is not running or socket is closing
+    }
+
+    pomelo_platform_send_t * send =
+        pomelo_pool_acquire(controller->send_pool, NULL);
+    if (!send) return -1; // Failed to acquire send
+
+    memset(&send->msg, 0, sizeof(struct msghdr));
+    if (address) {
+        if (pomelo_address_to_sockaddr(address, &send->addr) < 0) {
+            pomelo_pool_release(controller->send_pool, send);
+            return -1; // Invalid address
+        }
+        send->msg.msg_name = &send->addr;
+        send->msg.msg_namelen = sockaddr_length(&send->addr);
+    }
+
+    if (niovec > POMELO_PLATFORM_UDP_MAX_NUMBER_BUF_VECTORS) {
+        niovec = POMELO_PLATFORM_UDP_MAX_NUMBER_BUF_VECTORS;
+    }
+
+    size_t length = 0;
+    for (int i = 0; i < niovec; i++) {
+        send->iov[i].iov_base = iovec[i].data;
+        send->iov[i].iov_len = iovec[i].length;
+        length += iovec[i].length;
+    }
+    send->msg.msg_iov = send->iov;
+    send->msg.msg_iovlen = (size_t) niovec;
+
+    send->op.callback = pomelo_platform_send_complete;
+    send->controller = controller;
+    send->callback = callback;
+    send->callback_data = callback_data;
+
+    // The entry is submitted together with the others of this loop iteration
+    struct io_uring_sqe * sqe = pomelo_platform_uring_get_sqe(platform);
+    if (!sqe) {
+        pomelo_pool_release(controller->send_pool, send);
+        return -1; // The ring is full
+    }
+    io_uring_prep_sendmsg(sqe, socket->fd, &send->msg, 0);
+    io_uring_sqe_set_data(sqe, &send->op);
+
+    controller->send_bytes += length;
+    controller->sending_requests++;
+    return 0;
+}
+
+
+void pomelo_platform_uring_udp_recv_start(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_udp_t * socket,
+    void * context,
+    pomelo_platform_alloc_cb alloc_callback,
+    pomelo_platform_recv_cb recv_callback
+) {
+    (void) platform;
+    assert(socket != NULL);
+
+    socket->alloc_callback = alloc_callback;
+    socket->recv_callback = recv_callback;
+    socket->context = context;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+pomelo_platform_udp_t * pomelo_platform_udp_open(
+    pomelo_platform_udp_controller_t * controller,
+    int family,
+    int send_buf_size,
+    int recv_buf_size
+) {
+    assert(controller != NULL);
+    if (!controller->running) {
+        return NULL; // Controller is not running
+    }
+
+    int fd = socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return NULL; // Failed to create socket
+
+    pomelo_platform_udp_t * socket =
+        pomelo_pool_acquire(controller->socket_pool, NULL);
+    if (!socket) {
+        close(fd);
+        return NULL; // Failed to acquire socket
+    }
+
+    socket->controller = controller;
+    socket->fd = fd;
+    socket->recv_op.callback = pomelo_platform_udp_recv_complete;
+
+    // The kernel writes the source address after the recvmsg header
+    socket->recv_msg.msg_namelen = sizeof(struct sockaddr_storage);
+    socket->recv_msg.msg_controllen = 0;
+
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &send_buf_size, sizeof(int));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &recv_buf_size, sizeof(int));
+    return socket;
+}
+
+
+int pomelo_platform_udp_recv_arm(pomelo_platform_udp_t * socket) {
+    assert(socket != NULL);
+    assert(!socket->recv_armed);
+
+    pomelo_platform_uring_t * platform = socket->controller->platform;
+    struct io_uring_sqe * sqe = pomelo_platform_uring_get_sqe(platform);
+    if (!sqe) return -1; // The ring is full
+
+    io_uring_prep_recvmsg_multishot(sqe, socket->fd, &socket->recv_msg, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = POMELO_PLATFORM_UDP_RECV_BUFFER_GROUP;
+    io_uring_sqe_set_data(sqe, &socket->recv_op);
+
+    socket->recv_armed = true;
+    return 0;
+}
+
+
+/// @brief Dispatch a datagram which has been read into a provided buffer
+static void udp_recv_dispatch(
+    pomelo_platform_udp_t * socket,
+    uint8_t * buffer,
+    int length
+) {
+    struct io_uring_recvmsg_out * out =
+        io_uring_recvmsg_validate(buffer, length, &socket->recv_msg);
+    if (!out) return; // Invalid message
+
+    size_t nread = io_uring_recvmsg_payload_length(
+        out,
+        length,
+        &socket->recv_msg
+    );
+    socket->controller->recv_bytes += nread;
+
+    if (!socket->recv_callback || !socket->alloc_callback) return;
+    if (out->namelen == 0) return; // No source address
+
+    pomelo_address_t address;
+    struct sockaddr * addr = io_uring_recvmsg_name(out);
+    if (pomelo_address_from_sockaddr(&address, addr) < 0) return;
+
+    // Acquire the payload buffer for this datagram
+    pomelo_platform_iovec_t iovec;
+    memset(&iovec, 0, sizeof(pomelo_platform_iovec_t));
+    socket->alloc_callback(socket->context, &iovec);
+    if (!iovec.data) return; // Failed to acquire buffer
+
+    int status = 0;
+    if ((out->flags & MSG_TRUNC) || nread > iovec.length) {
+        status = -1; // Datagram is too large, the buffer will be discarded
+    } else {
+        memcpy(
+            iovec.data,
+            io_uring_recvmsg_payload(out, &socket->recv_msg),
+            nread
+        );
+        iovec.length = nread;
+    }
+
+    socket->recv_callback(socket->context, &address, &iovec, status);
+}
+
+
+void pomelo_platform_udp_recv_complete(
+    pomelo_platform_uring_op_t * op,
+    struct io_uring_cqe * cqe
+) {
+    pomelo_platform_udp_t * socket =
+        pomelo_platform_uring_container(op, pomelo_platform_udp_t, recv_op);
+    pomelo_platform_udp_controller_t * controller = socket->controller;
+
+    bool more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+    if (!more) {
+        socket->recv_armed = false;
+    }
+
+    if (cqe->flags & IORING_CQE_F_BUFFER) {
+        uint16_t buffer_id = (uint16_t) (cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        if (cqe->res > 0 && !socket->closing) {
+            udp_recv_dispatch(
+                socket,
+                controller->recv_buffers +
+                    buffer_id * controller->recv_buffer_size,
+                cqe->res
+            );
+        }
+        pomelo_platform_udp_recv_recycle(controller, buffer_id);
+    } else if (cqe->res == -ENOBUFS) {
+        // All provided buffers are in use, the multishot request has ended
+        controller->recv_buffers_exhausted++;
+    }
+
+    if (more) return; // The multishot request is still active
+
+    if (socket->closing) {
+        pomelo_platform_udp_on_closed(socket);
+        return;
+    }
+
+    // The multishot request has been terminated, arm it again
+    if (pomelo_platform_udp_recv_arm(socket) < 0) {
+        pomelo_platform_udp_close(socket);
+    }
+}
+
+
+void pomelo_platform_udp_recv_recycle(
+    pomelo_platform_udp_controller_t * controller,
+    uint16_t buffer_id
+) {
+    assert(controller != NULL);
+    io_uring_buf_ring_add(
+        controller->recv_ring,
+        controller->recv_buffers + buffer_id * controller->recv_buffer_size,
+        (unsigned int) controller->recv_buffer_size,
+        buffer_id,
+        io_uring_buf_ring_mask(controller->recv_buffer_count),
+        0
+    );
+    io_uring_buf_ring_advance(controller->recv_ring, 1);
+}
+
+
+void pomelo_platform_send_complete(
+    pomelo_platform_uring_op_t * op,
+    struct io_uring_cqe * cqe
+) {
+    pomelo_platform_send_t * send = (pomelo_platform_send_t *) op;
+    pomelo_platform_udp_controller_t * controller = send->controller;
+
+    // Capture the values
+    void * callback_data = send->callback_data;
+    pomelo_platform_send_cb callback = send->callback;
+    int status = (cqe->res < 0) ? cqe->res : 0;
+
+    // Release the sending pass
+    pomelo_pool_release(controller->send_pool, send);
+
+    // Finally, call the callback
+    if (callback) {
+        callback(callback_data, status);
+    }
+
+    controller->sending_requests--;
+    pomelo_platform_udp_controller_check_shutdown(controller);
+}
+
+
+void pomelo_platform_udp_controller_check_shutdown(
+    pomelo_platform_udp_controller_t * controller
+) {
+    assert(controller != NULL);
+    if (
+        !controller->running &&
+        controller->sockets->size == 0 &&
+        controller->sending_requests == 0
+    ) {
+        pomelo_platform_udp_controller_on_shutdown(controller);
+    }
+}
+
+
+void pomelo_platform_udp_close(pomelo_platform_udp_t * socket) {
+    assert(socket != NULL);
+    if (socket->closing) return; // Already closing
+
+    socket->closing = true;
+    pomelo_platform_uring_t * platform = socket->controller->platform;
+    struct io_uring_sqe * sqe = pomelo_platform_uring_get_sqe(platform);
+    if (!sqe) {
+        // The ring is unable to accept more entries, the socket cannot be
+        // released until its receiving request has completed.
+        if (!socket->recv_armed) {
+            pomelo_platform_udp_on_closed(socket);
+        }
+        return;
+    }
+
+    if (socket->recv_armed) {
+        // Cancel the receiving request, the final completion of the request
+        // releases the socket.
+        io_uring_prep_cancel(sqe, &socket->recv_op, 0);
+        io_uring_sqe_set_data(sqe, NULL);
+    } else {
+        // Release the socket in the completion stage, like the others
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, &socket->recv_op);
+    }
+}
+
+
+void pomelo_platform_udp_on_closed(pomelo_platform_udp_t * socket) {
+    assert(socket != NULL);
+    pomelo_platform_udp_controller_t * controller = socket->controller;
+
+    // Queued sends of this socket must be issued before the descriptor is gone
+    pomelo_platform_uring_t * platform = controller->platform;
+    io_uring_submit(&platform->ring);
+
+    close(socket->fd);
+    socket->fd = -1;
+
+    if (socket->entry) {
+        pomelo_list_remove(controller->sockets, socket->entry);
+        socket->entry = NULL;
+    }
+    pomelo_pool_release(controller->socket_pool, socket);
+
+    pomelo_platform_udp_controller_check_shutdown(controller);
+}
@@ -0,0 +1,234 @@
+#ifndef POMELO_PLATFORM_URING_SOCKET_SRC_H
+#define POMELO_PLATFORM_URING_SOCKET_SRC_H
+#include <sys/socket.h>
+#include "utils/pool.h"
+#include "utils/list.h"
+#include "platform-uring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define POMELO_CLIENT_SOCKET_SNDBUF_SIZE 256 * 1024
+#define POMELO_CLIENT_SOCKET_RCVBUF_SIZE 256 * 1024
+#define POMELO_SERVER_SOCKET_SNDBUF_SIZE 4 * 1024 * 1024
+#define POMELO_SERVER_SOCKET_RCVBUF_SIZE 4 * 1024 * 1024
+
+/// There are 2 vectors: header & body
+#define POMELO_PLATFORM_UDP_MAX_NUMBER_BUF_VECTORS 2
+
+/// The buffer group ID of provided receiving buffers
+#define POMELO_PLATFORM_UDP_RECV_BUFFER_GROUP 0
+
+
+/// @brief The sending information
+typedef struct pomelo_platform_send_s pomelo_platform_send_t;
+
+
+struct pomelo_platform_udp_s {
+    /// @brief The socket controller
+    pomelo_platform_udp_controller_t * controller;
+
+    /// @brief The file descriptor
+    int fd;
+
+    /// @brief The multishot receiving operation
+    pomelo_platform_uring_op_t recv_op;
+
+    /// @brief The message header template of multishot receiving
+    struct msghdr recv_msg;
+
+    /// @brief Whether the multishot receiving is in flight
+    bool recv_armed;
+
+    /// @brief The context for callbacks
+    void * context;
+
+    /// @brief The pool of payload
+    pomelo_platform_alloc_cb alloc_callback;
+
+    /// @brief The payload receive callback
+    pomelo_platform_recv_cb recv_callback;
+
+    /// @brief The entry in sockets list
+    pomelo_list_entry_t * entry;
+
+    /// @brief Closing flag
+    bool closing;
+};
+
+
+struct pomelo_platform_udp_controller_s {
+    /// @brief Platform
+    pomelo_platform_uring_t * platform;
+
+    /// @brief The allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The send information pool
+    pomelo_pool_t * send_pool;
+
+    /// @brief The pool of platform sockets
+    pomelo_pool_t * socket_pool;
+
+    /// @brief The list of running sockets
+    pomelo_list_t * sockets;
+
+    /// @brief The ring of provided receiving buffers
+    struct io_uring_buf_ring * recv_ring;
+
+    /// @brief The memory of provided receiving buffers
+    uint8_t * recv_buffers;
+
+    /// @brief The number of provided receiving buffers
+    uint32_t recv_buffer_count;
+
+    /// @brief The size of each provided receiving buffer, including the
+    /// message header and the source address
+    size_t recv_buffer_size;
+
+    /// @brief Total sent bytes
+    uint64_t send_bytes;
+
+    /// @brief Total received bytes
+    uint64_t recv_bytes;
+
+    /// @brief The number of times the provided buffers ran out
+    uint64_t recv_buffers_exhausted;
+
+    /// @brief Whether bound sockets share their address with SO_REUSEPORT
+    bool reuse_port;
+
+    /// @brief The flag of running
+    bool running;
+
+    /// @brief The number of sending requests
+    size_t sending_requests;
+};
+
+
+struct pomelo_platform_send_s {
+    /// @brief The send operation
+    pomelo_platform_uring_op_t op;
+
+    /// @brief The controller
+    pomelo_platform_udp_controller_t * controller;
+
+    /// @brief The callback
+    pomelo_platform_send_cb callback;
+
+    /// @brief The callback data
+    void * callback_data;
+
+    /// @brief The message header
+    struct msghdr msg;
+
+    /// @brief The buffers of datagram
+    struct iovec iov[POMELO_PLATFORM_UDP_MAX_NUMBER_BUF_VECTORS];
+
+    /// @brief The target address
+    struct sockaddr_storage addr;
+};
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Create platform socket controller
+pomelo_platform_udp_controller_t * pomelo_platform_udp_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator,
+    uint32_t recv_buffers,
+    size_t recv_buffer_size
+);
+
+
+/// @brief Destroy platform socket controller
+void pomelo_platform_udp_controller_destroy(
+    pomelo_platform_udp_controller_t * controller
+);
+
+
+/// @brief Get the socket controller statistic
+void pomelo_platform_udp_controller_statistic(
+    pomelo_platform_udp_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+);
+
+
+/// @brief Startup the UDP controller
+void pomelo_platform_udp_controller_startup(
+    pomelo_platform_udp_controller_t * controller
+);
+
+
+/// @brief Close all UDP sockets
+void pomelo_platform_udp_controller_shutdown(
+    pomelo_platform_udp_controller_t * controller
+);
+
+
+/// @brief Callback when the UDP controller is completely shutdown
+void pomelo_platform_udp_controller_on_shutdown(
+    pomelo_platform_udp_controller_t * controller
+);
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Create a non-blocking socket for the address family
+pomelo_platform_udp_t * pomelo_platform_udp_open(
+    pomelo_platform_udp_controller_t * controller,
+    int family,
+    int send_buf_size,
+    int recv_buf_size
+);
+
+
+/// @brief Arm the multishot receiving of socket
+int pomelo_platform_udp_recv_arm(pomelo_platform_udp_t * socket);
+
+
+/// @brief The completion callback of multishot receiving
+void pomelo_platform_udp_recv_complete(
+    pomelo_platform_uring_op_t * op,
+    struct io_uring_cqe * cqe
+);
+
+
+/// @brief Return a provided buffer to the buffer ring
+void pomelo_platform_udp_recv_recycle(
+    pomelo_platform_udp_controller_t * controller,
+    uint16_t buffer_id
+);
+
+
+/// @brief The completion callback of sending
+void pomelo_platform_send_complete(
+    pomelo_platform_uring_op_t * op,
+    struct io_uring_cqe * cqe
+);
+
+
+/// @brief Close the udp socket
+void pomelo_platform_udp_close(pomelo_platform_udp_t * socket);
+
+
+/// @brief Release the udp socket after all of its operations have completed
+void pomelo_platform_udp_on_closed(pomelo_platform_udp_t * socket);
+
+
+/// @brief Check if the controller is shutdown
+void pomelo_platform_udp_controller_check_shutdown(
+    pomelo_platform_udp_controller_t * controller
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PLATFORM_URING_SOCKET_SRC_H
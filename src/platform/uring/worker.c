@@ -0,0 +1,358 @@
+#include <assert.h>
+#include <string.h>
+#include "worker.h"
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+pomelo_platform_worker_controller_t * pomelo_platform_worker_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator,
+    size_t nthreads
+) {
+    assert(allocator != NULL);
+    assert(nthreads > 0);
+
+    pomelo_platform_worker_controller_t * controller =
+        pomelo_allocator_malloc_t(
+            allocator, pomelo_platform_worker_controller_t
+        );
+    if (!controller) return NULL;
+    memset(controller, 0, sizeof(pomelo_platform_worker_controller_t));
+    controller->platform = platform;
+    controller->allocator = allocator;
+    pthread_mutex_init(&controller->mutex, NULL);
+    pthread_cond_init(&controller->cond, NULL);
+
+    pomelo_pool_root_options_t pool_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_platform_task_worker_t),
+        .zero_init = true
+    };
+    controller->task_pool = pomelo_pool_root_create(&pool_options);
+    if (!controller->task_pool) {
+        pomelo_platform_worker_controller_destroy(controller);
+        return NULL;
+    }
+
+    pomelo_list_options_t list_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_platform_task_worker_t *)
+    };
+    controller->tasks = pomelo_list_create(&list_options);
+    if (!controller->tasks) {
+        pomelo_platform_worker_controller_destroy(controller);
+        return NULL;
+    }
+
+    // Pending & done lists are only accessed with the mutex held
+    controller->pending_tasks = pomelo_list_create(&list_options);
+    if (!controller->pending_tasks) {
+        pomelo_platform_worker_controller_destroy(controller);
+        return NULL;
+    }
+
+    controller->done_tasks = pomelo_list_create(&list_options);
+    if (!controller->done_tasks) {
+        pomelo_platform_worker_controller_destroy(controller);
+        return NULL;
+    }
+
+    controller->threads = pomelo_allocator_malloc(
+        allocator,
+        sizeof(pthread_t) * nthreads
+    );
+    if (!controller->threads) {
+        pomelo_platform_worker_controller_destroy(controller);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < nthreads; i++) {
+        int ret = pthread_create(
+            &controller->threads[i],
+            NULL,
+            pomelo_platform_worker_main,
+            controller
+        );
+        if (ret != 0) {
+            pomelo_platform_worker_controller_destroy(controller);
+            return NULL; // Failed to start worker thread
+        }
+        controller->nthreads++;
+    }
+
+    return controller;
+}
+
+
+void pomelo_platform_worker_controller_destroy(
+    pomelo_platform_worker_controller_t * controller
+) {
+    assert(controller != NULL);
+    pomelo_allocator_t * allocator = controller->allocator;
+
+    if (controller->threads) {
+        // Stop all worker threads
+        pthread_mutex_lock(&controller->mutex);
+        controller->exiting = true;
+        pthread_cond_broadcast(&controller->cond);
+        pthread_mutex_unlock(&controller->mutex);
+
+        for (size_t i = 0; i < controller->nthreads; i++) {
+            pthread_join(controller->threads[i], NULL);
+        }
+
+        pomelo_allocator_free(allocator, controller->threads);
+        controller->threads = NULL;
+        controller->nthreads = 0;
+    }
+
+    if (controller->task_pool) {
+        pomelo_pool_destroy(controller->task_pool);
+        controller->task_pool = NULL;
+    }
+
+    if (controller->tasks) {
+        pomelo_list_destroy(controller->tasks);
+        controller->tasks = NULL;
+    }
+
+    if (controller->pending_tasks) {
+        pomelo_list_destroy(controller->pending_tasks);
+        controller->pending_tasks = NULL;
+    }
+
+    if (controller->done_tasks) {
+        pomelo_list_destroy(controller->done_tasks);
+        controller->done_tasks = NULL;
+    }
+
+    pthread_cond_destroy(&controller->cond);
+    pthread_mutex_destroy(&controller->mutex);
+    pomelo_allocator_free(allocator, controller);
+}
+
+
+void pomelo_platform_worker_controller_startup(
+    pomelo_platform_worker_controller_t * controller
+) {
+    assert(controller != NULL);
+    controller->running = true;
+}
+
+
+void pomelo_platform_worker_controller_shutdown(
+    pomelo_platform_worker_controller_t * controller
+) {
+    assert(controller != NULL);
+    if (!controller->running) {
+        return; // Controller is already shutting down
+    }
+    controller->running = false;
+    if (controller->tasks->size == 0) {
+        pomelo_platform_worker_controller_on_shutdown(controller);
+        return;
+    }
+
+    pomelo_platform_task_worker_t * task = NULL;
+    pomelo_list_iterator_t it;
+    pomelo_list_iterator_init(&it, controller->tasks);
+    while (pomelo_list_iterator_next(&it, &task) == 0) {
+        pomelo_platform_cancel_worker_task_ex(task);
+    }
+}
+
+
+void pomelo_platform_worker_controller_statistic(
+    pomelo_platform_worker_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+) {
+    assert(controller != NULL);
+    assert(statistic != NULL);
+    statistic->worker_tasks = controller->tasks->size;
+}
+
+
+void pomelo_platform_worker_controller_process(
+    pomelo_platform_worker_controller_t * controller
+) {
+    assert(controller != NULL);
+    bool processed = false;
+    pomelo_platform_task_worker_t * task = NULL;
+
+    /* ----------- Begin mutex scope ----------- */
+    pthread_mutex_lock(&controller->mutex);
+    while (pomelo_list_pop_front(controller->done_tasks, &task) == 0) {
+        pthread_mutex_unlock(&controller->mutex);
+        /* ------------ End mutex scope ------------ */
+
+        bool canceled = task->canceled;
+        pomelo_platform_task_complete complete = task->complete;
+        void * data = task->data;
+
+        pomelo_platform_worker_release(task);
+        processed = true;
+
+        // Worker tasks eventually will be done.
+        complete(data, canceled);
+
+        /* ----------- Begin mutex scope ----------- */
+        pthread_mutex_lock(&controller->mutex);
+    }
+    pthread_mutex_unlock(&controller->mutex);
+    /* ------------ End mutex scope ------------ */
+
+    if (processed && !controller->running && controller->tasks->size == 0) {
+        pomelo_platform_worker_controller_on_shutdown(controller);
+    }
+}
+
+
+pomelo_platform_task_t * pomelo_platform_uring_submit_worker_task(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_task_entry entry,
+    pomelo_platform_task_complete complete,
+    void * data
+) {
+    assert(platform != NULL);
+    assert(entry != NULL);
+
+    pomelo_platform_worker_controller_t * controller =
+        platform->worker_controller;
+    if (!controller->running) {
+        return NULL; // Controller is not running
+    }
+
+    pomelo_platform_task_worker_t * task =
+        pomelo_pool_acquire(controller->task_pool, NULL);
+    if (!task) {
+        return NULL; // Failed to acquire new task
+    }
+
+    task->controller = controller;
+    task->entry = entry;
+    task->complete = complete;
+    task->data = data;
+
+    task->list_entry = pomelo_list_push_back(controller->tasks, task);
+    if (!task->list_entry) {
+        pomelo_pool_release(controller->task_pool, task);
+        return NULL; // Failed to append to global list
+    }
+
+    /* ----------- Begin mutex scope ----------- */
+    pthread_mutex_lock(&controller->mutex);
+    task->pending_entry =
+        pomelo_list_push_back(controller->pending_tasks, task);
+    if (task->pending_entry) {
+        pthread_cond_signal(&controller->cond);
+    }
+    pthread_mutex_unlock(&controller->mutex);
+    /* ------------ End mutex scope ------------ */
+
+    if (!task->pending_entry) {
+        pomelo_platform_worker_release(task);
+        return NULL; // Failed to queue work
+    }
+
+    return (pomelo_platform_task_t *) task;
+}
+
+
+void pomelo_platform_uring_cancel_worker_task(
+    pomelo_platform_uring_t * platform,
+    pomelo_platform_task_t * task
+) {
+    (void) platform;
+    pomelo_platform_cancel_worker_task_ex(
+        (pomelo_platform_task_worker_t *) task
+    );
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+void * pomelo_platform_worker_main(void * data) {
+    pomelo_platform_worker_controller_t * controller = data;
+    pomelo_platform_task_worker_t * task = NULL;
+
+    /* ----------- Begin mutex scope ----------- */
+    pthread_mutex_lock(&controller->mutex);
+    while (true) {
+        while (
+            !controller->exiting &&
+            pomelo_list_is_empty(controller->pending_tasks)
+        ) {
+            pthread_cond_wait(&controller->cond, &controller->mutex);
+        }
+
+        if (controller->exiting) break;
+
+        pomelo_list_pop_front(controller->pending_tasks, &task);
+        task->pending_entry = NULL;
+        pthread_mutex_unlock(&controller->mutex);
+        /* ------------ End mutex scope ------------ */
+
+        task->entry(task->data);
+
+        /* ----------- Begin mutex scope ----------- */
+        pthread_mutex_lock(&controller->mutex);
+        pomelo_list_entry_t * entry =
+            pomelo_list_push_back(controller->done_tasks, task);
+        assert(entry != NULL);
+        (void) entry;
+        pthread_mutex_unlock(&controller->mutex);
+        /* ------------ End mutex scope ------------ */
+
+        pomelo_platform_uring_wakeup(controller->platform);
+
+        /* ----------- Begin mutex scope ----------- */
+        pthread_mutex_lock(&controller->mutex);
+    }
+    pthread_mutex_unlock(&controller->mutex);
+    /* ------------ End mutex scope ------------ */
+
+    return NULL;
+}
+
+
+void pomelo_platform_worker_release(pomelo_platform_task_worker_t * task) {
+    assert(task != NULL);
+
+    pomelo_platform_worker_controller_t * controller = task->controller;
+    pomelo_list_remove(controller->tasks, task->list_entry);
+    pomelo_pool_release(controller->task_pool, task);
+}
+
+
+void pomelo_platform_cancel_worker_task_ex(
+    pomelo_platform_task_worker_t * task
+) {
+    assert(task != NULL);
+    if (task->canceled) {
+        return;
+    }
+
+    task->canceled = true;
+    pomelo_platform_worker_controller_t * controller = task->controller;
+
+    /* ----------- Begin mutex scope ----------- */
+    pthread_mutex_lock(&controller->mutex);
+    bool pending = (task->pending_entry != NULL);
+    if (pending) {
+        // The task has not been picked yet, complete it without running
+        pomelo_list_remove(controller->pending_tasks, task->pending_entry);
+        task->pending_entry = NULL;
+        pomelo_list_push_back(controller->done_tasks, task);
+    }
+    pthread_mutex_unlock(&controller->mutex);
+    /* ------------ End mutex scope ------------ */
+
+    if (pending) {
+        pomelo_platform_uring_wakeup(controller->platform);
+    }
+}
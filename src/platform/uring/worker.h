@@ -0,0 +1,152 @@
+#ifndef POMELO_PLATFORM_URING_TASK_WORKER_SRC_H
+#define POMELO_PLATFORM_URING_TASK_WORKER_SRC_H
+#include <pthread.h>
+#include "utils/pool.h"
+#include "utils/list.h"
+#include "platform-uring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// @brief Worker task
+typedef struct pomelo_platform_task_worker_s pomelo_platform_task_worker_t;
+
+
+struct pomelo_platform_worker_controller_s {
+    /// @brief Platform
+    pomelo_platform_uring_t * platform;
+
+    /// @brief Allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief Pool of worker tasks
+    pomelo_pool_t * task_pool;
+
+    /// @brief Processing tasks
+    pomelo_list_t * tasks;
+
+    /// @brief Tasks which are waiting for a worker thread
+    pomelo_list_t * pending_tasks;
+
+    /// @brief Tasks which are done and waiting for completion
+    pomelo_list_t * done_tasks;
+
+    /// @brief The mutex of pending & done tasks
+    pthread_mutex_t mutex;
+
+    /// @brief The condition for waking up worker threads
+    pthread_cond_t cond;
+
+    /// @brief The worker threads
+    pthread_t * threads;
+
+    /// @brief The number of started worker threads
+    size_t nthreads;
+
+    /// @brief Whether the worker threads are requested to exit
+    bool exiting;
+
+    /// @brief Running flag
+    bool running;
+};
+
+
+struct pomelo_platform_task_worker_s {
+    /// @brief Controller
+    pomelo_platform_worker_controller_t * controller;
+
+    /// @brief The entry point of work
+    pomelo_platform_task_entry entry;
+
+    /// @brief The done point of work
+    pomelo_platform_task_complete complete;
+
+    /// @brief Callback data
+    void * data;
+
+    /// @brief Canceled flag
+    bool canceled;
+
+    /// @brief Entry of this task in the list of controller
+    pomelo_list_entry_t * list_entry;
+
+    /// @brief Entry of this task in the pending list. NULL if the task has
+    /// been picked by a worker thread.
+    pomelo_list_entry_t * pending_entry;
+};
+
+
+/* -------------------------------------------------------------------------- */
+/*                                Public APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief Create task worker controller
+pomelo_platform_worker_controller_t * pomelo_platform_worker_controller_create(
+    pomelo_platform_uring_t * platform,
+    pomelo_allocator_t * allocator,
+    size_t nthreads
+);
+
+
+/// @brief Destroy task worker controller
+void pomelo_platform_worker_controller_destroy(
+    pomelo_platform_worker_controller_t * controller
+);
+
+
+/// @brief Startup the controller
+void pomelo_platform_worker_controller_startup(
+    pomelo_platform_worker_controller_t * controller
+);
+
+
+/// @brief Shutdown the controller
+void pomelo_platform_worker_controller_shutdown(
+    pomelo_platform_worker_controller_t * controller
+);
+
+
+/// @brief Callback when the controller is completely shutdown
+void pomelo_platform_worker_controller_on_shutdown(
+    pomelo_platform_worker_controller_t * controller
+);
+
+
+/// @brief Get statistic information
+void pomelo_platform_worker_controller_statistic(
+    pomelo_platform_worker_controller_t * controller,
+    pomelo_statistic_platform_uring_t * statistic
+);
+
+
+/// @brief Complete all done tasks. This is called in the loop thread after
+/// the loop has been woken up.
+void pomelo_platform_worker_controller_process(
+    pomelo_platform_worker_controller_t * controller
+);
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Private APIs                                 */
+/* -------------------------------------------------------------------------- */
+
+/// @brief The main function of worker threads
+void * pomelo_platform_worker_main(void * data);
+
+
+/// @brief Release task worker
+void pomelo_platform_worker_release(pomelo_platform_task_worker_t * task);
+
+
+/// @brief Cancel worker task
+void pomelo_platform_cancel_worker_task_ex(
+    pomelo_platform_task_worker_t * task
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PLATFORM_URING_TASK_WORKER_SRC_H
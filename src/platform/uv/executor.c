@@ -54,8 +54,6 @@ pomelo_platform_threadsafe_controller_create(
     pool_options.alloc_data = controller;
     pool_options.on_alloc = (pomelo_pool_alloc_cb)
         pomelo_threadsafe_executor_on_alloc;
-    pool_options.on_free = (pomelo_pool_free_cb)
-        pomelo_threadsafe_executor_on_free;
     controller->executor_pool = pomelo_pool_root_create(&pool_options);
     if (!controller->executor_pool) {
         pomelo_platform_threadsafe_controller_destroy(controller);
@@ -239,31 +237,29 @@ pomelo_platform_task_t * pomelo_threadsafe_executor_uv_submit(
     task->controller = controller;
     task->entry = entry;
     task->data = data;
-    
-    uv_mutex_t * mutex = &executor->mutex;
 
-    /* -------------------------  Critical Begin  ----------------------- */
-    uv_mutex_lock(mutex);
-
-    pomelo_list_t * tasks = executor->tasks_front;
-    pomelo_list_entry_t * list_entry = pomelo_list_push_back(tasks, task);
-
-    uv_mutex_unlock(mutex);
-    /* --------------------------  Critical End  ------------------------ */
+    // The counter is increased before the task becomes visible to the loop
+    // thread, which decreases it after executing.
+    pomelo_atomic_uint64_fetch_add(&controller->task_counter, 1);
+    pomelo_mpsc_queue_push(&executor->tasks, &task->node);
 
-    if (!list_entry) {
-        pomelo_platform_task_threadsafe_release(task);
-        return NULL; // Failed to append to list
+    // Pair with the fence in async callback, so that the loop thread either
+    // sees this task or the signal is sent again.
+    pomelo_atomic_fence();
+    if (pomelo_atomic_int64_exchange(&executor->signaled, true)) {
+        // The signal is pending, the task will be executed with it
+        return (pomelo_platform_task_t *) task;
     }
 
     // Send signal
     int ret = uv_async_send(&executor->uv_async);
     if (ret < 0) {
-        pomelo_platform_task_threadsafe_release(task);
-        return NULL; // Failed to send signal
+        // The task cannot be unlinked from the queue, so it is still
+        // submitted. It is executed with the next signal or dropped by
+        // shutting down. Let the next submission signal again.
+        pomelo_atomic_int64_store(&executor->signaled, false);
     }
 
-    pomelo_atomic_uint64_fetch_add(&controller->task_counter, 1);
     return (pomelo_platform_task_t *) task;
 }
 
@@ -288,34 +284,38 @@ void pomelo_platform_task_threadsafe_async_callback(uv_async_t * async) {
     // Set the busy flag
     executor->flags |= POMELO_EXECUTOR_FLAG_BUSY;
 
-    uv_mutex_t * mutex = &executor->mutex;
-    pomelo_list_t * tasks = executor->tasks_front;
+    // Take the signal before popping tasks. Submissions after this point will
+    // send a new signal.
+    pomelo_atomic_int64_exchange(&executor->signaled, false);
+    pomelo_atomic_fence();
 
-    /* ----------- Begin mutex scope ----------- */
-    uv_mutex_lock(mutex);
-
-    // Swap the tasks lists
-    executor->tasks_front = executor->tasks_back;
-    executor->tasks_back = tasks;
-
-    uv_mutex_unlock(mutex);
-    /* ------------ End mutex scope ------------ */
-
-    // Update task counter
-    pomelo_platform_threadsafe_controller_t * controller = executor->controller;
-    pomelo_atomic_uint64_fetch_sub(&controller->task_counter, tasks->size);
+    // Tasks which are submitted while executing (e.g. by the tasks themselves)
+    // are queued after the marker and executed by the next callback.
+    pomelo_mpsc_queue_t * tasks = &executor->tasks;
+    if (!executor->marker_queued) {
+        pomelo_mpsc_queue_push(tasks, &executor->marker);
+        executor->marker_queued = true;
+    }
 
     // Execute tasks
+    pomelo_platform_threadsafe_controller_t * controller = executor->controller;
     pomelo_platform_task_threadsafe_t * task = NULL;
     pomelo_platform_task_entry entry = NULL;
     void * data = NULL;
-    while (
-        !(executor->flags & POMELO_EXECUTOR_FLAG_SHUTDOWN) &&
-        pomelo_list_pop_front(tasks, &task) == 0
-    ) {
+    pomelo_mpsc_node_t * node = NULL;
+    while (!(executor->flags & POMELO_EXECUTOR_FLAG_SHUTDOWN)) {
+        node = pomelo_mpsc_queue_pop(tasks);
+        if (!node) break; // The pushing producer will signal again
+        if (node == &executor->marker) {
+            executor->marker_queued = false;
+            break;
+        }
+
+        task = (pomelo_platform_task_threadsafe_t *) node;
         entry = task->entry;
         data = task->data;
         pomelo_platform_task_threadsafe_release(task);
+        pomelo_atomic_uint64_fetch_sub(&controller->task_counter, 1);
 
         entry(data);
     }
@@ -337,47 +337,13 @@ int pomelo_threadsafe_executor_on_alloc(
 
     executor->controller = controller;
     pomelo_atomic_int64_store(&executor->running, false);
-
-    // Create tasks lists
-    pomelo_list_options_t list_options = {
-        .allocator = controller->allocator,
-        .element_size = sizeof(pomelo_platform_task_threadsafe_t *)
-    };
-    executor->tasks_front = pomelo_list_create(&list_options);
-    if (!executor->tasks_front) {
-        return -1;
-    }
-
-    executor->tasks_back = pomelo_list_create(&list_options);
-    if (!executor->tasks_back) {
-        return -1;
-    }
-
-    // Initialize mutex
-    uv_mutex_init_recursive(&executor->mutex);
+    pomelo_atomic_int64_store(&executor->signaled, false);
+    pomelo_mpsc_queue_init(&executor->tasks);
+    executor->marker_queued = false;
     return 0;
 }
 
 
-void pomelo_threadsafe_executor_on_free(
-    pomelo_threadsafe_executor_t * executor
-) {
-    assert(executor != NULL);
-
-    if (executor->tasks_front) {
-        pomelo_list_destroy(executor->tasks_front);
-        executor->tasks_front = NULL;
-    }
-
-    if (executor->tasks_back) {
-        pomelo_list_destroy(executor->tasks_back);
-        executor->tasks_back = NULL;
-    }
-
-    uv_mutex_destroy(&executor->mutex);
-}
-
-
 int pomelo_threadsafe_executor_startup(
     pomelo_threadsafe_executor_t * executor,
     pomelo_platform_threadsafe_controller_t * controller
@@ -397,6 +363,9 @@ int pomelo_threadsafe_executor_startup(
     }
     async->data = executor;
 
+    pomelo_mpsc_queue_init(&executor->tasks);
+    executor->marker_queued = false;
+    pomelo_atomic_int64_store(&executor->signaled, false);
     pomelo_atomic_int64_store(&executor->running, true);
     return 0;
 }
@@ -445,30 +414,15 @@ int pomelo_threadsafe_executor_shutdown(
     uv_close((uv_handle_t *) async, executor_shutdown_complete);
 
     // Clean all tasks
-    uv_mutex_t * mutex = &executor->mutex;
-
-    /* ----------- Begin mutex scope ----------- */
-    uv_mutex_lock(mutex);
-
-    // Update task counter
-    pomelo_atomic_uint64_fetch_sub(
-        &controller->task_counter,
-        executor->tasks_front->size + executor->tasks_back->size
-    );
-
-    pomelo_platform_task_threadsafe_t * task = NULL;
-    pomelo_list_t * tasks = executor->tasks_front;
-    while (pomelo_list_pop_front(tasks, &task) == 0) {
-        pomelo_platform_task_threadsafe_release(task);
-    }
-
-    tasks = executor->tasks_back;
-    while (pomelo_list_pop_front(tasks, &task) == 0) {
-        pomelo_platform_task_threadsafe_release(task);
+    pomelo_mpsc_node_t * node = NULL;
+    while ((node = pomelo_mpsc_queue_pop(&executor->tasks)) != NULL) {
+        if (node == &executor->marker) continue;
+        pomelo_platform_task_threadsafe_release(
+            (pomelo_platform_task_threadsafe_t *) node
+        );
+        pomelo_atomic_uint64_fetch_sub(&controller->task_counter, 1);
     }
-
-    uv_mutex_unlock(mutex);
-    /* ------------ End mutex scope ------------ */
+    executor->marker_queued = false;
 
     return 0;
 }
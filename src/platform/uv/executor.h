@@ -2,6 +2,7 @@
 #define POMELO_PLATFORM_UV_EXECUTOR_SRC_H
 #include "utils/list.h"
 #include "utils/atomic.h"
+#include "utils/mpsc.h"
 #include "utils/pool.h"
 #include "platform-uv.h"
 
@@ -56,14 +57,21 @@ struct pomelo_threadsafe_executor_s {
     /// @brief Running flag of executor
     pomelo_atomic_int64_t running;
 
-    /// @brief Front tasks list for queuing
-    pomelo_list_t * tasks_front;
+    /// @brief Queue of submitted tasks. Other threads push tasks without locking
+    /// and the loop thread pops them.
+    pomelo_mpsc_queue_t tasks;
 
-    /// @brief Back tasks list for executing
-    pomelo_list_t * tasks_back;
+    /// @brief The marker which is pushed at the beginning of async callback.
+    /// Tasks queued after it are executed in the next callback.
+    pomelo_mpsc_node_t marker;
 
-    /// @brief Mutex of controller
-    uv_mutex_t mutex;
+    /// @brief Whether the marker is in the tasks queue
+    bool marker_queued;
+
+    /// @brief Whether the async signal has been sent and not been handled yet.
+    /// Only the first submission after the loop thread takes the signal calls
+    /// uv_async_send.
+    pomelo_atomic_int64_t signaled;
 
     /// @brief UV async
     uv_async_t uv_async;
@@ -77,6 +85,9 @@ struct pomelo_threadsafe_executor_s {
 
 
 struct pomelo_platform_task_threadsafe_s {
+    /// @brief The node in tasks queue of executor
+    pomelo_mpsc_node_t node;
+
     /// @brief Controller
     pomelo_platform_threadsafe_controller_t * controller;
 
@@ -154,12 +165,6 @@ int pomelo_threadsafe_executor_on_alloc(
 );
 
 
-/// @brief Finalize the threadsafe executor
-void pomelo_threadsafe_executor_on_free(
-    pomelo_threadsafe_executor_t * executor
-);
-
-
 /// @brief Startup the threadsafe executor
 int pomelo_threadsafe_executor_startup(
     pomelo_threadsafe_executor_t * executor,
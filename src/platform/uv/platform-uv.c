@@ -2,6 +2,7 @@
 #include <string.h>
 #include "uv.h"
 #include "utils/list.h"
+#include "utils/macro.h"
 #include "platform-uv.h"
 #include "executor.h"
 #include "worker.h"
@@ -47,6 +48,17 @@ pomelo_platform_t * pomelo_platform_uv_create(
     uv_loop_t * uv_loop = options->uv_loop;
     platform->allocator = allocator;
     platform->uv_loop = uv_loop;
+    platform->recv_batch_size = POMELO_MIN(
+        options->recv_batch_size,
+        POMELO_PLATFORM_UV_RECV_BATCH_SIZE_MAX
+    );
+    platform->send_batch_size = POMELO_MIN(
+        options->send_batch_size,
+        POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX
+    );
+    platform->udp_gso = options->udp_gso;
+    platform->reuse_port = options->reuse_port;
+    platform->timer_wheel = options->timer_wheel;
 
     // Initialize idle handle for shutdown
     uv_idle_init(uv_loop, &platform->shutdown_idle);
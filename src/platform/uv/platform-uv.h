@@ -21,6 +21,13 @@ extern "C" {
     POMELO_PLATFORM_UV_COMPONENT_THREADSAFE   \
 )
 
+/// @brief The upper bound of datagrams per receive call. libuv never reads more
+/// than this number of messages in a single recvmmsg call.
+#define POMELO_PLATFORM_UV_RECV_BATCH_SIZE_MAX 20
+
+/// @brief The upper bound of datagrams per batched send call
+#define POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX 64
+
 /// @brief Platform UV
 typedef struct pomelo_platform_uv_s pomelo_platform_uv_t;
 
@@ -51,6 +58,21 @@ struct pomelo_platform_uv_s {
     /// @brief The uv loop
     uv_loop_t * uv_loop;
 
+    /// @brief The maximum number of datagrams per receive call
+    size_t recv_batch_size;
+
+    /// @brief The maximum number of datagrams per send call
+    size_t send_batch_size;
+
+    /// @brief Whether UDP segmentation offload is requested
+    bool udp_gso;
+
+    /// @brief Whether server sockets are bound with SO_REUSEPORT
+    bool reuse_port;
+
+    /// @brief Whether timers are scheduled on the timing wheel
+    bool timer_wheel;
+
     /// @brief The flag of running
     bool running;
 
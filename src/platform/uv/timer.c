@@ -1,8 +1,24 @@
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
+#include "utils/macro.h"
 #include "timer.h"
 
 
+#define WHEEL_ROOT_MASK (POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE - 1)
+#define WHEEL_LEVEL_MASK (POMELO_PLATFORM_UV_TIMER_WHEEL_LEVEL_SIZE - 1)
+
+/// The bit offset of the upper level (1-based)
+#define WHEEL_LEVEL_SHIFT(level) (                                             \
+    POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_BITS +                                 \
+    ((level) - 1) * POMELO_PLATFORM_UV_TIMER_WHEEL_LEVEL_BITS                  \
+)
+
+/// The span of the whole wheel in milliseconds
+#define WHEEL_SPAN                                                             \
+    (1ULL << WHEEL_LEVEL_SHIFT(POMELO_PLATFORM_UV_TIMER_WHEEL_LEVELS + 1))
+
+
 pomelo_platform_timer_controller_t * pomelo_platform_timer_controller_create(
     pomelo_platform_uv_t * platform,
     pomelo_allocator_t * allocator,
@@ -24,6 +40,7 @@ pomelo_platform_timer_controller_t * pomelo_platform_timer_controller_create(
     controller->platform = platform;
     controller->allocator = allocator;
     controller->uv_loop = uv_loop;
+    controller->wheel_deadline = UINT64_MAX;
 
     // Create active timers list
     pomelo_list_options_t list_options = {
@@ -81,7 +98,7 @@ void pomelo_platform_timer_controller_statistic(
     assert(controller != NULL);
     assert(statistic != NULL);
 
-    statistic->timers = controller->timers->size;
+    statistic->timers = controller->timers->size + controller->wheel_size;
 }
 
 
@@ -90,6 +107,33 @@ void pomelo_platform_timer_controller_startup(
 ) {
     assert(controller != NULL);
     controller->running = true;
+
+    if (controller->platform->timer_wheel && !controller->wheel_closing) {
+        uv_timer_init(controller->uv_loop, &controller->wheel_uv_timer);
+        controller->wheel_uv_timer.data = controller;
+        controller->wheel_time = uv_now(controller->uv_loop);
+        controller->wheel_deadline = UINT64_MAX;
+        controller->wheel_active = true;
+    }
+}
+
+
+/// @brief Callback for when the uv timer of wheel is closed
+static void wheel_uv_timer_close_complete(uv_handle_t * handle) {
+    pomelo_platform_timer_controller_t * controller = handle->data;
+    controller->wheel_closing = false;
+
+    if (!controller->running && controller->timers->size == 0) {
+        pomelo_platform_timer_controller_on_shutdown(controller);
+    }
+}
+
+
+/// @brief Stop all timers in a slot of wheel
+static void wheel_stop_slot(pomelo_platform_timer_t ** slot) {
+    while (*slot) {
+        pomelo_platform_uv_timer_stop_ex(*slot);
+    }
 }
 
 
@@ -101,8 +145,35 @@ void pomelo_platform_timer_controller_shutdown(
         return; // Controller is already shutting down
     }
     controller->running = false;
+
+    if (controller->wheel_active) {
+        // Wheel timers are released synchronously, only the uv timer of wheel
+        // needs to be closed
+        controller->wheel_active = false;
+        for (size_t i = 0; i < POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE; i++) {
+            wheel_stop_slot(&controller->wheel_root[i]);
+        }
+        for (size_t l = 0; l < POMELO_PLATFORM_UV_TIMER_WHEEL_LEVELS; l++) {
+            for (size_t i = 0; i < POMELO_PLATFORM_UV_TIMER_WHEEL_LEVEL_SIZE;
+                i++
+            ) {
+                wheel_stop_slot(&controller->wheel_levels[l][i]);
+            }
+        }
+        assert(controller->wheel_size == 0);
+
+        controller->wheel_closing = true;
+        controller->wheel_deadline = UINT64_MAX;
+        uv_close(
+            (uv_handle_t *) &controller->wheel_uv_timer,
+            wheel_uv_timer_close_complete
+        );
+    }
+
     if (controller->timers->size == 0) {
-        pomelo_platform_timer_controller_on_shutdown(controller);
+        if (!controller->wheel_closing) {
+            pomelo_platform_timer_controller_on_shutdown(controller);
+        }
         return;
     }
 
@@ -139,6 +210,32 @@ int pomelo_platform_uv_timer_start(
     timer->is_repeat = (repeat_ms != 0);
     timer->is_running = true;
 
+    if (controller->wheel_active) {
+        // Schedule the timer on wheel, no uv handle is involved
+        if (controller->wheel_size == 0 && !controller->wheel_processing) {
+            // The wheel is empty, catch up with the loop time
+            controller->wheel_time = uv_now(controller->uv_loop);
+        }
+
+        timer->on_wheel = true;
+        timer->expire = uv_now(controller->uv_loop) + timeout_ms;
+        timer->repeat_ms = repeat_ms;
+        pomelo_platform_timer_wheel_insert(controller, timer);
+        controller->wheel_size++;
+
+        if (!controller->wheel_processing &&
+            timer->expire < controller->wheel_deadline
+        ) {
+            pomelo_platform_timer_wheel_schedule(controller);
+        }
+
+        if (handle) {
+            handle->timer = timer;
+            timer->handle = handle;
+        }
+        return 0;
+    }
+
     timer->list_entry = pomelo_list_push_back(controller->timers, timer);
     if (!timer->list_entry) {
         // Cannot add new timer to active list
@@ -199,7 +296,10 @@ static void uv_timer_stop_complete(uv_handle_t * handle) {
     pomelo_list_remove(controller->timers, timer->list_entry);
     pomelo_pool_release(controller->timer_pool, timer);
 
-    if (!controller->running && controller->timers->size == 0) {
+    if (!controller->running &&
+        !controller->wheel_closing &&
+        controller->timers->size == 0
+    ) {
         pomelo_platform_timer_controller_on_shutdown(controller);
     }
 }
@@ -211,15 +311,24 @@ int pomelo_platform_uv_timer_stop_ex(pomelo_platform_timer_t * timer) {
         return 0; // The timer is not running. Nothing to do
     }
 
-    // Stop the UV timer
     timer->is_running = false;
-    uv_close((uv_handle_t *) &timer->uv_timer, uv_timer_stop_complete);
-
     if (timer->handle) {
         timer->handle->timer = NULL;
         timer->handle = NULL;
     }
 
+    if (timer->on_wheel) {
+        // Detach the timer from wheel and release it immediately. The uv timer
+        // of wheel is left as is, an early wake up is harmless.
+        pomelo_platform_timer_controller_t * controller = timer->controller;
+        pomelo_platform_timer_wheel_remove(controller, timer);
+        controller->wheel_size--;
+        pomelo_pool_release(controller->timer_pool, timer);
+        return 0;
+    }
+
+    // Stop the UV timer
+    uv_close((uv_handle_t *) &timer->uv_timer, uv_timer_stop_complete);
     return 0;
 }
 
@@ -238,3 +347,221 @@ void pomelo_platform_uv_timer_callback(uv_timer_t * uv_timer) {
 
     entry(data);
 }
+
+
+/// @brief Get the slot of wheel
+static pomelo_platform_timer_t ** wheel_slot(
+    pomelo_platform_timer_controller_t * controller,
+    size_t level,
+    size_t index
+) {
+    return (level == 0)
+        ? &controller->wheel_root[index]
+        : &controller->wheel_levels[level - 1][index];
+}
+
+
+/// @brief Find the first non-empty root slot from the index. Returns the size
+/// of root level if there is no such slot.
+static size_t wheel_root_next(
+    pomelo_platform_timer_controller_t * controller,
+    size_t index
+) {
+    if (index >= POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE) {
+        return POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE;
+    }
+
+    size_t word = index >> 6;
+    uint64_t bits = controller->wheel_bitmap[word] & (~0ULL << (index & 63));
+    while (!bits) {
+        if (++word == POMELO_PLATFORM_UV_TIMER_WHEEL_BITMAP_SIZE) {
+            return POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE;
+        }
+        bits = controller->wheel_bitmap[word];
+    }
+
+    return (word << 6) + (size_t) __builtin_ctzll(bits);
+}
+
+
+void pomelo_platform_timer_wheel_insert(
+    pomelo_platform_timer_controller_t * controller,
+    pomelo_platform_timer_t * timer
+) {
+    assert(controller != NULL);
+    assert(timer != NULL);
+
+    uint64_t time = controller->wheel_time;
+    if (controller->wheel_processing && timer->expire <= time) {
+        // The current slot is being fired, defer to the next one
+        timer->expire = time + 1;
+    } else if (timer->expire < time) {
+        timer->expire = time;
+    }
+
+    uint64_t expire = timer->expire;
+    uint64_t delta = expire - time;
+    size_t level = 0;
+    size_t index = 0;
+
+    if (delta < POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE) {
+        index = (size_t) (expire & WHEEL_ROOT_MASK);
+        controller->wheel_bitmap[index >> 6] |= (1ULL << (index & 63));
+    } else {
+        if (delta >= WHEEL_SPAN) {
+            // Too far, park it in the farthest slot of the top level
+            expire = time + WHEEL_SPAN - 1;
+        }
+
+        level = 1;
+        while (expire - time >= (1ULL << WHEEL_LEVEL_SHIFT(level + 1))) {
+            level++;
+        }
+        index = (size_t) ((expire >> WHEEL_LEVEL_SHIFT(level)) &
+            WHEEL_LEVEL_MASK);
+    }
+
+    pomelo_platform_timer_t ** slot = wheel_slot(controller, level, index);
+    timer->wheel_level = level;
+    timer->wheel_index = index;
+    timer->wheel_prev = NULL;
+    timer->wheel_next = *slot;
+    if (*slot) {
+        (*slot)->wheel_prev = timer;
+    }
+    *slot = timer;
+}
+
+
+void pomelo_platform_timer_wheel_remove(
+    pomelo_platform_timer_controller_t * controller,
+    pomelo_platform_timer_t * timer
+) {
+    assert(controller != NULL);
+    assert(timer != NULL);
+
+    size_t level = timer->wheel_level;
+    size_t index = timer->wheel_index;
+    pomelo_platform_timer_t ** slot = wheel_slot(controller, level, index);
+
+    if (timer->wheel_prev) {
+        timer->wheel_prev->wheel_next = timer->wheel_next;
+    } else {
+        *slot = timer->wheel_next;
+    }
+    if (timer->wheel_next) {
+        timer->wheel_next->wheel_prev = timer->wheel_prev;
+    }
+    timer->wheel_prev = NULL;
+    timer->wheel_next = NULL;
+
+    if (level == 0 && *slot == NULL) {
+        controller->wheel_bitmap[index >> 6] &= ~(1ULL << (index & 63));
+    }
+}
+
+
+/// @brief Move the timers of current upper slots down to the lower levels
+static void wheel_cascade(pomelo_platform_timer_controller_t * controller) {
+    uint64_t time = controller->wheel_time;
+    for (size_t level = 1; level <= POMELO_PLATFORM_UV_TIMER_WHEEL_LEVELS;
+        level++
+    ) {
+        size_t index =
+            (size_t) ((time >> WHEEL_LEVEL_SHIFT(level)) & WHEEL_LEVEL_MASK);
+        pomelo_platform_timer_t ** slot = wheel_slot(controller, level, index);
+        pomelo_platform_timer_t * timer = *slot;
+        *slot = NULL;
+
+        while (timer) {
+            pomelo_platform_timer_t * next = timer->wheel_next;
+            pomelo_platform_timer_wheel_insert(controller, timer);
+            timer = next;
+        }
+
+        if (index != 0) break; // The upper levels are not wrapped yet
+    }
+}
+
+
+void pomelo_platform_timer_wheel_run(
+    pomelo_platform_timer_controller_t * controller,
+    uint64_t now
+) {
+    assert(controller != NULL);
+
+    while (controller->wheel_active && controller->wheel_time <= now) {
+        uint64_t time = controller->wheel_time;
+        size_t index = (size_t) (time & WHEEL_ROOT_MASK);
+        if (index == 0) {
+            wheel_cascade(controller);
+        }
+
+        pomelo_platform_timer_t * timer = NULL;
+        controller->wheel_processing = true;
+        while ((timer = controller->wheel_root[index]) != NULL) {
+            pomelo_platform_timer_entry entry = timer->entry;
+            void * data = timer->data;
+
+            if (timer->repeat_ms > 0) {
+                // Reschedule first, the callback may stop the timer
+                pomelo_platform_timer_wheel_remove(controller, timer);
+                timer->expire = now + timer->repeat_ms;
+                pomelo_platform_timer_wheel_insert(controller, timer);
+            } else {
+                pomelo_platform_uv_timer_stop_ex(timer);
+            }
+
+            entry(data);
+        }
+        controller->wheel_processing = false;
+
+        // Skip the empty slots, but never pass the next cascading point
+        uint64_t next = time - index + wheel_root_next(controller, index + 1);
+        controller->wheel_time = POMELO_MIN(next, now + 1);
+    }
+}
+
+
+void pomelo_platform_timer_wheel_schedule(
+    pomelo_platform_timer_controller_t * controller
+) {
+    assert(controller != NULL);
+    if (!controller->wheel_active) return; // The wheel is stopped
+
+    if (controller->wheel_size == 0) {
+        if (controller->wheel_deadline != UINT64_MAX) {
+            uv_timer_stop(&controller->wheel_uv_timer);
+            controller->wheel_deadline = UINT64_MAX;
+        }
+        return;
+    }
+
+    // Wake up at the nearest non-empty root slot, or at the next cascading
+    // point if the root level is empty.
+    uint64_t time = controller->wheel_time;
+    size_t index = (size_t) (time & WHEEL_ROOT_MASK);
+    uint64_t deadline = time - index + wheel_root_next(controller, index);
+    if (deadline == controller->wheel_deadline) {
+        return; // Already scheduled
+    }
+
+    uint64_t now = uv_now(controller->uv_loop);
+    controller->wheel_deadline = deadline;
+    uv_timer_start(
+        &controller->wheel_uv_timer,
+        pomelo_platform_timer_wheel_callback,
+        (deadline > now) ? (deadline - now) : 0,
+        0 // No repeat
+    );
+}
+
+
+void pomelo_platform_timer_wheel_callback(uv_timer_t * uv_timer) {
+    pomelo_platform_timer_controller_t * controller = uv_timer->data;
+    assert(controller != NULL);
+
+    controller->wheel_deadline = UINT64_MAX;
+    pomelo_platform_timer_wheel_run(controller, uv_now(controller->uv_loop));
+    pomelo_platform_timer_wheel_schedule(controller);
+}
@@ -8,6 +8,30 @@
 extern "C" {
 #endif
 
+/// @brief The number of bits of the root level of timing wheel. Each slot of
+/// the root level covers one millisecond.
+#define POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_BITS 8
+
+/// @brief The number of bits of each upper level of timing wheel
+#define POMELO_PLATFORM_UV_TIMER_WHEEL_LEVEL_BITS 6
+
+/// @brief The number of upper levels of timing wheel. Timers which are farther
+/// than the span of all levels (about 18 hours) are parked in the last slot of
+/// the top level and cascaded again later.
+#define POMELO_PLATFORM_UV_TIMER_WHEEL_LEVELS 3
+
+/// @brief The number of slots of the root level
+#define POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE \
+    (1 << POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_BITS)
+
+/// @brief The number of slots of each upper level
+#define POMELO_PLATFORM_UV_TIMER_WHEEL_LEVEL_SIZE \
+    (1 << POMELO_PLATFORM_UV_TIMER_WHEEL_LEVEL_BITS)
+
+/// @brief The number of 64-bit words of the root occupancy bitmap
+#define POMELO_PLATFORM_UV_TIMER_WHEEL_BITMAP_SIZE \
+    (POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE / 64)
+
 
 struct pomelo_platform_timer_s {
     /// @brief The user data
@@ -33,6 +57,29 @@ struct pomelo_platform_timer_s {
 
     /// @brief The handle of this timer
     pomelo_platform_timer_handle_t * handle;
+
+    /// @brief Whether this timer is scheduled on the timing wheel instead of
+    /// its own uv timer
+    bool on_wheel;
+
+    /// @brief [Wheel] The absolute expiration time in milliseconds
+    uint64_t expire;
+
+    /// @brief [Wheel] The repeat interval in milliseconds
+    uint64_t repeat_ms;
+
+    /// @brief [Wheel] The level of the slot holding this timer. Zero is the
+    /// root level.
+    size_t wheel_level;
+
+    /// @brief [Wheel] The index of the slot holding this timer
+    size_t wheel_index;
+
+    /// @brief [Wheel] The previous timer in the same slot
+    pomelo_platform_timer_t * wheel_prev;
+
+    /// @brief [Wheel] The next timer in the same slot
+    pomelo_platform_timer_t * wheel_next;
 };
 
 
@@ -54,6 +101,40 @@ struct pomelo_platform_timer_controller_s {
 
     /// @brief The flag of running
     bool running;
+
+    /// @brief Whether new timers are scheduled on the timing wheel
+    bool wheel_active;
+
+    /// @brief Whether the uv timer of wheel is closing
+    bool wheel_closing;
+
+    /// @brief Whether the wheel is firing its expired timers
+    bool wheel_processing;
+
+    /// @brief The uv timer ticking the wheel
+    uv_timer_t wheel_uv_timer;
+
+    /// @brief The current time of wheel. All slots before it are processed.
+    uint64_t wheel_time;
+
+    /// @brief The time the uv timer of wheel is scheduled at, or UINT64_MAX if
+    /// it is not scheduled
+    uint64_t wheel_deadline;
+
+    /// @brief The number of timers on the wheel
+    size_t wheel_size;
+
+    /// @brief The occupancy bitmap of root slots
+    uint64_t wheel_bitmap[POMELO_PLATFORM_UV_TIMER_WHEEL_BITMAP_SIZE];
+
+    /// @brief The root level of wheel
+    pomelo_platform_timer_t *
+        wheel_root[POMELO_PLATFORM_UV_TIMER_WHEEL_ROOT_SIZE];
+
+    /// @brief The upper levels of wheel
+    pomelo_platform_timer_t * wheel_levels
+        [POMELO_PLATFORM_UV_TIMER_WHEEL_LEVELS]
+        [POMELO_PLATFORM_UV_TIMER_WHEEL_LEVEL_SIZE];
 };
 
 
@@ -113,6 +194,37 @@ int pomelo_platform_uv_timer_stop_ex(pomelo_platform_timer_t * timer);
 void pomelo_platform_uv_timer_callback(uv_timer_t * uv_timer);
 
 
+/// @brief Add timer to the slot of wheel matching its expiration time
+void pomelo_platform_timer_wheel_insert(
+    pomelo_platform_timer_controller_t * controller,
+    pomelo_platform_timer_t * timer
+);
+
+
+/// @brief Remove timer from its slot of wheel
+void pomelo_platform_timer_wheel_remove(
+    pomelo_platform_timer_controller_t * controller,
+    pomelo_platform_timer_t * timer
+);
+
+
+/// @brief Fire all timers of wheel which are expired at the time
+void pomelo_platform_timer_wheel_run(
+    pomelo_platform_timer_controller_t * controller,
+    uint64_t now
+);
+
+
+/// @brief Reschedule the uv timer of wheel to the nearest non-empty slot
+void pomelo_platform_timer_wheel_schedule(
+    pomelo_platform_timer_controller_t * controller
+);
+
+
+/// @brief The callback from the uv timer of wheel
+void pomelo_platform_timer_wheel_callback(uv_timer_t * uv_timer);
+
+
 #ifdef __cplusplus
 }
 #endif
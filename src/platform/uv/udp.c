@@ -1,7 +1,16 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // For sendmmsg
+#endif
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
+#include <errno.h>
 #include "base/constants.h"
 #include "udp.h"
+#if POMELO_PLATFORM_UDP_REUSEPORT_AVAILABLE == 1
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 
 /* -------------------------------------------------------------------------- */
@@ -29,6 +38,14 @@ pomelo_platform_udp_controller_t * pomelo_platform_udp_controller_create(
     controller->platform = platform;
     controller->allocator = allocator;
     controller->uv_loop = uv_loop;
+    controller->recv_batch_size = platform->recv_batch_size;
+    controller->reuse_port = platform->reuse_port;
+#if POMELO_PLATFORM_UDP_SENDMMSG_AVAILABLE == 1
+    if (platform->send_batch_size > 1) {
+        controller->send_batch_size = platform->send_batch_size;
+        controller->gso = platform->udp_gso;
+    }
+#endif
 
     // Create send object pool
     pomelo_pool_root_options_t pool_options;
@@ -104,6 +121,28 @@ void pomelo_platform_udp_controller_statistic(
     statistic->send_commands = pomelo_pool_in_use(controller->send_pool);
     statistic->sent_bytes = controller->send_bytes;
     statistic->recv_bytes = controller->recv_bytes;
+    statistic->send_batch_size = controller->send_batch_size;
+    statistic->send_flushes = controller->send_flushes;
+    statistic->send_flushed_datagrams = controller->send_flushed_datagrams;
+    statistic->send_gso_segments = controller->send_gso_segments;
+}
+
+
+/// @brief The flush callback of prepare & check handles
+static void flush_handle_callback(uv_handle_t * handle) {
+    pomelo_platform_udp_controller_t * controller = handle->data;
+    assert(controller != NULL);
+    pomelo_platform_udp_controller_flush(controller);
+}
+
+
+/// @brief The close callback of flush handles
+static void flush_handle_on_closed(uv_handle_t * handle) {
+    pomelo_platform_udp_controller_t * controller = handle->data;
+    assert(controller != NULL);
+
+    controller->flush_handles--;
+    pomelo_platform_udp_controller_check_shutdown(controller);
 }
 
 
@@ -113,6 +152,16 @@ void pomelo_platform_udp_controller_startup(
     assert(controller != NULL);
     controller->running = true;
     controller->sending_requests = 0;
+    controller->flush_scheduled = false;
+
+    if (controller->send_batch_size > 0) {
+        // Initialize the flush handles
+        uv_prepare_init(controller->uv_loop, &controller->flush_prepare);
+        controller->flush_prepare.data = controller;
+        uv_check_init(controller->uv_loop, &controller->flush_check);
+        controller->flush_check.data = controller;
+        controller->flush_handles = 2;
+    }
 }
 
 
@@ -132,6 +181,20 @@ void pomelo_platform_udp_controller_shutdown(
         pomelo_platform_udp_close(socket);
     }
 
+    // Close the flush handles. All queued sends have been flushed by closing
+    // the sockets.
+    if (controller->flush_handles > 0) {
+        controller->flush_scheduled = false;
+        uv_close(
+            (uv_handle_t *) &controller->flush_prepare,
+            flush_handle_on_closed
+        );
+        uv_close(
+            (uv_handle_t *) &controller->flush_check,
+            flush_handle_on_closed
+        );
+    }
+
     pomelo_platform_udp_controller_check_shutdown(controller);
 }
 
@@ -160,8 +223,18 @@ pomelo_platform_udp_t * pomelo_platform_uv_udp_bind(
 
     // Setup UDP handle
     uv_udp_t * udp = &socket->uv_udp;
-    uv_udp_init(controller->uv_loop, udp);
-    udp->data = socket;
+    if (pomelo_platform_udp_init_handle(socket) < 0) {
+        pomelo_pool_release(controller->socket_pool, socket);
+        return NULL; // Failed to initialize the handle
+    }
+
+    if (controller->reuse_port) {
+        int ret = pomelo_platform_udp_open_reuse_port(udp, addr.ss_family);
+        if (ret < 0) {
+            pomelo_platform_udp_close(socket);
+            return NULL; // Failed to share the address
+        }
+    }
 
     int send_buf_size = POMELO_SERVER_SOCKET_SNDBUF_SIZE;
     int recv_buf_size = POMELO_SERVER_SOCKET_RCVBUF_SIZE;
@@ -174,6 +247,8 @@ pomelo_platform_udp_t * pomelo_platform_uv_udp_bind(
         return NULL;
     }
 
+    pomelo_platform_udp_detect_gso(socket);
+
     int ret = uv_udp_recv_start(
         udp,
         pomelo_platform_udp_alloc_callback,
@@ -219,8 +294,10 @@ pomelo_platform_udp_t * pomelo_platform_uv_udp_connect(
 
     // Setup UDP handle
     uv_udp_t * udp = &socket->uv_udp;
-    uv_udp_init(controller->uv_loop, udp);
-    udp->data = socket;
+    if (pomelo_platform_udp_init_handle(socket) < 0) {
+        pomelo_pool_release(controller->socket_pool, socket);
+        return NULL; // Failed to initialize the handle
+    }
 
     int send_buf_size = POMELO_CLIENT_SOCKET_SNDBUF_SIZE;
     int recv_buf_size = POMELO_CLIENT_SOCKET_RCVBUF_SIZE;
@@ -248,6 +325,8 @@ pomelo_platform_udp_t * pomelo_platform_uv_udp_connect(
         return NULL;
     }
 
+    pomelo_platform_udp_detect_gso(socket);
+
     if (uv_udp_recv_start(
         udp,
         pomelo_platform_udp_alloc_callback,
@@ -318,38 +397,52 @@ int pomelo_platform_uv_udp_send(
     send->callback_data = callback_data;
     send->socket = socket;
     send->uv_req.data = send;
+    send->next = NULL;
 
-    uv_buf_t bufs[POMELO_PLATFORM_UDP_MAX_NUMBER_BUF_VECTORS];
-    bufs[0].base = (char *) iovec[0].data;
-    bufs[0].len = (BUFFER_LENGTH_TYPE) iovec[0].length;
+    send->bufs[0].base = (char *) iovec[0].data;
+    send->bufs[0].len = (BUFFER_LENGTH_TYPE) iovec[0].length;
+    send->nbufs = 1;
 
     controller->send_bytes += iovec[0].length;
 
     if (niovec > 1) {
-        bufs[1].base = (char *) iovec[1].data;
-        bufs[1].len = (BUFFER_LENGTH_TYPE) iovec[1].length;
+        send->bufs[1].base = (char *) iovec[1].data;
+        send->bufs[1].len = (BUFFER_LENGTH_TYPE) iovec[1].length;
+        send->nbufs = 2;
         controller->send_bytes += iovec[1].length;
     }
 
-    int ret = uv_udp_send(
-        &send->uv_req,
-        &socket->uv_udp,
-        bufs,
-        niovec,
-        address
-            ? ((struct sockaddr *) &addr)
+    if (address) {
+        memcpy(&send->addr, &addr, sizeof(struct sockaddr_storage));
+        send->has_addr = true;
+    } else {
 #if UV_UV_CONNECT_AVAILABLE == 1
-            : NULL,
+        send->has_addr = false;
 #else
-            : (const struct sockaddr *) &socket->target_addr,
+        memcpy(
+            &send->addr,
+            &socket->target_addr,
+            sizeof(struct sockaddr_storage)
+        );
+        send->has_addr = true;
 #endif
-        pomelo_platform_send_done
-    );
+    }
 
-    if (ret == 0) {
+    if (controller->flush_handles > 0 && !socket->closing) {
+        // Batched sending, the send will be flushed later in this loop
+        pomelo_platform_udp_enqueue_send(socket, send);
         controller->sending_requests++;
+        return 0;
     }
-    return ret;
+
+    int ret = pomelo_platform_send_submit(send);
+    if (ret < 0) {
+        pomelo_pool_release(controller->send_pool, send);
+        return ret;
+    }
+
+    controller->sending_requests++;
+    return 0;
 }
 
 
@@ -394,6 +487,13 @@ void pomelo_platform_udp_alloc_callback(
         return;
     }
 
+    if (socket->recv_slab) {
+        // Batched receiving, read all datagrams into the slab
+        buf->base = (char *) socket->recv_slab;
+        buf->len = (BUFFER_LENGTH_TYPE) socket->recv_slab_size;
+        return;
+    }
+
     socket->alloc_callback(socket->context, &iovec);
     
     buf->base = (char *) iovec.data;
@@ -410,6 +510,16 @@ void pomelo_platform_udp_recv_callback(
 ) {
     pomelo_platform_udp_t * socket = handle->data;
     assert(socket != NULL);
+
+    if (socket->recv_slab) {
+#if UV_UDP_RECVMMSG_AVAILABLE == 1
+        if (flags & UV_UDP_MMSG_FREE) return; // The slab is owned by socket
+#else
+        (void) flags;
+#endif
+        pomelo_platform_udp_recv_batched(socket, nread, buf, addr);
+        return;
+    }
     (void) flags;
 
     pomelo_address_t address;
@@ -437,7 +547,12 @@ void pomelo_platform_udp_recv_callback(
 
 
 void pomelo_platform_send_done(uv_udp_send_t * req, int status) {
-    pomelo_platform_send_t * send = req->data;
+    pomelo_platform_send_finish(req->data, status);
+}
+
+
+void pomelo_platform_send_finish(pomelo_platform_send_t * send, int status) {
+    assert(send != NULL);
     pomelo_platform_udp_t * socket = send->socket;
     pomelo_platform_udp_controller_t * controller = socket->controller;
 
@@ -465,7 +580,8 @@ void pomelo_platform_udp_controller_check_shutdown(
     if (
         !controller->running &&
         controller->sockets->size == 0 &&
-        controller->sending_requests == 0
+        controller->sending_requests == 0 &&
+        controller->flush_handles == 0
     ) {
         pomelo_platform_udp_controller_on_shutdown(controller);
     }
@@ -476,6 +592,12 @@ void pomelo_platform_udp_on_closed(uv_udp_t * udp) {
     pomelo_platform_udp_t * socket = udp->data;
     pomelo_platform_udp_controller_t * controller = socket->controller;
 
+    if (socket->recv_slab) {
+        pomelo_allocator_free(controller->allocator, socket->recv_slab);
+        socket->recv_slab = NULL;
+        socket->recv_slab_size = 0;
+    }
+
     pomelo_list_remove(controller->sockets, socket->entry);
     pomelo_pool_release(controller->socket_pool, socket);
 
@@ -488,8 +610,425 @@ void pomelo_platform_udp_close(pomelo_platform_udp_t * socket) {
     if (socket->closing) return; // Already closing
 
     socket->closing = true;
+
+    // Flush all queued sends before closing
+    if (socket->send_queue_size > 0) {
+        pomelo_platform_udp_flush(socket);
+    }
+
     uv_close(
         (uv_handle_t *) &socket->uv_udp,
         (uv_close_cb) pomelo_platform_udp_on_closed
     );
 }
+
+
+int pomelo_platform_udp_init_handle(pomelo_platform_udp_t * socket) {
+    assert(socket != NULL);
+    pomelo_platform_udp_controller_t * controller = socket->controller;
+    uv_udp_t * udp = &socket->uv_udp;
+    udp->data = socket;
+
+#if UV_UDP_RECVMMSG_AVAILABLE == 1
+    size_t batch_size = controller->recv_batch_size;
+    if (batch_size > 1) {
+        int ret = uv_udp_init_ex(
+            controller->uv_loop,
+            udp,
+            AF_UNSPEC | UV_UDP_RECVMMSG
+        );
+        if (ret < 0) return ret;
+
+        if (!uv_udp_using_recvmmsg(udp)) {
+            return 0; // recvmmsg is not supported, fallback to single recv
+        }
+
+        size_t slab_size = batch_size * POMELO_PLATFORM_UDP_RECV_SLOT_SIZE;
+        socket->recv_slab = pomelo_allocator_malloc(
+            controller->allocator,
+            slab_size
+        );
+        if (socket->recv_slab) {
+            socket->recv_slab_size = slab_size;
+        }
+        // Otherwise, fallback to single recv
+        return 0;
+    }
+#endif
+
+    return uv_udp_init(controller->uv_loop, udp);
+}
+
+
+void pomelo_platform_udp_recv_batched(
+    pomelo_platform_udp_t * socket,
+    ssize_t nread,
+    const uv_buf_t * buf,
+    const struct sockaddr * addr
+) {
+    assert(socket != NULL);
+    assert(buf != NULL);
+
+    // No more datagrams or error. There is no payload buffer to be released
+    // because the buffer is only acquired per received datagram.
+    if (nread <= 0 || !addr) return;
+    socket->controller->recv_bytes += nread;
+
+    if (!socket->recv_callback || !socket->alloc_callback) return;
+
+    pomelo_address_t address;
+    if (pomelo_address_from_sockaddr(&address, addr) < 0) return;
+
+    // Acquire the payload buffer for this datagram
+    pomelo_platform_iovec_t iovec;
+    memset(&iovec, 0, sizeof(pomelo_platform_iovec_t));
+    socket->alloc_callback(socket->context, &iovec);
+    if (!iovec.data) return; // Failed to acquire buffer
+
+    int status = 0;
+    if ((size_t) nread > iovec.length) {
+        status = -1; // Datagram is too large, the buffer will be discarded
+    } else {
+        memcpy(iovec.data, buf->base, (size_t) nread);
+        iovec.length = (size_t) nread;
+    }
+
+    socket->recv_callback(socket->context, &address, &iovec, status);
+}
+
+
+int pomelo_platform_send_submit(pomelo_platform_send_t * send) {
+    assert(send != NULL);
+    pomelo_platform_udp_t * socket = send->socket;
+
+    return uv_udp_send(
+        &send->uv_req,
+        &socket->uv_udp,
+        send->bufs,
+        send->nbufs,
+        send->has_addr ? (const struct sockaddr *) &send->addr : NULL,
+        pomelo_platform_send_done
+    );
+}
+
+
+void pomelo_platform_udp_enqueue_send(
+    pomelo_platform_udp_t * socket,
+    pomelo_platform_send_t * send
+) {
+    assert(socket != NULL);
+    assert(send != NULL);
+
+    if (socket->send_queue_back) {
+        socket->send_queue_back->next = send;
+    } else {
+        socket->send_queue_front = send;
+    }
+    socket->send_queue_back = send;
+    socket->send_queue_size++;
+
+    pomelo_platform_udp_controller_t * controller = socket->controller;
+    if (controller->flush_scheduled) return; // Already scheduled
+    controller->flush_scheduled = true;
+
+    // Flush before polling (sends from timers) and after polling (sends from
+    // I/O callbacks), whichever comes first.
+    uv_prepare_start(
+        &controller->flush_prepare,
+        (uv_prepare_cb) flush_handle_callback
+    );
+    uv_check_start(
+        &controller->flush_check,
+        (uv_check_cb) flush_handle_callback
+    );
+}
+
+
+/// @brief Pop the front send of the socket send queue
+static pomelo_platform_send_t * send_queue_pop(pomelo_platform_udp_t * socket) {
+    pomelo_platform_send_t * send = socket->send_queue_front;
+    if (!send) return NULL;
+
+    socket->send_queue_front = send->next;
+    if (!socket->send_queue_front) {
+        socket->send_queue_back = NULL;
+    }
+    socket->send_queue_size--;
+    send->next = NULL;
+    return send;
+}
+
+
+#if POMELO_PLATFORM_UDP_SENDMMSG_AVAILABLE == 1
+/// @brief Check if two sends have the same target
+static bool send_same_target(
+    pomelo_platform_send_t * a,
+    pomelo_platform_send_t * b
+) {
+    if (a->has_addr != b->has_addr) return false;
+    if (!a->has_addr) return true; // Connected socket
+    if (a->addr.ss_family != b->addr.ss_family) return false;
+
+    size_t length = (a->addr.ss_family == AF_INET6)
+        ? sizeof(struct sockaddr_in6)
+        : sizeof(struct sockaddr_in);
+    return memcmp(&a->addr, &b->addr, length) == 0;
+}
+
+
+/// @brief Get the total length of a send
+static size_t send_length(pomelo_platform_send_t * send) {
+    size_t length = 0;
+    for (unsigned int i = 0; i < send->nbufs; i++) {
+        length += send->bufs[i].len;
+    }
+    return length;
+}
+
+
+/// @brief Send the front of socket send queue with sendmmsg. If GSO is
+/// available, consecutive datagrams with the same target and size are packed
+/// into a single message and segmented by the kernel.
+/// @return The number of sent datagrams, or a negative errno on failure
+static int send_queue_sendmmsg(pomelo_platform_udp_t * socket) {
+    pomelo_platform_udp_controller_t * controller = socket->controller;
+    struct mmsghdr msgs[POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX];
+    struct iovec iovs[
+        POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX *
+        POMELO_PLATFORM_UDP_MAX_NUMBER_BUF_VECTORS
+    ];
+
+    // The number of datagrams packed in each message
+    size_t segments[POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX];
+
+#if POMELO_PLATFORM_UDP_GSO_AVAILABLE == 1
+    // The control messages carrying the segment size (aligned for cmsghdr)
+    uint64_t controls[POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX][
+        (CMSG_SPACE(sizeof(uint16_t)) + 7) / 8
+    ];
+#endif
+
+    uv_os_fd_t fd;
+    if (uv_fileno((uv_handle_t *) &socket->uv_udp, &fd) < 0) {
+        return -EBADF;
+    }
+
+    size_t count = 0;
+    size_t nsends = 0; // The number of packed sends
+    struct iovec * iov = iovs;
+    pomelo_platform_send_t * send = socket->send_queue_front;
+    while (
+        send &&
+        count < controller->send_batch_size &&
+        nsends < POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX
+    ) {
+        struct msghdr * hdr = &msgs[count].msg_hdr;
+        memset(hdr, 0, sizeof(struct msghdr));
+        hdr->msg_iov = iov;
+
+        if (send->has_addr) {
+            hdr->msg_name = &send->addr;
+            hdr->msg_namelen = (send->addr.ss_family == AF_INET6)
+                ? sizeof(struct sockaddr_in6)
+                : sizeof(struct sockaddr_in);
+        }
+
+        pomelo_platform_send_t * first = send;
+        size_t segment_size = send_length(first);
+        size_t total_size = 0;
+        size_t nsegments = 0;
+        while (send && nsends < POMELO_PLATFORM_UV_SEND_BATCH_SIZE_MAX) {
+            if (nsegments > 0) {
+                // Check if this datagram can be packed into current message
+                size_t length = send_length(send);
+                if (
+                    !socket->gso_enabled ||
+                    nsegments >= POMELO_PLATFORM_UDP_GSO_MAX_SEGMENTS ||
+                    length > segment_size ||
+                    total_size + length > POMELO_PLATFORM_UDP_GSO_MAX_BYTES ||
+                    !send_same_target(first, send)
+                ) break;
+            }
+
+            for (unsigned int i = 0; i < send->nbufs; i++) {
+                iov[i].iov_base = send->bufs[i].base;
+                iov[i].iov_len = send->bufs[i].len;
+            }
+            hdr->msg_iovlen += send->nbufs;
+            iov += send->nbufs;
+
+            size_t length = send_length(send);
+            total_size += length;
+            nsegments++;
+            nsends++;
+            send = send->next;
+
+            // Only the last segment may be shorter than the segment size
+            if (length < segment_size) break;
+        }
+
+#if POMELO_PLATFORM_UDP_GSO_AVAILABLE == 1
+        if (nsegments > 1) {
+            // Attach the segment size
+            hdr->msg_control = controls[count];
+            hdr->msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            struct cmsghdr * cmsg = CMSG_FIRSTHDR(hdr);
+            cmsg->cmsg_level = IPPROTO_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t gso_size = (uint16_t) segment_size;
+            memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(uint16_t));
+        }
+#endif
+
+        segments[count] = nsegments;
+        msgs[count].msg_len = 0;
+        count++;
+    }
+
+    int ret;
+    do {
+        ret = sendmmsg(fd, msgs, (unsigned int) count, 0);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 0) {
+        int error = errno;
+        if (segments[0] > 1 && (error == EIO || error == EINVAL)) {
+            // The device does not support segmentation offload, disable GSO
+            // and try again.
+            socket->gso_enabled = false;
+            return 0;
+        }
+        return -error;
+    }
+
+    size_t sent = 0;
+    for (int i = 0; i < ret; i++) {
+        sent += segments[i];
+        if (segments[i] > 1) {
+            controller->send_gso_segments += segments[i];
+        }
+    }
+
+    controller->send_flushes++;
+    controller->send_flushed_datagrams += sent;
+    return (int) sent;
+}
+#endif
+
+
+void pomelo_platform_udp_flush(pomelo_platform_udp_t * socket) {
+    assert(socket != NULL);
+    pomelo_platform_send_t * send = NULL;
+
+#if POMELO_PLATFORM_UDP_SENDMMSG_AVAILABLE == 1
+    // Keep the order with the sends which are waiting in uv queue
+    while (
+        socket->send_queue_size > 0 &&
+        uv_udp_get_send_queue_count(&socket->uv_udp) == 0
+    ) {
+        int ret = send_queue_sendmmsg(socket);
+        if (ret == -EAGAIN || ret == -EWOULDBLOCK || ret == -ENOBUFS) {
+            break; // The socket is busy, let uv wait for writable
+        }
+
+        if (ret < 0) {
+            // The first datagram has failed, drop it and continue
+            send = send_queue_pop(socket);
+            pomelo_platform_send_finish(send, uv_translate_sys_error(-ret));
+            continue;
+        }
+
+        // Detach the sent datagrams before calling their callbacks, which
+        // may close or flush this socket again.
+        pomelo_platform_send_t * sent = NULL;
+        pomelo_platform_send_t * sent_back = NULL;
+        for (int i = 0; i < ret; i++) {
+            send = send_queue_pop(socket);
+            if (sent_back) {
+                sent_back->next = send;
+            } else {
+                sent = send;
+            }
+            sent_back = send;
+        }
+
+        while (sent) {
+            send = sent;
+            sent = send->next;
+            send->next = NULL;
+            pomelo_platform_send_finish(send, 0);
+        }
+    }
+#endif
+
+    // Hand the remain sends over to uv
+    while ((send = send_queue_pop(socket))) {
+        int ret = pomelo_platform_send_submit(send);
+        if (ret < 0) {
+            pomelo_platform_send_finish(send, ret);
+        }
+    }
+}
+
+
+void pomelo_platform_udp_controller_flush(
+    pomelo_platform_udp_controller_t * controller
+) {
+    assert(controller != NULL);
+    if (!controller->flush_scheduled) return;
+
+    // Stop the handles first, new sends in callbacks will reschedule them
+    controller->flush_scheduled = false;
+    uv_prepare_stop(&controller->flush_prepare);
+    uv_check_stop(&controller->flush_check);
+
+    pomelo_platform_udp_t * socket = NULL;
+    pomelo_list_iterator_t it;
+    pomelo_list_iterator_init(&it, controller->sockets);
+    while (pomelo_list_iterator_next(&it, &socket) == 0) {
+        if (socket->send_queue_size > 0) {
+            pomelo_platform_udp_flush(socket);
+        }
+    }
+}
+
+
+void pomelo_platform_udp_detect_gso(pomelo_platform_udp_t * socket) {
+    assert(socket != NULL);
+    socket->gso_enabled = false;
+
+#if POMELO_PLATFORM_UDP_GSO_AVAILABLE == 1
+    if (!socket->controller->gso) return; // GSO is not requested
+
+    uv_os_fd_t fd;
+    if (uv_fileno((uv_handle_t *) &socket->uv_udp, &fd) < 0) return;
+
+    // Kernels without UDP_SEGMENT (< 4.18) reject this option
+    int value = 0;
+    int ret = setsockopt(fd, IPPROTO_UDP, UDP_SEGMENT, &value, sizeof(value));
+    socket->gso_enabled = (ret == 0);
+#endif
+}
+
+
+int pomelo_platform_udp_open_reuse_port(uv_udp_t * udp, int family) {
+    assert(udp != NULL);
+
+#if POMELO_PLATFORM_UDP_REUSEPORT_AVAILABLE == 1
+    int fd = socket(family, SOCK_DGRAM, 0);
+    if (fd < 0) return -1; // Failed to create socket
+
+    int value = 1;
+    int ret = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value));
+    if (ret < 0 || uv_udp_open(udp, fd) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return 0;
+#else
+    (void) family;
+    return -1; // SO_REUSEPORT is not supported
+#endif
+}
@@ -23,6 +23,51 @@ extern "C" {
 #define UV_UV_CONNECT_AVAILABLE 0
 #endif
 
+// UV_UDP_RECVMMSG with UV_UDP_MMSG_FREE is only available after uv 1.40.0
+#if UV_VERSION_HEX >= ((1 << 16) | (40 << 8) | 0)
+#define UV_UDP_RECVMMSG_AVAILABLE 1
+#else
+#define UV_UDP_RECVMMSG_AVAILABLE 0
+#endif
+
+// sendmmsg is only available on Linux
+#if defined(__linux__)
+#define POMELO_PLATFORM_UDP_SENDMMSG_AVAILABLE 1
+#else
+#define POMELO_PLATFORM_UDP_SENDMMSG_AVAILABLE 0
+#endif
+
+// UDP generic segmentation offload is only available on Linux >= 4.18. The
+// option is detected at runtime for each socket.
+#if POMELO_PLATFORM_UDP_SENDMMSG_AVAILABLE == 1
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#define POMELO_PLATFORM_UDP_GSO_AVAILABLE 1
+#else
+#define POMELO_PLATFORM_UDP_GSO_AVAILABLE 0
+#endif
+
+// SO_REUSEPORT is not available on Windows. Linux >= 3.9 balances datagrams
+// between the sockets sharing an address by hashing the 4-tuple.
+#if !defined(_WIN32) && defined(SO_REUSEPORT)
+#define POMELO_PLATFORM_UDP_REUSEPORT_AVAILABLE 1
+#else
+#define POMELO_PLATFORM_UDP_REUSEPORT_AVAILABLE 0
+#endif
+
+/// The maximum number of segments in a single GSO message
+#define POMELO_PLATFORM_UDP_GSO_MAX_SEGMENTS 64
+
+/// The maximum number of bytes in a single GSO message
+#define POMELO_PLATFORM_UDP_GSO_MAX_BYTES 65000
+
+/// The size of each datagram slot in the receiving slab. libuv splits the
+/// receiving buffer into slots of this size when recvmmsg is used.
+#define POMELO_PLATFORM_UDP_RECV_SLOT_SIZE (64 * 1024)
+
 
 /// @brief The sending information
 typedef struct pomelo_platform_send_s pomelo_platform_send_t;
@@ -50,6 +95,26 @@ struct pomelo_platform_udp_s {
     /// @brief Closing flag
     bool closing;
 
+    /// @brief The receiving slab for batched receiving. Datagrams are read
+    /// into this slab by recvmmsg and then copied to the payload buffers.
+    /// NULL if batched receiving is disabled for this socket.
+    uint8_t * recv_slab;
+
+    /// @brief The capacity of receiving slab
+    size_t recv_slab_size;
+
+    /// @brief The front of queued sends which are waiting to be flushed
+    pomelo_platform_send_t * send_queue_front;
+
+    /// @brief The back of queued sends which are waiting to be flushed
+    pomelo_platform_send_t * send_queue_back;
+
+    /// @brief The number of queued sends
+    size_t send_queue_size;
+
+    /// @brief Whether segmentation offload is usable for this socket
+    bool gso_enabled;
+
 #if UV_UV_CONNECT_AVAILABLE == 0
     // In the case of unavailable connect function, we need to store the target
     // address
@@ -90,6 +155,40 @@ struct pomelo_platform_udp_controller_s {
 
     /// @brief The number of sending requests
     size_t sending_requests;
+
+    /// @brief The maximum number of datagrams per receive call
+    size_t recv_batch_size;
+
+    /// @brief The maximum number of datagrams per send call. Zero if batched
+    /// sending is disabled.
+    size_t send_batch_size;
+
+    /// @brief The prepare handle for flushing queued sends before polling
+    uv_prepare_t flush_prepare;
+
+    /// @brief The check handle for flushing queued sends after polling
+    uv_check_t flush_check;
+
+    /// @brief The number of opening flush handles
+    int flush_handles;
+
+    /// @brief Whether the flush handles are active
+    bool flush_scheduled;
+
+    /// @brief The number of batched send calls
+    uint64_t send_flushes;
+
+    /// @brief The number of datagrams sent by batched send calls
+    uint64_t send_flushed_datagrams;
+
+    /// @brief Whether segmentation offload is requested
+    bool gso;
+
+    /// @brief The number of datagrams sent as GSO segments
+    uint64_t send_gso_segments;
+
+    /// @brief Whether bound sockets share their address with SO_REUSEPORT
+    bool reuse_port;
 };
 
 
@@ -105,6 +204,21 @@ struct pomelo_platform_send_s {
 
     /// @brief The callback data
     void * callback_data;
+
+    /// @brief The buffers of datagram
+    uv_buf_t bufs[POMELO_PLATFORM_UDP_MAX_NUMBER_BUF_VECTORS];
+
+    /// @brief The number of buffers
+    unsigned int nbufs;
+
+    /// @brief The target address
+    struct sockaddr_storage addr;
+
+    /// @brief Whether the target address is set
+    bool has_addr;
+
+    /// @brief The next send in the socket send queue
+    pomelo_platform_send_t * next;
 };
 
 
@@ -163,6 +277,20 @@ void pomelo_platform_udp_on_closed(uv_udp_t * udp);
 void pomelo_platform_udp_close(pomelo_platform_udp_t * socket);
 
 
+/// @brief Initialize the UDP handle of socket. Batched receiving is enabled
+/// when it is configured and supported by the running libuv.
+int pomelo_platform_udp_init_handle(pomelo_platform_udp_t * socket);
+
+
+/// @brief Dispatch a datagram which has been read into the receiving slab
+void pomelo_platform_udp_recv_batched(
+    pomelo_platform_udp_t * socket,
+    ssize_t nread,
+    const uv_buf_t * buf,
+    const struct sockaddr * addr
+);
+
+
 /// @brief The allocation callback for uv
 void pomelo_platform_udp_alloc_callback(
     uv_handle_t * handle,
@@ -185,6 +313,40 @@ void pomelo_platform_udp_recv_callback(
 void pomelo_platform_send_done(uv_udp_send_t * req, int status);
 
 
+/// @brief Finish a send and call its callback
+void pomelo_platform_send_finish(pomelo_platform_send_t * send, int status);
+
+
+/// @brief Submit a send to the uv send queue of its socket
+int pomelo_platform_send_submit(pomelo_platform_send_t * send);
+
+
+/// @brief Append a send to the send queue of socket and schedule flushing
+void pomelo_platform_udp_enqueue_send(
+    pomelo_platform_udp_t * socket,
+    pomelo_platform_send_t * send
+);
+
+
+/// @brief Detect if the socket supports segmentation offload
+void pomelo_platform_udp_detect_gso(pomelo_platform_udp_t * socket);
+
+
+/// @brief Open the OS socket of handle with SO_REUSEPORT before binding.
+/// @return 0 on success or -1 on failure
+int pomelo_platform_udp_open_reuse_port(uv_udp_t * udp, int family);
+
+
+/// @brief Flush the queued sends of socket
+void pomelo_platform_udp_flush(pomelo_platform_udp_t * socket);
+
+
+/// @brief Flush the queued sends of all sockets
+void pomelo_platform_udp_controller_flush(
+    pomelo_platform_udp_controller_t * controller
+);
+
+
 /// @brief Check if the controller is shutdown
 void pomelo_platform_udp_controller_check_shutdown(
     pomelo_platform_udp_controller_t * controller
@@ -634,6 +634,13 @@ void pomelo_protocol_client_send_keep_alive(pomelo_protocol_client_t * client) {
         return;
     }
 
+    // The upper layers share the schedule of keep alive
+    pomelo_protocol_socket_on_heartbeat(socket);
+
+    if (time_ns - peer->last_send_time < POMELO_KEEP_ALIVE_IDLE_NS) {
+        return; // Recent packets keep the connection alive
+    }
+
     // Update the sequence number
     pomelo_protocol_packet_keep_alive_info_t info = {
         .sequence = pomelo_protocol_peer_next_sequence(peer),
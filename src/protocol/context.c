@@ -5,6 +5,7 @@
 #include "client.h"
 #include "server.h"
 #include "adapter.h"
+#include "replay.h"
 
 /* -------------------------------------------------------------------------- */
 /*                            Packet init/cleanup                             */
@@ -108,6 +109,28 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
     context->buffer_context = options->buffer_context;
     context->payload_capacity = options->payload_capacity;
 
+    if (options->decrypt_policy >= POMELO_DECRYPT_POLICY_COUNT) {
+        pomelo_protocol_context_destroy(context);
+        return NULL; // Invalid decrypt policy
+    }
+    context->decrypt_policy = options->decrypt_policy;
+    context->decrypt_inline_threshold = options->decrypt_inline_threshold;
+    if (context->decrypt_inline_threshold == 0) {
+        context->decrypt_inline_threshold =
+            POMELO_PROTOCOL_DECRYPT_INLINE_THRESHOLD_DEFAULT;
+    }
+
+    context->replay_window = options->replay_window;
+    if (context->replay_window == 0) {
+        context->replay_window = POMELO_PROTOCOL_REPLAY_WINDOW_DEFAULT;
+    } else if (!pomelo_protocol_replay_window_valid(context->replay_window)) {
+        pomelo_protocol_context_destroy(context);
+        return NULL; // Invalid replay window
+    }
+    pomelo_atomic_uint64_store(&context->inline_received_packets, 0);
+    pomelo_atomic_uint64_store(&context->worker_received_packets, 0);
+    pomelo_atomic_uint64_store(&context->dropped_requests, 0);
+
     // Initialize pools
     pomelo_pool_root_options_t pool_options;
     memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
@@ -123,6 +146,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
         pool_options.on_init = descriptor->init;
         pool_options.on_cleanup = descriptor->cleanup;
         pool_options.zero_init = true;
+        pool_options.synchronized = options->synchronized;
         context->packet_pools[i] = pomelo_pool_root_create(&pool_options);
         if (!context->packet_pools[i]) {
             pomelo_protocol_context_destroy(context);
@@ -139,6 +163,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
         pomelo_protocol_receiver_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_protocol_receiver_cleanup;
+    pool_options.synchronized = options->synchronized;
     context->receiver_pool = pomelo_pool_root_create(&pool_options);
     if (!context->receiver_pool) {
         pomelo_protocol_context_destroy(context);
@@ -154,6 +179,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
         pomelo_protocol_sender_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_protocol_sender_cleanup;
+    pool_options.synchronized = options->synchronized;
     context->sender_pool = pomelo_pool_root_create(&pool_options);
     if (!context->sender_pool) {
         pomelo_protocol_context_destroy(context);
@@ -173,6 +199,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
     pool_options.on_free = (pomelo_pool_free_cb)
         pomelo_protocol_peer_on_free;
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
     context->peer_pool = pomelo_pool_root_create(&pool_options);
     if (!context->peer_pool) {
         pomelo_protocol_context_destroy(context);
@@ -192,6 +219,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
         pomelo_protocol_client_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_protocol_client_cleanup;
+    pool_options.synchronized = options->synchronized;
     context->client_pool = pomelo_pool_root_create(&pool_options);
     if (!context->client_pool) {
         pomelo_protocol_context_destroy(context);
@@ -211,6 +239,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
         pomelo_protocol_server_init;
     pool_options.on_cleanup = (pomelo_pool_cleanup_cb)
         pomelo_protocol_server_cleanup;
+    pool_options.synchronized = options->synchronized;
     context->server_pool = pomelo_pool_root_create(&pool_options);
     if (!context->server_pool) {
         pomelo_protocol_context_destroy(context);
@@ -225,6 +254,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
     pool_options.on_alloc = (pomelo_pool_alloc_cb)
         pomelo_protocol_crypto_context_on_alloc;
     pool_options.on_init = (pomelo_pool_init_cb) crypto_context_init;
+    pool_options.synchronized = options->synchronized;
     context->crypto_context_pool = pomelo_pool_root_create(&pool_options);
     if (!context->crypto_context_pool) {
         pomelo_protocol_context_destroy(context);
@@ -236,6 +266,7 @@ pomelo_protocol_context_t * pomelo_protocol_context_create(
     pool_options.allocator = allocator;
     pool_options.element_size = sizeof(pomelo_protocol_acceptance_t);
     pool_options.alloc_data = context;
+    pool_options.synchronized = options->synchronized;
     context->acceptance_pool = pomelo_pool_root_create(&pool_options);
     if (!context->acceptance_pool) {
         pomelo_protocol_context_destroy(context);
@@ -315,6 +346,12 @@ void pomelo_protocol_context_statistic(
     statistic->crypto_contexts =
         pomelo_pool_in_use(context->crypto_context_pool);
     statistic->acceptances = pomelo_pool_in_use(context->acceptance_pool);
+    statistic->inline_received_packets =
+        pomelo_atomic_uint64_load(&context->inline_received_packets);
+    statistic->worker_received_packets =
+        pomelo_atomic_uint64_load(&context->worker_received_packets);
+    statistic->dropped_requests =
+        pomelo_atomic_uint64_load(&context->dropped_requests);
 }
 
 
@@ -1,5 +1,6 @@
 #ifndef POMELO_PROTOCOL_CONTEXT_SRC_H
 #define POMELO_PROTOCOL_CONTEXT_SRC_H
+#include "utils/atomic.h"
 #include "utils/pool.h"
 #include "protocol.h"
 #include "packet.h"
@@ -8,6 +9,12 @@ extern "C" {
 #endif // __plusplus
 
 
+/// The default maximum body size of packets decrypted in the loop thread by the
+/// adaptive policy. Decrypting such a packet costs less than a round trip
+/// through the worker threads.
+#define POMELO_PROTOCOL_DECRYPT_INLINE_THRESHOLD_DEFAULT 512
+
+
 struct pomelo_protocol_context_s {
     /// @brief The allocator
     pomelo_allocator_t * allocator;
@@ -41,6 +48,25 @@ struct pomelo_protocol_context_s {
 
     /// @brief Pool of acceptance
     pomelo_pool_t * acceptance_pool;
+
+    /// @brief The decryption policy of incoming packets
+    pomelo_decrypt_policy decrypt_policy;
+
+    /// @brief The maximum body size of packets decrypted inline by the
+    /// adaptive policy
+    size_t decrypt_inline_threshold;
+
+    /// @brief The number of sequences of the replay protection window
+    size_t replay_window;
+
+    /// @brief The number of received packets processed in the loop thread
+    pomelo_atomic_uint64_t inline_received_packets;
+
+    /// @brief The number of received packets processed in worker threads
+    pomelo_atomic_uint64_t worker_received_packets;
+
+    /// @brief The number of connection requests dropped by servers
+    pomelo_atomic_uint64_t dropped_requests;
 };
 
 
@@ -0,0 +1,225 @@
+#include <assert.h>
+#include <string.h>
+#include "decryptor.h"
+#include "receiver.h"
+
+
+/// @brief Dispatch the pending receivers in batches of at least the size
+static void decryptor_dispatch(
+    pomelo_protocol_decryptor_t * decryptor,
+    size_t min_size
+);
+
+
+/// @brief Flush the pending receivers after the receiving burst
+static void decryptor_flush(pomelo_protocol_decryptor_t * decryptor) {
+    pomelo_protocol_decryptor_dispatch(decryptor);
+}
+
+
+/// @brief Free the decryptor
+static void decryptor_free(pomelo_protocol_decryptor_t * decryptor) {
+    if (decryptor->batch_pool) {
+        pomelo_pool_destroy(decryptor->batch_pool);
+        decryptor->batch_pool = NULL;
+    }
+
+    pomelo_allocator_free(decryptor->allocator, decryptor);
+}
+
+
+pomelo_protocol_decryptor_t * pomelo_protocol_decryptor_create(
+    pomelo_allocator_t * allocator,
+    pomelo_platform_t * platform
+) {
+    assert(allocator != NULL);
+    assert(platform != NULL);
+
+    pomelo_protocol_decryptor_t * decryptor =
+        pomelo_allocator_malloc_t(allocator, pomelo_protocol_decryptor_t);
+    if (!decryptor) return NULL; // Failed to allocate new decryptor
+
+    memset(decryptor, 0, sizeof(pomelo_protocol_decryptor_t));
+    decryptor->allocator = allocator;
+    decryptor->platform = platform;
+
+    pomelo_pool_root_options_t pool_options;
+    memset(&pool_options, 0, sizeof(pomelo_pool_root_options_t));
+    pool_options.allocator = allocator;
+    pool_options.element_size = sizeof(pomelo_protocol_decryptor_batch_t);
+    pool_options.available_max = POMELO_PROTOCOL_DECRYPTOR_INFLIGHT_MAX;
+    decryptor->batch_pool = pomelo_pool_root_create(&pool_options);
+    if (!decryptor->batch_pool) {
+        decryptor_free(decryptor);
+        return NULL;
+    }
+
+    return decryptor;
+}
+
+
+void pomelo_protocol_decryptor_destroy(
+    pomelo_protocol_decryptor_t * decryptor
+) {
+    assert(decryptor != NULL);
+    decryptor->detached = true;
+    pomelo_platform_timer_stop(decryptor->platform, &decryptor->flush_timer);
+
+    // Complete all pending receivers as canceled
+    pomelo_protocol_receiver_t * receiver = NULL;
+    while ((receiver = decryptor->pending_head) != NULL) {
+        decryptor->pending_head = receiver->next;
+        decryptor->npending--;
+        receiver->next = NULL;
+        pomelo_protocol_receiver_process_complete(receiver, true);
+    }
+    decryptor->pending_tail = NULL;
+
+    if (decryptor->inflight == 0) {
+        decryptor_free(decryptor);
+    }
+    // Otherwise, the last running batch will free the decryptor
+}
+
+
+void pomelo_protocol_decryptor_submit(
+    pomelo_protocol_decryptor_t * decryptor,
+    pomelo_protocol_receiver_t * receiver
+) {
+    assert(decryptor != NULL);
+    assert(receiver != NULL);
+    assert(!decryptor->detached);
+
+    // Append to pending receivers
+    receiver->next = NULL;
+    if (decryptor->pending_tail) {
+        decryptor->pending_tail->next = receiver;
+    } else {
+        decryptor->pending_head = receiver;
+    }
+    decryptor->pending_tail = receiver;
+    decryptor->npending++;
+
+    // Full batches go to the worker threads immediately
+    decryptor_dispatch(decryptor, POMELO_PROTOCOL_DECRYPTOR_BATCH_CAPACITY);
+    if (decryptor->npending == 0) return;
+    if (decryptor->inflight == POMELO_PROTOCOL_DECRYPTOR_INFLIGHT_MAX) {
+        return; // The next completion will dispatch the pending receivers
+    }
+    if (decryptor->flush_timer.timer) return; // Already scheduled
+
+    // Wait for the other packets of the receiving burst
+    int ret = pomelo_platform_timer_start(
+        decryptor->platform,
+        (pomelo_platform_timer_entry) decryptor_flush,
+        0, // No timeout
+        0, // No repeat
+        decryptor,
+        &decryptor->flush_timer
+    );
+    if (ret < 0) {
+        // Failed to start timer, dispatch now
+        pomelo_protocol_decryptor_dispatch(decryptor);
+    }
+}
+
+
+void pomelo_protocol_decryptor_dispatch(
+    pomelo_protocol_decryptor_t * decryptor
+) {
+    assert(decryptor != NULL);
+    decryptor_dispatch(decryptor, 1);
+}
+
+
+static void decryptor_dispatch(
+    pomelo_protocol_decryptor_t * decryptor,
+    size_t min_size
+) {
+    while (!decryptor->detached &&
+        decryptor->npending >= min_size &&
+        decryptor->inflight < POMELO_PROTOCOL_DECRYPTOR_INFLIGHT_MAX
+    ) {
+        pomelo_protocol_decryptor_batch_t * batch =
+            pomelo_pool_acquire(decryptor->batch_pool, NULL);
+        if (!batch) return; // Failed to acquire batch, retry later
+
+        // Take the pending receivers in order
+        batch->decryptor = decryptor;
+        batch->size = 0;
+        while (decryptor->pending_head &&
+            batch->size < POMELO_PROTOCOL_DECRYPTOR_BATCH_CAPACITY
+        ) {
+            pomelo_protocol_receiver_t * receiver = decryptor->pending_head;
+            decryptor->pending_head = receiver->next;
+            receiver->next = NULL;
+            batch->receivers[batch->size++] = receiver;
+        }
+        if (!decryptor->pending_head) {
+            decryptor->pending_tail = NULL;
+        }
+        decryptor->npending -= batch->size;
+        decryptor->inflight++;
+
+        pomelo_platform_task_t * task = pomelo_platform_submit_worker_task(
+            decryptor->platform,
+            (pomelo_platform_task_entry) pomelo_protocol_decryptor_batch_process,
+            (pomelo_platform_task_complete)
+                pomelo_protocol_decryptor_batch_complete,
+            batch
+        );
+        if (!task) {
+            // Failed to submit to worker, fail all receivers of batch
+            decryptor->inflight--;
+            for (size_t i = 0; i < batch->size; i++) {
+                pomelo_protocol_receiver_t * receiver = batch->receivers[i];
+                receiver->flags |= POMELO_PROTOCOL_RECEIVER_FLAG_FAILED;
+                pomelo_pipeline_finish(&receiver->pipeline);
+            }
+            pomelo_pool_release(decryptor->batch_pool, batch);
+            return;
+        }
+        // => pomelo_protocol_decryptor_batch_process()
+    }
+}
+
+
+void pomelo_protocol_decryptor_batch_process(
+    pomelo_protocol_decryptor_batch_t * batch
+) {
+    assert(batch != NULL);
+    for (size_t i = 0; i < batch->size; i++) {
+        pomelo_protocol_receiver_process_entry(batch->receivers[i]);
+    }
+}
+
+
+void pomelo_protocol_decryptor_batch_complete(
+    pomelo_protocol_decryptor_batch_t * batch,
+    bool canceled
+) {
+    assert(batch != NULL);
+    pomelo_protocol_decryptor_t * decryptor = batch->decryptor;
+
+    // The decryptor may be detached by one of these completions, it is still
+    // alive until the in-flight counter is decreased.
+    for (size_t i = 0; i < batch->size; i++) {
+        pomelo_protocol_receiver_process_complete(
+            batch->receivers[i],
+            canceled
+        );
+    }
+
+    pomelo_pool_release(decryptor->batch_pool, batch);
+    decryptor->inflight--;
+
+    if (decryptor->detached) {
+        if (decryptor->inflight == 0) {
+            decryptor_free(decryptor);
+        }
+        return;
+    }
+
+    // Continue with the receivers queued while this batch was running
+    pomelo_protocol_decryptor_dispatch(decryptor);
+}
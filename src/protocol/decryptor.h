@@ -0,0 +1,122 @@
+#ifndef POMELO_PROTOCOL_DECRYPTOR_SRC_H
+#define POMELO_PROTOCOL_DECRYPTOR_SRC_H
+#include "protocol.h"
+#include "platform/platform.h"
+#include "utils/pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The maximum number of receivers processed by a single worker task
+#define POMELO_PROTOCOL_DECRYPTOR_BATCH_CAPACITY 64
+
+/// The maximum number of batches running in worker threads at the same time
+#define POMELO_PROTOCOL_DECRYPTOR_INFLIGHT_MAX 4
+
+
+/// @brief The decryptor of socket. It collects the receivers which require
+/// worker processing (decryption & decoding) and hands them to the worker
+/// threads in batches, so that a burst of packets costs one worker task and
+/// one completion instead of one per packet.
+///
+/// Receivers are accumulated while the packets of a receiving burst are read,
+/// and the partial batch is flushed by a zero timeout timer once the loop has
+/// finished its I/O callbacks. Only full batches are dispatched immediately.
+/// While the in-flight limit is reached, new receivers are queued and they
+/// form the next batch once a running batch completes.
+typedef struct pomelo_protocol_decryptor_s pomelo_protocol_decryptor_t;
+
+/// @brief The batch of receivers processed by a single worker task
+typedef struct pomelo_protocol_decryptor_batch_s
+    pomelo_protocol_decryptor_batch_t;
+
+
+struct pomelo_protocol_decryptor_s {
+    /// @brief The allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The platform
+    pomelo_platform_t * platform;
+
+    /// @brief The pool of batches
+    pomelo_pool_t * batch_pool;
+
+    /// @brief The head of pending receivers
+    pomelo_protocol_receiver_t * pending_head;
+
+    /// @brief The tail of pending receivers
+    pomelo_protocol_receiver_t * pending_tail;
+
+    /// @brief The number of pending receivers
+    size_t npending;
+
+    /// @brief The number of batches running in worker threads
+    size_t inflight;
+
+    /// @brief The timer flushing the partial batch after the receiving burst
+    pomelo_platform_timer_handle_t flush_timer;
+
+    /// @brief Whether the socket has released this decryptor. The decryptor is
+    /// freed when the last running batch completes.
+    bool detached;
+};
+
+
+struct pomelo_protocol_decryptor_batch_s {
+    /// @brief The decryptor
+    pomelo_protocol_decryptor_t * decryptor;
+
+    /// @brief The number of receivers
+    size_t size;
+
+    /// @brief The receivers of batch
+    pomelo_protocol_receiver_t *
+        receivers[POMELO_PROTOCOL_DECRYPTOR_BATCH_CAPACITY];
+};
+
+
+/// @brief Create the decryptor
+pomelo_protocol_decryptor_t * pomelo_protocol_decryptor_create(
+    pomelo_allocator_t * allocator,
+    pomelo_platform_t * platform
+);
+
+
+/// @brief Release the decryptor. Pending receivers are completed as canceled.
+/// The decryptor is freed immediately or after its running batches complete.
+void pomelo_protocol_decryptor_destroy(pomelo_protocol_decryptor_t * decryptor);
+
+
+/// @brief Submit a receiver to decryptor. It is dispatched with a full batch
+/// or by the flush timer.
+void pomelo_protocol_decryptor_submit(
+    pomelo_protocol_decryptor_t * decryptor,
+    pomelo_protocol_receiver_t * receiver
+);
+
+
+/// @brief Move pending receivers to worker threads while the in-flight limit
+/// allows
+void pomelo_protocol_decryptor_dispatch(
+    pomelo_protocol_decryptor_t * decryptor
+);
+
+
+/// @brief Process all receivers of batch. This runs in a worker thread.
+void pomelo_protocol_decryptor_batch_process(
+    pomelo_protocol_decryptor_batch_t * batch
+);
+
+
+/// @brief Complete all receivers of batch. This runs in the loop thread.
+void pomelo_protocol_decryptor_batch_complete(
+    pomelo_protocol_decryptor_batch_t * batch,
+    bool canceled
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PROTOCOL_DECRYPTOR_SRC_H
@@ -62,11 +62,10 @@ int pomelo_protocol_peer_on_alloc(
     assert(context != NULL);
     peer->context = context;
 
-    // Reset the replay protector
-    memset(
-        peer->replay_protector.received_sequence,
-        0xff, // Maximum value
-        sizeof(peer->replay_protector.received_sequence)
+    // Initialize the replay protector
+    pomelo_protocol_replay_protector_init(
+        &peer->replay_protector,
+        context->replay_window
     );
 
     pomelo_allocator_t * allocator = context->allocator;
@@ -100,6 +99,10 @@ int pomelo_protocol_peer_init(
 
     peer->socket = info->socket;
     peer->created_time_ns = info->created_time_ns;
+    peer->deadline_time = 0;
+    peer->deadline_entry = NULL;
+    peer->keep_alive_time = 0;
+    peer->keep_alive_entry = NULL;
 
     // Acquire new codec context
     peer->crypto_ctx = pomelo_protocol_context_acquire_crypto_context(context);
@@ -126,13 +129,14 @@ void pomelo_protocol_peer_cleanup(pomelo_protocol_peer_t * peer) {
     peer->state = POMELO_PROTOCOL_PEER_DISCONNECTED;
     peer->last_recv_time = 0;
     peer->last_recv_time_keep_alive = 0;
+    peer->last_send_time = 0;
+    peer->deadline_time = 0;
+    peer->deadline_entry = NULL;
+    peer->keep_alive_time = 0;
+    peer->keep_alive_entry = NULL;
     peer->timeout_ns = 0;
     peer->sequence_number = 0;
-    memset(
-        peer->replay_protector.received_sequence,
-        0xff,
-        sizeof(peer->replay_protector.received_sequence)
-    );
+    pomelo_protocol_replay_protector_reset(&peer->replay_protector);
 
     // Unref the codec context
     if (peer->crypto_ctx) {
@@ -173,26 +177,10 @@ int pomelo_protocol_peer_protect_replay(
 ) {
     assert(peer != NULL);
 
-    pomelo_protocol_replay_protector_t * protector = &peer->replay_protector;
-    if (sequence_number < protector->most_recent_sequence) {
-        uint64_t delta = protector->most_recent_sequence - sequence_number;
-        if (delta > POMELO_REPLAY_PROTECTED_BUFFER_SIZE) return -1;
-    }
-
-    uint64_t index = sequence_number % POMELO_REPLAY_PROTECTED_BUFFER_SIZE;
-    uint64_t received = protector->received_sequence[index];
-
-    if (received == UINT64_MAX || received < sequence_number) {
-        protector->received_sequence[index] = sequence_number;
-
-        if (sequence_number > protector->most_recent_sequence) {
-            protector->most_recent_sequence = sequence_number;
-        }
-
-        return 0;
-    }
-
-    return -1;
+    return pomelo_protocol_replay_protector_update(
+        &peer->replay_protector,
+        sequence_number
+    );
 }
 
 
@@ -2,15 +2,15 @@
 #define POMELO_PROTOCOL_PEER_SRC_H
 #include "pomelo/constants.h"
 #include "utils/list.h"
+#include "utils/heap.h"
 #include "protocol.h"
 #include "packet.h"
+#include "replay.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 
-#define POMELO_REPLAY_PROTECTED_BUFFER_SIZE 256
-
 /// @brief Peer is confirmed
 #define POMELO_PEER_FLAG_CONFIRMED           (1 << 0)
 
@@ -18,24 +18,10 @@ extern "C" {
 #define POMELO_PEER_FLAG_PROCESSING_RESPONSE (1 << 1)
 
 
-/// @brief Replay protected structure
-typedef struct pomelo_protocol_replay_protector_s
-    pomelo_protocol_replay_protector_t;
-
-
 /// @brief The info for peer
 typedef struct pomelo_protocol_peer_info_s pomelo_protocol_peer_info_t;
 
 
-struct pomelo_protocol_replay_protector_s {
-    /// @brief The buffer array
-    uint64_t received_sequence[POMELO_REPLAY_PROTECTED_BUFFER_SIZE];
-
-    /// @brief The most recent sequence received
-    uint64_t most_recent_sequence;
-};
-
-
 struct pomelo_protocol_peer_info_s {
     /// @brief The socket
     pomelo_protocol_socket_t * socket;
@@ -87,6 +73,9 @@ struct pomelo_protocol_peer_s {
     /// @brief Last time receive keep alive packet
     uint64_t last_recv_time_keep_alive;
 
+    /// @brief The last time a packet was dispatched to peer (in nanoseconds)
+    uint64_t last_send_time;
+
     /// @brief The timeout of peer (in nanoseconds)
     /// This is set by request connect token
     uint64_t timeout_ns;
@@ -114,6 +103,22 @@ struct pomelo_protocol_peer_s {
     /// @brief The entry in connected / disconnecting / anonymous / denied list.
     pomelo_list_entry_t * entry;
 
+    /// @brief The deadline of peer when it was pushed to the deadline heap of
+    /// server (in nanoseconds). The actual deadline of connected peers moves
+    /// with their received packets.
+    uint64_t deadline_time;
+
+    /// @brief The entry in the deadline heap of server
+    pomelo_heap_entry_t * deadline_entry;
+
+    /// @brief The time to send the keep alive packet to peer when it was
+    /// pushed to the keep alive heap of server (in nanoseconds). The actual
+    /// time moves with the dispatched packets.
+    uint64_t keep_alive_time;
+
+    /// @brief The entry in the keep alive heap of server
+    pomelo_heap_entry_t * keep_alive_entry;
+
     /// @brief Flags of peer
     uint32_t flags;
 
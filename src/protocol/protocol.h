@@ -2,6 +2,7 @@
 #define POMELO_PROTOCOL_SRC_H
 #include "pomelo/allocator.h"
 #include "pomelo/address.h"
+#include "pomelo/common.h"
 #include "pomelo/statistic/statistic-protocol.h"
 #include "platform/platform.h"
 #include "adapter/adapter.h"
@@ -81,6 +82,20 @@ struct pomelo_protocol_context_options_s {
 
     /// @brief Capacity of payload
     size_t payload_capacity;
+
+    /// @brief Whether the pools are shared between threads
+    bool synchronized;
+
+    /// @brief The decryption policy of incoming packets
+    pomelo_decrypt_policy decrypt_policy;
+
+    /// @brief The maximum body size of packets decrypted in the loop thread by
+    /// the adaptive policy. Zero for default.
+    size_t decrypt_inline_threshold;
+
+    /// @brief The number of sequences of the replay protection window. It
+    /// must be a power of two from 64 to 1024. Zero for default.
+    size_t replay_window;
 };
 
 
@@ -108,6 +123,14 @@ struct pomelo_protocol_server_options_s {
 
     /// @brief The bind address of socket
     pomelo_address_t address;
+
+    /// @brief The number of connection requests per second accepted from a
+    /// source. Zero for default.
+    uint32_t request_rate;
+
+    /// @brief The number of connection requests accepted at once from a
+    /// source. Zero for default.
+    uint32_t request_burst;
 };
 
 
@@ -299,6 +322,13 @@ void pomelo_protocol_socket_on_connect_result(
 );
 
 
+/// @brief The callback at every keep alive tick of socket, before the keep
+/// alive packets are sent. The upper layers run their heartbeats here, so that
+/// their packets suppress the keep alive packets of the same peers.
+/// @param socket The socket
+void pomelo_protocol_socket_on_heartbeat(pomelo_protocol_socket_t * socket);
+
+
 #ifdef __cplusplus
 }
 #endif
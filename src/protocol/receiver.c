@@ -5,6 +5,7 @@
 #include "receiver.h"
 #include "server.h"
 #include "context.h"
+#include "decryptor.h"
 
 
 #define WORKER_DECODE_REQUIRED (1 << 0)
@@ -112,8 +113,9 @@ void pomelo_protocol_receiver_cleanup(pomelo_protocol_receiver_t * receiver) {
 }
 
 
-/// @brief Process callback of receiver
-static void receiver_process_entry(pomelo_protocol_receiver_t * receiver) {
+void pomelo_protocol_receiver_process_entry(
+    pomelo_protocol_receiver_t * receiver
+) {
     assert(receiver != NULL);
     pomelo_buffer_view_t * body_view = &receiver->body_view;
     pomelo_protocol_crypto_context_t * crypto_ctx = receiver->crypto_ctx;
@@ -149,15 +151,12 @@ static void receiver_process_entry(pomelo_protocol_receiver_t * receiver) {
 }
 
 
-/// @brief Complete callback of receiver
-static void receiver_process_complete(
+void pomelo_protocol_receiver_process_complete(
     pomelo_protocol_receiver_t * receiver,
     bool canceled
 ) {
     assert(receiver != NULL);
 
-    // Unset task
-    receiver->task = NULL;
     if (canceled) {
         receiver->flags |= POMELO_PROTOCOL_RECEIVER_FLAG_CANCELED;
     }
@@ -185,36 +184,51 @@ void pomelo_protocol_receiver_submit(pomelo_protocol_receiver_t * receiver) {
 }
 
 
+/// @brief Check if the receiver should be processed in the loop thread
+static bool receiver_process_inline(pomelo_protocol_receiver_t * receiver) {
+    pomelo_protocol_context_t * context = receiver->context;
+    pomelo_protocol_packet_type type = receiver->packet->type;
+
+    if ((receiver->flags & POMELO_PROTOCOL_RECEIVER_FLAG_NO_DECRYPT) &&
+        !worker_required[type]
+    ) {
+        return true; // Nothing heavy to do
+    }
+
+    switch (context->decrypt_policy) {
+        case POMELO_DECRYPT_POLICY_INLINE:
+            return true;
+
+        case POMELO_DECRYPT_POLICY_WORKER:
+            return false;
+
+        default:
+            // Tokens are always offloaded
+            return !worker_required[type] &&
+                receiver->body_view.length <= context->decrypt_inline_threshold;
+    }
+}
+
+
 void pomelo_protocol_receiver_process(pomelo_protocol_receiver_t * receiver) {
     assert(receiver != NULL);
+    pomelo_protocol_context_t * context = receiver->context;
 
     // Update sequence number of packet
     pomelo_protocol_packet_t * packet = receiver->packet;
     packet->sequence = receiver->header.sequence;
 
-    if (receiver->flags & POMELO_PROTOCOL_RECEIVER_FLAG_NO_DECRYPT) {
-        // Packet is not encrypted
-        if (!worker_required[packet->type]) {
-            receiver_process_entry(receiver);
-            receiver_process_complete(receiver, false);
-            return;
-        }
-    }
-
-    // Submit process to worker
-    receiver->task = pomelo_platform_submit_worker_task(
-        receiver->platform,
-        (pomelo_platform_task_entry) receiver_process_entry,
-        (pomelo_platform_task_complete) receiver_process_complete,
-        receiver
-    );
-
-    if (!receiver->task) {
-        // Failed to submit to worker
-        receiver->flags |= POMELO_PROTOCOL_RECEIVER_FLAG_FAILED;
-        pomelo_pipeline_finish(&receiver->pipeline);
+    if (receiver_process_inline(receiver)) {
+        pomelo_atomic_uint64_fetch_add(&context->inline_received_packets, 1);
+        pomelo_protocol_receiver_process_entry(receiver);
+        pomelo_protocol_receiver_process_complete(receiver, false);
         return;
     }
+    pomelo_atomic_uint64_fetch_add(&context->worker_received_packets, 1);
+
+    // Hand the receiver to the worker threads in batches
+    pomelo_protocol_decryptor_submit(receiver->socket->decryptor, receiver);
+    // => pomelo_protocol_receiver_process_complete()
 }
 
 
@@ -248,12 +262,7 @@ void pomelo_protocol_receiver_cancel(pomelo_protocol_receiver_t * receiver) {
         return; // Receiver has been canceled, ignore
     }
     receiver->flags |= POMELO_PROTOCOL_RECEIVER_FLAG_CANCELED;
-
-    // Cancel the task
-    if (receiver->task) {
-        pomelo_platform_cancel_worker_task(receiver->platform, receiver->task);
-        receiver->task = NULL;
-    }
+    // A receiver in the decryptor is completed along with its batch
 
     // Remove the receiver from the peer's receiving receivers list
     if (receiver->entry && receiver->peer) {
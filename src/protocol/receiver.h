@@ -61,8 +61,8 @@ struct pomelo_protocol_receiver_s {
     /// @brief The codec context
     pomelo_protocol_crypto_context_t * crypto_ctx;
 
-    /// @brief The async task of this receiver
-    pomelo_platform_task_t * task;
+    /// @brief The next receiver in the pending queue of decryptor
+    pomelo_protocol_receiver_t * next;
 
     /// @brief Entry of this receiver in peer receivers list
     pomelo_list_entry_t * entry;
@@ -104,6 +104,20 @@ void pomelo_protocol_receiver_process(pomelo_protocol_receiver_t * receiver);
 void pomelo_protocol_receiver_complete(pomelo_protocol_receiver_t * receiver);
 
 
+/// @brief Decrypt & decode the packet of receiver. This runs in a worker
+/// thread if the packet requires it.
+void pomelo_protocol_receiver_process_entry(
+    pomelo_protocol_receiver_t * receiver
+);
+
+
+/// @brief Finish the processing stage of receiver
+void pomelo_protocol_receiver_process_complete(
+    pomelo_protocol_receiver_t * receiver,
+    bool canceled
+);
+
+
 /// @brief Cancel the receiver
 void pomelo_protocol_receiver_cancel(pomelo_protocol_receiver_t * receiver);
 
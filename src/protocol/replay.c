@@ -0,0 +1,62 @@
+#include <assert.h>
+#include <string.h>
+#include "replay.h"
+
+
+void pomelo_protocol_replay_protector_init(
+    pomelo_protocol_replay_protector_t * protector,
+    size_t window
+) {
+    assert(protector != NULL);
+    assert(pomelo_protocol_replay_window_valid(window));
+
+    protector->window = window;
+    protector->word_mask = 2 * window / POMELO_PROTOCOL_REPLAY_WORD_BITS - 1;
+    pomelo_protocol_replay_protector_reset(protector);
+}
+
+
+void pomelo_protocol_replay_protector_reset(
+    pomelo_protocol_replay_protector_t * protector
+) {
+    assert(protector != NULL);
+    memset(protector->bitmap, 0, sizeof(protector->bitmap));
+    protector->most_recent_sequence = 0;
+}
+
+
+int pomelo_protocol_replay_protector_update(
+    pomelo_protocol_replay_protector_t * protector,
+    uint64_t sequence
+) {
+    assert(protector != NULL);
+    uint64_t recent = protector->most_recent_sequence;
+    uint64_t word_mask = protector->word_mask;
+    uint64_t word_index = sequence / POMELO_PROTOCOL_REPLAY_WORD_BITS;
+    uint64_t bit = 1ULL << (sequence % POMELO_PROTOCOL_REPLAY_WORD_BITS);
+
+    if (sequence <= recent) {
+        if (recent - sequence >= protector->window) return -1; // Too old
+
+        uint64_t * word = protector->bitmap + (word_index & word_mask);
+        if (*word & bit) return -1; // Already received
+
+        *word |= bit;
+        return 0;
+    }
+
+    // Advance the window, clear the words of the skipped sequences
+    uint64_t recent_index = recent / POMELO_PROTOCOL_REPLAY_WORD_BITS;
+    uint64_t nwords = word_index - recent_index;
+    if (nwords > word_mask) {
+        memset(protector->bitmap, 0, sizeof(protector->bitmap));
+    } else {
+        for (uint64_t i = 1; i <= nwords; i++) {
+            protector->bitmap[(recent_index + i) & word_mask] = 0;
+        }
+    }
+
+    protector->bitmap[word_index & word_mask] |= bit;
+    protector->most_recent_sequence = sequence;
+    return 0;
+}
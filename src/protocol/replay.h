@@ -0,0 +1,85 @@
+#ifndef POMELO_PROTOCOL_REPLAY_SRC_H
+#define POMELO_PROTOCOL_REPLAY_SRC_H
+#include <stdint.h>
+#include <stddef.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// @brief The number of sequences of a bitmap word
+#define POMELO_PROTOCOL_REPLAY_WORD_BITS 64
+
+/// @brief The minimum number of sequences of the replay window
+#define POMELO_PROTOCOL_REPLAY_WINDOW_MIN POMELO_PROTOCOL_REPLAY_WORD_BITS
+
+/// @brief The default number of sequences of the replay window
+#define POMELO_PROTOCOL_REPLAY_WINDOW_DEFAULT 256
+
+/// @brief The maximum number of sequences of the replay window
+#define POMELO_PROTOCOL_REPLAY_WINDOW_MAX 1024
+
+/// @brief The number of bitmap words. The bitmap holds twice the words of the
+/// window, so that the word of the most recent sequence never overlaps the
+/// oldest sequences of the window.
+#define POMELO_PROTOCOL_REPLAY_BITMAP_WORDS                                    \
+    (2 * POMELO_PROTOCOL_REPLAY_WINDOW_MAX / POMELO_PROTOCOL_REPLAY_WORD_BITS)
+
+
+/// @brief Check if the replay window size is valid. It must be a power of two
+/// between the minimum and the maximum sizes.
+#define pomelo_protocol_replay_window_valid(window)                            \
+    ((window) >= POMELO_PROTOCOL_REPLAY_WINDOW_MIN &&                          \
+    (window) <= POMELO_PROTOCOL_REPLAY_WINDOW_MAX &&                           \
+    ((window) & ((window) - 1)) == 0)
+
+
+/// @brief Replay protected structure
+typedef struct pomelo_protocol_replay_protector_s
+    pomelo_protocol_replay_protector_t;
+
+
+/// @brief The replay protector is a sliding window of received sequences. The
+/// bitmap is a ring of words, the bit of a sequence is set when it has been
+/// received. Advancing the window clears the words of the skipped sequences.
+struct pomelo_protocol_replay_protector_s {
+    /// @brief The received sequences bitmap
+    uint64_t bitmap[POMELO_PROTOCOL_REPLAY_BITMAP_WORDS];
+
+    /// @brief The most recent sequence received
+    uint64_t most_recent_sequence;
+
+    /// @brief The number of sequences of the window
+    uint64_t window;
+
+    /// @brief The mask of word indices in the bitmap
+    uint64_t word_mask;
+};
+
+
+/// @brief Initialize the replay protector with a valid window size
+void pomelo_protocol_replay_protector_init(
+    pomelo_protocol_replay_protector_t * protector,
+    size_t window
+);
+
+
+/// @brief Forget all the received sequences
+void pomelo_protocol_replay_protector_reset(
+    pomelo_protocol_replay_protector_t * protector
+);
+
+
+/// @brief Check the sequence and mark it as received.
+/// @return 0 if the sequence has not been received and it is not older than
+/// the window, -1 otherwise
+int pomelo_protocol_replay_protector_update(
+    pomelo_protocol_replay_protector_t * protector,
+    uint64_t sequence
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PROTOCOL_REPLAY_SRC_H
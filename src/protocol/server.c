@@ -13,25 +13,84 @@
 /*                              Server internal                               */
 /* -------------------------------------------------------------------------- */
 
-static int64_t pomelo_map_address_hash(
-    pomelo_map_t * map,
-    void * callback_context,
-    pomelo_address_t * address
+/// @brief Compare two peers by their deadlines
+static int peer_deadline_compare(void * a, void * b) {
+    assert(a != NULL);
+    assert(b != NULL);
+
+    pomelo_protocol_peer_t * peer_a = *((pomelo_protocol_peer_t **) a);
+    pomelo_protocol_peer_t * peer_b = *((pomelo_protocol_peer_t **) b);
+    if (peer_a->deadline_time > peer_b->deadline_time) return 1;
+    if (peer_a->deadline_time < peer_b->deadline_time) return -1;
+    return 0;
+}
+
+
+/// @brief Get the current deadline of peer. Challenging peers expire after
+/// their creation, connected peers after their last received packets.
+static uint64_t peer_deadline(pomelo_protocol_peer_t * peer) {
+    uint64_t base = (peer->state == POMELO_PROTOCOL_PEER_CHALLENGE)
+        ? peer->created_time_ns
+        : peer->last_recv_time;
+
+    if (peer->timeout_ns > UINT64_MAX - base) {
+        return UINT64_MAX; // Negative timeout, the peer never expires
+    }
+    return base + peer->timeout_ns;
+}
+
+
+/// @brief Compare two peers by their keep alive times
+static int peer_keep_alive_compare(void * a, void * b) {
+    assert(a != NULL);
+    assert(b != NULL);
+
+    pomelo_protocol_peer_t * peer_a = *((pomelo_protocol_peer_t **) a);
+    pomelo_protocol_peer_t * peer_b = *((pomelo_protocol_peer_t **) b);
+    if (peer_a->keep_alive_time > peer_b->keep_alive_time) return 1;
+    if (peer_a->keep_alive_time < peer_b->keep_alive_time) return -1;
+    return 0;
+}
+
+
+/// @brief Get the time to send the next keep alive packet to peer. It is not
+/// earlier than the next tick after the given time, so that a keep alive
+/// packet which failed to be sent is retried by the next tick.
+static uint64_t peer_keep_alive_time(
+    pomelo_protocol_peer_t * peer,
+    uint64_t time_ns
 ) {
-    (void) map;
-    (void) callback_context;
-    return pomelo_address_hash(address);
+    uint64_t keep_alive_time = peer->last_send_time + POMELO_KEEP_ALIVE_IDLE_NS;
+    return POMELO_MAX(keep_alive_time, time_ns + 1);
 }
 
-static bool pomelo_map_address_compare(
-    pomelo_map_t * map,
-    void * callback_context,
-    pomelo_address_t * first,
-    pomelo_address_t * second
+
+/// @brief Take a token from the bucket of the request source. The ports of a
+/// host share its bucket, so do the IPv6 hosts of a /64 prefix.
+/// @return true if the request is admitted, false if the bucket is empty
+static bool request_admit(
+    pomelo_protocol_server_t * server,
+    pomelo_address_t * address
 ) {
-    (void) map;
-    (void) callback_context;
-    return pomelo_address_compare(first, second);
+    size_t length = (address->type == POMELO_ADDRESS_IPV4)
+        ? sizeof(address->ip.v4)
+        : sizeof(address->ip.v6) / 2;
+    uint64_t hash = pomelo_crypto_shorthash(
+        (const uint8_t *) &address->ip,
+        length,
+        server->request_key
+    );
+    uint64_t * bucket = server->request_buckets +
+        (hash % POMELO_PROTOCOL_SERVER_REQUEST_BUCKETS);
+
+    uint64_t now = pomelo_platform_hrtime(server->socket.platform);
+    uint64_t full_time = (*bucket > now) ? *bucket : now;
+    if (full_time - now > server->request_burst_ns) {
+        return false; // No token left
+    }
+
+    *bucket = full_time + server->request_interval_ns;
+    return true;
 }
 
 
@@ -53,16 +112,9 @@ int pomelo_protocol_server_on_alloc(
     
     pomelo_allocator_t * allocator = context->allocator;
 
-    // Create address to peer maps
-    pomelo_map_options_t map_options = {
-        .allocator = allocator,
-        .key_size = sizeof(pomelo_address_t),
-        .value_size = sizeof(pomelo_protocol_peer_t *),
-        .hash_fn = (pomelo_map_hash_fn) pomelo_map_address_hash,
-        .compare_fn = (pomelo_map_compare_fn) pomelo_map_address_compare
-    };
-    server->peer_address_map = pomelo_map_create(&map_options);
-    if (!server->peer_address_map) return -1; // Failed to create new map
+    // Create address to peer table
+    server->peer_table = pomelo_protocol_peer_table_create(allocator);
+    if (!server->peer_table) return -1; // Failed to create new table
 
     pomelo_list_options_t list_options = {
         .allocator = allocator,
@@ -89,6 +141,20 @@ int pomelo_protocol_server_on_alloc(
     server->disconnecting_peers = pomelo_list_create(&list_options);
     if (!server->disconnecting_peers) return -1; // Failed to create new list
 
+    // Create deadline heap of peers
+    pomelo_heap_options_t heap_options = {
+        .allocator = allocator,
+        .element_size = sizeof(pomelo_protocol_peer_t *),
+        .compare = peer_deadline_compare
+    };
+    server->peer_deadlines = pomelo_heap_create(&heap_options);
+    if (!server->peer_deadlines) return -1; // Failed to create new heap
+
+    // Create keep alive heap of peers
+    heap_options.compare = peer_keep_alive_compare;
+    server->peer_keep_alives = pomelo_heap_create(&heap_options);
+    if (!server->peer_keep_alives) return -1; // Failed to create new heap
+
     return 0;
 }
 
@@ -96,9 +162,9 @@ int pomelo_protocol_server_on_alloc(
 void pomelo_protocol_server_on_free(pomelo_protocol_server_t * server) {
     assert(server != NULL);
 
-    if (server->peer_address_map) {
-        pomelo_map_destroy(server->peer_address_map);
-        server->peer_address_map = NULL;
+    if (server->peer_table) {
+        pomelo_protocol_peer_table_destroy(server->peer_table);
+        server->peer_table = NULL;
     }
 
     if (server->requesting_peers) {
@@ -126,6 +192,16 @@ void pomelo_protocol_server_on_free(pomelo_protocol_server_t * server) {
         server->disconnecting_peers = NULL;
     }
 
+    if (server->peer_deadlines) {
+        pomelo_heap_destroy(server->peer_deadlines);
+        server->peer_deadlines = NULL;
+    }
+
+    if (server->peer_keep_alives) {
+        pomelo_heap_destroy(server->peer_keep_alives);
+        server->peer_keep_alives = NULL;
+    }
+
     pomelo_protocol_socket_on_free(&server->socket);
 }
 
@@ -174,6 +250,18 @@ int pomelo_protocol_server_init(
     server->anonymous_sequence_number = 0;
     server->challenge_sequence_number = 0;
 
+    uint32_t request_rate = options->request_rate;
+    if (request_rate == 0) {
+        request_rate = POMELO_PROTOCOL_SERVER_REQUEST_RATE_DEFAULT;
+    }
+    uint32_t request_burst = options->request_burst;
+    if (request_burst == 0) {
+        request_burst = POMELO_PROTOCOL_SERVER_REQUEST_BURST_DEFAULT;
+    }
+    server->request_interval_ns = POMELO_FREQ_TO_NS(request_rate);
+    server->request_burst_ns =
+        server->request_interval_ns * (request_burst - 1);
+
     // Initialize the tasks
     pomelo_sequencer_task_init(
         &server->keep_alive_task,
@@ -250,7 +338,7 @@ int pomelo_protocol_server_validate(
     pomelo_protocol_peer_state state = POMELO_PROTOCOL_PEER_DISCONNECTED;
 
     // Check the peer out and protect server from packet replay
-    pomelo_map_get(server->peer_address_map, *address, &peer);
+    peer = pomelo_protocol_peer_table_get(server->peer_table, address);
     if (peer) {
         state = peer->state;
     }
@@ -309,6 +397,27 @@ int pomelo_protocol_server_validate(
         return -1; // Failed to read protocol ID or mismatch
     }
 
+    // Quick check expire timestamp of token
+    uint64_t expire_timestamp = 0;
+    ret = pomelo_payload_read_uint64(&payload, &expire_timestamp);
+    if (ret < 0 ||
+        expire_timestamp < pomelo_platform_now(server->socket.platform)
+    ) {
+        return -1; // Failed to read expire timestamp or expired
+    }
+
+    // Nothing is allocated and no token is decrypted for the requests of
+    // flooding sources, or while too many requests are pending
+    if (!request_admit(server, address) ||
+        server->requesting_peers->size >= server->max_clients
+    ) {
+        pomelo_atomic_uint64_fetch_add(
+            &server->socket.context->dropped_requests,
+            1
+        );
+        return -1;
+    }
+
     // Create new anonymous peer
     if (!peer) {
         peer = pomelo_protocol_server_acquire_peer(server, address);
@@ -400,6 +509,10 @@ void pomelo_protocol_server_recv_packet(
                 server, peer, (pomelo_protocol_packet_keep_alive_t *) packet
             );
             break;
+
+        case POMELO_PROTOCOL_PACKET_PAYLOAD:
+            pomelo_protocol_server_recv_payload(server, peer);
+            break;
             
         default:
             break;
@@ -479,6 +592,13 @@ void pomelo_protocol_server_recv_request(
     }
     peer->state = POMELO_PROTOCOL_PEER_CHALLENGE;
 
+    if (pomelo_protocol_server_track_deadline(server, peer) < 0) {
+        // The peer would never expire, release it
+        pomelo_list_remove(server->challenging_peers, peer->entry);
+        pomelo_protocol_server_release_peer(server, peer);
+        return;
+    }
+
     // Response with challenge packet
     pomelo_protocol_server_send_challenge(server, peer, packet);
 }
@@ -530,6 +650,7 @@ void pomelo_protocol_server_recv_response(
 
     // Remove the peer from anonymous list
     pomelo_list_remove(server->challenging_peers, peer->entry);
+    pomelo_protocol_server_untrack_deadline(server, peer);
 
     // Add to connected peers, and put the peer to connected map
     peer->entry = pomelo_list_push_back(server->connected_peers, peer);
@@ -541,6 +662,15 @@ void pomelo_protocol_server_recv_response(
     peer->state = POMELO_PROTOCOL_PEER_CONNECTED;
     peer->flags &= ~POMELO_PEER_FLAG_CONFIRMED;
 
+    if (pomelo_protocol_server_track_deadline(server, peer) < 0 ||
+        pomelo_protocol_server_track_keep_alive(server, peer) < 0
+    ) {
+        // The peer would never time out or be kept alive, release it
+        pomelo_list_remove(server->connected_peers, peer->entry);
+        pomelo_protocol_server_release_peer(server, peer);
+        return;
+    }
+
     // Send keep alive packet
     pomelo_protocol_server_send_keep_alive(server, peer);
 
@@ -600,6 +730,22 @@ void pomelo_protocol_server_recv_keep_alive(
 }
 
 
+void pomelo_protocol_server_recv_payload(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+) {
+    assert(server != NULL);
+    assert(peer != NULL);
+    (void) server;
+
+    // Clients with traffic do not send keep alive packets, so that payloads
+    // confirm the connection as well
+    if (peer->state == POMELO_PROTOCOL_PEER_CONNECTED) {
+        peer->flags |= POMELO_PEER_FLAG_CONFIRMED;
+    }
+}
+
+
 /* -------------------------------------------------------------------------- */
 /*                             Outgoing packets                               */
 /* -------------------------------------------------------------------------- */
@@ -680,6 +826,13 @@ int pomelo_protocol_server_start(pomelo_protocol_server_t * server) {
     // Initialize randomly challenge key
     pomelo_random_buffer(server->challenge_key, POMELO_KEY_BYTES);
 
+    // Generate new hash key of the address table
+    pomelo_protocol_peer_table_seed(server->peer_table);
+
+    // Reset the request buckets and their hash key
+    pomelo_random_buffer(server->request_key, sizeof(server->request_key));
+    memset(server->request_buckets, 0, sizeof(server->request_buckets));
+
     // Start adapter as server
     int ret = pomelo_adapter_listen(socket->adapter, &server->address);
     if (ret < 0) return ret; // Failed to listen
@@ -741,35 +894,33 @@ void pomelo_protocol_server_broadcast_keep_alive(
     assert(server != NULL);
 
     pomelo_protocol_socket_t * socket = (pomelo_protocol_socket_t *) server;
-    pomelo_list_t * peers = server->connected_peers;
-    if (peers->size == 0) {
-        return; // No connected clients, nothing to do
-    }
 
-    // Get the current time
+    // Release the timed out peers first
+    pomelo_protocol_server_expire_peers(server);
+
+    // The upper layers share the schedule of keep alive
+    pomelo_protocol_socket_on_heartbeat(socket);
+
+    pomelo_heap_t * keep_alives = server->peer_keep_alives;
     uint64_t time_ns = pomelo_platform_hrtime(socket->platform);
-    
-    pomelo_protocol_peer_t * peer;
-    pomelo_list_iterator_t it;
-    pomelo_list_iterator_init(&it, peers);
 
-    while (pomelo_list_iterator_next(&it, &peer) == 0) {
-        uint64_t elapsed_ns = time_ns - peer->last_recv_time;
-        if (elapsed_ns <= peer->timeout_ns) {
-            // Send the keep alive to peer
-            pomelo_protocol_server_send_keep_alive(server, peer);
-            continue;
-        }
+    pomelo_protocol_peer_t * peer = NULL;
+    while (pomelo_heap_top(keep_alives, &peer) == 0) {
+        if (peer->keep_alive_time > time_ns) break; // No more idle peers
 
-        // Timed out, call the disconnect callback
-        peer->state = POMELO_PROTOCOL_PEER_DISCONNECTED;
-        pomelo_protocol_socket_dispatch_peer_disconnected(socket, peer);
+        pomelo_heap_pop(keep_alives, NULL);
+        peer->keep_alive_entry = NULL;
 
-        // Then remove the peer from connected list
-        pomelo_list_iterator_remove(&it);
+        // The keep alive time is not updated by every dispatched packet, so
+        // that it is checked again here.
+        if (time_ns - peer->last_send_time >= POMELO_KEEP_ALIVE_IDLE_NS) {
+            pomelo_protocol_server_send_keep_alive(server, peer);
+        }
 
-        // Then release the peer
-        pomelo_protocol_server_release_peer(server, peer);
+        if (pomelo_protocol_server_track_keep_alive(server, peer) < 0) {
+            // The peer would not be kept alive anymore
+            pomelo_protocol_server_disconnect_peer(server, peer);
+        }
     }
 }
 
@@ -877,15 +1028,11 @@ pomelo_protocol_peer_t * pomelo_protocol_server_acquire_peer(
     // Set the address
     peer->address = *address;
 
-    // Set to address map
-    pomelo_map_entry_t * entry = pomelo_map_set(
-        server->peer_address_map,
-        *address,
-        peer
-    );
-    if (!entry) {
+    // Set to address table
+    int ret = pomelo_protocol_peer_table_set(server->peer_table, peer);
+    if (ret < 0) {
         pomelo_pool_release(context->peer_pool, peer);
-        return NULL; // Failed to set to map
+        return NULL; // Failed to set to table
     }
 
     return peer;
@@ -902,8 +1049,12 @@ void pomelo_protocol_server_release_peer(
     // Cancel all senders and receivers
     pomelo_protocol_peer_cancel_senders_and_receivers(peer);
 
-    // Remove from address map
-    pomelo_map_del(server->peer_address_map, peer->address);
+    // Stop tracking the deadline & the keep alive time
+    pomelo_protocol_server_untrack_deadline(server, peer);
+    pomelo_protocol_server_untrack_keep_alive(server, peer);
+
+    // Remove from address table
+    pomelo_protocol_peer_table_del(server->peer_table, &peer->address);
 
     // Release the peer
     pomelo_pool_release(server->socket.context->peer_pool, peer);
@@ -928,7 +1079,10 @@ void pomelo_protocol_server_stop(pomelo_protocol_server_t * server) {
     memset(server->private_key, 0, POMELO_KEY_BYTES);
     memset(server->challenge_key, 0, POMELO_KEY_BYTES);
 
-    // Remove all connected peers
+    // Remove all connected peers, their deadline & keep alive entries are
+    // dropped with the heaps
+    pomelo_heap_clear(server->peer_deadlines);
+    pomelo_heap_clear(server->peer_keep_alives);
     pomelo_protocol_peer_t * peer;
     pomelo_pool_t * peer_pool = server->socket.context->peer_pool;
 
@@ -963,7 +1117,7 @@ void pomelo_protocol_server_stop(pomelo_protocol_server_t * server) {
     }
 
     // Remove all mapping
-    pomelo_map_clear(server->peer_address_map);
+    pomelo_protocol_peer_table_clear(server->peer_table);
 }
 
 
@@ -980,6 +1134,8 @@ int pomelo_protocol_server_disconnect_peer(
 
     // Move the peer to disconnecting list
     pomelo_list_remove(server->connected_peers, peer->entry);
+    pomelo_protocol_server_untrack_deadline(server, peer);
+    pomelo_protocol_server_untrack_keep_alive(server, peer);
     peer->entry = pomelo_list_push_back(server->disconnecting_peers, peer);
     if (!peer->entry) {
         peer->state = POMELO_PROTOCOL_PEER_DISCONNECTED;
@@ -1060,27 +1216,112 @@ void pomelo_protocol_server_scan_challenging_peers(
 ) {
     assert(server != NULL);
 
+    // Challenging peers share the deadline heap with connected peers
+    pomelo_protocol_server_expire_peers(server);
+}
+
+
+int pomelo_protocol_server_track_deadline(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+) {
+    assert(server != NULL);
+    assert(peer != NULL);
+    assert(peer->deadline_entry == NULL);
+
+    peer->deadline_time = peer_deadline(peer);
+    peer->deadline_entry = pomelo_heap_push(server->peer_deadlines, peer);
+    if (!peer->deadline_entry) return -1; // Failed to push the peer
+
+    return 0;
+}
+
+
+void pomelo_protocol_server_untrack_deadline(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+) {
+    assert(server != NULL);
+    assert(peer != NULL);
+
+    if (!peer->deadline_entry) return; // Not tracked
+    pomelo_heap_remove(server->peer_deadlines, peer->deadline_entry);
+    peer->deadline_entry = NULL;
+}
+
+
+int pomelo_protocol_server_track_keep_alive(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+) {
+    assert(server != NULL);
+    assert(peer != NULL);
+    assert(peer->keep_alive_entry == NULL);
+
+    uint64_t time_ns = pomelo_platform_hrtime(server->socket.platform);
+    peer->keep_alive_time = peer_keep_alive_time(peer, time_ns);
+    peer->keep_alive_entry = pomelo_heap_push(server->peer_keep_alives, peer);
+    if (!peer->keep_alive_entry) return -1; // Failed to push the peer
+
+    return 0;
+}
+
+
+void pomelo_protocol_server_untrack_keep_alive(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+) {
+    assert(server != NULL);
+    assert(peer != NULL);
+
+    if (!peer->keep_alive_entry) return; // Not tracked
+    pomelo_heap_remove(server->peer_keep_alives, peer->keep_alive_entry);
+    peer->keep_alive_entry = NULL;
+}
+
+
+void pomelo_protocol_server_expire_peers(pomelo_protocol_server_t * server) {
+    assert(server != NULL);
+
     pomelo_protocol_socket_t * socket = (pomelo_protocol_socket_t *) server;
-    pomelo_list_t * challenging_peers = server->challenging_peers;
-    if (challenging_peers->size == 0) {
-        return; // No anonymous peers, nothing to do
-    }
-    
-    pomelo_protocol_peer_t * peer;
-    pomelo_list_iterator_t it;
-    uint64_t current_time_ns = pomelo_platform_hrtime(socket->platform);
+    pomelo_heap_t * deadlines = server->peer_deadlines;
+    uint64_t time_ns = pomelo_platform_hrtime(socket->platform);
 
-    pomelo_list_iterator_init(&it, challenging_peers);
-    while (pomelo_list_iterator_next(&it, &peer) == 0) {
-        uint64_t elapsed_ns = current_time_ns - peer->created_time_ns;
-        if (elapsed_ns > peer->timeout_ns) {
-            // Remove the peer from challenging list
-            pomelo_list_iterator_remove(&it);
+    pomelo_protocol_peer_t * peer = NULL;
+    while (pomelo_heap_top(deadlines, &peer) == 0) {
+        if (peer->deadline_time >= time_ns) break; // No more expired peers
 
-            // Then release the peer
-            pomelo_protocol_server_release_peer(server, peer);
+        pomelo_heap_pop(deadlines, NULL);
+        peer->deadline_entry = NULL;
+
+        if (peer->state == POMELO_PROTOCOL_PEER_CHALLENGE) {
             // No denied packet will be sent for this peer
+            pomelo_list_remove(server->challenging_peers, peer->entry);
+            pomelo_protocol_server_release_peer(server, peer);
+            continue;
+        }
+
+        assert(peer->state == POMELO_PROTOCOL_PEER_CONNECTED);
+
+        // The deadline is not updated by every received packet, so that it
+        // is checked again here. A peer which cannot be tracked again is
+        // released like the timed out ones.
+        if (peer_deadline(peer) >= time_ns &&
+            pomelo_protocol_server_track_deadline(server, peer) == 0
+        ) {
+            continue; // Still alive
         }
+
+        // Timed out, call the disconnect callback
+        peer->state = POMELO_PROTOCOL_PEER_DISCONNECTED;
+        pomelo_protocol_socket_dispatch_peer_disconnected(socket, peer);
+
+        // Then remove the peer from connected list
+        pomelo_list_remove(server->connected_peers, peer->entry);
+        peer->entry = NULL;
+
+        // Then release the peer
+        pomelo_protocol_server_release_peer(server, peer);
     }
 }
 
@@ -1104,6 +1345,7 @@ void pomelo_protocol_server_deny_peer(
 
         case POMELO_PROTOCOL_PEER_CHALLENGE:
             pomelo_list_remove(server->challenging_peers, peer->entry);
+            pomelo_protocol_server_untrack_deadline(server, peer);
             break;
 
         default:
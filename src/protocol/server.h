@@ -4,10 +4,11 @@
 #include "protocol.h"
 #include "platform/platform.h"
 #include "utils/pool.h"
-#include "utils/map.h"
+#include "utils/heap.h"
 #include "utils/macro.h"
 #include "socket.h"
 #include "packet.h"
+#include "table.h"
 
 
 #ifdef __cplusplus
@@ -15,13 +16,23 @@ extern "C" {
 #endif
 
 
+/// @brief The default number of connection requests per second from a source
+#define POMELO_PROTOCOL_SERVER_REQUEST_RATE_DEFAULT 64
+
+/// @brief The default number of connection requests at once from a source.
+/// Many clients might share the address of a NAT.
+#define POMELO_PROTOCOL_SERVER_REQUEST_BURST_DEFAULT 256
+
+/// @brief The number of token buckets of request sources
+#define POMELO_PROTOCOL_SERVER_REQUEST_BUCKETS 1024
+
+
 struct pomelo_protocol_server_s {
     /// @brief The base socket
     pomelo_protocol_socket_t socket;
 
-    /// @brief The address map for connected peers.
-    /// Map from address to peer.
-    pomelo_map_t * peer_address_map;
+    /// @brief The table from addresses to peers
+    pomelo_protocol_peer_table_t * peer_table;
 
     /// @brief The requesting peers
     pomelo_list_t * requesting_peers;
@@ -38,12 +49,32 @@ struct pomelo_protocol_server_s {
     /// @brief The disconnecting peers
     pomelo_list_t * disconnecting_peers;
 
+    /// @brief The challenging and connected peers, ordered by their deadlines
+    pomelo_heap_t * peer_deadlines;
+
+    /// @brief The connected peers, ordered by the times to send their keep
+    /// alive packets
+    pomelo_heap_t * peer_keep_alives;
+
     /// @brief The private key for decoding request packets
     uint8_t private_key[POMELO_KEY_BYTES];
     
     /// @brief The challenge key
     uint8_t challenge_key[POMELO_KEY_BYTES];
 
+    /// @brief The hash key of request sources
+    uint8_t request_key[POMELO_CRYPTO_SHORTHASH_KEY_BYTES];
+
+    /// @brief The token buckets of request sources. Each bucket is kept as
+    /// the time when it is full again (in nanoseconds).
+    uint64_t request_buckets[POMELO_PROTOCOL_SERVER_REQUEST_BUCKETS];
+
+    /// @brief The time to refill one request token (in nanoseconds)
+    uint64_t request_interval_ns;
+
+    /// @brief The time to refill a whole bucket but one token (in nanoseconds)
+    uint64_t request_burst_ns;
+
     /// @brief The maximum number of clients
     size_t max_clients;
 
@@ -189,6 +220,13 @@ void pomelo_protocol_server_recv_keep_alive(
 );
 
 
+/// @brief Process payload packet
+void pomelo_protocol_server_recv_payload(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+);
+
+
 /* -------------------------------------------------------------------------- */
 /*                             Outgoing packets                               */
 /* -------------------------------------------------------------------------- */
@@ -212,7 +250,8 @@ void pomelo_protocol_server_sent_denied(
 /*                        Server specific functions                           */
 /* -------------------------------------------------------------------------- */
 
-/// @brief Broadcast keep alive to all connected peers
+/// @brief Send keep alive packets to the idle connected peers. Only the peers
+/// whose keep alive times have passed are visited.
 void pomelo_protocol_server_broadcast_keep_alive(
     pomelo_protocol_server_t * server
 );
@@ -281,6 +320,41 @@ void pomelo_protocol_server_scan_challenging_peers(
 );
 
 
+/// @brief Track the deadline of a challenging or connected peer
+/// @return 0 on success, or -1 on failure
+int pomelo_protocol_server_track_deadline(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+);
+
+
+/// @brief Stop tracking the deadline of peer
+void pomelo_protocol_server_untrack_deadline(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+);
+
+
+/// @brief Track the keep alive time of a connected peer
+/// @return 0 on success, or -1 on failure
+int pomelo_protocol_server_track_keep_alive(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+);
+
+
+/// @brief Stop tracking the keep alive time of peer
+void pomelo_protocol_server_untrack_keep_alive(
+    pomelo_protocol_server_t * server,
+    pomelo_protocol_peer_t * peer
+);
+
+
+/// @brief Release the challenging and connected peers which have expired.
+/// Only the peers whose deadlines have passed are visited.
+void pomelo_protocol_server_expire_peers(pomelo_protocol_server_t * server);
+
+
 /// @brief Deny a peer
 void pomelo_protocol_server_deny_peer(
     pomelo_protocol_server_t * server,
@@ -97,6 +97,7 @@ int pomelo_protocol_socket_on_alloc(
     assert(socket != NULL);
     assert(context != NULL);
     socket->context = context;
+    socket->decryptor = NULL;
     return 0;
 }
 
@@ -145,12 +146,23 @@ int pomelo_protocol_socket_init(
         socket
     );
 
+    // Create the decryptor
+    socket->decryptor = pomelo_protocol_decryptor_create(
+        socket->context->allocator,
+        platform
+    );
+    if (!socket->decryptor) return -1; // Failed to create decryptor
+
     return 0;
 }
 
 
 void pomelo_protocol_socket_cleanup(pomelo_protocol_socket_t * socket) {
-    (void) socket;
+    assert(socket != NULL);
+    if (socket->decryptor) {
+        pomelo_protocol_decryptor_destroy(socket->decryptor);
+        socket->decryptor = NULL;
+    }
 }
 
 
@@ -628,6 +640,9 @@ void pomelo_protocol_socket_dispatch(
     assert(socket != NULL);
     assert(peer != NULL);
     assert(packet != NULL);
+
+    // Any packet keeps the connection alive, see POMELO_KEEP_ALIVE_IDLE_NS
+    peer->last_send_time = pomelo_platform_hrtime(socket->platform);
     
     // Acquire new sender
     pomelo_protocol_context_t * context = socket->context;
@@ -4,6 +4,7 @@
 #include "base/buffer.h"
 #include "sender.h"
 #include "receiver.h"
+#include "decryptor.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -14,6 +15,11 @@ extern "C" {
 /// The keep alive packet sending frequency
 #define POMELO_KEEP_ALIVE_FREQUENCY_HZ 10 // Hz
 
+/// Keep alive packets are only sent to the peers which have not been sent any
+/// packets for this duration. Any packet keeps the connection alive as well.
+#define POMELO_KEEP_ALIVE_IDLE_NS                                              \
+    (2 * POMELO_FREQ_TO_NS(POMELO_KEEP_ALIVE_FREQUENCY_HZ))
+
 /// The sending connection request & response frequency
 #define POMELO_CONNECTION_REQUEST_RESPONSE_FREQUENCY_HZ 10 // Hz
 
@@ -140,6 +146,9 @@ struct pomelo_protocol_socket_s {
 
     /// @brief The destroy task of socket
     pomelo_sequencer_task_t destroy_task;
+
+    /// @brief The decryptor which processes incoming packets in worker threads
+    pomelo_protocol_decryptor_t * decryptor;
 };
 
 
@@ -0,0 +1,253 @@
+#include <assert.h>
+#include <string.h>
+#include "pomelo/random.h"
+#include "table.h"
+#include "peer.h"
+
+
+/// @brief Hash the address with the key of table
+static uint64_t table_hash(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_address_t * address
+) {
+    // Layout: IP (4 or 16 bytes) | port (2 bytes) | type (1 byte)
+    uint8_t data[sizeof(address->ip) + sizeof(address->port) + 1];
+    size_t length = (address->type == POMELO_ADDRESS_IPV4)
+        ? sizeof(address->ip.v4)
+        : sizeof(address->ip.v6);
+
+    memcpy(data, &address->ip, length);
+    memcpy(data + length, &address->port, sizeof(address->port));
+    length += sizeof(address->port);
+    data[length++] = (uint8_t) address->type;
+
+    return pomelo_crypto_shorthash(data, length, table->key);
+}
+
+
+/// @brief Get the distance of the slot from the home slot of its hash
+#define table_distance(table, slot_index, hash)                                \
+    (((slot_index) - (size_t) (hash)) & ((table)->capacity - 1))
+
+
+/// @brief Find the slot index of address
+/// @return The slot index or the capacity if the address is not found
+static size_t table_find(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_address_t * address
+) {
+    size_t mask = table->capacity - 1;
+    uint64_t hash = table_hash(table, address);
+    size_t index = (size_t) hash & mask;
+
+    for (size_t distance = 0; distance < table->capacity; distance++) {
+        pomelo_protocol_peer_slot_t * slot = table->slots + index;
+        if (!slot->peer) break; // Empty slot
+
+        // Entries of the same hash are never farther than this one
+        if (table_distance(table, index, slot->hash) < distance) break;
+
+        if (slot->hash == hash &&
+            pomelo_address_compare(&slot->peer->address, address)
+        ) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return table->capacity;
+}
+
+
+/// @brief Insert the slot into the table. The address must not exist and the
+/// table must have an empty slot.
+static void table_insert(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_protocol_peer_slot_t entry
+) {
+    size_t mask = table->capacity - 1;
+    size_t index = (size_t) entry.hash & mask;
+    size_t distance = 0;
+
+    while (true) {
+        pomelo_protocol_peer_slot_t * slot = table->slots + index;
+        if (!slot->peer) {
+            *slot = entry;
+            table->size++;
+            return;
+        }
+
+        // Take the slot from the entry which is closer to its home slot
+        size_t slot_distance = table_distance(table, index, slot->hash);
+        if (slot_distance < distance) {
+            pomelo_protocol_peer_slot_t tmp = *slot;
+            *slot = entry;
+            entry = tmp;
+            distance = slot_distance;
+        }
+
+        index = (index + 1) & mask;
+        distance++;
+    }
+}
+
+
+/// @brief Resize the slots of table
+static int table_resize(
+    pomelo_protocol_peer_table_t * table,
+    size_t capacity
+) {
+    pomelo_protocol_peer_slot_t * slots = pomelo_allocator_malloc(
+        table->allocator,
+        capacity * sizeof(pomelo_protocol_peer_slot_t)
+    );
+    if (!slots) return -1; // Failed to allocate new slots
+    memset(slots, 0, capacity * sizeof(pomelo_protocol_peer_slot_t));
+
+    pomelo_protocol_peer_slot_t * old_slots = table->slots;
+    size_t old_capacity = table->capacity;
+
+    table->slots = slots;
+    table->capacity = capacity;
+    table->size = 0;
+
+    // The hashes are kept in slots, so the addresses are not hashed again
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].peer) {
+            table_insert(table, old_slots[i]);
+        }
+    }
+
+    if (old_slots) {
+        pomelo_allocator_free(table->allocator, old_slots);
+    }
+    return 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*                               Public APIs                                  */
+/* -------------------------------------------------------------------------- */
+
+
+pomelo_protocol_peer_table_t * pomelo_protocol_peer_table_create(
+    pomelo_allocator_t * allocator
+) {
+    if (!allocator) {
+        allocator = pomelo_allocator_default();
+    }
+
+    pomelo_protocol_peer_table_t * table =
+        pomelo_allocator_malloc_t(allocator, pomelo_protocol_peer_table_t);
+    if (!table) return NULL; // Failed to allocate memory
+    memset(table, 0, sizeof(pomelo_protocol_peer_table_t));
+    table->allocator = allocator;
+
+    int ret = table_resize(table, POMELO_PROTOCOL_PEER_TABLE_INITIAL_CAPACITY);
+    if (ret < 0) {
+        pomelo_protocol_peer_table_destroy(table);
+        return NULL; // Failed to allocate slots
+    }
+
+    pomelo_protocol_peer_table_seed(table);
+    return table;
+}
+
+
+void pomelo_protocol_peer_table_destroy(pomelo_protocol_peer_table_t * table) {
+    assert(table != NULL);
+    if (table->slots) {
+        pomelo_allocator_free(table->allocator, table->slots);
+        table->slots = NULL;
+    }
+
+    pomelo_allocator_free(table->allocator, table);
+}
+
+
+void pomelo_protocol_peer_table_seed(pomelo_protocol_peer_table_t * table) {
+    assert(table != NULL);
+    assert(table->size == 0); // The hashes of slots would be stale
+    pomelo_random_buffer(table->key, sizeof(table->key));
+}
+
+
+pomelo_protocol_peer_t * pomelo_protocol_peer_table_get(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_address_t * address
+) {
+    assert(table != NULL);
+    assert(address != NULL);
+
+    size_t index = table_find(table, address);
+    if (index == table->capacity) return NULL; // Not found
+    return table->slots[index].peer;
+}
+
+
+int pomelo_protocol_peer_table_set(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_protocol_peer_t * peer
+) {
+    assert(table != NULL);
+    assert(peer != NULL);
+
+    size_t index = table_find(table, &peer->address);
+    if (index != table->capacity) {
+        table->slots[index].peer = peer; // Override
+        return 0;
+    }
+
+    size_t max_size =
+        table->capacity / 8 * POMELO_PROTOCOL_PEER_TABLE_MAX_LOAD;
+    if (table->size >= max_size) {
+        int ret = table_resize(table, table->capacity * 2);
+        if (ret < 0) return -1; // Failed to grow the table
+    }
+
+    pomelo_protocol_peer_slot_t entry;
+    entry.peer = peer;
+    entry.hash = table_hash(table, &peer->address);
+    table_insert(table, entry);
+    return 0;
+}
+
+
+int pomelo_protocol_peer_table_del(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_address_t * address
+) {
+    assert(table != NULL);
+    assert(address != NULL);
+
+    size_t index = table_find(table, address);
+    if (index == table->capacity) return -1; // Not found
+
+    // Shift the following entries back to their home slots
+    size_t mask = table->capacity - 1;
+    size_t next = (index + 1) & mask;
+    pomelo_protocol_peer_slot_t * slots = table->slots;
+    while (slots[next].peer &&
+        table_distance(table, next, slots[next].hash) > 0
+    ) {
+        slots[index] = slots[next];
+        index = next;
+        next = (next + 1) & mask;
+    }
+
+    slots[index].peer = NULL;
+    slots[index].hash = 0;
+    table->size--;
+    return 0;
+}
+
+
+void pomelo_protocol_peer_table_clear(pomelo_protocol_peer_table_t * table) {
+    assert(table != NULL);
+    memset(
+        table->slots,
+        0,
+        table->capacity * sizeof(pomelo_protocol_peer_slot_t)
+    );
+    table->size = 0;
+}
@@ -0,0 +1,102 @@
+#ifndef POMELO_PROTOCOL_TABLE_SRC_H
+#define POMELO_PROTOCOL_TABLE_SRC_H
+#include "pomelo/address.h"
+#include "pomelo/allocator.h"
+#include "crypto/crypto.h"
+#include "protocol.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// @brief The initial number of slots of the peer table
+#define POMELO_PROTOCOL_PEER_TABLE_INITIAL_CAPACITY 64
+
+/// @brief The maximum load of the peer table in eighths of the capacity
+#define POMELO_PROTOCOL_PEER_TABLE_MAX_LOAD 7
+
+
+/// @brief The slot of peer table
+typedef struct pomelo_protocol_peer_slot_s pomelo_protocol_peer_slot_t;
+
+/// @brief The table from addresses to peers
+typedef struct pomelo_protocol_peer_table_s pomelo_protocol_peer_table_t;
+
+
+struct pomelo_protocol_peer_slot_s {
+    /// @brief The peer. NULL if the slot is empty
+    pomelo_protocol_peer_t * peer;
+
+    /// @brief The keyed hash of the peer address
+    uint64_t hash;
+};
+
+
+/// @brief The peer table is an open addressing hash table with Robin Hood
+/// probing. Addresses are hashed by SipHash with a random key, so that the
+/// remote hosts cannot choose addresses which collide.
+struct pomelo_protocol_peer_table_s {
+    /// @brief The allocator
+    pomelo_allocator_t * allocator;
+
+    /// @brief The slots
+    pomelo_protocol_peer_slot_t * slots;
+
+    /// @brief The number of slots, a power of two
+    size_t capacity;
+
+    /// @brief The number of peers
+    size_t size;
+
+    /// @brief The hash key
+    uint8_t key[POMELO_CRYPTO_SHORTHASH_KEY_BYTES];
+};
+
+
+/// @brief Create new peer table
+pomelo_protocol_peer_table_t * pomelo_protocol_peer_table_create(
+    pomelo_allocator_t * allocator
+);
+
+
+/// @brief Destroy the peer table
+void pomelo_protocol_peer_table_destroy(pomelo_protocol_peer_table_t * table);
+
+
+/// @brief Generate new random hash key. The table must be empty.
+void pomelo_protocol_peer_table_seed(pomelo_protocol_peer_table_t * table);
+
+
+/// @brief Get the peer of address
+/// @return The peer or NULL if the address is not found
+pomelo_protocol_peer_t * pomelo_protocol_peer_table_get(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_address_t * address
+);
+
+
+/// @brief Set the peer with its address. It will override the peer of the
+/// same address.
+/// @return 0 on success or -1 on failure
+int pomelo_protocol_peer_table_set(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_protocol_peer_t * peer
+);
+
+
+/// @brief Delete the peer of address
+/// @return 0 on success or -1 if the address is not found
+int pomelo_protocol_peer_table_del(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_address_t * address
+);
+
+
+/// @brief Remove all the peers
+void pomelo_protocol_peer_table_clear(pomelo_protocol_peer_table_t * table);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_PROTOCOL_TABLE_SRC_H
@@ -139,6 +139,36 @@ int64_t pomelo_atomic_int64_load(pomelo_atomic_int64_t * object) {
     return InterlockedExchangeAddNoFence64((LONG64 volatile *) object, 0);
 }
 
+
+void * pomelo_atomic_ptr_load(pomelo_atomic_ptr_t * object) {
+    assert(object != NULL);
+    return InterlockedCompareExchangePointer(
+        (PVOID volatile *) object,
+        NULL,
+        NULL
+    );
+}
+
+
+void pomelo_atomic_ptr_store(pomelo_atomic_ptr_t * object, void * value) {
+    assert(object != NULL);
+    InterlockedExchangePointer((PVOID volatile *) object, value);
+}
+
+
+void * pomelo_atomic_ptr_exchange(
+    pomelo_atomic_ptr_t * object,
+    void * new_value
+) {
+    assert(object != NULL);
+    return InterlockedExchangePointer((PVOID volatile *) object, new_value);
+}
+
+
+void pomelo_atomic_fence(void) {
+    MemoryBarrier();
+}
+
 #else
 
 #include <stdatomic.h>
@@ -244,4 +274,30 @@ int64_t pomelo_atomic_int64_exchange(
 }
 
 
+void * pomelo_atomic_ptr_load(pomelo_atomic_ptr_t * object) {
+    assert(object != NULL);
+    return atomic_load_explicit(object, memory_order_acquire);
+}
+
+
+void pomelo_atomic_ptr_store(pomelo_atomic_ptr_t * object, void * value) {
+    assert(object != NULL);
+    atomic_store_explicit(object, value, memory_order_release);
+}
+
+
+void * pomelo_atomic_ptr_exchange(
+    pomelo_atomic_ptr_t * object,
+    void * new_value
+) {
+    assert(object != NULL);
+    return atomic_exchange_explicit(object, new_value, memory_order_acq_rel);
+}
+
+
+void pomelo_atomic_fence(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+
 #endif // For Unix
@@ -1,6 +1,7 @@
 /*
     Atomic compatible data types for internal usage.
-    These types use relaxed memory order.
+    Integer types use relaxed memory order. Pointer types use acquire/release
+    memory order, because they are used to publish the pointed data.
 */
 #ifndef POMELO_UTILS_ATOMIC_SRC_H
 #define POMELO_UTILS_ATOMIC_SRC_H
@@ -21,6 +22,9 @@ typedef uint64_t volatile pomelo_atomic_uint64_t;
 /// @brief Atomic signed integer 64
 typedef int64_t volatile pomelo_atomic_int64_t;
 
+/// @brief Atomic pointer
+typedef void * volatile pomelo_atomic_ptr_t;
+
 #else
 
 /// @brief Atomic unsigned integer 64
@@ -29,6 +33,9 @@ typedef _Atomic uint64_t pomelo_atomic_uint64_t;
 /// @brief Atomic signedinteger 64
 typedef _Atomic int64_t pomelo_atomic_int64_t;
 
+/// @brief Atomic pointer
+typedef void * _Atomic pomelo_atomic_ptr_t;
+
 #endif // !_MSC_VER
 
 
@@ -117,6 +124,27 @@ int64_t pomelo_atomic_int64_exchange(
 );
 
 
+/// @brief Load the atomic pointer (acquire)
+void * pomelo_atomic_ptr_load(pomelo_atomic_ptr_t * object);
+
+
+/// @brief Store the pointer to atomic (release)
+void pomelo_atomic_ptr_store(pomelo_atomic_ptr_t * object, void * value);
+
+
+/// @brief Load the previous pointer and store new pointer (acquire & release)
+/// @return The previous pointer
+void * pomelo_atomic_ptr_exchange(
+    pomelo_atomic_ptr_t * object,
+    void * new_value
+);
+
+
+/// @brief Full memory fence. It orders the relaxed operations before and after
+/// it.
+void pomelo_atomic_fence(void);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -429,6 +429,24 @@ void pomelo_list_remove(pomelo_list_t * list, pomelo_list_entry_t * entry) {
 }
 
 
+void pomelo_list_move_back(pomelo_list_t * list, pomelo_list_entry_t * entry) {
+    assert(list != NULL);
+    assert(entry != NULL);
+    pomelo_list_check_signature(list);
+    pomelo_list_entry_check_signature(list, entry);
+
+    pomelo_mutex_t * mutex = list->mutex;
+    POMELO_BEGIN_CRITICAL_SECTION(mutex);
+
+    if (entry != list->back) {
+        pomelo_list_unlink_entry(list, entry);
+        pomelo_list_link_back(list, entry);
+    }
+
+    POMELO_END_CRITICAL_SECTION(mutex);
+}
+
+
 void pomelo_list_clear(pomelo_list_t * list) {
     assert(list != NULL);
     pomelo_list_check_signature(list);
@@ -197,6 +197,9 @@ int pomelo_list_pop_back(pomelo_list_t * list, void * data);
 /// @brief Remove a node from list
 void pomelo_list_remove(pomelo_list_t * list, pomelo_list_entry_t * entry);
 
+/// @brief Move a node of list to its back. The node is not reallocated.
+void pomelo_list_move_back(pomelo_list_t * list, pomelo_list_entry_t * entry);
+
 /// @brief Clear the list
 void pomelo_list_clear(pomelo_list_t * list);
 
@@ -0,0 +1,61 @@
+#include <assert.h>
+#include <stddef.h>
+#include "mpsc.h"
+
+
+void pomelo_mpsc_queue_init(pomelo_mpsc_queue_t * queue) {
+    assert(queue != NULL);
+    pomelo_atomic_ptr_store(&queue->stub.next, NULL);
+    pomelo_atomic_ptr_store(&queue->head, &queue->stub);
+    queue->tail = &queue->stub;
+}
+
+
+void pomelo_mpsc_queue_push(
+    pomelo_mpsc_queue_t * queue,
+    pomelo_mpsc_node_t * node
+) {
+    assert(queue != NULL);
+    assert(node != NULL);
+
+    pomelo_atomic_ptr_store(&node->next, NULL);
+    pomelo_mpsc_node_t * prev = pomelo_atomic_ptr_exchange(&queue->head, node);
+
+    // Until this store, the node is not reachable from the tail
+    pomelo_atomic_ptr_store(&prev->next, node);
+}
+
+
+pomelo_mpsc_node_t * pomelo_mpsc_queue_pop(pomelo_mpsc_queue_t * queue) {
+    assert(queue != NULL);
+    pomelo_mpsc_node_t * stub = &queue->stub;
+    pomelo_mpsc_node_t * tail = queue->tail;
+    pomelo_mpsc_node_t * next = pomelo_atomic_ptr_load(&tail->next);
+
+    // Skip the stub node
+    if (tail == stub) {
+        if (!next) return NULL; // Empty queue
+        queue->tail = next;
+        tail = next;
+        next = pomelo_atomic_ptr_load(&next->next);
+    }
+
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+
+    if (tail != pomelo_atomic_ptr_load(&queue->head)) {
+        return NULL; // A producer has not linked its node yet
+    }
+
+    // The tail is the last node, push the stub back to take it out
+    pomelo_mpsc_queue_push(queue, stub);
+    next = pomelo_atomic_ptr_load(&tail->next);
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+
+    return NULL; // A producer has not linked its node yet
+}
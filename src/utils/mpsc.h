@@ -0,0 +1,64 @@
+#ifndef POMELO_UTILS_MPSC_SRC_H
+#define POMELO_UTILS_MPSC_SRC_H
+#include "atomic.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Intrusive multiple producers - single consumer queue (Vyukov).
+    Pushing is wait-free: one atomic exchange and one store. Popping is only
+    called by the consumer thread and it is lock-free.
+
+    The queue is intrusive, nodes are embedded in the queued elements so that
+    pushing never allocates.
+*/
+
+
+/// @brief The node of MPSC queue
+typedef struct pomelo_mpsc_node_s pomelo_mpsc_node_t;
+
+/// @brief The MPSC queue
+typedef struct pomelo_mpsc_queue_s pomelo_mpsc_queue_t;
+
+
+struct pomelo_mpsc_node_s {
+    /// @brief The next node
+    pomelo_atomic_ptr_t next;
+};
+
+
+struct pomelo_mpsc_queue_s {
+    /// @brief The last pushed node. Producers exchange this.
+    pomelo_atomic_ptr_t head;
+
+    /// @brief The next node to pop. Only the consumer accesses this.
+    pomelo_mpsc_node_t * tail;
+
+    /// @brief The stub node which keeps the queue non-empty
+    pomelo_mpsc_node_t stub;
+};
+
+
+/// @brief Initialize the queue
+void pomelo_mpsc_queue_init(pomelo_mpsc_queue_t * queue);
+
+
+/// @brief Push a node to the queue. This is safe to call from any thread.
+void pomelo_mpsc_queue_push(
+    pomelo_mpsc_queue_t * queue,
+    pomelo_mpsc_node_t * node
+);
+
+
+/// @brief Pop a node from the queue. Only the consumer thread calls this.
+/// @return The popped node or NULL if the queue is empty. NULL is also
+/// returned while a producer is in the middle of pushing the next node, the
+/// consumer should try again after being signaled by that producer.
+pomelo_mpsc_node_t * pomelo_mpsc_queue_pop(pomelo_mpsc_queue_t * queue);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif // POMELO_UTILS_MPSC_SRC_H
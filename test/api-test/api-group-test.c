@@ -0,0 +1,522 @@
+#include <string.h>
+#include "uv.h"
+#include "pomelo-test.h"
+#include "pomelo/api.h"
+#include "pomelo/platform.h"
+#include "pomelo/platforms/platform-uv.h"
+#include "pomelo/token.h"
+#include "pomelo/random.h"
+#include "platform-test/platform-test.h"
+#include "statistic-check/statistic-check.h"
+#include "utils/atomic.h"
+
+
+/**
+ * This test verifies the sharded servers of a socket group. Every shard runs
+ * in its own loop thread and shares the root context with the others:
+ *  - Clients connect to both shards, then a message is broadcasted to all of
+ *    them through the group.
+ *  - Every client sends reliable messages which are echoed by its shard.
+ *  - Every client disconnects after receiving all the echoes.
+ * The shards accept, exchange and release their sessions at the same time.
+ */
+
+#define API_TEST_PROTOCOL_ID 51
+#define API_TEST_CHANNELS 4
+#define API_TEST_MAX_CLIENTS 32
+#define API_TEST_ADDRESS "127.0.0.1:8889"
+#define API_TEST_TOKEN_EXPIRE (3600 * 1000) // 1 hour
+#define API_TEST_TOKEN_TIMEOUT -1
+#define API_TEST_NCLIENTS 16
+#define API_TEST_NSHARDS 2
+#define API_TEST_MESSAGE_VALUE 21
+#define API_TEST_ECHO_VALUE 42
+#define API_TEST_RELIABLE_CHANNEL 1
+#define API_TEST_NMESSAGES 10 // Reliable messages sent by every client
+
+
+// Environment
+static pomelo_allocator_t * allocator;
+static pomelo_context_t * context;
+static pomelo_platform_t * platform; // Platform of clients
+static pomelo_threadsafe_executor_t * executor; // Executor of clients
+static pomelo_socket_group_t * group;
+static pomelo_channel_mode channel_modes[API_TEST_CHANNELS];
+
+// Shards, each one runs in its own thread
+static uv_loop_t shard_loops[API_TEST_NSHARDS];
+static uv_thread_t shard_threads[API_TEST_NSHARDS];
+static pomelo_platform_t * shard_platforms[API_TEST_NSHARDS];
+static pomelo_threadsafe_executor_t * shard_executors[API_TEST_NSHARDS];
+static pomelo_socket_t * shards[API_TEST_NSHARDS];
+
+// Keys
+static uint8_t private_key[POMELO_KEY_BYTES];
+static uint8_t connect_token[POMELO_CONNECT_TOKEN_BYTES];
+static pomelo_connect_token_t token;
+
+// Clients
+static pomelo_socket_t * clients[API_TEST_NCLIENTS];
+static size_t echo_counters[API_TEST_NCLIENTS]; // Main thread only
+
+
+// Global variables, updated from the shard threads and the main thread
+static pomelo_atomic_uint64_t server_connected_counter;
+static pomelo_atomic_uint64_t client_connected_counter;
+static pomelo_atomic_uint64_t shard_connected_counters[API_TEST_NSHARDS];
+static pomelo_atomic_uint64_t server_recv_counter;
+static pomelo_atomic_uint64_t server_disconnected_counter;
+static pomelo_atomic_uint64_t client_disconnected_counter;
+static pomelo_atomic_uint64_t broadcasted;
+static pomelo_atomic_uint64_t finished;
+static size_t recv_counter = 0; // Main thread only
+
+
+static void check_ready(void);
+static void check_finished(void);
+static void finish(void);
+
+
+/// @brief Initialize connect token & keys
+static int init_connect_token(int64_t client_id) {
+    token.protocol_id = API_TEST_PROTOCOL_ID;
+    token.create_timestamp = pomelo_platform_now(platform);
+    token.expire_timestamp = token.create_timestamp + API_TEST_TOKEN_EXPIRE;
+    pomelo_random_buffer(
+        token.connect_token_nonce,
+        sizeof(token.connect_token_nonce)
+    );
+
+    token.timeout = API_TEST_TOKEN_TIMEOUT;
+    token.naddresses = 1;
+    pomelo_address_from_string(&token.addresses[0], API_TEST_ADDRESS);
+
+    pomelo_random_buffer(
+        token.client_to_server_key,
+        sizeof(token.client_to_server_key)
+    );
+    pomelo_random_buffer(
+        token.server_to_client_key,
+        sizeof(token.server_to_client_key)
+    );
+    token.client_id = client_id;
+
+    int ret = pomelo_connect_token_encode(connect_token, &token, private_key);
+    pomelo_check(ret == 0);
+
+    return 0;
+}
+
+
+/// @brief Get the index of shard
+/// @return The index or -1 if the socket is not a shard
+static int shard_index(pomelo_socket_t * socket) {
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        if (shards[i] == socket) return i;
+    }
+    return -1;
+}
+
+
+static bool is_shard(pomelo_socket_t * socket) {
+    return shard_index(socket) >= 0;
+}
+
+
+/// @brief Get the index of client
+static int client_index(pomelo_socket_t * socket) {
+    for (int i = 0; i < API_TEST_NCLIENTS; i++) {
+        if (clients[i] == socket) return i;
+    }
+    pomelo_check(false && "Unknown client");
+    return -1;
+}
+
+
+/// @brief Send a message with the value through the reliable channel
+static void send_reliable(pomelo_session_t * session, uint8_t value) {
+    pomelo_message_t * message = pomelo_context_acquire_message(context);
+    pomelo_check(message != NULL);
+    int ret = pomelo_message_write_uint8(message, value);
+    pomelo_check(ret == 0);
+
+    pomelo_session_send(session, API_TEST_RELIABLE_CHANNEL, message, NULL);
+    pomelo_message_unref(message);
+}
+
+
+static void run_shard(void * data) {
+    uv_run((uv_loop_t *) data, UV_RUN_DEFAULT);
+}
+
+
+/// @brief Stop the shard in its loop thread
+static void stop_shard(pomelo_socket_t * shard) {
+    pomelo_track_function();
+    pomelo_socket_stop(shard);
+    pomelo_platform_shutdown(pomelo_socket_get_platform(shard), NULL);
+}
+
+
+int main(void) {
+    int ret = 0;
+
+    printf("API group test\n");
+    allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    pomelo_atomic_uint64_store(&server_connected_counter, 0);
+    pomelo_atomic_uint64_store(&client_connected_counter, 0);
+    pomelo_atomic_uint64_store(&server_recv_counter, 0);
+    pomelo_atomic_uint64_store(&server_disconnected_counter, 0);
+    pomelo_atomic_uint64_store(&client_disconnected_counter, 0);
+    pomelo_atomic_uint64_store(&broadcasted, 0);
+    pomelo_atomic_uint64_store(&finished, 0);
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        pomelo_atomic_uint64_store(&shard_connected_counters[i], 0);
+    }
+
+    for (int i = 0; i < API_TEST_CHANNELS; i++) {
+        channel_modes[i] = POMELO_CHANNEL_MODE_UNRELIABLE;
+    }
+    channel_modes[API_TEST_RELIABLE_CHANNEL] = POMELO_CHANNEL_MODE_RELIABLE;
+
+    // Create platform of clients
+    platform = pomelo_test_platform_create(allocator);
+    pomelo_check(platform != NULL);
+    pomelo_platform_startup(platform);
+
+    executor = pomelo_platform_acquire_threadsafe_executor(platform);
+    pomelo_check(executor != NULL);
+
+    // Groups require a synchronized context
+    pomelo_context_root_options_t context_options;
+    memset(&context_options, 0, sizeof(pomelo_context_root_options_t));
+    context_options.allocator = allocator;
+    context = pomelo_context_root_create(&context_options);
+    pomelo_check(context != NULL);
+
+    pomelo_socket_group_options_t group_options;
+    memset(&group_options, 0, sizeof(pomelo_socket_group_options_t));
+    group_options.allocator = allocator;
+    group_options.context = context;
+    pomelo_check(pomelo_socket_group_create(&group_options) == NULL);
+    pomelo_context_destroy(context);
+
+    context_options.synchronized = true;
+    context = pomelo_context_root_create(&context_options);
+    pomelo_check(context != NULL);
+
+    group_options.context = context;
+    group = pomelo_socket_group_create(&group_options);
+    pomelo_check(group != NULL);
+
+    pomelo_address_t address;
+    pomelo_address_from_string(&address, API_TEST_ADDRESS);
+    pomelo_random_buffer(private_key, sizeof(private_key));
+
+    // Create shards. Their loops are not running yet, so they can be set up
+    // from this thread.
+    pomelo_socket_options_t socket_options;
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        ret = uv_loop_init(&shard_loops[i]);
+        pomelo_check(ret == 0);
+
+        pomelo_platform_uv_options_t platform_options = {
+            .allocator = allocator,
+            .uv_loop = &shard_loops[i],
+            .reuse_port = true
+        };
+        shard_platforms[i] = pomelo_platform_uv_create(&platform_options);
+        pomelo_check(shard_platforms[i] != NULL);
+        pomelo_platform_startup(shard_platforms[i]);
+
+        shard_executors[i] =
+            pomelo_platform_acquire_threadsafe_executor(shard_platforms[i]);
+        pomelo_check(shard_executors[i] != NULL);
+
+        memset(&socket_options, 0, sizeof(pomelo_socket_options_t));
+        socket_options.nchannels = API_TEST_CHANNELS;
+        socket_options.channel_modes = channel_modes;
+        socket_options.platform = shard_platforms[i];
+        socket_options.context = context;
+        socket_options.group = group;
+
+        shards[i] = pomelo_socket_create(&socket_options);
+        pomelo_check(shards[i] != NULL);
+
+        ret = pomelo_socket_listen(
+            shards[i],
+            private_key,
+            API_TEST_PROTOCOL_ID,
+            API_TEST_MAX_CLIENTS,
+            &address
+        );
+        pomelo_check(ret == 0);
+    }
+    pomelo_check(pomelo_socket_group_get_nsockets(group) == API_TEST_NSHARDS);
+    pomelo_check(pomelo_socket_group_get_nsessions(group) == 0);
+
+    // Create clients
+    for (int i = 0; i < API_TEST_NCLIENTS; i++) {
+        ret = init_connect_token(i + 2000);
+        pomelo_check(ret == 0);
+
+        memset(&socket_options, 0, sizeof(pomelo_socket_options_t));
+        socket_options.nchannels = API_TEST_CHANNELS;
+        socket_options.channel_modes = channel_modes;
+        socket_options.platform = platform;
+        socket_options.context = context;
+
+        clients[i] = pomelo_socket_create(&socket_options);
+        pomelo_check(clients[i] != NULL);
+
+        ret = pomelo_socket_connect(clients[i], connect_token);
+        pomelo_check(ret == 0);
+    }
+
+    // Run the shards
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        ret = uv_thread_create(&shard_threads[i], run_shard, &shard_loops[i]);
+        pomelo_check(ret == 0);
+    }
+
+    pomelo_test_platform_run(platform);
+
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        uv_thread_join(&shard_threads[i]);
+        uv_loop_close(&shard_loops[i]);
+    }
+
+    // All sessions have been released by stopping
+    pomelo_check(pomelo_socket_group_get_nsessions(group) == 0);
+
+    // Destroy the sockets
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        pomelo_socket_destroy(shards[i]);
+    }
+    for (int i = 0; i < API_TEST_NCLIENTS; i++) {
+        pomelo_socket_destroy(clients[i]);
+    }
+    pomelo_check(pomelo_socket_group_get_nsockets(group) == 0);
+
+    // Get statistic to check resource leak
+    pomelo_statistic_t statistic;
+    pomelo_socket_group_statistic(group, &statistic);
+    pomelo_statistic_check_resource_leak(&statistic);
+
+    pomelo_socket_group_destroy(group);
+    pomelo_context_destroy(context);
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        pomelo_platform_uv_destroy(shard_platforms[i]);
+    }
+    pomelo_test_platform_destroy(platform);
+
+    // Check memleak
+    pomelo_check(alloc_bytes == pomelo_allocator_allocated_bytes(allocator));
+    return 0;
+}
+
+
+/// @brief Broadcast once all sessions have connected on both sides
+static void check_ready(void) {
+    uint64_t nservers = pomelo_atomic_uint64_load(&server_connected_counter);
+    uint64_t nclients = pomelo_atomic_uint64_load(&client_connected_counter);
+    if (nservers < API_TEST_NCLIENTS || nclients < API_TEST_NCLIENTS) {
+        return; // Not ready
+    }
+
+    if (!pomelo_atomic_uint64_compare_exchange(&broadcasted, 0, 1)) {
+        return; // Already broadcasted
+    }
+
+    pomelo_track_function();
+    size_t nsessions = pomelo_socket_group_get_nsessions(group);
+    pomelo_check(nsessions == API_TEST_NCLIENTS);
+
+    pomelo_message_t * message = pomelo_context_acquire_message(context);
+    pomelo_check(message != NULL);
+    int ret = pomelo_message_write_uint8(message, API_TEST_MESSAGE_VALUE);
+    pomelo_check(ret == 0);
+
+    ret = pomelo_socket_group_broadcast(group, 0, message, group);
+    pomelo_check(ret == API_TEST_NSHARDS);
+
+    // The message is still owned by this thread
+    pomelo_message_unref(message);
+}
+
+
+/// @brief Finish once all sessions have disconnected on both sides
+static void check_finished(void) {
+    uint64_t nservers = pomelo_atomic_uint64_load(&server_disconnected_counter);
+    uint64_t nclients = pomelo_atomic_uint64_load(&client_disconnected_counter);
+    if (nservers < API_TEST_NCLIENTS || nclients < API_TEST_NCLIENTS) {
+        return; // Not finished
+    }
+
+    if (!pomelo_atomic_uint64_compare_exchange(&finished, 0, 1)) {
+        return; // Already finished
+    }
+
+    // This might be called in a shard thread
+    pomelo_platform_task_t * task = pomelo_threadsafe_executor_submit(
+        platform,
+        executor,
+        (pomelo_platform_task_entry) finish,
+        NULL
+    );
+    pomelo_check(task != NULL);
+}
+
+
+/// @brief Stop everything. This is called in the main thread.
+static void finish(void) {
+    pomelo_track_function();
+
+    // Both shards have served sessions
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        uint64_t nconnected =
+            pomelo_atomic_uint64_load(&shard_connected_counters[i]);
+        printf("[i] Shard %d has served %llu sessions\n",
+            i, (unsigned long long) nconnected
+        );
+        pomelo_check(nconnected > 0);
+    }
+
+    pomelo_check(recv_counter == API_TEST_NCLIENTS);
+    pomelo_check(
+        pomelo_atomic_uint64_load(&server_recv_counter) ==
+        API_TEST_NCLIENTS * API_TEST_NMESSAGES
+    );
+    for (int i = 0; i < API_TEST_NCLIENTS; i++) {
+        pomelo_check(echo_counters[i] == API_TEST_NMESSAGES);
+    }
+
+    for (int i = 0; i < API_TEST_NCLIENTS; i++) {
+        pomelo_socket_stop(clients[i]);
+    }
+
+    for (int i = 0; i < API_TEST_NSHARDS; i++) {
+        pomelo_platform_task_t * task = pomelo_threadsafe_executor_submit(
+            shard_platforms[i],
+            shard_executors[i],
+            (pomelo_platform_task_entry) stop_shard,
+            shards[i]
+        );
+        pomelo_check(task != NULL);
+    }
+
+    pomelo_platform_shutdown(platform, NULL);
+}
+
+
+/* Implementation of events */
+
+void pomelo_session_on_cleanup(pomelo_session_t * session) {
+    (void) session;
+}
+
+
+void pomelo_channel_on_cleanup(pomelo_channel_t * channel) {
+    (void) channel;
+}
+
+
+void pomelo_socket_on_connected(
+    pomelo_socket_t * socket,
+    pomelo_session_t * session
+) {
+    pomelo_check(socket != NULL);
+    pomelo_check(session != NULL);
+
+    int index = shard_index(socket);
+    if (index >= 0) {
+        pomelo_atomic_uint64_fetch_add(&server_connected_counter, 1);
+        pomelo_atomic_uint64_fetch_add(&shard_connected_counters[index], 1);
+    } else {
+        pomelo_atomic_uint64_fetch_add(&client_connected_counter, 1);
+    }
+
+    check_ready();
+}
+
+
+void pomelo_socket_on_disconnected(
+    pomelo_socket_t * socket,
+    pomelo_session_t * session
+) {
+    pomelo_check(socket != NULL);
+    pomelo_check(session != NULL);
+
+    if (is_shard(socket)) {
+        pomelo_atomic_uint64_fetch_add(&server_disconnected_counter, 1);
+    } else {
+        pomelo_atomic_uint64_fetch_add(&client_disconnected_counter, 1);
+    }
+
+    check_finished();
+}
+
+
+void pomelo_socket_on_received(
+    pomelo_socket_t * socket,
+    pomelo_session_t * session,
+    pomelo_message_t * message
+) {
+    pomelo_check(socket != NULL);
+    pomelo_check(session != NULL);
+    pomelo_check(message != NULL);
+
+    uint8_t value = 0;
+    int ret = pomelo_message_read_uint8(message, &value);
+    pomelo_check(ret == 0);
+
+    if (is_shard(socket)) {
+        // Echo the message in the shard thread
+        pomelo_check(value == API_TEST_ECHO_VALUE);
+        pomelo_atomic_uint64_fetch_add(&server_recv_counter, 1);
+        send_reliable(session, API_TEST_ECHO_VALUE);
+        return;
+    }
+
+    // Clients run in the main thread
+    int index = client_index(socket);
+    if (value == API_TEST_MESSAGE_VALUE) {
+        // The broadcasted message, start exchanging
+        recv_counter++;
+        for (int i = 0; i < API_TEST_NMESSAGES; i++) {
+            send_reliable(session, API_TEST_ECHO_VALUE);
+        }
+        return;
+    }
+
+    pomelo_check(value == API_TEST_ECHO_VALUE);
+    echo_counters[index]++;
+    if (echo_counters[index] == API_TEST_NMESSAGES) {
+        pomelo_check(pomelo_session_disconnect(session) == 0);
+    }
+}
+
+
+void pomelo_socket_on_connect_result(
+    pomelo_socket_t * socket,
+    pomelo_socket_connect_result result
+) {
+    (void) socket;
+    pomelo_check(result == POMELO_SOCKET_CONNECT_SUCCESS);
+}
+
+
+void pomelo_socket_on_send_result(
+    pomelo_socket_t * socket,
+    pomelo_message_t * message,
+    void * data,
+    size_t send_count
+) {
+    (void) message;
+    if (data != group) return; // Not the broadcasted message
+
+    pomelo_check(is_shard(socket));
+    printf("[i] On shard send result send_count: %zu\n", send_count);
+}
@@ -0,0 +1,105 @@
+#include <string.h>
+#include "uv.h"
+#include "pomelo-test.h"
+#include "pomelo/random.h"
+#include "crypto/crypto.h"
+#include "crypto/checksum.h"
+
+
+/// The number of fragments of a parcel
+#define BENCH_NFRAGMENTS 16
+
+/// The content bytes of a fragment
+#define BENCH_FRAGMENT_BYTES 1200
+
+/// The number of checksummed parcels per algorithm
+#define BENCH_PARCELS 20000
+
+
+static uint8_t data[BENCH_NFRAGMENTS * BENCH_FRAGMENT_BYTES];
+
+
+/// @brief Get the name of algorithm
+static const char * bench_algorithm_name(pomelo_checksum algorithm) {
+    switch (algorithm) {
+        case POMELO_CHECKSUM_BLAKE2B:
+            return "BLAKE2b";
+
+        case POMELO_CHECKSUM_NONE:
+            return "none";
+
+        case POMELO_CHECKSUM_CRC32C:
+            return pomelo_crypto_crc32c_hardware()
+                ? "CRC32C (hardware)"
+                : "CRC32C (software)";
+
+        case POMELO_CHECKSUM_XXH64:
+            return "XXH64";
+
+        default:
+            return "unknown";
+    }
+}
+
+
+/// @brief Checksum the parcels fragment by fragment, like the sender does
+static int bench_algorithm(pomelo_checksum algorithm) {
+    uint8_t output[POMELO_CRYPTO_CHECKSUM_BYTES];
+    memset(output, 0, sizeof(output));
+    uint8_t digest = 0;
+
+    uint64_t start = uv_hrtime();
+    for (int i = 0; i < BENCH_PARCELS; i++) {
+        pomelo_crypto_checksum_state_t state;
+        int ret = pomelo_crypto_checksum_init(&state, algorithm);
+        pomelo_check(ret == 0);
+
+        for (int j = 0; j < BENCH_NFRAGMENTS; j++) {
+            ret = pomelo_crypto_checksum_update(
+                &state,
+                data + j * BENCH_FRAGMENT_BYTES,
+                BENCH_FRAGMENT_BYTES
+            );
+            pomelo_check(ret == 0);
+        }
+
+        ret = pomelo_crypto_checksum_final(&state, output);
+        pomelo_check(ret == 0);
+        digest ^= output[0];
+    }
+    uint64_t elapsed_ns = uv_hrtime() - start;
+
+    double bytes = (double) BENCH_PARCELS * sizeof(data);
+    printf(
+        "[i] %-18s %2zu bytes: %8.1f us/parcel, %7.2f GB/s (%02x)\n",
+        bench_algorithm_name(algorithm),
+        pomelo_crypto_checksum_bytes(algorithm),
+        (double) elapsed_ns / BENCH_PARCELS / 1000.0,
+        (elapsed_ns > 0) ? bytes / (double) elapsed_ns : 0.0,
+        digest
+    );
+    return 0;
+}
+
+
+static int pomelo_bench_checksum(void) {
+    pomelo_check(pomelo_crypto_init() == 0);
+    pomelo_random_buffer(data, sizeof(data));
+
+    printf(
+        "[i] %d parcels of %d x %d bytes\n",
+        BENCH_PARCELS,
+        BENCH_NFRAGMENTS,
+        BENCH_FRAGMENT_BYTES
+    );
+    for (int i = 0; i < POMELO_CHECKSUM_COUNT; i++) {
+        pomelo_check(bench_algorithm((pomelo_checksum) i) == 0);
+    }
+    return 0;
+}
+
+
+int main(void) {
+    pomelo_run_test(pomelo_bench_checksum);
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include "pomelo-test.h"
 #include "pomelo/random.h"
 #include "crypto/crypto.h"
+#include "crypto/checksum.h"
 
 
 static uint64_t sequence;
@@ -14,6 +15,150 @@ static char raw_msg[] = "Hello Crypto!";
 static char decrypted_msg[sizeof(raw_msg)];
 static char encrypted_msg[sizeof(raw_msg) + POMELO_CRYPTO_AEAD_HMAC_BYTES];
 
+static uint8_t checksum_data[4096];
+
+
+/// @brief Compute the checksum of the buffer, split into chunks of the size
+static void checksum_compute(
+    pomelo_checksum algorithm,
+    const uint8_t * buffer,
+    size_t length,
+    size_t chunk_size,
+    uint8_t * output
+) {
+    pomelo_crypto_checksum_state_t state;
+    pomelo_crypto_checksum_init(&state, algorithm);
+    for (size_t offset = 0; offset < length; offset += chunk_size) {
+        size_t remain = length - offset;
+        pomelo_crypto_checksum_update(
+            &state,
+            buffer + offset,
+            (remain < chunk_size) ? remain : chunk_size
+        );
+    }
+    pomelo_crypto_checksum_final(&state, output);
+}
+
+
+/// @brief Compute the little-endian value of checksum
+static uint64_t checksum_value(pomelo_checksum algorithm, const char * str) {
+    uint8_t output[POMELO_CRYPTO_CHECKSUM_BYTES];
+    checksum_compute(
+        algorithm,
+        (const uint8_t *) str,
+        strlen(str),
+        SIZE_MAX,
+        output
+    );
+
+    uint64_t value = 0;
+    size_t bytes = pomelo_crypto_checksum_bytes(algorithm);
+    for (size_t i = 0; i < bytes; i++) {
+        value |= ((uint64_t) output[i]) << (i * 8);
+    }
+    return value;
+}
+
+
+/// @brief Bitwise CRC32C for reference
+static uint32_t crc32c_reference(const uint8_t * buffer, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= buffer[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+        }
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+
+static int test_checksum(void) {
+    pomelo_check(pomelo_crypto_checksum_bytes(POMELO_CHECKSUM_BLAKE2B) == 32);
+    pomelo_check(pomelo_crypto_checksum_bytes(POMELO_CHECKSUM_NONE) == 0);
+    pomelo_check(pomelo_crypto_checksum_bytes(POMELO_CHECKSUM_CRC32C) == 4);
+    pomelo_check(pomelo_crypto_checksum_bytes(POMELO_CHECKSUM_XXH64) == 8);
+
+    pomelo_crypto_checksum_state_t state;
+    pomelo_check(
+        pomelo_crypto_checksum_init(&state, POMELO_CHECKSUM_COUNT) < 0
+    );
+
+    // Known vectors
+    pomelo_check(
+        checksum_value(POMELO_CHECKSUM_CRC32C, "123456789") == 0xE3069283
+    );
+    pomelo_check(
+        checksum_value(POMELO_CHECKSUM_XXH64, "") == 0xEF46DB3751D8E999ULL
+    );
+    pomelo_check(
+        checksum_value(POMELO_CHECKSUM_XXH64, "abc") == 0x44BC2CF5AD770999ULL
+    );
+    pomelo_check(
+        checksum_value(
+            POMELO_CHECKSUM_XXH64,
+            "Nobody inspects the spammish repetition"
+        ) == 0xFBCEA83C8A378BF1ULL
+    );
+
+    // CRC32C against the bitwise implementation, both of the unaligned heads
+    // and tails
+    pomelo_random_buffer(checksum_data, sizeof(checksum_data));
+    size_t lengths[] = { 1, 7, 8, 9, 63, 1000, sizeof(checksum_data) };
+    size_t nlengths = sizeof(lengths) / sizeof(lengths[0]);
+    for (size_t i = 0; i < nlengths; i++) {
+        uint8_t output[POMELO_CRYPTO_CHECKSUM_BYTES];
+        checksum_compute(
+            POMELO_CHECKSUM_CRC32C,
+            checksum_data,
+            lengths[i],
+            SIZE_MAX,
+            output
+        );
+        uint32_t crc = crc32c_reference(checksum_data, lengths[i]);
+        pomelo_check(
+            output[0] == (uint8_t) crc &&
+            output[1] == (uint8_t) (crc >> 8) &&
+            output[2] == (uint8_t) (crc >> 16) &&
+            output[3] == (uint8_t) (crc >> 24)
+        );
+    }
+
+    // Streaming in chunks must give the same checksum
+    pomelo_checksum algorithms[] = {
+        POMELO_CHECKSUM_BLAKE2B,
+        POMELO_CHECKSUM_CRC32C,
+        POMELO_CHECKSUM_XXH64
+    };
+    size_t chunk_sizes[] = { 1, 5, 31, 32, 33, 1200 };
+    size_t nchunk_sizes = sizeof(chunk_sizes) / sizeof(chunk_sizes[0]);
+    for (size_t i = 0; i < sizeof(algorithms) / sizeof(algorithms[0]); i++) {
+        uint8_t expected[POMELO_CRYPTO_CHECKSUM_BYTES];
+        checksum_compute(
+            algorithms[i],
+            checksum_data,
+            sizeof(checksum_data),
+            SIZE_MAX,
+            expected
+        );
+
+        size_t bytes = pomelo_crypto_checksum_bytes(algorithms[i]);
+        for (size_t j = 0; j < nchunk_sizes; j++) {
+            uint8_t output[POMELO_CRYPTO_CHECKSUM_BYTES];
+            checksum_compute(
+                algorithms[i],
+                checksum_data,
+                sizeof(checksum_data),
+                chunk_sizes[j],
+                output
+            );
+            pomelo_check(memcmp(expected, output, bytes) == 0);
+        }
+    }
+
+    return 0;
+}
+
 
 int main(void) {
     printf("Crypto test\n");
@@ -57,6 +202,9 @@ int main(void) {
     pomelo_check(output_length == sizeof(raw_msg));
     pomelo_check(memcmp(raw_msg, decrypted_msg, sizeof(raw_msg)) == 0);
 
+    printf("Checking checksums\n");
+    pomelo_check(test_checksum() == 0);
+
     printf("*** All crypto tests passed ***\n");
     return 0;
 }
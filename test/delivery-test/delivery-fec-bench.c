@@ -0,0 +1,421 @@
+#include <string.h>
+#include "uv.h"
+#include "pomelo-test.h"
+#include "delivery/delivery.h"
+#include "delivery/parcel.h"
+#include "platform/uv/platform-uv.h"
+#include "delivery/context.h"
+#include "delivery/fragment.h"
+#include "delivery/endpoint.h"
+#include "delivery/fec.h"
+#include "crypto/checksum.h"
+#include "pomelo/random.h"
+#include "base/constants.h"
+#include "statistic-check/statistic-check.h"
+
+
+/**
+ * This benchmark measures the completion rate of unreliable multi-fragment
+ * parcels through a transporter which drops the data packets randomly, with
+ * different numbers of FEC repair fragments. The transporter counts the
+ * delivered fragments of each parcel, so the benchmark also verifies that every
+ * parcel which has enough fragments is completed.
+ */
+
+
+#define BENCH_NPARCELS 500
+#define BENCH_NFRAGMENTS 8
+#define BENCH_FRAGMENT_CAPACITY 256
+
+/// The number of slots to count the delivered fragments of parcels
+#define BENCH_NSLOTS (BENCH_NPARCELS + 2)
+
+
+static const size_t bench_repairs[] = { 0, 2, 4 };
+static const uint32_t bench_loss_permille[] = { 10, 50, 100, 200 };
+
+#define BENCH_NREPAIRS (sizeof(bench_repairs) / sizeof(bench_repairs[0]))
+#define BENCH_NLOSSES                                                          \
+    (sizeof(bench_loss_permille) / sizeof(bench_loss_permille[0]))
+
+
+// Environment
+static uv_loop_t uv_loop;
+static pomelo_allocator_t * allocator;
+static pomelo_platform_t * platform;
+static pomelo_sequencer_t sequencer;
+
+// Endpoints
+static pomelo_delivery_endpoint_t * sender;
+static pomelo_delivery_endpoint_t * receiver;
+
+// Contexts
+static pomelo_buffer_context_t * buffer_ctx;
+static pomelo_delivery_context_t * delivery_ctx;
+static pomelo_delivery_heartbeat_t * heartbeat;
+
+// Data to send
+static uint8_t data[BENCH_NFRAGMENTS * BENCH_FRAGMENT_CAPACITY];
+static size_t data_length = 0;
+
+// Temp variables
+static uint32_t loss_permille = 0;
+static uint32_t random_state = 0;
+static size_t sent_parcels = 0;
+static size_t received_parcels = 0;
+static size_t ready_count = 0;
+static size_t nfragments = 0;
+static bool finished = false;
+
+/// The delivered fragments & repair fragments of each parcel
+static size_t delivered_fragments[BENCH_NSLOTS];
+static size_t delivered_repairs[BENCH_NSLOTS];
+
+/// The timer to stop the endpoints out of the current callbacks
+static pomelo_platform_timer_handle_t stop_timer;
+
+
+/// @brief Deterministic pseudo random generator of the lossy transporter
+static uint32_t bench_random(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+
+/// @brief Stop the endpoints
+static void stop_endpoints(void * data) {
+    (void) data;
+    pomelo_delivery_endpoint_stop(sender);
+    pomelo_delivery_endpoint_stop(receiver);
+}
+
+
+/// @brief Get the number of parcels which can be completed by the receiver
+static size_t bench_completable_parcels(void) {
+    size_t count = 0;
+    for (size_t i = 0; i < BENCH_NSLOTS; i++) {
+        // Repair fragments never open a receiver. They are useful only after
+        // a data fragment of their parcel has been received.
+        size_t nrecv = delivered_fragments[i];
+        if (nrecv == 0) continue;
+        if (nrecv + delivered_repairs[i] >= nfragments) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+/// @brief Check if this round should finish
+static void check_finish(void) {
+    if (finished) return;
+    if (sent_parcels < BENCH_NPARCELS) return;
+
+    // The checksums are verified by the workers, wait for all of them
+    if (received_parcels < bench_completable_parcels()) return;
+    finished = true;
+
+    int ret = pomelo_platform_timer_start(
+        platform,
+        stop_endpoints,
+        0, // Immediately
+        0, // No repeat
+        NULL,
+        &stop_timer
+    );
+    pomelo_check(ret == 0);
+}
+
+
+void pomelo_delivery_bus_on_received(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_parcel_t * parcel,
+    pomelo_delivery_mode mode
+) {
+    (void) bus;
+    pomelo_check(mode == POMELO_DELIVERY_MODE_UNRELIABLE);
+
+    pomelo_delivery_reader_t reader;
+    pomelo_delivery_reader_init(&reader, parcel);
+    pomelo_check(pomelo_delivery_reader_remain_bytes(&reader) == data_length);
+
+    uint8_t byte;
+    size_t i = 0;
+    while (pomelo_delivery_reader_read(&reader, &byte, 1) == 0) {
+        pomelo_check(byte == data[i]);
+        i++;
+    }
+
+    received_parcels++;
+    check_finish();
+}
+
+
+void pomelo_delivery_sender_on_result(
+    pomelo_delivery_sender_t * delivery_sender,
+    pomelo_delivery_parcel_t * parcel,
+    size_t transmission_count
+) {
+    (void) delivery_sender;
+    pomelo_check(transmission_count == 1);
+    pomelo_delivery_parcel_unref(parcel);
+
+    sent_parcels++;
+    check_finish();
+}
+
+
+int pomelo_delivery_endpoint_send(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+) {
+    // Combine the views into a single view
+    pomelo_buffer_t * buffer = pomelo_buffer_context_acquire(buffer_ctx);
+    if (!buffer) return -1;
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = 0;
+
+    for (size_t i = 0; i < nviews; i++) {
+        pomelo_buffer_view_t * current = &views[i];
+        memcpy(
+            buffer->data + view.length,
+            current->buffer->data + current->offset,
+            current->length
+        );
+        view.length += current->length;
+    }
+
+    // Only the data packets of the sender are dropped
+    pomelo_buffer_view_t meta_view = view;
+    pomelo_delivery_fragment_meta_t meta;
+    int ret = pomelo_delivery_fragment_meta_decode(&meta, &meta_view);
+    pomelo_check(ret == 0);
+
+    if (endpoint == sender && meta.bus_id != 0) {
+        if (bench_random() % 1000 < loss_permille) {
+            pomelo_buffer_unref(buffer);
+            return 0; // Drop the packet
+        }
+
+        pomelo_check(meta.sequence < BENCH_NSLOTS);
+        pomelo_check(meta.last_index + 1 == nfragments);
+        if (meta.fragment_index > meta.last_index) {
+            // Repairs which arrive before any data fragment are useless
+            if (delivered_fragments[meta.sequence] > 0) {
+                delivered_repairs[meta.sequence]++;
+            }
+        } else {
+            delivered_fragments[meta.sequence]++;
+        }
+    }
+
+    pomelo_delivery_endpoint_t * target =
+        (endpoint == sender) ? receiver : sender;
+    pomelo_delivery_endpoint_recv(target, &view);
+    pomelo_buffer_unref(buffer);
+    return 0;
+}
+
+
+/// @brief Send an unreliable parcel
+static void send_parcel(void) {
+    pomelo_delivery_bus_t * bus = pomelo_delivery_endpoint_get_bus(sender, 1);
+    pomelo_check(bus != NULL);
+
+    pomelo_delivery_parcel_t * parcel =
+        pomelo_delivery_context_acquire_parcel(delivery_ctx);
+    pomelo_check(parcel != NULL);
+
+    pomelo_delivery_writer_t writer;
+    pomelo_delivery_writer_init(&writer, parcel);
+    pomelo_check(
+        pomelo_delivery_writer_write(&writer, data, data_length) == 0
+    );
+
+    pomelo_delivery_sender_options_t options = {
+        .context = delivery_ctx,
+        .parcel = parcel,
+        .platform = platform
+    };
+    pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
+    pomelo_check(sender != NULL);
+
+    int ret = pomelo_delivery_sender_add_transmission(
+        sender,
+        bus,
+        POMELO_DELIVERY_MODE_UNRELIABLE
+    );
+    pomelo_check(ret == 0);
+
+    pomelo_delivery_sender_submit(sender);
+}
+
+
+void pomelo_delivery_endpoint_on_ready(
+    pomelo_delivery_endpoint_t * endpoint
+) {
+    (void) endpoint;
+    ready_count++;
+    if (ready_count < 2) return;
+
+    for (size_t i = 0; i < BENCH_NPARCELS; i++) {
+        send_parcel();
+    }
+}
+
+
+/// @brief Run a round of benchmark
+/// @return The number of received parcels
+static size_t bench_run(size_t repairs, uint32_t loss) {
+    loss_permille = loss;
+    random_state = 0x9E3779B9U;
+    sent_parcels = 0;
+    received_parcels = 0;
+    ready_count = 0;
+    finished = false;
+    memset(delivered_fragments, 0, sizeof(delivered_fragments));
+    memset(delivered_repairs, 0, sizeof(delivered_repairs));
+
+    uv_loop_init(&uv_loop);
+
+    // Create data context
+    pomelo_buffer_context_root_options_t buffer_ctx_options = {
+        .allocator = allocator,
+        .buffer_capacity = POMELO_BUFFER_CAPACITY
+    };
+    buffer_ctx = pomelo_buffer_context_root_create(&buffer_ctx_options);
+    pomelo_check(buffer_ctx != NULL);
+
+    // Create the platform
+    pomelo_platform_uv_options_t platform_options = {
+        .allocator = allocator,
+        .uv_loop = &uv_loop
+    };
+    platform = pomelo_platform_uv_create(&platform_options);
+    pomelo_check(platform != NULL);
+    pomelo_platform_startup(platform);
+
+    // Create transport context
+    pomelo_delivery_context_root_options_t context_options = {
+        .allocator = allocator,
+        .buffer_context = buffer_ctx,
+        .fragment_capacity = BENCH_FRAGMENT_CAPACITY,
+        .fec_repairs = repairs
+    };
+    delivery_ctx = pomelo_delivery_context_root_create(&context_options);
+    pomelo_check(delivery_ctx != NULL);
+
+    // The parcel and its embedded checksum are split into exactly
+    // BENCH_NFRAGMENTS fragments
+    nfragments = BENCH_NFRAGMENTS;
+    data_length = delivery_ctx->fragment_content_capacity * nfragments -
+        POMELO_CRYPTO_CHECKSUM_BYTES;
+    pomelo_check(data_length <= sizeof(data));
+
+    // Create heartbeat
+    pomelo_delivery_heartbeat_options_t heartbeat_options = {
+        .context = delivery_ctx,
+        .platform = platform
+    };
+    heartbeat = pomelo_delivery_heartbeat_create(&heartbeat_options);
+    pomelo_check(heartbeat != NULL);
+
+    pomelo_sequencer_init(&sequencer);
+
+    pomelo_delivery_endpoint_options_t options = {
+        .context = delivery_ctx,
+        .platform = platform,
+        .heartbeat = heartbeat,
+        .sequencer = &sequencer,
+        .nbuses = 2
+    };
+    sender = pomelo_delivery_endpoint_create(&options);
+    pomelo_check(sender != NULL);
+
+    options.time_sync = true;
+    receiver = pomelo_delivery_endpoint_create(&options);
+    pomelo_check(receiver != NULL);
+
+    pomelo_delivery_endpoint_start(sender);
+    pomelo_delivery_endpoint_start(receiver);
+
+    uv_run(&uv_loop, UV_RUN_DEFAULT);
+    uv_loop_close(&uv_loop);
+
+    pomelo_check(sent_parcels == BENCH_NPARCELS);
+    pomelo_check(received_parcels == bench_completable_parcels());
+
+    pomelo_delivery_endpoint_destroy(sender);
+    pomelo_delivery_endpoint_destroy(receiver);
+    pomelo_delivery_heartbeat_destroy(heartbeat);
+
+    // Check resource leak
+    pomelo_statistic_delivery_t statistic_delivery;
+    pomelo_delivery_context_statistic(delivery_ctx, &statistic_delivery);
+    pomelo_statistic_delivery_check_resource_leak(&statistic_delivery);
+    if (repairs == 0) {
+        pomelo_check(statistic_delivery.recovered_fragments == 0);
+    }
+
+    pomelo_statistic_buffer_t statistic_buffer;
+    pomelo_buffer_context_statistic(buffer_ctx, &statistic_buffer);
+    pomelo_statistic_buffer_check_resource_leak(&statistic_buffer);
+
+    pomelo_delivery_context_destroy(delivery_ctx);
+    pomelo_platform_uv_destroy(platform);
+    pomelo_buffer_context_destroy(buffer_ctx);
+
+    printf(
+        "[i] %zu repairs, %4.1f%% loss: %5.1f%% completed, "
+        "%llu fragments recovered\n",
+        repairs,
+        loss / 10.0,
+        received_parcels * 100.0 / BENCH_NPARCELS,
+        (unsigned long long) statistic_delivery.recovered_fragments
+    );
+
+    return received_parcels;
+}
+
+
+int main(void) {
+    printf("Delivery FEC benchmark\n");
+
+    pomelo_random_buffer(data, sizeof(data));
+
+    allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    // The number of repair fragments must not exceed the maximum value
+    pomelo_delivery_context_root_options_t context_options = {
+        .allocator = allocator,
+        .fragment_capacity = BENCH_FRAGMENT_CAPACITY,
+        .fec_repairs = POMELO_DELIVERY_FEC_MAX_REPAIRS + 1
+    };
+    pomelo_check(pomelo_delivery_context_root_create(&context_options) == NULL);
+
+    size_t received[BENCH_NLOSSES][BENCH_NREPAIRS];
+    for (size_t i = 0; i < BENCH_NLOSSES; i++) {
+        for (size_t j = 0; j < BENCH_NREPAIRS; j++) {
+            received[i][j] =
+                bench_run(bench_repairs[j], bench_loss_permille[i]);
+        }
+    }
+
+    for (size_t i = 0; i < BENCH_NLOSSES; i++) {
+        // More repair fragments, more completed parcels
+        for (size_t j = 1; j < BENCH_NREPAIRS; j++) {
+            pomelo_check(received[i][j] >= received[i][j - 1]);
+        }
+        pomelo_check(received[i][BENCH_NREPAIRS - 1] > received[i][0]);
+    }
+
+    pomelo_check(alloc_bytes == pomelo_allocator_allocated_bytes(allocator));
+    return 0;
+}
@@ -0,0 +1,331 @@
+#include <string.h>
+#include "uv.h"
+#include "pomelo-test.h"
+#include "delivery/delivery.h"
+#include "delivery/parcel.h"
+#include "delivery/bus.h"
+#include "delivery/endpoint.h"
+#include "delivery/heartbeat.h"
+#include "platform/uv/platform-uv.h"
+#include "delivery/context.h"
+#include "base/constants.h"
+#include "utils/macro.h"
+#include "statistic-check/statistic-check.h"
+
+
+/**
+ * This test verifies the pings of the heartbeat which is run by its owner.
+ * While the sender has steady reliable traffic, the ACKs sample its RTT, so it
+ * sends no pings to keep the connection alive. Once the traffic stops, the
+ * sender pings again.
+ */
+
+
+#define POMELO_TEST_HEARTBEAT_NBUSES 2
+#define POMELO_TEST_HEARTBEAT_DATA_LENGTH 100
+
+/// The interval of sending parcels in milliseconds
+#define POMELO_TEST_HEARTBEAT_TICK_MS 20
+
+/// The number of traffic ticks per heartbeat
+#define POMELO_TEST_HEARTBEAT_TICKS_PER_BEAT                                   \
+    (POMELO_FREQ_TO_MS(POMELO_DELIVERY_HEARTBEAT_FREQUENCY) /                  \
+        POMELO_TEST_HEARTBEAT_TICK_MS)
+
+/// The number of ticks with steady traffic (2 seconds)
+#define POMELO_TEST_HEARTBEAT_BUSY_TICKS 100
+
+/// The number of idle ticks after the traffic (1 second)
+#define POMELO_TEST_HEARTBEAT_IDLE_TICKS 50
+
+
+// Environment
+static uv_loop_t uv_loop;
+static pomelo_allocator_t * allocator;
+static pomelo_platform_t * platform;
+static pomelo_sequencer_t sequencer;
+static pomelo_platform_timer_handle_t tick_timer;
+
+// Endpoints
+static pomelo_delivery_endpoint_t * sender;
+static pomelo_delivery_endpoint_t * receiver;
+
+// Contexts
+static pomelo_buffer_context_t * buffer_ctx;
+static pomelo_delivery_context_t * delivery_ctx;
+static pomelo_delivery_heartbeat_t * heartbeat;
+
+// Data to send
+static uint8_t data[POMELO_TEST_HEARTBEAT_DATA_LENGTH];
+
+// Temp variables
+static size_t ready_count = 0;
+static size_t beats = 0; // All ticks
+static size_t ticks = 0; // Ticks since both endpoints are ready
+static size_t sent_parcels = 0;
+static size_t received_parcels = 0;
+static uint64_t busy_ping_sequence = 0;
+static uint64_t idle_ping_sequence = 0;
+
+
+void pomelo_delivery_bus_on_received(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_parcel_t * parcel,
+    pomelo_delivery_mode mode
+) {
+    (void) bus;
+    (void) parcel;
+    pomelo_check(mode == POMELO_DELIVERY_MODE_RELIABLE);
+    received_parcels++;
+}
+
+
+void pomelo_delivery_sender_on_result(
+    pomelo_delivery_sender_t * delivery_sender,
+    pomelo_delivery_parcel_t * parcel,
+    size_t transmission_count
+) {
+    (void) delivery_sender;
+    pomelo_check(transmission_count == 1);
+    pomelo_delivery_parcel_unref(parcel);
+}
+
+
+int pomelo_delivery_endpoint_send(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+) {
+    // Combine the views into a single view
+    pomelo_buffer_t * buffer = pomelo_buffer_context_acquire(buffer_ctx);
+    if (!buffer) return -1;
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = 0;
+
+    for (size_t i = 0; i < nviews; i++) {
+        pomelo_buffer_view_t * current = &views[i];
+        memcpy(
+            buffer->data + view.length,
+            current->buffer->data + current->offset,
+            current->length
+        );
+        view.length += current->length;
+    }
+
+    int ret = pomelo_delivery_endpoint_recv(
+        (endpoint == sender) ? receiver : sender,
+        &view
+    );
+    pomelo_check(ret == 0);
+    pomelo_buffer_unref(buffer);
+    return 0;
+}
+
+
+void pomelo_delivery_endpoint_on_ready(
+    pomelo_delivery_endpoint_t * endpoint
+) {
+    (void) endpoint;
+    ready_count++;
+    if (ready_count == 2) {
+        printf("[i] Endpoints are ready\n");
+        busy_ping_sequence = sender->rtt.entry_sequence;
+    }
+}
+
+
+/// @brief Send a reliable parcel from sender to receiver
+static void send_parcel(void) {
+    pomelo_delivery_bus_t * bus = pomelo_delivery_endpoint_get_bus(sender, 1);
+    pomelo_check(bus != NULL);
+
+    pomelo_delivery_parcel_t * parcel =
+        pomelo_delivery_context_acquire_parcel(delivery_ctx);
+    pomelo_check(parcel != NULL);
+
+    pomelo_delivery_writer_t writer;
+    pomelo_delivery_writer_init(&writer, parcel);
+    pomelo_delivery_writer_write(&writer, data, sizeof(data));
+
+    pomelo_delivery_sender_options_t options = {
+        .context = delivery_ctx,
+        .parcel = parcel,
+        .platform = platform
+    };
+    pomelo_delivery_sender_t * delivery_sender =
+        pomelo_delivery_sender_create(&options);
+    pomelo_check(delivery_sender != NULL);
+
+    int ret = pomelo_delivery_sender_add_transmission(
+        delivery_sender,
+        bus,
+        POMELO_DELIVERY_MODE_RELIABLE
+    );
+    pomelo_check(ret == 0);
+
+    pomelo_delivery_sender_submit(delivery_sender);
+    sent_parcels++;
+}
+
+
+/// @brief Finish the test
+static void finish(void) {
+    uint64_t busy_pings = idle_ping_sequence - busy_ping_sequence;
+    uint64_t idle_pings = sender->rtt.entry_sequence - idle_ping_sequence;
+    printf(
+        "[i] Sent %zu parcels, received %zu parcels\n",
+        sent_parcels,
+        received_parcels
+    );
+    printf("[i] Pings: busy = %llu, idle = %llu\n",
+        (unsigned long long) busy_pings,
+        (unsigned long long) idle_pings
+    );
+
+    pomelo_check(received_parcels == sent_parcels);
+    pomelo_check(busy_pings == 0);
+    pomelo_check(idle_pings > 0);
+
+    pomelo_platform_timer_stop(platform, &tick_timer);
+    pomelo_delivery_endpoint_stop(sender);
+    pomelo_delivery_endpoint_stop(receiver);
+}
+
+
+/// @brief The tick of traffic. The heartbeat is run at its own frequency as
+/// the keep alive of protocol sockets does.
+static void on_tick(void * arg) {
+    (void) arg;
+    if (ready_count == 2) {
+        if (ticks < POMELO_TEST_HEARTBEAT_BUSY_TICKS) {
+            send_parcel();
+        } else if (ticks == POMELO_TEST_HEARTBEAT_BUSY_TICKS) {
+            idle_ping_sequence = sender->rtt.entry_sequence;
+        } else if (ticks ==
+            POMELO_TEST_HEARTBEAT_BUSY_TICKS + POMELO_TEST_HEARTBEAT_IDLE_TICKS
+        ) {
+            finish();
+            return;
+        }
+        ticks++;
+    }
+
+    beats++;
+    if (beats % POMELO_TEST_HEARTBEAT_TICKS_PER_BEAT == 0) {
+        pomelo_delivery_heartbeat_run(heartbeat);
+    }
+}
+
+
+int main(void) {
+    printf("Delivery heartbeat test\n");
+    memset(data, 0x5a, sizeof(data));
+
+    allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    uv_loop_init(&uv_loop);
+
+    // Create data context
+    pomelo_buffer_context_root_options_t buffer_ctx_options = {
+        .allocator = allocator,
+        .buffer_capacity = POMELO_BUFFER_CAPACITY
+    };
+    buffer_ctx = pomelo_buffer_context_root_create(&buffer_ctx_options);
+    pomelo_check(buffer_ctx != NULL);
+
+    // Create the platform
+    pomelo_platform_uv_options_t platform_options = {
+        .allocator = allocator,
+        .uv_loop = &uv_loop
+    };
+    platform = pomelo_platform_uv_create(&platform_options);
+    pomelo_check(platform != NULL);
+    pomelo_platform_startup(platform);
+
+    // Create transport context
+    pomelo_delivery_context_root_options_t context_options = {
+        .allocator = allocator,
+        .buffer_context = buffer_ctx,
+        .fragment_capacity = POMELO_PACKET_BODY_CAPACITY
+    };
+    delivery_ctx = pomelo_delivery_context_root_create(&context_options);
+    pomelo_check(delivery_ctx != NULL);
+
+    // Create the heartbeat which is run by the tick
+    pomelo_delivery_heartbeat_options_t heartbeat_options = {
+        .context = delivery_ctx,
+        .platform = platform,
+        .manual = true
+    };
+    heartbeat = pomelo_delivery_heartbeat_create(&heartbeat_options);
+    pomelo_check(heartbeat != NULL);
+
+    // Initialize sequencer
+    pomelo_sequencer_init(&sequencer);
+
+    pomelo_delivery_endpoint_options_t options = {
+        .context = delivery_ctx,
+        .platform = platform,
+        .heartbeat = heartbeat,
+        .sequencer = &sequencer,
+        .nbuses = POMELO_TEST_HEARTBEAT_NBUSES
+    };
+    sender = pomelo_delivery_endpoint_create(&options);
+    pomelo_check(sender != NULL);
+
+    receiver = pomelo_delivery_endpoint_create(&options);
+    pomelo_check(receiver != NULL);
+
+    // Start the endpoints and the tick
+    pomelo_delivery_endpoint_start(sender);
+    pomelo_delivery_endpoint_start(receiver);
+
+    int ret = pomelo_platform_timer_start(
+        platform,
+        on_tick,
+        POMELO_TEST_HEARTBEAT_TICK_MS,
+        POMELO_TEST_HEARTBEAT_TICK_MS,
+        NULL,
+        &tick_timer
+    );
+    pomelo_check(ret == 0);
+
+    /* Start testing */
+
+    uv_run(&uv_loop, UV_RUN_DEFAULT);
+    uv_loop_close(&uv_loop);
+
+    /* End testing */
+
+    pomelo_check(ticks ==
+        POMELO_TEST_HEARTBEAT_BUSY_TICKS + POMELO_TEST_HEARTBEAT_IDLE_TICKS
+    );
+
+    // Destroy endpoints
+    pomelo_delivery_endpoint_destroy(sender);
+    pomelo_delivery_endpoint_destroy(receiver);
+
+    // Destroy the heartbeat
+    pomelo_delivery_heartbeat_destroy(heartbeat);
+
+    // Check resource leak
+    pomelo_statistic_delivery_t statistic_delivery;
+    pomelo_delivery_context_statistic(delivery_ctx, &statistic_delivery);
+    pomelo_statistic_delivery_check_resource_leak(&statistic_delivery);
+
+    pomelo_statistic_buffer_t statistic_buffer;
+    pomelo_buffer_context_statistic(buffer_ctx, &statistic_buffer);
+    pomelo_statistic_buffer_check_resource_leak(&statistic_buffer);
+
+    // Destroy platform and contexts
+    pomelo_delivery_context_destroy(delivery_ctx);
+    pomelo_platform_uv_destroy(platform);
+    pomelo_buffer_context_destroy(buffer_ctx);
+
+    pomelo_check(alloc_bytes == pomelo_allocator_allocated_bytes(allocator));
+    return 0;
+}
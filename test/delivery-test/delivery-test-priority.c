@@ -0,0 +1,256 @@
+#include <string.h>
+#include "uv.h"
+#include "pomelo-test.h"
+#include "delivery/delivery.h"
+#include "delivery/parcel.h"
+#include "platform/uv/platform-uv.h"
+#include "delivery/context.h"
+#include "delivery/endpoint.h"
+#include "delivery/bus.h"
+#include "base/constants.h"
+#include "statistic-check/statistic-check.h"
+
+
+/**
+ * This test verifies the scheduling of paced payloads between the buses of an
+ * endpoint. The payloads are queued while the pacer has no tokens, then they
+ * are released one by one. The system bus and the buses of higher priorities
+ * are served first, and the buses of the same priority share the pacer in
+ * proportion to their weights.
+ */
+
+
+#define POMELO_TEST_PRIORITY_NBUSES 3
+
+/// The marker of the system bus payloads
+#define POMELO_TEST_PRIORITY_SYSTEM 0
+
+
+static uint8_t bus_priorities[POMELO_TEST_PRIORITY_NBUSES] = { 0, 0, 1 };
+static uint32_t bus_weights[POMELO_TEST_PRIORITY_NBUSES] = { 1, 3, 1 };
+
+/// The number of queued payloads of the system bus and the user buses
+static size_t bus_payloads[POMELO_TEST_PRIORITY_NBUSES + 1] = { 1, 4, 6, 2 };
+
+/// The expected order of sent payloads by their markers (bus IDs)
+static const uint8_t expected_order[] = {
+    POMELO_TEST_PRIORITY_SYSTEM, 3, 3, 1, 2, 2, 2, 1, 2, 2, 2, 1, 1
+};
+
+#define POMELO_TEST_PRIORITY_NPAYLOADS                                         \
+    (sizeof(expected_order) / sizeof(expected_order[0]))
+
+
+// Environment
+static uv_loop_t uv_loop;
+static pomelo_allocator_t * allocator;
+static pomelo_platform_t * platform;
+static pomelo_sequencer_t sequencer;
+static pomelo_buffer_context_t * buffer_ctx;
+static pomelo_delivery_context_t * delivery_ctx;
+static pomelo_delivery_heartbeat_t * heartbeat;
+static pomelo_delivery_endpoint_t * endpoint;
+
+// The markers of sent payloads
+static uint8_t sent_order[POMELO_TEST_PRIORITY_NPAYLOADS];
+static size_t sent_count = 0;
+
+
+void pomelo_delivery_bus_on_received(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_parcel_t * parcel,
+    pomelo_delivery_mode mode
+) {
+    (void) bus;
+    (void) parcel;
+    (void) mode;
+    pomelo_check(false); // Nothing is received
+}
+
+
+void pomelo_delivery_sender_on_result(
+    pomelo_delivery_sender_t * delivery_sender,
+    pomelo_delivery_parcel_t * parcel,
+    size_t transmission_count
+) {
+    (void) delivery_sender;
+    (void) parcel;
+    (void) transmission_count;
+    pomelo_check(false); // Nothing is sent by senders
+}
+
+
+int pomelo_delivery_endpoint_send(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+) {
+    (void) endpoint;
+    pomelo_check(nviews == 1);
+    pomelo_check(views[0].length == endpoint->congestion.mss);
+    pomelo_check(sent_count < POMELO_TEST_PRIORITY_NPAYLOADS);
+
+    sent_order[sent_count++] = views[0].buffer->data[views[0].offset];
+    return 0;
+}
+
+
+void pomelo_delivery_endpoint_on_ready(
+    pomelo_delivery_endpoint_t * endpoint
+) {
+    (void) endpoint;
+}
+
+
+/// @brief Transmit a full-sized payload marked with the bus ID
+static void transmit_payload(pomelo_delivery_bus_t * bus) {
+    pomelo_buffer_t * buffer = pomelo_buffer_context_acquire(buffer_ctx);
+    pomelo_check(buffer != NULL);
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = endpoint->congestion.mss;
+    memset(buffer->data, 0, view.length);
+    buffer->data[0] = (uint8_t) bus->id;
+
+    int ret = pomelo_delivery_endpoint_transmit(endpoint, bus, &view, 1);
+    pomelo_check(ret == 0 || ret == 1); // Sent or queued for the pacer
+    pomelo_buffer_unref(buffer);
+}
+
+
+/// @brief Let the pacer send exactly one payload
+static void release_payload(void) {
+    endpoint->pacer_tokens = endpoint->congestion.mss;
+    endpoint->pacer_time = pomelo_platform_hrtime(platform);
+    pomelo_delivery_endpoint_flush_paced(endpoint);
+}
+
+
+static int pomelo_test_priority(void) {
+    // The pacer has no tokens, so that all the payloads are queued
+    endpoint->pacer_tokens = 0;
+    endpoint->pacer_time = pomelo_platform_hrtime(platform);
+
+    for (size_t i = 0; i < POMELO_TEST_PRIORITY_NBUSES; i++) {
+        pomelo_delivery_bus_t * bus = pomelo_delivery_endpoint_get_bus(
+            endpoint,
+            i
+        );
+        for (size_t j = 0; j < bus_payloads[i + 1]; j++) {
+            transmit_payload(bus);
+        }
+    }
+
+    // The system bus is queued last, but it is sent first
+    for (size_t j = 0; j < bus_payloads[0]; j++) {
+        transmit_payload(endpoint->system_bus);
+    }
+
+    pomelo_check(sent_count == 0);
+    pomelo_check(endpoint->pacer_count == POMELO_TEST_PRIORITY_NPAYLOADS);
+
+    for (size_t i = 0; i < POMELO_TEST_PRIORITY_NPAYLOADS; i++) {
+        release_payload();
+        pomelo_check(sent_count == i + 1);
+        printf("[i] Sent payload of bus %d\n", sent_order[i]);
+        pomelo_check(sent_order[i] == expected_order[i]);
+    }
+
+    // Nothing is left
+    pomelo_check(endpoint->pacer_count == 0);
+    pomelo_check(pomelo_list_is_empty(endpoint->pacer_buses));
+
+    // The pending payloads are dropped with the endpoint
+    transmit_payload(pomelo_delivery_endpoint_get_bus(endpoint, 0));
+    transmit_payload(pomelo_delivery_endpoint_get_bus(endpoint, 2));
+    pomelo_check(endpoint->pacer_count == 2);
+    return 0;
+}
+
+
+int main(void) {
+    printf("Delivery priority test\n");
+
+    allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    uv_loop_init(&uv_loop);
+
+    // Create data context
+    pomelo_buffer_context_root_options_t buffer_ctx_options = {
+        .allocator = allocator,
+        .buffer_capacity = POMELO_BUFFER_CAPACITY
+    };
+    buffer_ctx = pomelo_buffer_context_root_create(&buffer_ctx_options);
+    pomelo_check(buffer_ctx != NULL);
+
+    // Create the platform
+    pomelo_platform_uv_options_t platform_options = {
+        .allocator = allocator,
+        .uv_loop = &uv_loop
+    };
+    platform = pomelo_platform_uv_create(&platform_options);
+    pomelo_check(platform != NULL);
+    pomelo_platform_startup(platform);
+
+    // Create transport context
+    pomelo_delivery_context_root_options_t context_options = {
+        .allocator = allocator,
+        .buffer_context = buffer_ctx,
+        .fragment_capacity = POMELO_PACKET_BODY_CAPACITY
+    };
+    delivery_ctx = pomelo_delivery_context_root_create(&context_options);
+    pomelo_check(delivery_ctx != NULL);
+
+    // Create heartbeat
+    pomelo_delivery_heartbeat_options_t heartbeat_options = {
+        .context = delivery_ctx,
+        .platform = platform
+    };
+    heartbeat = pomelo_delivery_heartbeat_create(&heartbeat_options);
+    pomelo_check(heartbeat != NULL);
+
+    // Initialize sequencer
+    pomelo_sequencer_init(&sequencer);
+
+    pomelo_delivery_endpoint_options_t options = {
+        .context = delivery_ctx,
+        .platform = platform,
+        .heartbeat = heartbeat,
+        .sequencer = &sequencer,
+        .nbuses = POMELO_TEST_PRIORITY_NBUSES,
+        .congestion_control = POMELO_CONGESTION_CONTROL_CUBIC,
+        .bus_priorities = bus_priorities,
+        .bus_weights = bus_weights
+    };
+    endpoint = pomelo_delivery_endpoint_create(&options);
+    pomelo_check(endpoint != NULL);
+
+    pomelo_run_test(pomelo_test_priority);
+
+    // Destroy the endpoint and run the loop until all handles are closed
+    pomelo_delivery_endpoint_destroy(endpoint);
+    pomelo_delivery_heartbeat_destroy(heartbeat);
+    pomelo_platform_shutdown(platform, NULL);
+    uv_run(&uv_loop, UV_RUN_DEFAULT);
+    uv_loop_close(&uv_loop);
+
+    // Check resource leak
+    pomelo_statistic_delivery_t statistic_delivery;
+    pomelo_delivery_context_statistic(delivery_ctx, &statistic_delivery);
+    pomelo_statistic_delivery_check_resource_leak(&statistic_delivery);
+
+    pomelo_statistic_buffer_t statistic_buffer;
+    pomelo_buffer_context_statistic(buffer_ctx, &statistic_buffer);
+    pomelo_statistic_buffer_check_resource_leak(&statistic_buffer);
+
+    // Destroy platform and contexts
+    pomelo_delivery_context_destroy(delivery_ctx);
+    pomelo_platform_uv_destroy(platform);
+    pomelo_buffer_context_destroy(buffer_ctx);
+
+    pomelo_check(alloc_bytes == pomelo_allocator_allocated_bytes(allocator));
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include "pomelo-test.h"
 #include "delivery/delivery.h"
 #include "delivery/parcel.h"
+#include "delivery/bus.h"
 #include "platform/uv/platform-uv.h"
 #include "delivery/context.h"
 #include "pomelo/random.h"
@@ -12,10 +13,20 @@
 /**
  * This test is used to verify the basic functionality of the delivery system.
  * It sends a parcel from one endpoint to another and verifies that the parcel
- * is received correctly.
+ * is received correctly. With POMELO_TEST_DELIVERY_CHECKSUM, the parcels are
+ * checksummed by another algorithm. With POMELO_TEST_DELIVERY_CONTIGUOUS, the
+ * received parcels are reassembled into contiguous bodies.
  */
 
 
+#ifndef POMELO_TEST_DELIVERY_CHECKSUM
+#define POMELO_TEST_DELIVERY_CHECKSUM POMELO_CHECKSUM_BLAKE2B
+#endif
+
+#ifndef POMELO_TEST_DELIVERY_CONTIGUOUS
+#define POMELO_TEST_DELIVERY_CONTIGUOUS 0
+#endif
+
 #define POMELO_TEST_DELIVERY_BUFFER_LENGTH 3200
 #define POMELO_TEST_DELIVERY_NBUSES 3
 
@@ -57,6 +68,45 @@ static pomelo_delivery_mode modes[] = {
 };
 
 
+/// @brief Check that the buses only create the structures they use
+static void check_bus_state(void) {
+    // The last bus is never used
+    for (int i = 0; i < 2; i++) {
+        pomelo_delivery_endpoint_t * endpoint = i ? receiver : sender;
+        pomelo_delivery_bus_t * bus = pomelo_delivery_endpoint_get_bus(
+            endpoint,
+            POMELO_TEST_DELIVERY_NBUSES - 1
+        );
+        pomelo_check(bus != NULL);
+        pomelo_check(bus->pending_dispatchers == NULL);
+        pomelo_check(bus->receivers_map == NULL);
+        pomelo_check(bus->reliable_dispatchers == NULL);
+        pomelo_check(bus->reliable_slots == NULL);
+        pomelo_check(bus->state_bytes == 0);
+    }
+
+    // Parcels only flow from sender to receiver
+    pomelo_delivery_bus_t * bus = pomelo_delivery_endpoint_get_bus(sender, 1);
+    pomelo_check(bus->reliable_dispatchers != NULL);
+    pomelo_check(bus->reliable_slots == NULL);
+
+    bus = pomelo_delivery_endpoint_get_bus(receiver, 1);
+    pomelo_check(bus->reliable_dispatchers == NULL);
+    pomelo_check(bus->reliable_slots != NULL);
+    pomelo_check(bus->receivers_map != NULL);
+
+    pomelo_statistic_delivery_t statistic;
+    pomelo_delivery_context_statistic(delivery_ctx, &statistic);
+    pomelo_check(statistic.bus_state_bytes > 0);
+    pomelo_check(statistic.endpoint_bytes > 0);
+    printf(
+        "[i] Bus state: %zu bytes, endpoint: %zu bytes\n",
+        statistic.bus_state_bytes,
+        statistic.endpoint_bytes
+    );
+}
+
+
 /// @brief Check if this test should finish
 static void check_finish(void) {
     if (total_transmission_count < sizeof(modes) / sizeof(modes[0])) {
@@ -67,6 +117,7 @@ static void check_finish(void) {
         return;
     }
 
+    check_bus_state();
     printf("[i] Stopping endpoints...\n");
 
     // Stop the endpoints
@@ -102,6 +153,17 @@ void pomelo_delivery_bus_on_received(
 
     printf("[i] Parcel data is valid, bytes = %d\n", i);
 
+    // The body is only contiguous when it is reassembled in one buffer
+    size_t body_length = 0;
+    const uint8_t * body = pomelo_delivery_parcel_body(parcel, &body_length);
+    pomelo_check(body_length == sizeof(data));
+    if (POMELO_TEST_DELIVERY_CONTIGUOUS) {
+        pomelo_check(body != NULL);
+        pomelo_check(memcmp(body, data, sizeof(data)) == 0);
+    } else {
+        pomelo_check(body == NULL);
+    }
+
     if (mode == POMELO_DELIVERY_MODE_RELIABLE) {
         received_reliable_parcels++;
         check_finish();
@@ -212,7 +274,8 @@ static void send_parcel(pomelo_delivery_mode mode) {
     pomelo_delivery_sender_options_t options = {
         .context = delivery_ctx,
         .parcel = parcel,
-        .platform = platform
+        .platform = platform,
+        .checksum = POMELO_TEST_DELIVERY_CHECKSUM
     };
     pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
     pomelo_check(sender != NULL);
@@ -286,7 +349,8 @@ int main(void) {
     pomelo_delivery_context_root_options_t context_options = {
         .allocator = allocator,
         .buffer_context = buffer_ctx,
-        .fragment_capacity = POMELO_PACKET_BODY_CAPACITY
+        .fragment_capacity = POMELO_PACKET_BODY_CAPACITY,
+        .contiguous_reassembly = POMELO_TEST_DELIVERY_CONTIGUOUS
     };
     delivery_ctx = pomelo_delivery_context_root_create(&context_options);
     pomelo_check(delivery_ctx != NULL);
@@ -310,6 +374,11 @@ int main(void) {
         .nbuses = POMELO_TEST_DELIVERY_NBUSES
     };
 
+    // The checksum algorithm must be valid
+    options.checksum = POMELO_CHECKSUM_COUNT;
+    pomelo_check(pomelo_delivery_endpoint_create(&options) == NULL);
+
+    options.checksum = POMELO_TEST_DELIVERY_CHECKSUM;
     options.time_sync = false;
     sender = pomelo_delivery_endpoint_create(&options);
     pomelo_check(sender != NULL);
@@ -345,6 +414,16 @@ int main(void) {
     pomelo_buffer_context_statistic(buffer_ctx, &statistic_buffer);
     pomelo_statistic_buffer_check_resource_leak(&statistic_buffer);
 
+    pomelo_delivery_context_root_t * root = delivery_ctx->root;
+    for (size_t i = 0; i < POMELO_DELIVERY_BODY_CLASSES; i++) {
+        if (!root->body_contexts[i]) continue;
+        pomelo_buffer_context_statistic(
+            root->body_contexts[i],
+            &statistic_buffer
+        );
+        pomelo_statistic_buffer_check_resource_leak(&statistic_buffer);
+    }
+
     // Destroy platform and contexts
     pomelo_delivery_context_destroy(delivery_ctx);
     pomelo_platform_uv_destroy(platform);
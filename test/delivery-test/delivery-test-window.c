@@ -0,0 +1,588 @@
+#include <string.h>
+#include "uv.h"
+#include "pomelo-test.h"
+#include "delivery/delivery.h"
+#include "delivery/parcel.h"
+#include "platform/uv/platform-uv.h"
+#include "delivery/context.h"
+#include "delivery/fragment.h"
+#include "delivery/endpoint.h"
+#include "delivery/ack.h"
+#include "pomelo/random.h"
+#include "base/constants.h"
+#include "statistic-check/statistic-check.h"
+
+
+/**
+ * This test is used to verify the sliding window of reliable parcels. It sends
+ * many reliable parcels at once through a transporter which drops and reorders
+ * packets, and verifies that they are received in order and exactly once.
+ * With POMELO_TEST_WINDOW_ACK_DELAY_MS, the ACKs are aggregated. With
+ * POMELO_TEST_WINDOW_COALESCE, small fragments are coalesced into shared
+ * payloads. With POMELO_TEST_WINDOW_CONGESTION, the endpoints are paced by the
+ * congestion controller. With POMELO_TEST_WINDOW_UNORDERED, the parcels are
+ * reliable unordered, they are received exactly once but not in order.
+ * Before that, it checks the ACK blocks built from receiving parcels.
+ */
+
+
+#ifndef POMELO_TEST_WINDOW_ACK_DELAY_MS
+#define POMELO_TEST_WINDOW_ACK_DELAY_MS 0
+#endif
+
+#ifndef POMELO_TEST_WINDOW_COALESCE
+#define POMELO_TEST_WINDOW_COALESCE 0
+#endif
+
+#ifndef POMELO_TEST_WINDOW_CONGESTION
+#define POMELO_TEST_WINDOW_CONGESTION POMELO_CONGESTION_CONTROL_DISABLED
+#endif
+
+#ifndef POMELO_TEST_WINDOW_UNORDERED
+#define POMELO_TEST_WINDOW_UNORDERED 0
+#endif
+
+#if POMELO_TEST_WINDOW_UNORDERED
+#define POMELO_TEST_WINDOW_MODE POMELO_DELIVERY_MODE_RELIABLE_UNORDERED
+#else
+#define POMELO_TEST_WINDOW_MODE POMELO_DELIVERY_MODE_RELIABLE
+#endif
+
+
+#define POMELO_TEST_WINDOW_NPARCELS 200
+#define POMELO_TEST_WINDOW_SIZE 8
+#define POMELO_TEST_WINDOW_NBUSES 2
+
+/// The parcels fit in single fragments. Parcels with multiple fragments may be
+/// dispatched out of submission order because of their checksum tasks.
+#define POMELO_TEST_WINDOW_PARCEL_LENGTH 64
+
+
+// Environment
+static uv_loop_t uv_loop;
+static pomelo_allocator_t * allocator;
+static pomelo_platform_t * platform;
+static pomelo_sequencer_t sequencer;
+
+// Endpoints
+static pomelo_delivery_endpoint_t * sender;
+static pomelo_delivery_endpoint_t * receiver;
+
+// Contexts
+static pomelo_buffer_context_t * buffer_ctx;
+static pomelo_delivery_context_t * delivery_ctx;
+static pomelo_delivery_heartbeat_t * heartbeat;
+
+// Data to send
+static uint8_t data[POMELO_TEST_WINDOW_PARCEL_LENGTH];
+
+
+// Temp variables
+static uint32_t next_index = 0;
+static size_t sent_parcels = 0;
+static size_t transported_packets = 0;
+static size_t ack_fragments = 0;
+static size_t coalesced_packets = 0;
+static size_t unordered_parcels = 0;
+static bool received[POMELO_TEST_WINDOW_NPARCELS];
+static size_t ready_count = 0;
+static bool finished = false;
+
+/// The packet which is held back to be delivered after the next one
+static pomelo_buffer_view_t held_view;
+static pomelo_delivery_endpoint_t * held_target = NULL;
+
+/// The timer to stop the endpoints out of the current callbacks
+static pomelo_platform_timer_handle_t stop_timer;
+
+
+/// @brief Stop the endpoints
+static void stop_endpoints(void * data) {
+    (void) data;
+    pomelo_delivery_endpoint_stop(sender);
+    pomelo_delivery_endpoint_stop(receiver);
+}
+
+
+/// @brief Check if this test should finish
+static void check_finish(void) {
+    if (finished) return;
+    if (next_index < POMELO_TEST_WINDOW_NPARCELS) return;
+    if (sent_parcels < POMELO_TEST_WINDOW_NPARCELS) return;
+    finished = true;
+
+    printf(
+        "[i] Received %d parcels, transported %zu packets, "
+        "%zu ACK fragments, %zu coalesced packets, "
+        "%zu parcels out of order\n",
+        POMELO_TEST_WINDOW_NPARCELS,
+        transported_packets,
+        ack_fragments,
+        coalesced_packets,
+        unordered_parcels
+    );
+
+    if (held_target) {
+        pomelo_buffer_unref(held_view.buffer);
+        held_target = NULL;
+    }
+
+    // Packets are transported synchronously, so this might be called while
+    // the heartbeat is iterating the endpoints. Stop them later.
+    int ret = pomelo_platform_timer_start(
+        platform,
+        stop_endpoints,
+        0, // Immediately
+        0, // No repeat
+        NULL,
+        &stop_timer
+    );
+    pomelo_check(ret == 0);
+}
+
+
+void pomelo_delivery_bus_on_received(
+    pomelo_delivery_bus_t * bus,
+    pomelo_delivery_parcel_t * parcel,
+    pomelo_delivery_mode mode
+) {
+    (void) bus;
+    pomelo_check(mode == POMELO_TEST_WINDOW_MODE);
+
+    pomelo_delivery_reader_t reader;
+    pomelo_delivery_reader_init(&reader, parcel);
+
+    // The parcels must be received in order
+    uint32_t index = 0;
+    pomelo_check(
+        pomelo_delivery_reader_read(&reader, (uint8_t *) &index, 4) == 0
+    );
+    pomelo_check(index < POMELO_TEST_WINDOW_NPARCELS);
+    pomelo_check(!received[index]); // Exactly once
+    received[index] = true;
+    if (index != next_index) {
+        pomelo_check(POMELO_TEST_WINDOW_UNORDERED);
+        unordered_parcels++;
+    }
+
+    pomelo_check(
+        pomelo_delivery_reader_remain_bytes(&reader) ==
+        POMELO_TEST_WINDOW_PARCEL_LENGTH - sizeof(index)
+    );
+
+    uint8_t byte;
+    size_t i = sizeof(index);
+    while (pomelo_delivery_reader_read(&reader, &byte, 1) == 0) {
+        pomelo_check(byte == data[i]);
+        i++;
+    }
+
+    next_index++;
+    check_finish();
+}
+
+
+void pomelo_delivery_sender_on_result(
+    pomelo_delivery_sender_t * delivery_sender,
+    pomelo_delivery_parcel_t * parcel,
+    size_t transmission_count
+) {
+    (void) delivery_sender;
+    pomelo_check(transmission_count == 1);
+    pomelo_delivery_parcel_unref(parcel);
+
+    sent_parcels++;
+    check_finish();
+}
+
+
+/// @brief Deliver a payload to the target endpoint
+static void transport_deliver(
+    pomelo_delivery_endpoint_t * target,
+    pomelo_buffer_view_t * view
+) {
+    transported_packets++;
+
+    pomelo_buffer_view_t meta_view = *view;
+    pomelo_delivery_fragment_meta_t meta;
+    int ret = pomelo_delivery_fragment_meta_decode(&meta, &meta_view);
+    pomelo_check(ret == 0);
+    if (meta.type == POMELO_FRAGMENT_TYPE_ACK) {
+        ack_fragments++;
+    } else if (meta.bus_id == 0 && meta.sequence == 0) {
+        coalesced_packets++;
+    }
+
+    ret = pomelo_delivery_endpoint_recv(target, view);
+    pomelo_check(ret == 0);
+    pomelo_buffer_unref(view->buffer);
+}
+
+
+int pomelo_delivery_endpoint_send(
+    pomelo_delivery_endpoint_t * endpoint,
+    pomelo_buffer_view_t * views,
+    size_t nviews
+) {
+    static int counter = 0;
+    counter++;
+    if (counter % 7 == 0) {
+        return 0; // Drop the packet
+    }
+
+    // Combine the views into a single view
+    pomelo_buffer_t * buffer = pomelo_buffer_context_acquire(buffer_ctx);
+    if (!buffer) return -1;
+
+    pomelo_buffer_view_t view;
+    view.buffer = buffer;
+    view.offset = 0;
+    view.length = 0;
+
+    for (size_t i = 0; i < nviews; i++) {
+        pomelo_buffer_view_t * current = &views[i];
+        memcpy(
+            buffer->data + view.length,
+            current->buffer->data + current->offset,
+            current->length
+        );
+        view.length += current->length;
+    }
+
+    pomelo_delivery_endpoint_t * target =
+        (endpoint == sender) ? receiver : sender;
+
+    if (finished) {
+        transport_deliver(target, &view);
+        return 0;
+    }
+
+    if (!held_target && counter % 3 == 0) {
+        // Hold this packet, it will be delivered after the next one
+        held_view = view;
+        held_target = target;
+        return 0;
+    }
+
+    transport_deliver(target, &view);
+    if (held_target) {
+        pomelo_delivery_endpoint_t * held = held_target;
+        held_target = NULL;
+        transport_deliver(held, &held_view);
+    }
+
+    return 0;
+}
+
+
+/// @brief Send a reliable parcel with its index
+static void send_parcel(uint32_t index) {
+    pomelo_delivery_bus_t * bus = pomelo_delivery_endpoint_get_bus(sender, 1);
+    pomelo_check(bus != NULL);
+
+    pomelo_delivery_parcel_t * parcel =
+        pomelo_delivery_context_acquire_parcel(delivery_ctx);
+    pomelo_check(parcel != NULL);
+
+    pomelo_delivery_writer_t writer;
+    pomelo_delivery_writer_init(&writer, parcel);
+    pomelo_check(
+        pomelo_delivery_writer_write(&writer, (uint8_t *) &index, 4) == 0
+    );
+
+    size_t length = POMELO_TEST_WINDOW_PARCEL_LENGTH - sizeof(index);
+    pomelo_check(
+        pomelo_delivery_writer_write(&writer, data + sizeof(index), length) == 0
+    );
+
+    pomelo_delivery_sender_options_t options = {
+        .context = delivery_ctx,
+        .parcel = parcel,
+        .platform = platform
+    };
+    pomelo_delivery_sender_t * sender = pomelo_delivery_sender_create(&options);
+    pomelo_check(sender != NULL);
+
+    int ret = pomelo_delivery_sender_add_transmission(
+        sender,
+        bus,
+        POMELO_TEST_WINDOW_MODE
+    );
+    pomelo_check(ret == 0);
+
+    pomelo_delivery_sender_submit(sender);
+}
+
+
+void pomelo_delivery_endpoint_on_ready(
+    pomelo_delivery_endpoint_t * endpoint
+) {
+    (void) endpoint;
+    ready_count++;
+    if (ready_count < 2) return;
+
+    // Send all parcels at once, the window will queue them
+    for (uint32_t i = 0; i < POMELO_TEST_WINDOW_NPARCELS; i++) {
+        send_parcel(i);
+    }
+}
+
+
+/// Any non-NULL buffer marks a receiving fragment as received
+static pomelo_buffer_t * ack_received_mark =
+    (pomelo_buffer_t *) &ack_received_mark;
+
+
+/// @brief Set the received fragments from the pattern, 'x' for received
+static void ack_set_received(
+    pomelo_array_t * fragments,
+    const char * pattern
+) {
+    size_t length = strlen(pattern);
+    pomelo_array_resize(fragments, length);
+    for (size_t i = 0; i < length; i++) {
+        pomelo_delivery_fragment_t * fragment =
+            pomelo_array_get_ptr(fragments, i);
+        memset(fragment, 0, sizeof(pomelo_delivery_fragment_t));
+        if (pattern[i] == 'x') {
+            fragment->content.buffer = ack_received_mark;
+        }
+    }
+}
+
+
+/// @brief Build the ACK blocks of the fragments like the endpoint does and
+/// check that every received fragment is acked exactly once
+/// @return The number of built blocks
+static size_t ack_check_blocks(
+    pomelo_array_t * fragments,
+    const char * pattern
+) {
+    size_t acks[64] = { 0 };
+    size_t length = strlen(pattern);
+    pomelo_check(length <= 64);
+    ack_set_received(fragments, pattern);
+
+    pomelo_delivery_ack_block_t block;
+    memset(&block, 0, sizeof(pomelo_delivery_ack_block_t));
+
+    size_t nblocks = 0;
+    size_t start = 0;
+    while (start < length) {
+        size_t next = pomelo_delivery_ack_block_build(&block, fragments, start);
+        if (next <= start) break; // No more received fragments
+        start = next;
+        nblocks++;
+
+        for (size_t i = block.first; i < block.first + block.run; i++) {
+            acks[i]++;
+        }
+
+        uint32_t mask = block.mask;
+        size_t base = block.first + block.run + 1;
+        for (size_t i = 0; mask != 0; i++, mask >>= 1) {
+            if (mask & 1) acks[base + i]++;
+        }
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        pomelo_check(acks[i] == (pattern[i] == 'x' ? 1U : 0U));
+    }
+    return nblocks;
+}
+
+
+/// @brief Test the ACK blocks of receiving parcels
+static int test_ack_blocks(void) {
+    pomelo_array_options_t options;
+    memset(&options, 0, sizeof(pomelo_array_options_t));
+    options.element_size = sizeof(pomelo_delivery_fragment_t);
+    pomelo_array_t * fragments = pomelo_array_create(&options);
+    pomelo_check(fragments != NULL);
+
+    // Nothing has been received
+    pomelo_check(ack_check_blocks(fragments, "........") == 0);
+
+    // The last received run ends before the end of window
+    pomelo_delivery_ack_block_t block;
+    pomelo_check(ack_check_blocks(fragments, "xx.x....") == 1);
+    pomelo_check(pomelo_delivery_ack_block_build(&block, fragments, 0) == 4);
+    pomelo_check(block.first == 0);
+    pomelo_check(block.run == 2);
+    pomelo_check(block.mask == 1);
+    pomelo_check(pomelo_delivery_ack_block_build(&block, fragments, 4) == 4);
+
+    // Every fragment has been received
+    pomelo_check(ack_check_blocks(fragments, "xxxxxxxx") == 1);
+
+    // The received fragments do not fit in a single mask
+    pomelo_check(ack_check_blocks(
+        fragments,
+        ".x.x................................x.xx........"
+    ) == 2);
+
+    pomelo_array_destroy(fragments);
+    return 0;
+}
+
+
+int main(void) {
+    printf("Delivery window test\n");
+    pomelo_check(test_ack_blocks() == 0);
+
+    // Random data
+    pomelo_random_buffer(data, POMELO_TEST_WINDOW_PARCEL_LENGTH);
+
+    allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    uv_loop_init(&uv_loop);
+
+    // Create data context
+    pomelo_buffer_context_root_options_t buffer_ctx_options = {
+        .allocator = allocator,
+        .buffer_capacity = POMELO_BUFFER_CAPACITY
+    };
+    buffer_ctx = pomelo_buffer_context_root_create(&buffer_ctx_options);
+    pomelo_check(buffer_ctx != NULL);
+
+    // Create the platform
+    pomelo_platform_uv_options_t platform_options = {
+        .allocator = allocator,
+        .uv_loop = &uv_loop
+    };
+    platform = pomelo_platform_uv_create(&platform_options);
+    pomelo_check(platform != NULL);
+    pomelo_platform_startup(platform);
+
+    // The window size must not exceed the maximum value
+    pomelo_delivery_context_root_options_t context_options = {
+        .allocator = allocator,
+        .buffer_context = buffer_ctx,
+        .fragment_capacity = POMELO_PACKET_BODY_CAPACITY,
+        .reliable_window = POMELO_DELIVERY_RELIABLE_WINDOW_MAX + 1
+    };
+    pomelo_check(pomelo_delivery_context_root_create(&context_options) == NULL);
+
+    // So does the ACK delay
+    context_options.reliable_window = POMELO_TEST_WINDOW_SIZE;
+    context_options.ack_delay_ms = POMELO_DELIVERY_ACK_DELAY_MAX_MS + 1;
+    pomelo_check(pomelo_delivery_context_root_create(&context_options) == NULL);
+
+    // Create transport context
+    context_options.ack_delay_ms = POMELO_DELIVERY_ACK_DELAY_MAX_MS;
+    context_options.coalesce_delay_ms =
+        POMELO_DELIVERY_COALESCE_DELAY_MAX_MS + 1;
+    pomelo_check(pomelo_delivery_context_root_create(&context_options) == NULL);
+
+    context_options.ack_delay_ms = POMELO_TEST_WINDOW_ACK_DELAY_MS;
+    context_options.coalesce = POMELO_TEST_WINDOW_COALESCE;
+    context_options.coalesce_delay_ms = 1;
+    delivery_ctx = pomelo_delivery_context_root_create(&context_options);
+    pomelo_check(delivery_ctx != NULL);
+
+    // Create heartbeat
+    pomelo_delivery_heartbeat_options_t heartbeat_options = {
+        .context = delivery_ctx,
+        .platform = platform
+    };
+    heartbeat = pomelo_delivery_heartbeat_create(&heartbeat_options);
+    pomelo_check(heartbeat != NULL);
+
+    // Initialize sequencer
+    pomelo_sequencer_init(&sequencer);
+
+    pomelo_delivery_endpoint_options_t options = {
+        .context = delivery_ctx,
+        .platform = platform,
+        .heartbeat = heartbeat,
+        .sequencer = &sequencer,
+        .nbuses = POMELO_TEST_WINDOW_NBUSES
+    };
+
+    // The congestion control must be valid
+    options.congestion_control = POMELO_CONGESTION_CONTROL_COUNT;
+    pomelo_check(pomelo_delivery_endpoint_create(&options) == NULL);
+
+    options.congestion_control = POMELO_TEST_WINDOW_CONGESTION;
+    options.time_sync = false;
+    sender = pomelo_delivery_endpoint_create(&options);
+    pomelo_check(sender != NULL);
+
+    options.time_sync = true;
+    receiver = pomelo_delivery_endpoint_create(&options);
+    pomelo_check(receiver != NULL);
+
+    // Start the endpoints
+    pomelo_delivery_endpoint_start(sender);
+    pomelo_delivery_endpoint_start(receiver);
+
+    /* Start testing */
+
+    uv_run(&uv_loop, UV_RUN_DEFAULT);
+    uv_loop_close(&uv_loop);
+
+    /* End testing */
+
+    pomelo_check(next_index == POMELO_TEST_WINDOW_NPARCELS);
+    pomelo_check(sent_parcels == POMELO_TEST_WINDOW_NPARCELS);
+
+    // Aggregated ACKs are sent as system parcels instead of ACK fragments
+    if (POMELO_TEST_WINDOW_ACK_DELAY_MS > 0) {
+        pomelo_check(ack_fragments == 0);
+    } else if (!POMELO_TEST_WINDOW_COALESCE) {
+        pomelo_check(ack_fragments > 0);
+    }
+
+    // Parcels are sent at once, so their fragments share payloads
+    if (POMELO_TEST_WINDOW_COALESCE) {
+        pomelo_check(coalesced_packets > 0);
+    } else {
+        pomelo_check(coalesced_packets == 0);
+    }
+
+    // The dropped packets do not stall the unordered parcels
+    if (POMELO_TEST_WINDOW_UNORDERED) {
+        pomelo_check(unordered_parcels > 0);
+    }
+
+    // The dropped packets reduce the congestion window
+    if (POMELO_TEST_WINDOW_CONGESTION != POMELO_CONGESTION_CONTROL_DISABLED) {
+        pomelo_check(sender->congestion.recovery_time > 0);
+        pomelo_check(sender->pacer_count == 0);
+    }
+
+    // Destroy endpoints
+    pomelo_delivery_endpoint_destroy(sender);
+    pomelo_delivery_endpoint_destroy(receiver);
+
+    // Destroy the heartbeat
+    pomelo_delivery_heartbeat_destroy(heartbeat);
+
+    // Check resource leak
+    pomelo_statistic_delivery_t statistic_delivery;
+    pomelo_delivery_context_statistic(delivery_ctx, &statistic_delivery);
+    pomelo_statistic_delivery_check_resource_leak(&statistic_delivery);
+    printf(
+        "[i] Retransmitted %llu fragments by timeouts, %llu by later ACKs\n",
+        (unsigned long long) statistic_delivery.retransmitted_fragments,
+        (unsigned long long) statistic_delivery.fast_retransmitted_fragments
+    );
+    pomelo_check(
+        statistic_delivery.retransmitted_fragments +
+        statistic_delivery.fast_retransmitted_fragments > 0
+    );
+
+    pomelo_statistic_buffer_t statistic_buffer;
+    pomelo_buffer_context_statistic(buffer_ctx, &statistic_buffer);
+    pomelo_statistic_buffer_check_resource_leak(&statistic_buffer);
+
+    // Destroy platform and contexts
+    pomelo_delivery_context_destroy(delivery_ctx);
+    pomelo_platform_uv_destroy(platform);
+    pomelo_buffer_context_destroy(buffer_ctx);
+
+    pomelo_check(alloc_bytes == pomelo_allocator_allocated_bytes(allocator));
+
+    return 0;
+}
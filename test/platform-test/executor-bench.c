@@ -0,0 +1,183 @@
+#include <stdint.h>
+#include <string.h>
+#include "pomelo/platforms/platform-uv.h"
+#include "pomelo-test.h"
+#include "platform/platform.h"
+
+
+/// The number of producer threads
+#define BENCH_PRODUCERS 8
+
+/// The number of tasks submitted by each producer. This is the pattern of game
+/// logic threads which push thousands of sends per tick.
+#define BENCH_TASKS_PER_PRODUCER 50000
+
+/// The total number of tasks
+#define BENCH_TASKS (BENCH_PRODUCERS * BENCH_TASKS_PER_PRODUCER)
+
+
+typedef struct pomelo_bench_producer_s {
+    /// @brief The thread of producer
+    uv_thread_t thread;
+
+    /// @brief The time spent on submitting
+    uint64_t submit_ns;
+
+    /// @brief The number of failed submissions
+    int failed;
+} pomelo_bench_producer_t;
+
+
+typedef struct pomelo_bench_executor_s {
+    /// @brief The platform
+    pomelo_platform_t * platform;
+
+    /// @brief The shared executor
+    pomelo_threadsafe_executor_t * executor;
+
+    /// @brief The producers
+    pomelo_bench_producer_t producers[BENCH_PRODUCERS];
+
+    /// @brief The number of executed tasks
+    int executed;
+
+    /// @brief The number of tasks executed out of submission order
+    int reordered;
+
+    /// @brief The last executed sequence of each producer
+    int sequences[BENCH_PRODUCERS];
+} pomelo_bench_executor_t;
+
+
+/// @brief The task data encodes the producer and its sequence
+#define BENCH_TASK_DATA(producer, sequence)                                    \
+    ((void *) (uintptr_t) ((sequence) * BENCH_PRODUCERS + (producer) + 1))
+
+
+static pomelo_bench_executor_t * bench = NULL;
+
+
+static void bench_shutdown_callback(pomelo_platform_t * platform) {
+    (void) platform;
+}
+
+
+static void bench_task_entry(void * data) {
+    uintptr_t value = ((uintptr_t) data) - 1;
+    int producer = (int) (value % BENCH_PRODUCERS);
+    int sequence = (int) (value / BENCH_PRODUCERS);
+
+    // Tasks of a single producer are executed in order
+    if (sequence != bench->sequences[producer] + 1) {
+        bench->reordered++;
+    }
+    bench->sequences[producer] = sequence;
+
+    bench->executed++;
+    if (bench->executed == BENCH_TASKS) {
+        pomelo_platform_release_threadsafe_executor(
+            bench->platform,
+            bench->executor
+        );
+        bench->executor = NULL;
+        pomelo_platform_shutdown(bench->platform, bench_shutdown_callback);
+    }
+}
+
+
+static void bench_producer_entry(pomelo_bench_producer_t * producer) {
+    int index = (int) (producer - bench->producers);
+
+    uint64_t start = uv_hrtime();
+    for (int i = 0; i < BENCH_TASKS_PER_PRODUCER; i++) {
+        pomelo_platform_task_t * task = pomelo_threadsafe_executor_submit(
+            bench->platform,
+            bench->executor,
+            bench_task_entry,
+            BENCH_TASK_DATA(index, i)
+        );
+        if (!task) producer->failed++;
+    }
+    producer->submit_ns = uv_hrtime() - start;
+}
+
+
+static int pomelo_bench_executor(void) {
+    pomelo_allocator_t * allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    bench = pomelo_allocator_malloc_t(allocator, pomelo_bench_executor_t);
+    pomelo_check(bench != NULL);
+    memset(bench, 0, sizeof(pomelo_bench_executor_t));
+    for (int i = 0; i < BENCH_PRODUCERS; i++) {
+        bench->sequences[i] = -1;
+    }
+
+    uv_loop_t uv_loop;
+    pomelo_check(uv_loop_init(&uv_loop) == 0);
+
+    pomelo_platform_uv_options_t options = {
+        .allocator = allocator,
+        .uv_loop = &uv_loop
+    };
+    pomelo_platform_t * platform = pomelo_platform_uv_create(&options);
+    pomelo_check(platform != NULL);
+    bench->platform = platform;
+    pomelo_platform_startup(platform);
+
+    bench->executor = pomelo_platform_acquire_threadsafe_executor(platform);
+    pomelo_check(bench->executor != NULL);
+
+    uint64_t start = uv_hrtime();
+    for (int i = 0; i < BENCH_PRODUCERS; i++) {
+        pomelo_bench_producer_t * producer = &bench->producers[i];
+        int ret = uv_thread_create(
+            &producer->thread,
+            (uv_thread_cb) bench_producer_entry,
+            producer
+        );
+        pomelo_check(ret == 0);
+    }
+
+    uv_run(&uv_loop, UV_RUN_DEFAULT);
+    uint64_t elapsed_ns = uv_hrtime() - start;
+
+    uint64_t submit_ns = 0;
+    for (int i = 0; i < BENCH_PRODUCERS; i++) {
+        pomelo_bench_producer_t * producer = &bench->producers[i];
+        pomelo_check(uv_thread_join(&producer->thread) == 0);
+        pomelo_check(producer->failed == 0);
+        submit_ns += producer->submit_ns;
+    }
+
+    pomelo_check(bench->executed == BENCH_TASKS);
+    pomelo_check(bench->reordered == 0);
+
+    pomelo_statistic_platform_uv_t statistic;
+    pomelo_platform_uv_statistic(platform, &statistic);
+    pomelo_check(statistic.threadsafe_tasks == 0);
+
+    printf(
+        "[i] %d producers, %d tasks: submit %.1f ns/task, "
+        "throughput %.2f Mtasks/s\n",
+        BENCH_PRODUCERS,
+        BENCH_TASKS,
+        (double) submit_ns / BENCH_TASKS,
+        (double) BENCH_TASKS * 1000.0 / (double) elapsed_ns
+    );
+
+    pomelo_platform_uv_destroy(platform);
+    uv_loop_close(&uv_loop);
+    pomelo_allocator_free(allocator, bench);
+    bench = NULL;
+
+    // Check memleak
+    pomelo_check(pomelo_allocator_allocated_bytes(allocator) == alloc_bytes);
+    return 0;
+}
+
+
+int main(void) {
+    pomelo_run_test(pomelo_bench_executor);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include "platform-test.h"
+#include "pomelo/platforms/platform-uring.h"
+#include "pomelo-test.h"
+
+
+/* The platform runs its own loop in the calling thread */
+
+pomelo_platform_t * pomelo_test_platform_create(
+    pomelo_allocator_t * allocator
+) {
+    // Small number of provided buffers to exercise the buffer recycling
+    pomelo_platform_uring_options_t options = {
+        .allocator = allocator,
+        .queue_depth = 64,
+        .recv_buffers = 16,
+        .worker_threads = 2
+    };
+
+    return pomelo_platform_uring_create(&options);
+}
+
+
+void pomelo_test_platform_destroy(pomelo_platform_t * platform) {
+    pomelo_platform_uring_destroy(platform);
+}
+
+
+void pomelo_test_platform_run(pomelo_platform_t * platform) {
+    pomelo_platform_uring_run(platform);
+}
@@ -9,9 +9,15 @@ pomelo_platform_t * pomelo_test_platform_create(
     pomelo_allocator_t * allocator
 ) {
     // Create platform first
+    // Batched receiving & sending and the timing wheel are enabled here, other
+    // tests cover the single datagram paths and the per-timer uv timers.
     pomelo_platform_uv_options_t options = {
         .allocator = allocator,
-        .uv_loop = uv_default_loop()
+        .uv_loop = uv_default_loop(),
+        .recv_batch_size = 8,
+        .send_batch_size = 16,
+        .udp_gso = true,
+        .timer_wheel = true
     };
 
     return pomelo_platform_uv_create(&options);
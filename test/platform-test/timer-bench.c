@@ -0,0 +1,189 @@
+#include <string.h>
+#include "pomelo/platforms/platform-uv.h"
+#include "pomelo-test.h"
+#include "platform/platform.h"
+
+
+/// The number of churn rounds, one round per driver tick
+#define BENCH_CHURN_ROUNDS 200
+
+/// The number of timers started then stopped in each round. This is the
+/// pattern of resend timers: started when a reliable parcel is sent and
+/// stopped when it is acked.
+#define BENCH_CHURN_TIMERS 2000
+
+/// The resend-like timeout of churn timers
+#define BENCH_CHURN_TIMEOUT_MS 200
+
+/// The number of one-shot timers which must fire during the benchmark
+#define BENCH_FIRE_TIMERS 1000
+
+/// The interval of driver timer
+#define BENCH_DRIVER_INTERVAL_MS 1
+
+
+typedef struct pomelo_bench_timer_s {
+    /// @brief The platform
+    pomelo_platform_t * platform;
+
+    /// @brief The driver timer
+    pomelo_platform_timer_handle_t driver;
+
+    /// @brief The churn timers
+    pomelo_platform_timer_handle_t churn[BENCH_CHURN_TIMERS];
+
+    /// @brief The one-shot timers
+    pomelo_platform_timer_handle_t fire[BENCH_FIRE_TIMERS];
+
+    /// @brief The number of finished rounds
+    int rounds;
+
+    /// @brief The number of fired one-shot timers
+    int fired;
+
+    /// @brief The number of unexpected churn callbacks
+    int churn_callbacks;
+
+    /// @brief The accumulated time of churn rounds
+    uint64_t churn_ns;
+
+    /// @brief The flag of shutdown
+    bool shutdown;
+} pomelo_bench_timer_t;
+
+
+static void bench_churn_callback(pomelo_bench_timer_t * bench) {
+    bench->churn_callbacks++;
+}
+
+
+static void bench_fire_callback(pomelo_bench_timer_t * bench) {
+    bench->fired++;
+}
+
+
+static void bench_shutdown_callback(pomelo_platform_t * platform) {
+    (void) platform;
+}
+
+
+static void bench_driver_callback(pomelo_bench_timer_t * bench) {
+    pomelo_platform_t * platform = bench->platform;
+
+    if (bench->rounds < BENCH_CHURN_ROUNDS) {
+        uint64_t start = pomelo_platform_hrtime(platform);
+        for (int i = 0; i < BENCH_CHURN_TIMERS; i++) {
+            int ret = pomelo_platform_timer_start(
+                platform,
+                (pomelo_platform_timer_entry) bench_churn_callback,
+                BENCH_CHURN_TIMEOUT_MS,
+                BENCH_CHURN_TIMEOUT_MS,
+                bench,
+                &bench->churn[i]
+            );
+            pomelo_check(ret == 0);
+        }
+        for (int i = 0; i < BENCH_CHURN_TIMERS; i++) {
+            pomelo_platform_timer_stop(platform, &bench->churn[i]);
+        }
+        bench->churn_ns += pomelo_platform_hrtime(platform) - start;
+        bench->rounds++;
+    }
+
+    if (bench->rounds == BENCH_CHURN_ROUNDS &&
+        bench->fired == BENCH_FIRE_TIMERS &&
+        !bench->shutdown
+    ) {
+        bench->shutdown = true;
+        pomelo_platform_timer_stop(platform, &bench->driver);
+        pomelo_platform_shutdown(platform, bench_shutdown_callback);
+    }
+}
+
+
+static int pomelo_bench_timer_run(bool timer_wheel, uint64_t * churn_ns) {
+    pomelo_allocator_t * allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    pomelo_bench_timer_t * bench =
+        pomelo_allocator_malloc_t(allocator, pomelo_bench_timer_t);
+    pomelo_check(bench != NULL);
+    memset(bench, 0, sizeof(pomelo_bench_timer_t));
+
+    uv_loop_t uv_loop;
+    pomelo_check(uv_loop_init(&uv_loop) == 0);
+
+    pomelo_platform_uv_options_t options = {
+        .allocator = allocator,
+        .uv_loop = &uv_loop,
+        .timer_wheel = timer_wheel
+    };
+    pomelo_platform_t * platform = pomelo_platform_uv_create(&options);
+    pomelo_check(platform != NULL);
+    bench->platform = platform;
+    pomelo_platform_startup(platform);
+
+    // The one-shot timers are spread over several wheel levels
+    for (int i = 0; i < BENCH_FIRE_TIMERS; i++) {
+        int ret = pomelo_platform_timer_start(
+            platform,
+            (pomelo_platform_timer_entry) bench_fire_callback,
+            1 + (i * 7) % 300, // Timeout
+            0, // No repeat
+            bench,
+            &bench->fire[i]
+        );
+        pomelo_check(ret == 0);
+    }
+
+    int ret = pomelo_platform_timer_start(
+        platform,
+        (pomelo_platform_timer_entry) bench_driver_callback,
+        BENCH_DRIVER_INTERVAL_MS,
+        BENCH_DRIVER_INTERVAL_MS,
+        bench,
+        &bench->driver
+    );
+    pomelo_check(ret == 0);
+
+    uv_run(&uv_loop, UV_RUN_DEFAULT);
+
+    pomelo_statistic_platform_uv_t statistic;
+    pomelo_platform_uv_statistic(platform, &statistic);
+    pomelo_check(statistic.timers == 0);
+
+    pomelo_check(bench->rounds == BENCH_CHURN_ROUNDS);
+    pomelo_check(bench->fired == BENCH_FIRE_TIMERS);
+    pomelo_check(bench->churn_callbacks == 0);
+    *churn_ns = bench->churn_ns;
+
+    pomelo_platform_uv_destroy(platform);
+    uv_loop_close(&uv_loop);
+    pomelo_allocator_free(allocator, bench);
+
+    // Check memleak
+    pomelo_check(pomelo_allocator_allocated_bytes(allocator) == alloc_bytes);
+    return 0;
+}
+
+
+static int pomelo_bench_timer(void) {
+    uint64_t uv_timer_ns = 0;
+    uint64_t wheel_ns = 0;
+    pomelo_check(pomelo_bench_timer_run(false, &uv_timer_ns) == 0);
+    pomelo_check(pomelo_bench_timer_run(true, &wheel_ns) == 0);
+
+    double pairs = (double) BENCH_CHURN_ROUNDS * BENCH_CHURN_TIMERS;
+    printf(
+        "[i] Start/stop pair: uv timers %.1f ns, timing wheel %.1f ns\n",
+        (double) uv_timer_ns / pairs,
+        (double) wheel_ns / pairs
+    );
+    return 0;
+}
+
+
+int main(void) {
+    pomelo_run_test(pomelo_bench_timer);
+    return 0;
+}
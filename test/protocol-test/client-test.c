@@ -457,6 +457,11 @@ void pomelo_protocol_socket_on_connect_result(
 }
 
 
+void pomelo_protocol_socket_on_heartbeat(pomelo_protocol_socket_t * socket) {
+    (void) socket;
+}
+
+
 int main(void) {
     printf("Test protocol client.\n");
     if (pomelo_crypto_init() < 0) {
@@ -0,0 +1,342 @@
+#include <string.h>
+#include "pomelo-test.h"
+#include "pomelo/random.h"
+#include "pomelo/platforms/platform-uv.h"
+#include "protocol/server.h"
+#include "protocol/peer.h"
+#include "protocol/socket.h"
+#include "protocol/context.h"
+#include "protocol/packet.h"
+#include "crypto/crypto.h"
+#include "utils/macro.h"
+#include "adapter-simulator.h"
+#include "statistic-check/statistic-check.h"
+
+
+/**
+ * This test verifies the deadline & keep alive heaps of servers with connected
+ * peers which are put directly into the server:
+ *  - Expired peers are disconnected in the order of their deadlines, while the
+ *    peers which have received packets after being tracked are re-armed.
+ *  - Keep alive packets are only sent to the idle peers, while the peers which
+ *    have been sent packets after being tracked are re-armed.
+ */
+
+
+#define SERVER_ADDRESS "127.0.0.1:8888"
+#define PEER_PORT_BASE 9000
+#define MAX_CLIENTS 16
+#define PEER_TIMEOUT_NS POMELO_SECONDS_TO_NS(1)
+#define MS_TO_NS 1000000ULL
+
+/// The maximum number of loop iterations to wait for the keep alive packets
+#define MAX_LOOP_ITERATIONS 100000
+
+
+// Environment
+static pomelo_allocator_t * allocator;
+static pomelo_platform_t * platform;
+static pomelo_buffer_context_t * buffer_ctx;
+static pomelo_protocol_context_t * protocol_ctx;
+static uv_loop_t uv_loop;
+static pomelo_sequencer_t sequencer;
+static pomelo_adapter_t * adapter;
+static pomelo_protocol_socket_t * server_socket;
+static pomelo_protocol_server_t * server;
+static uint8_t private_key[POMELO_KEY_BYTES];
+
+// The disconnected peers in order
+static pomelo_protocol_peer_t * disconnected_peers[MAX_CLIENTS];
+static size_t ndisconnected = 0;
+
+// The number of sent keep alive packets
+static size_t nkeep_alives = 0;
+
+
+/// @brief Count the keep alive packets sent by server
+static void send_handler(
+    pomelo_address_t * address,
+    pomelo_buffer_view_t * view
+) {
+    (void) address;
+
+    pomelo_protocol_packet_header_t header;
+    int ret = pomelo_protocol_packet_header_decode(&header, view);
+    pomelo_check(ret == 0);
+
+    if (header.type == POMELO_PROTOCOL_PACKET_KEEP_ALIVE) {
+        nkeep_alives++;
+    }
+}
+
+
+/// @brief Put a connected peer into the server
+static pomelo_protocol_peer_t * connect_peer(
+    uint16_t index,
+    uint64_t last_recv_time,
+    uint64_t last_send_time
+) {
+    pomelo_address_t address;
+    int ret = pomelo_address_from_string(&address, SERVER_ADDRESS);
+    pomelo_check(ret == 0);
+    address.port = PEER_PORT_BASE + index;
+
+    pomelo_protocol_peer_t * peer =
+        pomelo_protocol_server_acquire_peer(server, &address);
+    pomelo_check(peer != NULL);
+
+    peer->state = POMELO_PROTOCOL_PEER_CONNECTED;
+    peer->timeout_ns = PEER_TIMEOUT_NS;
+    peer->last_recv_time = last_recv_time;
+    peer->last_send_time = last_send_time;
+    peer->entry = pomelo_list_push_back(server->connected_peers, peer);
+    pomelo_check(peer->entry != NULL);
+
+    ret = pomelo_protocol_server_track_deadline(server, peer);
+    pomelo_check(ret == 0);
+    ret = pomelo_protocol_server_track_keep_alive(server, peer);
+    pomelo_check(ret == 0);
+    return peer;
+}
+
+
+static int test_deadline(void) {
+    uint64_t now = pomelo_platform_hrtime(platform);
+    uint64_t expired = now - PEER_TIMEOUT_NS;
+
+    // Pushed out of the order of deadlines
+    pomelo_protocol_peer_t * late =
+        connect_peer(0, expired - 2 * MS_TO_NS, now);
+    pomelo_protocol_peer_t * alive = connect_peer(1, now, now);
+    pomelo_protocol_peer_t * early =
+        connect_peer(2, expired - 5 * MS_TO_NS, now);
+    pomelo_protocol_peer_t * rearmed =
+        connect_peer(3, expired - 1 * MS_TO_NS, now);
+    pomelo_check(late && alive && early && rearmed);
+
+    // The re-armed peer receives a packet after being tracked
+    rearmed->last_recv_time = now;
+
+    pomelo_protocol_server_expire_peers(server);
+
+    // The expired peers are disconnected in the order of their deadlines
+    pomelo_check(ndisconnected == 2);
+    pomelo_check(disconnected_peers[0] == early);
+    pomelo_check(disconnected_peers[1] == late);
+    pomelo_check(server->connected_peers->size == 2);
+
+    // The re-armed peer is tracked with its new deadline
+    pomelo_check(rearmed->deadline_entry != NULL);
+    pomelo_check(rearmed->deadline_time == now + PEER_TIMEOUT_NS);
+    pomelo_check(alive->deadline_entry != NULL);
+    pomelo_check(alive->deadline_time == now + PEER_TIMEOUT_NS);
+
+    // Nothing is expired again
+    pomelo_protocol_server_expire_peers(server);
+    pomelo_check(ndisconnected == 2);
+    return 0;
+}
+
+
+static int test_keep_alive(void) {
+    uint64_t now = pomelo_platform_hrtime(platform);
+    uint64_t idle = now - POMELO_KEEP_ALIVE_IDLE_NS;
+
+    pomelo_protocol_peer_t * idle1 =
+        connect_peer(10, now, idle - 2 * MS_TO_NS);
+    pomelo_protocol_peer_t * busy = connect_peer(11, now, now);
+    pomelo_protocol_peer_t * idle2 =
+        connect_peer(12, now, idle - 5 * MS_TO_NS);
+    pomelo_protocol_peer_t * rearmed = connect_peer(13, now, idle - MS_TO_NS);
+    pomelo_check(idle1 && busy && idle2 && rearmed);
+
+    // The re-armed peer is sent a packet after being tracked
+    uint64_t rearmed_send_time = now - MS_TO_NS;
+    rearmed->last_send_time = rearmed_send_time;
+    uint64_t busy_keep_alive_time = busy->keep_alive_time;
+
+    pomelo_protocol_server_broadcast_keep_alive(server);
+    pomelo_check(ndisconnected == 2);
+
+    // The idle peers are sent keep alive packets, then tracked again
+    pomelo_check(idle1->last_send_time >= now);
+    pomelo_check(idle2->last_send_time >= now);
+    pomelo_check(idle1->keep_alive_entry != NULL);
+    pomelo_check(idle2->keep_alive_entry != NULL);
+    pomelo_check(
+        idle1->keep_alive_time ==
+        idle1->last_send_time + POMELO_KEEP_ALIVE_IDLE_NS
+    );
+    pomelo_check(
+        idle2->keep_alive_time ==
+        idle2->last_send_time + POMELO_KEEP_ALIVE_IDLE_NS
+    );
+
+    // The re-armed peer is tracked with its new time without keep alive
+    pomelo_check(rearmed->last_send_time == rearmed_send_time);
+    pomelo_check(rearmed->keep_alive_entry != NULL);
+    pomelo_check(
+        rearmed->keep_alive_time ==
+        rearmed_send_time + POMELO_KEEP_ALIVE_IDLE_NS
+    );
+
+    // The busy peer is not visited
+    pomelo_check(busy->keep_alive_time == busy_keep_alive_time);
+
+    // The re-armed peer is the next one
+    pomelo_protocol_peer_t * next = NULL;
+    pomelo_check(pomelo_heap_top(server->peer_keep_alives, &next) == 0);
+    pomelo_check(next == rearmed);
+
+    // Wait for the keep alive packets
+    for (size_t i = 0; i < MAX_LOOP_ITERATIONS && nkeep_alives < 2; i++) {
+        uv_run(&uv_loop, UV_RUN_NOWAIT);
+    }
+    pomelo_check(nkeep_alives == 2);
+    return 0;
+}
+
+
+void pomelo_protocol_socket_on_connected(
+    pomelo_protocol_socket_t * socket,
+    pomelo_protocol_peer_t * peer
+) {
+    (void) socket;
+    (void) peer;
+}
+
+
+void pomelo_protocol_socket_on_disconnected(
+    pomelo_protocol_socket_t * socket,
+    pomelo_protocol_peer_t * peer
+) {
+    (void) socket;
+    pomelo_check(ndisconnected < MAX_CLIENTS);
+    disconnected_peers[ndisconnected++] = peer;
+}
+
+
+void pomelo_protocol_socket_on_received(
+    pomelo_protocol_socket_t * socket,
+    pomelo_protocol_peer_t * peer,
+    pomelo_buffer_view_t * view
+) {
+    (void) socket;
+    (void) peer;
+    (void) view;
+}
+
+
+void pomelo_protocol_socket_on_connect_result(
+    pomelo_protocol_socket_t * socket,
+    pomelo_protocol_connect_result result
+) {
+    (void) socket;
+    (void) result;
+}
+
+
+void pomelo_protocol_socket_on_heartbeat(pomelo_protocol_socket_t * socket) {
+    (void) socket;
+}
+
+
+int main(void) {
+    printf("Test protocol server deadlines.\n");
+    pomelo_check(pomelo_crypto_init() == 0);
+
+    allocator = pomelo_allocator_default();
+    uint64_t alloc_bytes = pomelo_allocator_allocated_bytes(allocator);
+
+    uv_loop_init(&uv_loop);
+
+    // Create platform
+    pomelo_platform_uv_options_t platform_options = {
+        .allocator = allocator,
+        .uv_loop = &uv_loop
+    };
+    platform = pomelo_platform_uv_create(&platform_options);
+    pomelo_check(platform != NULL);
+    pomelo_platform_startup(platform);
+
+    pomelo_sequencer_init(&sequencer);
+
+    // Create buffer context
+    pomelo_buffer_context_root_options_t buffer_ctx_options = {
+        .allocator = allocator,
+        .buffer_capacity = POMELO_BUFFER_CAPACITY
+    };
+    buffer_ctx = pomelo_buffer_context_root_create(&buffer_ctx_options);
+    pomelo_check(buffer_ctx != NULL);
+
+    // Create protocol context
+    pomelo_protocol_context_options_t protocol_ctx_options = {
+        .allocator = allocator,
+        .buffer_context = buffer_ctx,
+        .payload_capacity = POMELO_BUFFER_CAPACITY
+    };
+    protocol_ctx = pomelo_protocol_context_create(&protocol_ctx_options);
+    pomelo_check(protocol_ctx != NULL);
+
+    // Create adapter
+    pomelo_adapter_options_t adapter_options = {
+        .allocator = allocator,
+        .platform = platform
+    };
+    adapter = pomelo_adapter_create(&adapter_options);
+    pomelo_check(adapter != NULL);
+    adapter->send_handler = send_handler;
+
+    // Create server
+    pomelo_random_buffer(private_key, sizeof(private_key));
+    pomelo_protocol_server_options_t server_options;
+    memset(&server_options, 0, sizeof(pomelo_protocol_server_options_t));
+    server_options.context = protocol_ctx;
+    server_options.max_clients = MAX_CLIENTS;
+    server_options.platform = platform;
+    server_options.sequencer = &sequencer;
+    server_options.private_key = private_key;
+    server_options.adapter = adapter;
+    int ret = pomelo_address_from_string(
+        &server_options.address,
+        SERVER_ADDRESS
+    );
+    pomelo_check(ret == 0);
+
+    server_socket = pomelo_protocol_server_create(&server_options);
+    pomelo_check(server_socket != NULL);
+    server = (pomelo_protocol_server_t *) server_socket;
+
+    ret = pomelo_protocol_socket_start(server_socket);
+    pomelo_check(ret == 0);
+
+    pomelo_run_test(test_deadline);
+    pomelo_run_test(test_keep_alive);
+
+    // Stop the server and run the loop until all handles are closed
+    pomelo_protocol_socket_stop(server_socket);
+    pomelo_platform_shutdown(platform, NULL);
+    uv_run(&uv_loop, UV_RUN_DEFAULT);
+    uv_loop_close(&uv_loop);
+
+    pomelo_protocol_socket_destroy(server_socket);
+    pomelo_adapter_destroy(adapter);
+
+    // Check resource leak
+    pomelo_statistic_protocol_t protocol_statistic;
+    pomelo_protocol_context_statistic(protocol_ctx, &protocol_statistic);
+    pomelo_statistic_protocol_check_resource_leak(&protocol_statistic);
+
+    pomelo_statistic_buffer_t buffer_statistic;
+    pomelo_buffer_context_statistic(buffer_ctx, &buffer_statistic);
+    pomelo_statistic_buffer_check_resource_leak(&buffer_statistic);
+
+    // Destroy platform and contexts
+    pomelo_platform_uv_destroy(platform);
+    pomelo_protocol_context_destroy(protocol_ctx);
+    pomelo_buffer_context_destroy(buffer_ctx);
+
+    pomelo_check(alloc_bytes == pomelo_allocator_allocated_bytes(allocator));
+    printf("Test passed!\n");
+    return 0;
+}
@@ -783,6 +783,11 @@ void pomelo_protocol_socket_on_connect_result(
 }
 
 
+void pomelo_protocol_socket_on_heartbeat(pomelo_protocol_socket_t * socket) {
+    (void) socket;
+}
+
+
 void pomelo_protocol_socket_on_disconnect(
     pomelo_protocol_socket_t * socket
 ) {
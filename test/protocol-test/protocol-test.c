@@ -216,6 +216,12 @@ int main(void) {
     pomelo_protocol_context_statistic(protocol_ctx, &protocol_statistic);
     pomelo_statistic_protocol_check_resource_leak(&protocol_statistic);
 
+    // With the adaptive policy, handshake packets go to worker threads and
+    // small packets are processed inline.
+    pomelo_check(protocol_statistic.inline_received_packets > 0);
+    pomelo_check(protocol_statistic.worker_received_packets > 0);
+    pomelo_check(protocol_statistic.dropped_requests == 0);
+
     pomelo_statistic_buffer_t buffer_statistic;
     pomelo_buffer_context_statistic(buffer_ctx, &buffer_statistic);
     pomelo_statistic_buffer_check_resource_leak(&buffer_statistic);
@@ -352,3 +358,8 @@ void pomelo_protocol_socket_on_connect_result(
         pomelo_protocol_socket_stop(server);
     }
 }
+
+
+void pomelo_protocol_socket_on_heartbeat(pomelo_protocol_socket_t * socket) {
+    (void) socket;
+}
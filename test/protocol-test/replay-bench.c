@@ -0,0 +1,237 @@
+#include <string.h>
+#include "uv.h"
+#include "pomelo-test.h"
+#include "protocol/replay.h"
+
+
+/**
+ * This benchmark compares the replay protection of the previous array of
+ * received sequences with the bitmap sliding window. The incoming sequences
+ * are reordered and some of them are replayed, so both the accepted and the
+ * rejected paths are measured.
+ */
+
+
+/// The number of distinct sequences
+#define BENCH_SEQUENCES (1 << 18)
+
+/// The maximum distance of a swap of two sequences
+#define BENCH_REORDER_DISTANCE 48
+
+/// One of this number of sequences is replayed
+#define BENCH_REPLAY_RATIO 8
+
+/// The maximum age of a replayed sequence
+#define BENCH_REPLAY_AGE 512
+
+/// The number of rounds per protector
+#define BENCH_ROUNDS 20
+
+/// The number of entries of the previous array of received sequences
+#define BENCH_LEGACY_SIZE 256
+
+
+/// The previous replay protector, kept for comparison
+typedef struct bench_legacy_protector_s {
+    uint64_t received_sequence[BENCH_LEGACY_SIZE];
+    uint64_t most_recent_sequence;
+} bench_legacy_protector_t;
+
+
+static uint64_t stream[BENCH_SEQUENCES + BENCH_SEQUENCES / BENCH_REPLAY_RATIO];
+static size_t stream_length = 0;
+static uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+
+
+/// @brief Generate a deterministic random number
+static uint64_t bench_random(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+
+/// @brief Generate the stream of reordered and replayed sequences
+static void bench_generate_stream(void) {
+    static uint64_t sequences[BENCH_SEQUENCES];
+    for (size_t i = 0; i < BENCH_SEQUENCES; i++) {
+        sequences[i] = i;
+    }
+
+    // Swap every sequence with a following one
+    for (size_t i = 0; i + BENCH_REORDER_DISTANCE < BENCH_SEQUENCES; i++) {
+        size_t j = i + bench_random() % BENCH_REORDER_DISTANCE;
+        uint64_t sequence = sequences[i];
+        sequences[i] = sequences[j];
+        sequences[j] = sequence;
+    }
+
+    for (size_t i = 0; i < BENCH_SEQUENCES; i++) {
+        stream[stream_length++] = sequences[i];
+        if (i >= BENCH_REPLAY_AGE && i % BENCH_REPLAY_RATIO == 0) {
+            stream[stream_length++] =
+                sequences[i - bench_random() % BENCH_REPLAY_AGE];
+        }
+    }
+}
+
+
+static void bench_legacy_reset(bench_legacy_protector_t * protector) {
+    memset(
+        protector->received_sequence,
+        0xff,
+        sizeof(protector->received_sequence)
+    );
+    protector->most_recent_sequence = 0;
+}
+
+
+static int bench_legacy_update(
+    bench_legacy_protector_t * protector,
+    uint64_t sequence
+) {
+    if (sequence < protector->most_recent_sequence) {
+        uint64_t delta = protector->most_recent_sequence - sequence;
+        if (delta > BENCH_LEGACY_SIZE) return -1;
+    }
+
+    uint64_t index = sequence % BENCH_LEGACY_SIZE;
+    uint64_t received = protector->received_sequence[index];
+    if (received == UINT64_MAX || received < sequence) {
+        protector->received_sequence[index] = sequence;
+        if (sequence > protector->most_recent_sequence) {
+            protector->most_recent_sequence = sequence;
+        }
+        return 0;
+    }
+
+    return -1;
+}
+
+
+/// @brief Print the result of a protector
+static void bench_print(
+    const char * name,
+    size_t bytes,
+    size_t accepted,
+    uint64_t elapsed_ns
+) {
+    printf(
+        "[i] %-16s %5zu bytes: %6.2f ns/packet, accepted %zu/%zu\n",
+        name,
+        bytes,
+        (double) elapsed_ns / BENCH_ROUNDS / (double) stream_length,
+        accepted,
+        stream_length
+    );
+}
+
+
+/// @brief Run the previous protector
+static size_t bench_legacy(void) {
+    bench_legacy_protector_t protector;
+    size_t accepted = 0;
+
+    uint64_t start = uv_hrtime();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        bench_legacy_reset(&protector);
+        accepted = 0;
+        for (size_t i = 0; i < stream_length; i++) {
+            if (bench_legacy_update(&protector, stream[i]) == 0) {
+                accepted++;
+            }
+        }
+    }
+    uint64_t elapsed_ns = uv_hrtime() - start;
+
+    bench_print("array", sizeof(protector), accepted, elapsed_ns);
+    return accepted;
+}
+
+
+/// @brief Run the bitmap protector with the window
+static size_t bench_bitmap(size_t window) {
+    pomelo_protocol_replay_protector_t protector;
+    pomelo_protocol_replay_protector_init(&protector, window);
+    size_t accepted = 0;
+
+    uint64_t start = uv_hrtime();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        pomelo_protocol_replay_protector_reset(&protector);
+        accepted = 0;
+        for (size_t i = 0; i < stream_length; i++) {
+            if (pomelo_protocol_replay_protector_update(
+                &protector,
+                stream[i]
+            ) == 0) {
+                accepted++;
+            }
+        }
+    }
+    uint64_t elapsed_ns = uv_hrtime() - start;
+
+    char name[32];
+    snprintf(name, sizeof(name), "bitmap (%zu)", window);
+    bench_print(name, sizeof(protector), accepted, elapsed_ns);
+    return accepted;
+}
+
+
+/// @brief Check the window boundaries and the replays of the bitmap
+static int bench_check_bitmap(void) {
+    pomelo_protocol_replay_protector_t protector;
+    pomelo_protocol_replay_protector_init(&protector, 64);
+
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 0) == 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 0) < 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 100) == 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 37) == 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 36) < 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 37) < 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 100) < 0);
+
+    // Skip a lot of sequences, the stale bits are cleared
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 228) == 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 164) < 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 165) == 0);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 227) == 0);
+
+    pomelo_protocol_replay_protector_reset(&protector);
+    pomelo_check(pomelo_protocol_replay_protector_update(&protector, 0) == 0);
+    return 0;
+}
+
+
+static int pomelo_bench_replay(void) {
+    pomelo_check(bench_check_bitmap() == 0);
+    bench_generate_stream();
+
+    printf(
+        "[i] %d sequences, swapped within %d, %zu replayed\n",
+        BENCH_SEQUENCES,
+        BENCH_REORDER_DISTANCE,
+        stream_length - BENCH_SEQUENCES
+    );
+
+    size_t legacy_accepted = bench_legacy();
+    for (size_t window = POMELO_PROTOCOL_REPLAY_WINDOW_MIN;
+        window <= POMELO_PROTOCOL_REPLAY_WINDOW_MAX;
+        window *= 2
+    ) {
+        size_t accepted = bench_bitmap(window);
+        pomelo_check(accepted <= BENCH_SEQUENCES); // No replay is accepted
+
+        // The default window accepts the same sequences as the array
+        if (window == POMELO_PROTOCOL_REPLAY_WINDOW_DEFAULT) {
+            pomelo_check(accepted == legacy_accepted);
+        }
+    }
+    return 0;
+}
+
+
+int main(void) {
+    pomelo_run_test(pomelo_bench_replay);
+    return 0;
+}
@@ -11,6 +11,8 @@
 /*
     Protocol server test:
         - Simulator sends request packet
+        - Simulator floods request packets from another port of the same host,
+          server drops them by rate limiting
         - Server responses challenge packet
         - Simulator check challenge packet and replies response packet
         - Server replies a keep alive packet
@@ -24,6 +26,8 @@
 // Constants
 #define SERVER_ADDRESS "127.0.0.1:8888"
 #define CLIENT_ADDRESS "127.0.0.1:8889"
+#define FLOOD_ADDRESS "127.0.0.1:8890"
+#define FLOOD_REQUESTS 5
 #define MAX_CLIENTS 10
 #define CONNECT_TIMEOUT 1 // seconds
 #define TOKEN_EXPIRE 3600 // seconds
@@ -320,6 +324,25 @@ static void send_request_packet(void * unused) {
 }
 
 
+/// @brief Send request packets from another port of the client host. The
+/// request bucket of the host is already empty.
+static void send_flood_request_packets(void) {
+    pomelo_address_t client_address = address;
+    int ret = pomelo_address_from_string(&address, FLOOD_ADDRESS);
+    pomelo_check(ret == 0);
+
+    for (int i = 0; i < FLOOD_REQUESTS; i++) {
+        send_request_packet(NULL);
+    }
+    address = client_address;
+
+    // All of them are dropped before allocating peers
+    pomelo_statistic_protocol_t statistic;
+    pomelo_protocol_context_statistic(protocol_ctx, &statistic);
+    pomelo_check(statistic.dropped_requests == FLOOD_REQUESTS);
+}
+
+
 void pomelo_protocol_socket_on_connected(
     pomelo_protocol_socket_t * socket,
     pomelo_protocol_peer_t * peer
@@ -411,6 +434,11 @@ void pomelo_protocol_socket_on_connect_result(
 }
 
 
+void pomelo_protocol_socket_on_heartbeat(pomelo_protocol_socket_t * socket) {
+    (void) socket;
+}
+
+
 int main(void) {
     printf("Test protocol server.\n");
     if (pomelo_crypto_init() < 0) {
@@ -537,6 +565,8 @@ int main(void) {
     server_options.private_key = crypto_ctx.private_key;
     server_options.protocol_id = protocol_id;
     server_options.adapter = adapter_client;
+    server_options.request_rate = 1;
+    server_options.request_burst = 1;
     ret = pomelo_address_from_string(&server_options.address, SERVER_ADDRESS);
     pomelo_check(ret == 0);
 
@@ -551,6 +581,7 @@ int main(void) {
 
     // After starting server, send request from client
     send_request_packet(NULL);
+    send_flood_request_packets();
 
     // Run the loop
     uv_run(&uv_loop, UV_RUN_DEFAULT);
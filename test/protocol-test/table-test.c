@@ -0,0 +1,287 @@
+#include <string.h>
+#include "pomelo-test.h"
+#include "crypto/crypto.h"
+#include "protocol/table.h"
+#include "protocol/peer.h"
+
+
+/**
+ * This test verifies the peer table of servers: lookups of IPv4 & IPv6
+ * addresses, growing, entries sharing the same home slot, deletion with
+ * backward shift and overriding the peer of an address.
+ */
+
+
+/// The number of peers for growing the table
+#define TEST_TABLE_NPEERS 1000
+
+/// The number of peers sharing the same home slot
+#define TEST_TABLE_NCOLLISIONS 8
+
+/// The maximum number of candidates to find the colliding addresses
+#define TEST_TABLE_MAX_CANDIDATES 100000
+
+
+static pomelo_protocol_peer_t peers[TEST_TABLE_NPEERS];
+static pomelo_protocol_peer_t colliding_peers[TEST_TABLE_NCOLLISIONS];
+
+
+/// @brief Set the address of peer from the index
+static void test_table_set_address(
+    pomelo_protocol_peer_t * peer,
+    size_t index,
+    bool ipv6
+) {
+    memset(&peer->address, 0, sizeof(pomelo_address_t));
+    if (ipv6) {
+        peer->address.type = POMELO_ADDRESS_IPV6;
+        peer->address.ip.v6[0] = 0xfd00;
+        peer->address.ip.v6[7] = (uint16_t) (index >> 16);
+    } else {
+        peer->address.type = POMELO_ADDRESS_IPV4;
+        peer->address.ip.v4[0] = 10;
+        peer->address.ip.v4[3] = (uint8_t) (index >> 16);
+    }
+    peer->address.port = (uint16_t) index;
+}
+
+
+/// @brief Get the slot index of peer
+/// @return The slot index or the capacity if the peer is not found
+static size_t test_table_slot_of(
+    pomelo_protocol_peer_table_t * table,
+    pomelo_protocol_peer_t * peer
+) {
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->slots[i].peer == peer) return i;
+    }
+    return table->capacity;
+}
+
+
+/// @brief Check that every slot is reachable and not farther from its home
+/// slot than the previous slot plus one (Robin Hood invariant)
+static int test_table_check_slots(pomelo_protocol_peer_table_t * table) {
+    size_t mask = table->capacity - 1;
+    size_t size = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        pomelo_protocol_peer_slot_t * slot = table->slots + i;
+        if (!slot->peer) continue;
+        size++;
+
+        pomelo_check(
+            pomelo_protocol_peer_table_get(table, &slot->peer->address) ==
+            slot->peer
+        );
+
+        // The previous slot is occupied unless this one is at home
+        size_t distance = (i - (size_t) slot->hash) & mask;
+        if (distance > 0) {
+            size_t prev_index = (i - 1) & mask;
+            pomelo_protocol_peer_slot_t * prev = table->slots + prev_index;
+            pomelo_check(prev->peer != NULL);
+            size_t prev_distance = (prev_index - (size_t) prev->hash) & mask;
+            pomelo_check(prev_distance + 1 >= distance);
+        }
+    }
+    pomelo_check(size == table->size);
+    return 0;
+}
+
+
+/// @brief Test lookups, growing and deleting of IPv4 & IPv6 addresses
+static int test_table_grow(void) {
+    pomelo_protocol_peer_table_t * table =
+        pomelo_protocol_peer_table_create(NULL);
+    pomelo_check(table != NULL);
+    pomelo_check(
+        table->capacity == POMELO_PROTOCOL_PEER_TABLE_INITIAL_CAPACITY
+    );
+
+    for (size_t i = 0; i < TEST_TABLE_NPEERS; i++) {
+        test_table_set_address(&peers[i], i / 2, i % 2 == 1);
+        pomelo_check(pomelo_protocol_peer_table_set(table, &peers[i]) == 0);
+        pomelo_check(table->size == i + 1);
+    }
+
+    // Grown with the maximum load
+    pomelo_check(
+        table->capacity > POMELO_PROTOCOL_PEER_TABLE_INITIAL_CAPACITY
+    );
+    pomelo_check(
+        table->size <= table->capacity / 8 * POMELO_PROTOCOL_PEER_TABLE_MAX_LOAD
+    );
+    pomelo_check(test_table_check_slots(table) == 0);
+
+    // IPv4 & IPv6 addresses with the same index are different keys
+    for (size_t i = 0; i < TEST_TABLE_NPEERS; i++) {
+        pomelo_check(
+            pomelo_protocol_peer_table_get(table, &peers[i].address) ==
+            &peers[i]
+        );
+    }
+
+    // Unknown address
+    pomelo_protocol_peer_t missing;
+    test_table_set_address(&missing, TEST_TABLE_NPEERS, false);
+    pomelo_check(
+        pomelo_protocol_peer_table_get(table, &missing.address) == NULL
+    );
+    pomelo_check(pomelo_protocol_peer_table_del(table, &missing.address) < 0);
+
+    // Delete the IPv4 peers
+    for (size_t i = 0; i < TEST_TABLE_NPEERS; i += 2) {
+        pomelo_check(
+            pomelo_protocol_peer_table_del(table, &peers[i].address) == 0
+        );
+    }
+    pomelo_check(table->size == TEST_TABLE_NPEERS / 2);
+    pomelo_check(test_table_check_slots(table) == 0);
+
+    for (size_t i = 0; i < TEST_TABLE_NPEERS; i++) {
+        pomelo_protocol_peer_t * peer =
+            pomelo_protocol_peer_table_get(table, &peers[i].address);
+        pomelo_check(peer == ((i % 2 == 1) ? &peers[i] : NULL));
+    }
+
+    pomelo_protocol_peer_table_clear(table);
+    pomelo_check(table->size == 0);
+    pomelo_check(
+        pomelo_protocol_peer_table_get(table, &peers[1].address) == NULL
+    );
+
+    pomelo_protocol_peer_table_destroy(table);
+    return 0;
+}
+
+
+/// @brief Test the peers sharing the same home slot
+static int test_table_collisions(void) {
+    pomelo_protocol_peer_table_t * table =
+        pomelo_protocol_peer_table_create(NULL);
+    pomelo_check(table != NULL);
+
+    // The hash key is random, so find the addresses sharing the home slot of
+    // the first one by putting them into the empty table.
+    size_t home = table->capacity;
+    size_t ncollisions = 0;
+    pomelo_protocol_peer_t candidate;
+    for (size_t i = 0;
+        i < TEST_TABLE_MAX_CANDIDATES && ncollisions < TEST_TABLE_NCOLLISIONS;
+        i++
+    ) {
+        test_table_set_address(&candidate, i, i % 2 == 1);
+        pomelo_check(pomelo_protocol_peer_table_set(table, &candidate) == 0);
+        size_t slot = test_table_slot_of(table, &candidate);
+        pomelo_check(
+            pomelo_protocol_peer_table_del(table, &candidate.address) == 0
+        );
+
+        if (home == table->capacity) {
+            home = slot;
+        }
+        if (slot == home) {
+            colliding_peers[ncollisions++] = candidate;
+        }
+    }
+    pomelo_check(ncollisions == TEST_TABLE_NCOLLISIONS);
+    pomelo_check(table->size == 0);
+
+    // The colliding peers occupy the following slots in order
+    size_t mask = table->capacity - 1;
+    for (size_t i = 0; i < TEST_TABLE_NCOLLISIONS; i++) {
+        pomelo_protocol_peer_t * peer = &colliding_peers[i];
+        pomelo_check(pomelo_protocol_peer_table_set(table, peer) == 0);
+        pomelo_check(
+            test_table_slot_of(table, peer) == ((home + i) & mask)
+        );
+    }
+    pomelo_check(test_table_check_slots(table) == 0);
+
+    // Delete from the middle, the following peers are shifted back
+    pomelo_address_t * address = &colliding_peers[2].address;
+    pomelo_check(pomelo_protocol_peer_table_del(table, address) == 0);
+    pomelo_check(pomelo_protocol_peer_table_get(table, address) == NULL);
+    pomelo_check(test_table_check_slots(table) == 0);
+    for (size_t i = 3; i < TEST_TABLE_NCOLLISIONS; i++) {
+        pomelo_check(
+            test_table_slot_of(table, &colliding_peers[i]) ==
+            ((home + i - 1) & mask)
+        );
+    }
+    pomelo_check(
+        table->slots[(home + TEST_TABLE_NCOLLISIONS - 1) & mask].peer == NULL
+    );
+
+    // Delete the entry at home
+    address = &colliding_peers[0].address;
+    pomelo_check(pomelo_protocol_peer_table_del(table, address) == 0);
+    pomelo_check(test_table_slot_of(table, &colliding_peers[1]) == home);
+    pomelo_check(test_table_check_slots(table) == 0);
+
+    for (size_t i = 0; i < TEST_TABLE_NCOLLISIONS; i++) {
+        pomelo_protocol_peer_t * peer = pomelo_protocol_peer_table_get(
+            table,
+            &colliding_peers[i].address
+        );
+        pomelo_check(peer == ((i == 0 || i == 2) ? NULL : &colliding_peers[i]));
+    }
+
+    pomelo_protocol_peer_table_destroy(table);
+    return 0;
+}
+
+
+/// @brief Test overriding the peer of an address and deleting it
+static int test_table_override(void) {
+    pomelo_protocol_peer_table_t * table =
+        pomelo_protocol_peer_table_create(NULL);
+    pomelo_check(table != NULL);
+
+    for (size_t i = 0; i < 100; i++) {
+        test_table_set_address(&peers[i], i, i % 3 == 0);
+        pomelo_check(pomelo_protocol_peer_table_set(table, &peers[i]) == 0);
+    }
+
+    // The new peer of the same address replaces the old one
+    pomelo_protocol_peer_t * replaced = &peers[50];
+    pomelo_protocol_peer_t replacing;
+    memset(&replacing, 0, sizeof(pomelo_protocol_peer_t));
+    replacing.address = replaced->address;
+    pomelo_check(pomelo_protocol_peer_table_set(table, &replacing) == 0);
+    pomelo_check(table->size == 100);
+    pomelo_check(
+        pomelo_protocol_peer_table_get(table, &replaced->address) == &replacing
+    );
+    pomelo_check(test_table_slot_of(table, replaced) == table->capacity);
+    pomelo_check(test_table_check_slots(table) == 0);
+
+    // Delete it by address, no other peer becomes unreachable
+    pomelo_check(
+        pomelo_protocol_peer_table_del(table, &replacing.address) == 0
+    );
+    pomelo_check(table->size == 99);
+    pomelo_check(
+        pomelo_protocol_peer_table_get(table, &replacing.address) == NULL
+    );
+    pomelo_check(test_table_check_slots(table) == 0);
+    for (size_t i = 0; i < 100; i++) {
+        if (i == 50) continue;
+        pomelo_check(
+            pomelo_protocol_peer_table_get(table, &peers[i].address) ==
+            &peers[i]
+        );
+    }
+
+    pomelo_protocol_peer_table_destroy(table);
+    return 0;
+}
+
+
+int main(void) {
+    pomelo_check(pomelo_crypto_init() == 0);
+    pomelo_run_test(test_table_grow);
+    pomelo_run_test(test_table_collisions);
+    pomelo_run_test(test_table_override);
+    return 0;
+}
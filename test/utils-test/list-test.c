@@ -37,6 +37,17 @@ int pomelo_test_list(void) {
     pomelo_list_remove(list, second);
     pomelo_check(list->size == 2);
 
+    // Move the front to back and back again, the entry is kept
+    pomelo_list_entry_t * front = list->front;
+    pomelo_list_move_back(list, front);
+    pomelo_check(list->back == front);
+    pomelo_check(list->size == 2);
+    pomelo_check(pomelo_list_element(list->front, int) == 3);
+    pomelo_list_move_back(list, list->front);
+    pomelo_check(list->front == front);
+    pomelo_list_move_back(list, list->back);
+    pomelo_check(list->back->prev == front);
+
     value = 4;
     pomelo_check(pomelo_list_push_back(list, value) != NULL);
     pomelo_check(list->size == 3);
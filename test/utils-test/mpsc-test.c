@@ -0,0 +1,63 @@
+#include "pomelo-test.h"
+#include "utils/mpsc.h"
+#include "utils-test.h"
+
+
+typedef struct pomelo_test_mpsc_element_s {
+    pomelo_mpsc_node_t node;
+    int value;
+} pomelo_test_mpsc_element_t;
+
+
+int pomelo_test_mpsc(void) {
+    pomelo_mpsc_queue_t queue;
+    pomelo_mpsc_queue_init(&queue);
+
+    // Empty queue
+    pomelo_check(pomelo_mpsc_queue_pop(&queue) == NULL);
+
+    pomelo_test_mpsc_element_t elements[5];
+    for (int i = 0; i < 5; i++) {
+        elements[i].value = i;
+    }
+
+    // Single element
+    pomelo_mpsc_queue_push(&queue, &elements[0].node);
+    pomelo_check(
+        pomelo_mpsc_queue_pop(&queue) == &elements[0].node
+    );
+    pomelo_check(pomelo_mpsc_queue_pop(&queue) == NULL);
+
+    // FIFO order
+    for (int i = 0; i < 5; i++) {
+        pomelo_mpsc_queue_push(&queue, &elements[i].node);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        pomelo_test_mpsc_element_t * element =
+            (pomelo_test_mpsc_element_t *) pomelo_mpsc_queue_pop(&queue);
+        pomelo_check(element != NULL);
+        pomelo_check(element->value == i);
+    }
+
+    // Push the popped elements again while the queue is not empty
+    for (int i = 0; i < 3; i++) {
+        pomelo_mpsc_queue_push(&queue, &elements[i].node);
+    }
+
+    int expected[] = { 3, 4, 0, 1, 2 };
+    for (int i = 0; i < 5; i++) {
+        pomelo_test_mpsc_element_t * element =
+            (pomelo_test_mpsc_element_t *) pomelo_mpsc_queue_pop(&queue);
+        pomelo_check(element != NULL);
+        pomelo_check(element->value == expected[i]);
+    }
+    pomelo_check(pomelo_mpsc_queue_pop(&queue) == NULL);
+
+    // The queue is still usable after being drained
+    pomelo_mpsc_queue_push(&queue, &elements[4].node);
+    pomelo_check(pomelo_mpsc_queue_pop(&queue) == &elements[4].node);
+    pomelo_check(pomelo_mpsc_queue_pop(&queue) == NULL);
+
+    return 0;
+}
@@ -11,6 +11,7 @@ int main(void) {
     pomelo_run_test(pomelo_test_array);
     pomelo_run_test(pomelo_test_map);
     pomelo_run_test(pomelo_test_heap);
+    pomelo_run_test(pomelo_test_mpsc);
     
     printf("*** All utils tests passed ***\n");
     return 0;
@@ -11,6 +11,7 @@ int pomelo_test_unrolled_list(void);
 int pomelo_test_array(void);
 int pomelo_test_map(void);
 int pomelo_test_heap(void);
+int pomelo_test_mpsc(void);
 
 
 #ifdef __cplusplus